@@ -561,14 +561,14 @@ Resource::~Resource() {
 	ResourceCache::lock.lock();
 	// Only unregister from the cache if this is the actual resource listed there.
 	// (Other resources can have the same value in `path_cache` if loaded with `CACHE_IGNORE`.)
-	HashMap<String, Resource *>::Iterator E = ResourceCache::resources.find(path_cache);
+	FlatHashMap<String, Resource *>::Iterator E = ResourceCache::resources.find(path_cache);
 	if (likely(E && E->value == this)) {
 		ResourceCache::resources.remove(E);
 	}
 	ResourceCache::lock.unlock();
 }
 
-HashMap<String, Resource *> ResourceCache::resources;
+FlatHashMap<String, Resource *> ResourceCache::resources;
 #ifdef TOOLS_ENABLED
 HashMap<String, HashMap<String, String>> ResourceCache::resource_path_cache;
 #endif
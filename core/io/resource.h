@@ -35,6 +35,7 @@
 #include "core/object/class_db.h"
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/templates/flat_hash_map.h"
 #include "core/templates/safe_refcount.h"
 #include "core/templates/self_list.h"
 
@@ -156,7 +157,7 @@ class ResourceCache {
 	friend class Resource;
 	friend class ResourceLoader; //need the lock
 	static Mutex lock;
-	static HashMap<String, Resource *> resources;
+	static FlatHashMap<String, Resource *> resources;
 #ifdef TOOLS_ENABLED
 	static HashMap<String, HashMap<String, String>> resource_path_cache; // Each tscn has a set of resource paths and IDs.
 	static RWLock path_cache_lock;
@@ -52,6 +52,7 @@
 // and pairable_mask is either 0 if static, or set to all if non static
 
 #include "bvh_tree.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/mutex.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
@@ -88,6 +89,14 @@ public:
 		tree.params_set_pairing_expansion(p_value);
 	}
 
+	// Lets update() find the overlaps of changed items on the WorkerThreadPool. The (un)pair callbacks
+	// are still sent from the calling thread and in the same order, but USER_CULL_TEST_FUNCTION must
+	// then be safe to call from several threads at once.
+	void params_set_parallel_pairing(bool p_enable) {
+		BVH_LOCKED_FUNCTION
+		_parallel_pairing = p_enable;
+	}
+
 	void set_pair_callback(PairCallback p_callback, void *p_userdata) {
 		BVH_LOCKED_FUNCTION
 		pair_callback = p_callback;
@@ -381,6 +390,31 @@ public:
 		return params.result_count_overall;
 	}
 
+	// Like cull_segment() for up to 32 segments at once, but the tree is only walked once, so
+	// it's faster when the segments are close together. The results of segment n are written
+	// to r_results[n] and r_subindices[n].
+	void cull_segments(const POINT *p_from, const POINT *p_to, uint32_t p_count, LocalVector<T *> *r_results, LocalVector<int> *r_subindices, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF) {
+		BVH_LOCKED_FUNCTION
+		ERR_FAIL_COND(p_count > 32);
+
+		typename BVHTREE_CLASS::CullParams params;
+
+		params.result_count_overall = 0;
+		params.result_max = p_result_max;
+		params.result_array = nullptr;
+		params.subindex_array = nullptr;
+		params.tester = p_tester;
+		params.tree_collision_mask = p_tree_collision_mask;
+
+		typename BVHABB_CLASS::Segment segments[32];
+		for (uint32_t n = 0; n < p_count; n++) {
+			segments[n].from = p_from[n];
+			segments[n].to = p_to[n];
+		}
+
+		tree.cull_segments(params, segments, p_count, r_results, r_subindices);
+	}
+
 	int cull_point(const POINT &p_point, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
 		BVH_LOCKED_FUNCTION
 		typename BVHTREE_CLASS::CullParams params;
@@ -428,14 +462,21 @@ public:
 	}
 
 private:
-	// do this after moving etc.
-	void _check_for_collisions(bool p_full_check = false) {
-		if (!changed_items.size()) {
-			// noop
-			return;
-		}
+	// changed_items are paired in chunks of this size, whose cull hits are
+	// found on separate threads when parallel pairing is enabled
+	static const uint32_t PAIRING_CHUNK_SIZE = 32;
+
+	struct PairingChunk {
+		LocalVector<uint32_t, uint32_t, true> hits;
+		// where the hits of each item in the chunk end
+		LocalVector<uint32_t, uint32_t, true> item_hits_end;
+	};
 
-		BOUNDS bb;
+	// Appends the ref ids of the items the expanded aabb of each changed item in the chunk overlaps.
+	// This only reads the tree, so it can be run for several chunks at once.
+	void _find_chunk_hits(uint32_t p_chunk, PairingChunk &r_chunk) {
+		r_chunk.hits.clear();
+		r_chunk.item_hits_end.clear();
 
 		typename BVHTREE_CLASS::CullParams params;
 
@@ -444,37 +485,81 @@ private:
 		params.result_array = nullptr;
 		params.subindex_array = nullptr;
 
-		for (const BVHHandle &h : changed_items) {
-			// use the expanded aabb for pairing
-			const BOUNDS &expanded_aabb = tree._pairs[h.id()].expanded_aabb;
-			BVHABB_CLASS abb;
-			abb.from(expanded_aabb);
+		uint32_t from = p_chunk * PAIRING_CHUNK_SIZE;
+		uint32_t to = MIN(from + PAIRING_CHUNK_SIZE, changed_items.size());
+
+		for (uint32_t i = from; i < to; i++) {
+			const BVHHandle &h = changed_items[i];
 
+			// use the expanded aabb for pairing
 			tree.item_fill_cullparams(h, params);
+			params.abb.from(tree._pairs[h.id()].expanded_aabb);
+
+			uint32_t item_hits_start = r_chunk.hits.size();
+			tree.cull_aabb_ref_ids(params, r_chunk.hits);
+
+			// don't collide against ourself
+			for (uint32_t n = item_hits_start; n < r_chunk.hits.size(); n++) {
+				if (r_chunk.hits[n] == h.id()) {
+					r_chunk.hits.remove_at(n);
+					break;
+				}
+			}
 
-			// find all the existing paired aabbs that are no longer
-			// paired, and send callbacks
-			_find_leavers(h, abb, p_full_check);
+			r_chunk.item_hits_end.push_back(r_chunk.hits.size());
+		}
+	}
 
-			uint32_t changed_item_ref_id = h.id();
+	// do this after moving etc.
+	void _check_for_collisions(bool p_full_check = false) {
+		if (!changed_items.size()) {
+			// noop
+			return;
+		}
 
-			params.abb = abb;
+		uint32_t num_chunks = (changed_items.size() + PAIRING_CHUNK_SIZE - 1) / PAIRING_CHUNK_SIZE;
 
-			params.result_count_overall = 0; // might not be needed
-			tree.cull_aabb(params, false);
+		// The hits only depend on the tree, which pairing doesn't change, so finding them all
+		// up front gives the same pairs, in the same order, as finding them item by item.
+		bool parallel = _parallel_pairing && num_chunks > 1 && WorkerThreadPool::get_singleton();
+		if (_pairing_chunks.size() < (parallel ? num_chunks : 1)) {
+			_pairing_chunks.resize(parallel ? num_chunks : 1);
+		}
 
-			for (const uint32_t ref_id : tree._cull_hits) {
-				// don't collide against ourself
-				if (ref_id == changed_item_ref_id) {
-					continue;
+		if (parallel) {
+			auto find_hits = [this](uint32_t p_from, uint32_t p_to) {
+				for (uint32_t c = p_from; c < p_to; c++) {
+					_find_chunk_hits(c, _pairing_chunks[c]);
 				}
+			};
+			WorkerThreadPool::get_singleton()->parallel_for(0, num_chunks, 1, find_hits, true, SNAME("BVHPairing"));
+		}
+
+		for (uint32_t c = 0; c < num_chunks; c++) {
+			PairingChunk &chunk = _pairing_chunks[parallel ? c : 0];
+			if (!parallel) {
+				_find_chunk_hits(c, chunk);
+			}
+
+			uint32_t hit = 0;
+			for (uint32_t n = 0; n < chunk.item_hits_end.size(); n++) {
+				BVHHandle h = changed_items[c * PAIRING_CHUNK_SIZE + n];
+
+				BVHABB_CLASS abb;
+				abb.from(tree._pairs[h.id()].expanded_aabb);
 
-				// checkmasks is already done in the cull routine.
-				BVHHandle h_collidee;
-				h_collidee.set_id(ref_id);
+				// find all the existing paired aabbs that are no longer
+				// paired, and send callbacks
+				_find_leavers(h, abb, p_full_check);
 
-				// find NEW enterers, and send callbacks for them only
-				_collide(h, h_collidee);
+				for (; hit < chunk.item_hits_end[n]; hit++) {
+					// checkmasks is already done in the cull routine.
+					BVHHandle h_collidee;
+					h_collidee.set_id(chunk.hits[hit]);
+
+					// find NEW enterers, and send callbacks for them only
+					_collide(h, h_collidee);
+				}
 			}
 		}
 		_reset();
@@ -773,6 +858,9 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	LocalVector<PairingChunk> _pairing_chunks;
+	bool _parallel_pairing = false;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
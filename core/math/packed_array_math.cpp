@@ -0,0 +1,632 @@
+/**************************************************************************/
+/*  packed_array_math.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "packed_array_math.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PACKED_ARRAY_MATH_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define PACKED_ARRAY_MATH_NEON
+#include <arm_neon.h>
+#endif
+
+// A small group of scalars processed at once. The generic version is left to
+// the compiler to vectorize.
+template <typename T>
+struct PackedMathLanes {
+	static constexpr int WIDTH = 4;
+
+	T v[WIDTH];
+
+	static _FORCE_INLINE_ PackedMathLanes load(const T *p_src) {
+		PackedMathLanes r;
+		for (int i = 0; i < WIDTH; i++) {
+			r.v[i] = p_src[i];
+		}
+		return r;
+	}
+	static _FORCE_INLINE_ PackedMathLanes splat(T p_value) {
+		PackedMathLanes r;
+		for (int i = 0; i < WIDTH; i++) {
+			r.v[i] = p_value;
+		}
+		return r;
+	}
+	_FORCE_INLINE_ void store(T *p_dst) const {
+		for (int i = 0; i < WIDTH; i++) {
+			p_dst[i] = v[i];
+		}
+	}
+
+#define PACKED_MATH_LANES_OP(m_name, m_expr)                                                               \
+	friend _FORCE_INLINE_ PackedMathLanes m_name(const PackedMathLanes &p_a, const PackedMathLanes &p_b) { \
+		PackedMathLanes r;                                                                                 \
+		for (int i = 0; i < WIDTH; i++) {                                                                  \
+			const T a = p_a.v[i];                                                                          \
+			const T b = p_b.v[i];                                                                          \
+			r.v[i] = m_expr;                                                                               \
+		}                                                                                                  \
+		return r;                                                                                          \
+	}
+
+	PACKED_MATH_LANES_OP(operator+, a + b)
+	PACKED_MATH_LANES_OP(operator-, a - b)
+	PACKED_MATH_LANES_OP(operator*, a * b)
+	PACKED_MATH_LANES_OP(_min, MIN(a, b))
+	PACKED_MATH_LANES_OP(_max, MAX(a, b))
+
+#undef PACKED_MATH_LANES_OP
+};
+
+#define PACKED_MATH_LANES_SPECIALIZATION(m_type, m_width, m_reg, m_load, m_store, m_splat, m_add, m_sub, m_mul, m_min, m_max) \
+	template <>                                                                                                               \
+	struct PackedMathLanes<m_type> {                                                                                          \
+		static constexpr int WIDTH = m_width;                                                                                 \
+		m_reg v;                                                                                                              \
+		static _FORCE_INLINE_ PackedMathLanes load(const m_type *p_src) {                                                     \
+			return { m_load(p_src) };                                                                                         \
+		}                                                                                                                     \
+		static _FORCE_INLINE_ PackedMathLanes splat(m_type p_value) {                                                         \
+			return { m_splat(p_value) };                                                                                      \
+		}                                                                                                                     \
+		_FORCE_INLINE_ void store(m_type *p_dst) const {                                                                      \
+			m_store(p_dst, v);                                                                                                \
+		}                                                                                                                     \
+		friend _FORCE_INLINE_ PackedMathLanes operator+(const PackedMathLanes &p_a, const PackedMathLanes &p_b) {             \
+			return { m_add(p_a.v, p_b.v) };                                                                                   \
+		}                                                                                                                     \
+		friend _FORCE_INLINE_ PackedMathLanes operator-(const PackedMathLanes &p_a, const PackedMathLanes &p_b) {             \
+			return { m_sub(p_a.v, p_b.v) };                                                                                   \
+		}                                                                                                                     \
+		friend _FORCE_INLINE_ PackedMathLanes operator*(const PackedMathLanes &p_a, const PackedMathLanes &p_b) {             \
+			return { m_mul(p_a.v, p_b.v) };                                                                                   \
+		}                                                                                                                     \
+		friend _FORCE_INLINE_ PackedMathLanes _min(const PackedMathLanes &p_a, const PackedMathLanes &p_b) {                  \
+			return { m_min(p_a.v, p_b.v) };                                                                                   \
+		}                                                                                                                     \
+		friend _FORCE_INLINE_ PackedMathLanes _max(const PackedMathLanes &p_a, const PackedMathLanes &p_b) {                  \
+			return { m_max(p_a.v, p_b.v) };                                                                                   \
+		}                                                                                                                     \
+	};
+
+#if defined(PACKED_ARRAY_MATH_SSE2)
+PACKED_MATH_LANES_SPECIALIZATION(float, 4, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, _mm_min_ps, _mm_max_ps)
+PACKED_MATH_LANES_SPECIALIZATION(double, 2, __m128d, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_add_pd, _mm_sub_pd, _mm_mul_pd, _mm_min_pd, _mm_max_pd)
+#elif defined(PACKED_ARRAY_MATH_NEON)
+PACKED_MATH_LANES_SPECIALIZATION(float, 4, float32x4_t, vld1q_f32, vst1q_f32, vdupq_n_f32, vaddq_f32, vsubq_f32, vmulq_f32, vminq_f32, vmaxq_f32)
+#if defined(__aarch64__) || defined(_M_ARM64)
+PACKED_MATH_LANES_SPECIALIZATION(double, 2, float64x2_t, vld1q_f64, vst1q_f64, vdupq_n_f64, vaddq_f64, vsubq_f64, vmulq_f64, vminq_f64, vmaxq_f64)
+#endif
+#endif
+
+#undef PACKED_MATH_LANES_SPECIALIZATION
+
+// Scalar counterparts, so the same operation can be written once for lanes and for the remaining scalars.
+template <typename T>
+static _FORCE_INLINE_ T _min(T p_a, T p_b) {
+	return MIN(p_a, p_b);
+}
+template <typename T>
+static _FORCE_INLINE_ T _max(T p_a, T p_b) {
+	return MAX(p_a, p_b);
+}
+
+// Repeats a value of `p_stride` scalars over a block of registers. The block
+// size is a multiple of both the lane width and the stride, so every block
+// starts at the first component.
+template <typename T, int REGS>
+struct PackedMathPattern {
+	typedef PackedMathLanes<T> Lanes;
+	static constexpr int BLOCK = REGS * Lanes::WIDTH;
+
+	Lanes lanes[REGS];
+
+	PackedMathPattern(const T *p_value, int p_stride) {
+		T scalars[BLOCK];
+		for (int i = 0; i < BLOCK; i++) {
+			scalars[i] = p_value[i % p_stride];
+		}
+		for (int k = 0; k < REGS; k++) {
+			lanes[k] = Lanes::load(scalars + k * Lanes::WIDTH);
+		}
+	}
+};
+
+// Replaces every scalar `x` with `p_op(x, a, b)`, where `a` and `b` are the matching components of the given values.
+template <typename T, int REGS, typename F>
+static void _apply_values(T *p_dst, int64_t p_count, const T *p_a, const T *p_b, int p_stride, F p_op) {
+	typedef PackedMathPattern<T, REGS> Pattern;
+	typedef typename Pattern::Lanes Lanes;
+	const Pattern a(p_a, p_stride);
+	const Pattern b(p_b, p_stride);
+
+	int64_t i = 0;
+	for (; i + Pattern::BLOCK <= p_count; i += Pattern::BLOCK) {
+		for (int k = 0; k < REGS; k++) {
+			T *ptr = p_dst + i + k * Lanes::WIDTH;
+			p_op(Lanes::load(ptr), a.lanes[k], b.lanes[k]).store(ptr);
+		}
+	}
+	for (; i < p_count; i++) {
+		p_dst[i] = p_op(p_dst[i], p_a[i % p_stride], p_b[i % p_stride]);
+	}
+}
+
+template <typename T, typename F>
+static void _apply_values(T *p_dst, int64_t p_count, const T *p_a, const T *p_b, int p_stride, F p_op) {
+	ERR_FAIL_COND(p_stride < 1 || p_stride > PackedArrayMath::MAX_STRIDE);
+	if (p_stride == 3) {
+		_apply_values<T, 3>(p_dst, p_count, p_a, p_b, p_stride, p_op);
+	} else {
+		_apply_values<T, 4>(p_dst, p_count, p_a, p_b, p_stride, p_op);
+	}
+}
+
+// Replaces every scalar `x` with `p_op(x, a, b)`, where `a` and `b` are the scalars at the same index in the given buffers.
+template <typename T, typename F>
+static void _apply_buffers(T *p_dst, const T *p_a, const T *p_b, int64_t p_count, F p_op) {
+	typedef PackedMathLanes<T> Lanes;
+	constexpr int REGS = 4;
+	constexpr int BLOCK = REGS * Lanes::WIDTH;
+
+	int64_t i = 0;
+	for (; i + BLOCK <= p_count; i += BLOCK) {
+		for (int k = 0; k < REGS; k++) {
+			const int64_t j = i + k * Lanes::WIDTH;
+			p_op(Lanes::load(p_dst + j), Lanes::load(p_a + j), Lanes::load(p_b + j)).store(p_dst + j);
+		}
+	}
+	for (; i < p_count; i++) {
+		p_dst[i] = p_op(p_dst[i], p_a[i], p_b[i]);
+	}
+}
+
+// Folds every scalar into the matching component of `r_result` with `p_op`.
+// The lanes start from the initial value of `r_result`, so `p_op` must be idempotent for it (like min and max) or it must be zero.
+template <typename T, int REGS, typename F>
+static void _reduce(const T *p_src, int64_t p_count, T *r_result, int p_stride, F p_op) {
+	typedef PackedMathPattern<T, REGS> Pattern;
+	typedef typename Pattern::Lanes Lanes;
+	Pattern acc(r_result, p_stride);
+
+	int64_t i = 0;
+	for (; i + Pattern::BLOCK <= p_count; i += Pattern::BLOCK) {
+		for (int k = 0; k < REGS; k++) {
+			acc.lanes[k] = p_op(acc.lanes[k], Lanes::load(p_src + i + k * Lanes::WIDTH));
+		}
+	}
+
+	T scalars[Pattern::BLOCK];
+	for (int k = 0; k < REGS; k++) {
+		acc.lanes[k].store(scalars + k * Lanes::WIDTH);
+	}
+	T result[PackedArrayMath::MAX_STRIDE];
+	for (int c = 0; c < p_stride; c++) {
+		result[c] = scalars[c];
+	}
+	for (int j = p_stride; j < Pattern::BLOCK; j++) {
+		result[j % p_stride] = p_op(result[j % p_stride], scalars[j]);
+	}
+	for (; i < p_count; i++) {
+		result[i % p_stride] = p_op(result[i % p_stride], p_src[i]);
+	}
+	for (int c = 0; c < p_stride; c++) {
+		r_result[c] = result[c];
+	}
+}
+
+template <typename T, typename F>
+static void _reduce(const T *p_src, int64_t p_count, T *r_result, int p_stride, F p_op) {
+	ERR_FAIL_COND(p_stride < 1 || p_stride > PackedArrayMath::MAX_STRIDE);
+	if (p_stride == 3) {
+		_reduce<T, 3>(p_src, p_count, r_result, p_stride, p_op);
+	} else {
+		_reduce<T, 4>(p_src, p_count, r_result, p_stride, p_op);
+	}
+}
+
+template <typename T>
+void PackedArrayMath::add_value(T *p_dst, int64_t p_count, const T *p_value, int p_stride) {
+	_apply_values(p_dst, p_count, p_value, p_value, p_stride, [](auto x, auto a, auto) { return x + a; });
+}
+
+template <typename T>
+void PackedArrayMath::multiply_value(T *p_dst, int64_t p_count, const T *p_value, int p_stride) {
+	_apply_values(p_dst, p_count, p_value, p_value, p_stride, [](auto x, auto a, auto) { return x * a; });
+}
+
+template <typename T>
+void PackedArrayMath::multiply_add_value(T *p_dst, int64_t p_count, const T *p_multiplier, const T *p_addend, int p_stride) {
+	_apply_values(p_dst, p_count, p_multiplier, p_addend, p_stride, [](auto x, auto a, auto b) { return x * a + b; });
+}
+
+template <typename T>
+void PackedArrayMath::clamp(T *p_dst, int64_t p_count, const T *p_min, const T *p_max, int p_stride) {
+	_apply_values(p_dst, p_count, p_min, p_max, p_stride, [](auto x, auto a, auto b) { return _min(_max(x, a), b); });
+}
+
+template <typename T>
+void PackedArrayMath::add(T *p_dst, const T *p_src, int64_t p_count) {
+	_apply_buffers(p_dst, p_src, p_src, p_count, [](auto x, auto a, auto) { return x + a; });
+}
+
+template <typename T>
+void PackedArrayMath::multiply(T *p_dst, const T *p_src, int64_t p_count) {
+	_apply_buffers(p_dst, p_src, p_src, p_count, [](auto x, auto a, auto) { return x * a; });
+}
+
+template <typename T>
+void PackedArrayMath::multiply_add(T *p_dst, const T *p_multiplier, const T *p_addend, int64_t p_count) {
+	_apply_buffers(p_dst, p_multiplier, p_addend, p_count, [](auto x, auto a, auto b) { return x * a + b; });
+}
+
+template <typename T>
+void PackedArrayMath::lerp(T *p_dst, const T *p_to, T p_weight, int64_t p_count) {
+	const PackedMathLanes<T> weight = PackedMathLanes<T>::splat(p_weight);
+	_apply_buffers(p_dst, p_to, p_to, p_count, [&](auto x, auto a, auto) {
+		if constexpr (std::is_same_v<decltype(x), T>) {
+			return x + (a - x) * p_weight;
+		} else {
+			return x + (a - x) * weight;
+		}
+	});
+}
+
+template <typename T>
+T PackedArrayMath::dot(const T *p_a, const T *p_b, int64_t p_count) {
+	typedef PackedMathLanes<T> Lanes;
+	constexpr int REGS = 4;
+	constexpr int BLOCK = REGS * Lanes::WIDTH;
+
+	Lanes acc[REGS];
+	for (int k = 0; k < REGS; k++) {
+		acc[k] = Lanes::splat(0);
+	}
+	int64_t i = 0;
+	for (; i + BLOCK <= p_count; i += BLOCK) {
+		for (int k = 0; k < REGS; k++) {
+			const int64_t j = i + k * Lanes::WIDTH;
+			acc[k] = acc[k] + Lanes::load(p_a + j) * Lanes::load(p_b + j);
+		}
+	}
+
+	T scalars[BLOCK];
+	for (int k = 0; k < REGS; k++) {
+		acc[k].store(scalars + k * Lanes::WIDTH);
+	}
+	T result = 0;
+	for (int j = 0; j < BLOCK; j++) {
+		result += scalars[j];
+	}
+	for (; i < p_count; i++) {
+		result += p_a[i] * p_b[i];
+	}
+	return result;
+}
+
+template <typename T>
+void PackedArrayMath::sum(const T *p_src, int64_t p_count, T *r_result, int p_stride) {
+	for (int c = 0; c < p_stride; c++) {
+		r_result[c] = 0;
+	}
+	_reduce(p_src, p_count, r_result, p_stride, [](auto a, auto b) { return a + b; });
+}
+
+template <typename T>
+void PackedArrayMath::min(const T *p_src, int64_t p_count, T *r_result, int p_stride) {
+	if (p_count < p_stride) {
+		return;
+	}
+	for (int c = 0; c < p_stride; c++) {
+		r_result[c] = p_src[c];
+	}
+	_reduce(p_src, p_count, r_result, p_stride, [](auto a, auto b) { return _min(a, b); });
+}
+
+template <typename T>
+void PackedArrayMath::max(const T *p_src, int64_t p_count, T *r_result, int p_stride) {
+	if (p_count < p_stride) {
+		return;
+	}
+	for (int c = 0; c < p_stride; c++) {
+		r_result[c] = p_src[c];
+	}
+	_reduce(p_src, p_count, r_result, p_stride, [](auto a, auto b) { return _max(a, b); });
+}
+
+#define PACKED_ARRAY_MATH_INSTANTIATE(m_type)                                                                          \
+	template void PackedArrayMath::add_value<m_type>(m_type *, int64_t, const m_type *, int);                          \
+	template void PackedArrayMath::multiply_value<m_type>(m_type *, int64_t, const m_type *, int);                     \
+	template void PackedArrayMath::multiply_add_value<m_type>(m_type *, int64_t, const m_type *, const m_type *, int); \
+	template void PackedArrayMath::clamp<m_type>(m_type *, int64_t, const m_type *, const m_type *, int);              \
+	template void PackedArrayMath::add<m_type>(m_type *, const m_type *, int64_t);                                     \
+	template void PackedArrayMath::multiply<m_type>(m_type *, const m_type *, int64_t);                                \
+	template void PackedArrayMath::multiply_add<m_type>(m_type *, const m_type *, const m_type *, int64_t);            \
+	template void PackedArrayMath::lerp<m_type>(m_type *, const m_type *, m_type, int64_t);                            \
+	template m_type PackedArrayMath::dot<m_type>(const m_type *, const m_type *, int64_t);                             \
+	template void PackedArrayMath::sum<m_type>(const m_type *, int64_t, m_type *, int);                                \
+	template void PackedArrayMath::min<m_type>(const m_type *, int64_t, m_type *, int);                                \
+	template void PackedArrayMath::max<m_type>(const m_type *, int64_t, m_type *, int);
+
+PACKED_ARRAY_MATH_INSTANTIATE(float)
+PACKED_ARRAY_MATH_INSTANTIATE(double)
+
+#undef PACKED_ARRAY_MATH_INSTANTIATE
+
+// Four vectors at a time, split into one register per axis. Only for single-precision reals,
+// and only where division and square roots are available on vectors.
+#if !defined(REAL_T_IS_DOUBLE) && (defined(PACKED_ARRAY_MATH_SSE2) || (defined(PACKED_ARRAY_MATH_NEON) && (defined(__aarch64__) || defined(_M_ARM64))))
+#define PACKED_ARRAY_MATH_VECTORS
+
+typedef PackedMathLanes<float> VectorLanes;
+
+#if defined(PACKED_ARRAY_MATH_SSE2)
+static _FORCE_INLINE_ void _load_vectors(const Vector2 *p_src, VectorLanes &r_x, VectorLanes &r_y) {
+	const __m128 a = _mm_loadu_ps(&p_src[0].x); // x0 y0 x1 y1
+	const __m128 b = _mm_loadu_ps(&p_src[2].x); // x2 y2 x3 y3
+	r_x.v = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+	r_y.v = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+static _FORCE_INLINE_ void _store_vectors(Vector2 *p_dst, const VectorLanes &p_x, const VectorLanes &p_y) {
+	_mm_storeu_ps(&p_dst[0].x, _mm_unpacklo_ps(p_x.v, p_y.v));
+	_mm_storeu_ps(&p_dst[2].x, _mm_unpackhi_ps(p_x.v, p_y.v));
+}
+
+static _FORCE_INLINE_ void _load_vectors(const Vector3 *p_src, VectorLanes &r_x, VectorLanes &r_y, VectorLanes &r_z) {
+	const __m128 a = _mm_loadu_ps(&p_src[0].x); // x0 y0 z0 x1
+	const __m128 b = _mm_loadu_ps(&p_src[1].y); // y1 z1 x2 y2
+	const __m128 c = _mm_loadu_ps(&p_src[2].z); // z2 x3 y3 z3
+	r_x.v = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+	r_y.v = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	r_z.v = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+static _FORCE_INLINE_ void _store_vectors(Vector3 *p_dst, const VectorLanes &p_x, const VectorLanes &p_y, const VectorLanes &p_z) {
+	const __m128 x = p_x.v;
+	const __m128 y = p_y.v;
+	const __m128 z = p_z.v;
+	_mm_storeu_ps(&p_dst[0].x, _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm_storeu_ps(&p_dst[1].y, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm_storeu_ps(&p_dst[2].z, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+static _FORCE_INLINE_ VectorLanes _sqrt(const VectorLanes &p_a) {
+	return { _mm_sqrt_ps(p_a.v) };
+}
+
+static _FORCE_INLINE_ VectorLanes _divide(const VectorLanes &p_a, const VectorLanes &p_b) {
+	return { _mm_div_ps(p_a.v, p_b.v) };
+}
+
+// Picks `p_a` in the lanes where `p_test` isn't zero, and `p_b` elsewhere.
+static _FORCE_INLINE_ VectorLanes _select_nonzero(const VectorLanes &p_test, const VectorLanes &p_a, const VectorLanes &p_b) {
+	const __m128 mask = _mm_cmpneq_ps(p_test.v, _mm_setzero_ps());
+	return { _mm_or_ps(_mm_and_ps(mask, p_a.v), _mm_andnot_ps(mask, p_b.v)) };
+}
+#else
+static _FORCE_INLINE_ void _load_vectors(const Vector2 *p_src, VectorLanes &r_x, VectorLanes &r_y) {
+	const float32x4x2_t v = vld2q_f32(&p_src[0].x);
+	r_x.v = v.val[0];
+	r_y.v = v.val[1];
+}
+
+static _FORCE_INLINE_ void _store_vectors(Vector2 *p_dst, const VectorLanes &p_x, const VectorLanes &p_y) {
+	vst2q_f32(&p_dst[0].x, float32x4x2_t{ { p_x.v, p_y.v } });
+}
+
+static _FORCE_INLINE_ void _load_vectors(const Vector3 *p_src, VectorLanes &r_x, VectorLanes &r_y, VectorLanes &r_z) {
+	const float32x4x3_t v = vld3q_f32(&p_src[0].x);
+	r_x.v = v.val[0];
+	r_y.v = v.val[1];
+	r_z.v = v.val[2];
+}
+
+static _FORCE_INLINE_ void _store_vectors(Vector3 *p_dst, const VectorLanes &p_x, const VectorLanes &p_y, const VectorLanes &p_z) {
+	vst3q_f32(&p_dst[0].x, float32x4x3_t{ { p_x.v, p_y.v, p_z.v } });
+}
+
+static _FORCE_INLINE_ VectorLanes _sqrt(const VectorLanes &p_a) {
+	return { vsqrtq_f32(p_a.v) };
+}
+
+static _FORCE_INLINE_ VectorLanes _divide(const VectorLanes &p_a, const VectorLanes &p_b) {
+	return { vdivq_f32(p_a.v, p_b.v) };
+}
+
+// Picks `p_a` in the lanes where `p_test` isn't zero, and `p_b` elsewhere.
+static _FORCE_INLINE_ VectorLanes _select_nonzero(const VectorLanes &p_test, const VectorLanes &p_a, const VectorLanes &p_b) {
+	return { vbslq_f32(vceqq_f32(p_test.v, vdupq_n_f32(0)), p_b.v, p_a.v) };
+}
+#endif
+#endif
+
+// The vector paths below compute in the same order as the scalar loops, so both give the same results.
+
+void PackedArrayMath::lengths(const Vector2 *p_src, int64_t p_count, real_t *r_dst) {
+	int64_t i = 0;
+#ifdef PACKED_ARRAY_MATH_VECTORS
+	for (; i + 4 <= p_count; i += 4) {
+		VectorLanes x, y;
+		_load_vectors(p_src + i, x, y);
+		_sqrt(x * x + y * y).store(r_dst + i);
+	}
+#endif
+	for (; i < p_count; i++) {
+		const Vector2 &v = p_src[i];
+		r_dst[i] = Math::sqrt(v.x * v.x + v.y * v.y);
+	}
+}
+
+void PackedArrayMath::lengths(const Vector3 *p_src, int64_t p_count, real_t *r_dst) {
+	int64_t i = 0;
+#ifdef PACKED_ARRAY_MATH_VECTORS
+	for (; i + 4 <= p_count; i += 4) {
+		VectorLanes x, y, z;
+		_load_vectors(p_src + i, x, y, z);
+		_sqrt(x * x + y * y + z * z).store(r_dst + i);
+	}
+#endif
+	for (; i < p_count; i++) {
+		const Vector3 &v = p_src[i];
+		r_dst[i] = Math::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+	}
+}
+
+void PackedArrayMath::dots(const Vector2 *p_a, const Vector2 *p_b, int64_t p_count, real_t *r_dst) {
+	int64_t i = 0;
+#ifdef PACKED_ARRAY_MATH_VECTORS
+	for (; i + 4 <= p_count; i += 4) {
+		VectorLanes ax, ay, bx, by;
+		_load_vectors(p_a + i, ax, ay);
+		_load_vectors(p_b + i, bx, by);
+		(ax * bx + ay * by).store(r_dst + i);
+	}
+#endif
+	for (; i < p_count; i++) {
+		r_dst[i] = p_a[i].x * p_b[i].x + p_a[i].y * p_b[i].y;
+	}
+}
+
+void PackedArrayMath::dots(const Vector3 *p_a, const Vector3 *p_b, int64_t p_count, real_t *r_dst) {
+	int64_t i = 0;
+#ifdef PACKED_ARRAY_MATH_VECTORS
+	for (; i + 4 <= p_count; i += 4) {
+		VectorLanes ax, ay, az, bx, by, bz;
+		_load_vectors(p_a + i, ax, ay, az);
+		_load_vectors(p_b + i, bx, by, bz);
+		(ax * bx + ay * by + az * bz).store(r_dst + i);
+	}
+#endif
+	for (; i < p_count; i++) {
+		r_dst[i] = p_a[i].x * p_b[i].x + p_a[i].y * p_b[i].y + p_a[i].z * p_b[i].z;
+	}
+}
+
+void PackedArrayMath::normalize(Vector2 *p_dst, int64_t p_count) {
+	int64_t i = 0;
+#ifdef PACKED_ARRAY_MATH_VECTORS
+	for (; i + 4 <= p_count; i += 4) {
+		VectorLanes x, y;
+		_load_vectors(p_dst + i, x, y);
+		const VectorLanes length_squared = x * x + y * y;
+		const VectorLanes length = _sqrt(length_squared);
+		// Like Vector2::normalize(), leaves vectors with a length of zero unchanged.
+		_store_vectors(p_dst + i, _select_nonzero(length_squared, _divide(x, length), x), _select_nonzero(length_squared, _divide(y, length), y));
+	}
+#endif
+	for (; i < p_count; i++) {
+		p_dst[i].normalize();
+	}
+}
+
+void PackedArrayMath::normalize(Vector3 *p_dst, int64_t p_count) {
+	int64_t i = 0;
+#ifdef PACKED_ARRAY_MATH_VECTORS
+	const VectorLanes zero = VectorLanes::splat(0);
+	for (; i + 4 <= p_count; i += 4) {
+		VectorLanes x, y, z;
+		_load_vectors(p_dst + i, x, y, z);
+		const VectorLanes length_squared = x * x + y * y + z * z;
+		const VectorLanes length = _sqrt(length_squared);
+		// Like Vector3::normalize(), sets vectors with a length of zero to zero.
+		_store_vectors(p_dst + i, _select_nonzero(length_squared, _divide(x, length), zero), _select_nonzero(length_squared, _divide(y, length), zero), _select_nonzero(length_squared, _divide(z, length), zero));
+	}
+#endif
+	for (; i < p_count; i++) {
+		p_dst[i].normalize();
+	}
+}
+
+void PackedArrayMath::transform(Vector2 *p_dst, int64_t p_count, const Transform2D &p_transform) {
+	// Copied out of the transform, so the compiler doesn't reload them after every store.
+	const real_t xx = p_transform.columns[0].x;
+	const real_t xy = p_transform.columns[0].y;
+	const real_t yx = p_transform.columns[1].x;
+	const real_t yy = p_transform.columns[1].y;
+	const real_t ox = p_transform.columns[2].x;
+	const real_t oy = p_transform.columns[2].y;
+
+	int64_t i = 0;
+#ifdef PACKED_ARRAY_MATH_VECTORS
+	const VectorLanes lxx = VectorLanes::splat(xx);
+	const VectorLanes lxy = VectorLanes::splat(xy);
+	const VectorLanes lyx = VectorLanes::splat(yx);
+	const VectorLanes lyy = VectorLanes::splat(yy);
+	const VectorLanes lox = VectorLanes::splat(ox);
+	const VectorLanes loy = VectorLanes::splat(oy);
+	for (; i + 4 <= p_count; i += 4) {
+		VectorLanes x, y;
+		_load_vectors(p_dst + i, x, y);
+		_store_vectors(p_dst + i, (lxx * x + lyx * y) + lox, (lxy * x + lyy * y) + loy);
+	}
+#endif
+	for (; i < p_count; i++) {
+		const real_t x = p_dst[i].x;
+		const real_t y = p_dst[i].y;
+		p_dst[i].x = (xx * x + yx * y) + ox;
+		p_dst[i].y = (xy * x + yy * y) + oy;
+	}
+}
+
+void PackedArrayMath::transform(Vector3 *p_dst, int64_t p_count, const Transform3D &p_transform) {
+	// Copied out of the transform, so the compiler doesn't reload them after every store.
+	const Vector3 r0 = p_transform.basis.rows[0];
+	const Vector3 r1 = p_transform.basis.rows[1];
+	const Vector3 r2 = p_transform.basis.rows[2];
+	const Vector3 o = p_transform.origin;
+
+	int64_t i = 0;
+#ifdef PACKED_ARRAY_MATH_VECTORS
+	VectorLanes rows[3][3];
+	VectorLanes origin[3];
+	for (int r = 0; r < 3; r++) {
+		for (int c = 0; c < 3; c++) {
+			rows[r][c] = VectorLanes::splat(p_transform.basis.rows[r][c]);
+		}
+		origin[r] = VectorLanes::splat(o[r]);
+	}
+	for (; i + 4 <= p_count; i += 4) {
+		VectorLanes x, y, z;
+		_load_vectors(p_dst + i, x, y, z);
+		_store_vectors(p_dst + i,
+				rows[0][0] * x + rows[0][1] * y + rows[0][2] * z + origin[0],
+				rows[1][0] * x + rows[1][1] * y + rows[1][2] * z + origin[1],
+				rows[2][0] * x + rows[2][1] * y + rows[2][2] * z + origin[2]);
+	}
+#endif
+	for (; i < p_count; i++) {
+		const Vector3 v = p_dst[i];
+		p_dst[i].x = r0.x * v.x + r0.y * v.y + r0.z * v.z + o.x;
+		p_dst[i].y = r1.x * v.x + r1.y * v.y + r1.z * v.z + o.y;
+		p_dst[i].z = r2.x * v.x + r2.y * v.y + r2.z * v.z + o.z;
+	}
+}
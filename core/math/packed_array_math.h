@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*  packed_array_math.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef PACKED_ARRAY_MATH_H
+#define PACKED_ARRAY_MATH_H
+
+#include "core/math/transform_2d.h"
+#include "core/math/transform_3d.h"
+#include "core/math/vector2.h"
+#include "core/math/vector3.h"
+
+/**
+ * Bulk math kernels for the contiguous buffers behind packed arrays.
+ *
+ * Component-wise operations work on flat buffers of `p_count` scalars, so a
+ * PackedVector3Array is passed as `size() * 3` reals. Values given with a
+ * stride are repeated over the buffer: with a stride of 3, the x, y and z of a
+ * Vector3 apply to every third scalar. These kernels use SSE2 or NEON when
+ * available and are instantiated for `float` and `double`.
+ *
+ * Per-vector operations (lengths, normalization, transforms) take the vectors
+ * directly.
+ */
+class PackedArrayMath {
+public:
+	static constexpr int MAX_STRIDE = 4;
+
+	template <typename T>
+	static void add_value(T *p_dst, int64_t p_count, const T *p_value, int p_stride);
+	template <typename T>
+	static void multiply_value(T *p_dst, int64_t p_count, const T *p_value, int p_stride);
+	// Computes `dst * multiplier + addend`.
+	template <typename T>
+	static void multiply_add_value(T *p_dst, int64_t p_count, const T *p_multiplier, const T *p_addend, int p_stride);
+	template <typename T>
+	static void clamp(T *p_dst, int64_t p_count, const T *p_min, const T *p_max, int p_stride);
+
+	// `p_src` may be the same buffer as `p_dst`.
+	template <typename T>
+	static void add(T *p_dst, const T *p_src, int64_t p_count);
+	template <typename T>
+	static void multiply(T *p_dst, const T *p_src, int64_t p_count);
+	template <typename T>
+	static void multiply_add(T *p_dst, const T *p_multiplier, const T *p_addend, int64_t p_count);
+	template <typename T>
+	static void lerp(T *p_dst, const T *p_to, T p_weight, int64_t p_count);
+	template <typename T>
+	static T dot(const T *p_a, const T *p_b, int64_t p_count);
+
+	// Reductions write one result per component, so `r_result` holds `p_stride` scalars.
+	// The minimum and maximum of an empty buffer are left unchanged in `r_result`.
+	template <typename T>
+	static void sum(const T *p_src, int64_t p_count, T *r_result, int p_stride);
+	template <typename T>
+	static void min(const T *p_src, int64_t p_count, T *r_result, int p_stride);
+	template <typename T>
+	static void max(const T *p_src, int64_t p_count, T *r_result, int p_stride);
+
+	static void lengths(const Vector2 *p_src, int64_t p_count, real_t *r_dst);
+	static void lengths(const Vector3 *p_src, int64_t p_count, real_t *r_dst);
+	static void dots(const Vector2 *p_a, const Vector2 *p_b, int64_t p_count, real_t *r_dst);
+	static void dots(const Vector3 *p_a, const Vector3 *p_b, int64_t p_count, real_t *r_dst);
+	static void normalize(Vector2 *p_dst, int64_t p_count);
+	static void normalize(Vector3 *p_dst, int64_t p_count);
+	static void transform(Vector2 *p_dst, int64_t p_count, const Transform2D &p_transform);
+	static void transform(Vector3 *p_dst, int64_t p_count, const Transform3D &p_transform);
+};
+
+#endif // PACKED_ARRAY_MATH_H
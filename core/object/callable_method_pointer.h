@@ -50,6 +50,25 @@ class CallableCustomMethodPointerBase : public CallableCustom {
 protected:
 	void _setup(uint32_t *p_base_ptr, uint32_t p_ptr_size);
 
+	_FORCE_INLINE_ static bool _validate_ptrcall_argcount(int p_argcount, int p_expected, Callable::CallError &r_call_error) {
+		if (unlikely(p_argcount != p_expected)) {
+			r_call_error.error = p_argcount < p_expected ? Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS : Callable::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
+			r_call_error.expected = p_expected;
+			return false;
+		}
+		return true;
+	}
+
+	// Signatures with types that have no ptrcall encoding can only be called through call().
+	template <typename... P>
+	static constexpr bool _can_ptrcall_args() {
+		return (PtrToArgCanConvert<P>::value && ...);
+	}
+
+	_FORCE_INLINE_ static void _ptrcall_unsupported(Callable::CallError &r_call_error) {
+		r_call_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
+	}
+
 public:
 	virtual StringName get_method() const {
 #ifdef DEBUG_METHODS_ENABLED
@@ -103,6 +122,18 @@ public:
 		call_with_variant_args(data.instance, data.method, p_arguments, p_argcount, r_call_error);
 	}
 
+	virtual void ptrcall(const void **p_arguments, int p_argcount, void *r_return_value, Callable::CallError &r_call_error) const {
+		ERR_FAIL_NULL_MSG(ObjectDB::get_instance(ObjectID(data.object_id)), "Invalid Object id '" + uitos(data.object_id) + "', can't call method.");
+		if (!_validate_ptrcall_argcount(p_argcount, sizeof...(P), r_call_error)) {
+			return;
+		}
+		if constexpr (_can_ptrcall_args<P...>()) {
+			call_with_ptr_args(data.instance, data.method, p_arguments);
+		} else {
+			_ptrcall_unsupported(r_call_error);
+		}
+	}
+
 	CallableCustomMethodPointer(T *p_instance, void (T::*p_method)(P...)) {
 		memset(&data, 0, sizeof(Data)); // Clear beforehand, may have padding bytes.
 		data.instance = p_instance;
@@ -155,6 +186,18 @@ public:
 		call_with_variant_args_ret(data.instance, data.method, p_arguments, p_argcount, r_return_value, r_call_error);
 	}
 
+	virtual void ptrcall(const void **p_arguments, int p_argcount, void *r_return_value, Callable::CallError &r_call_error) const {
+		ERR_FAIL_NULL_MSG(ObjectDB::get_instance(ObjectID(data.object_id)), "Invalid Object id '" + uitos(data.object_id) + "', can't call method.");
+		if (!_validate_ptrcall_argcount(p_argcount, sizeof...(P), r_call_error)) {
+			return;
+		}
+		if constexpr (_can_ptrcall_args<P...>() && PtrToArgCanEncode<R>::value) {
+			call_with_ptr_args_ret(data.instance, data.method, p_arguments, r_return_value);
+		} else {
+			_ptrcall_unsupported(r_call_error);
+		}
+	}
+
 	CallableCustomMethodPointerRet(T *p_instance, R (T::*p_method)(P...)) {
 		memset(&data, 0, sizeof(Data)); // Clear beforehand, may have padding bytes.
 		data.instance = p_instance;
@@ -207,6 +250,18 @@ public:
 		call_with_variant_args_retc(data.instance, data.method, p_arguments, p_argcount, r_return_value, r_call_error);
 	}
 
+	virtual void ptrcall(const void **p_arguments, int p_argcount, void *r_return_value, Callable::CallError &r_call_error) const override {
+		ERR_FAIL_NULL_MSG(ObjectDB::get_instance(ObjectID(data.object_id)), "Invalid Object id '" + uitos(data.object_id) + "', can't call method.");
+		if (!_validate_ptrcall_argcount(p_argcount, sizeof...(P), r_call_error)) {
+			return;
+		}
+		if constexpr (_can_ptrcall_args<P...>() && PtrToArgCanEncode<R>::value) {
+			call_with_ptr_args_retc(data.instance, data.method, p_arguments, r_return_value);
+		} else {
+			_ptrcall_unsupported(r_call_error);
+		}
+	}
+
 	CallableCustomMethodPointerRetC(T *p_instance, R (T::*p_method)(P...) const) {
 		memset(&data, 0, sizeof(Data)); // Clear beforehand, may have padding bytes.
 		data.instance = p_instance;
@@ -263,6 +318,17 @@ public:
 		r_return_value = Variant();
 	}
 
+	virtual void ptrcall(const void **p_arguments, int p_argcount, void *r_return_value, Callable::CallError &r_call_error) const override {
+		if (!_validate_ptrcall_argcount(p_argcount, sizeof...(P), r_call_error)) {
+			return;
+		}
+		if constexpr (_can_ptrcall_args<P...>()) {
+			call_with_ptr_args_static_method(data.method, p_arguments);
+		} else {
+			_ptrcall_unsupported(r_call_error);
+		}
+	}
+
 	CallableCustomStaticMethodPointer(void (*p_method)(P...)) {
 		memset(&data, 0, sizeof(Data)); // Clear beforehand, may have padding bytes.
 		data.method = p_method;
@@ -309,6 +375,17 @@ public:
 		call_with_variant_args_static_ret(data.method, p_arguments, p_argcount, r_return_value, r_call_error);
 	}
 
+	virtual void ptrcall(const void **p_arguments, int p_argcount, void *r_return_value, Callable::CallError &r_call_error) const override {
+		if (!_validate_ptrcall_argcount(p_argcount, sizeof...(P), r_call_error)) {
+			return;
+		}
+		if constexpr (_can_ptrcall_args<P...>() && PtrToArgCanEncode<R>::value) {
+			call_with_ptr_args_static_method_ret(data.method, p_arguments, r_return_value);
+		} else {
+			_ptrcall_unsupported(r_call_error);
+		}
+	}
+
 	CallableCustomStaticMethodPointerRet(R (*p_method)(P...)) {
 		memset(&data, 0, sizeof(Data)); // Clear beforehand, may have padding bytes.
 		data.method = p_method;
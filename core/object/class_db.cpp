@@ -765,8 +765,8 @@ void ClassDB::get_method_list(const StringName &p_class, List<MethodInfo> *p_met
 			p_methods->push_back(minfo);
 		}
 #else
-		for (KeyValue<StringName, MethodBind *> &E : type->method_map) {
-			MethodBind *m = E.value;
+		for (const StringName &E : type->method_order) {
+			MethodBind *m = type->method_map.get(E);
 			MethodInfo minfo = info_from_bind(m);
 			p_methods->push_back(minfo);
 		}
@@ -813,8 +813,8 @@ void ClassDB::get_method_list_with_compatibility(const StringName &p_class, List
 			p_methods->push_back(pair);
 		}
 #else
-		for (KeyValue<StringName, MethodBind *> &E : type->method_map) {
-			MethodBind *method = E.value;
+		for (const StringName &E : type->method_order) {
+			MethodBind *method = type->method_map.get(E);
 			MethodInfo minfo = info_from_bind(method);
 
 			Pair<MethodInfo, uint32_t> pair(minfo, method->get_hash());
@@ -1734,10 +1734,7 @@ void ClassDB::_bind_method_custom(const StringName &p_class, MethodBind *p_metho
 		ERR_FAIL_MSG("Method already bound '" + p_class + "::" + p_method->get_name() + "'.");
 	}
 
-#ifdef DEBUG_METHODS_ENABLED
 	type->method_order.push_back(p_method->get_name());
-#endif
-
 	type->method_map[p_method->get_name()] = p_method;
 }
 
@@ -1765,10 +1762,10 @@ MethodBind *ClassDB::_bind_vararg_method(MethodBind *p_bind, const StringName &p
 		ERR_FAIL_V_MSG(nullptr, "Method already bound: " + instance_type + "::" + p_name + ".");
 	}
 	type->method_map[p_name] = bind;
+	type->method_order.push_back(p_name);
 #ifdef DEBUG_METHODS_ENABLED
 	// FIXME: <reduz> set_return_type is no longer in MethodBind, so I guess it should be moved to vararg method bind
 	//bind->set_return_type("Variant");
-	type->method_order.push_back(p_name);
 #endif
 
 	return bind;
@@ -1813,15 +1810,12 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, bool p_
 	}
 
 	p_bind->set_argument_names(method_name.args);
-
-	if (!p_compatibility) {
-		type->method_order.push_back(mdname);
-	}
 #endif
 
 	if (p_compatibility) {
 		_bind_compatibility(type, p_bind);
 	} else {
+		type->method_order.push_back(mdname);
 		type->method_map[mdname] = p_bind;
 	}
 
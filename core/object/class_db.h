@@ -38,6 +38,7 @@
 // Makes callable_mp readily available in all classes connecting signals.
 // Needs to come after method_bind and object have been included.
 #include "core/object/callable_method_pointer.h"
+#include "core/templates/flat_hash_map.h"
 #include "core/templates/hash_set.h"
 
 #include <type_traits>
@@ -104,7 +105,7 @@ public:
 
 		ObjectGDExtension *gdextension = nullptr;
 
-		HashMap<StringName, MethodBind *> method_map;
+		FlatHashMap<StringName, MethodBind *> method_map;
 		HashMap<StringName, LocalVector<MethodBind *>> method_map_compatibility;
 		HashMap<StringName, int64_t> constant_map;
 		struct EnumInfo {
@@ -116,16 +117,17 @@ public:
 		HashMap<StringName, MethodInfo> signal_map;
 		List<PropertyInfo> property_list;
 		HashMap<StringName, PropertyInfo> property_map;
+		// Keeps method lists in binding order, as method_map has no order.
+		List<StringName> method_order;
 #ifdef DEBUG_METHODS_ENABLED
 		List<StringName> constant_order;
-		List<StringName> method_order;
 		HashSet<StringName> methods_in_properties;
 		List<MethodInfo> virtual_methods;
 		HashMap<StringName, MethodInfo> virtual_methods_map;
 		HashMap<StringName, Vector<Error>> method_error_values;
 		HashMap<StringName, List<StringName>> linked_properties;
 #endif
-		HashMap<StringName, PropertySetGet> property_setget;
+		FlatHashMap<StringName, PropertySetGet> property_setget;
 
 		StringName inherits;
 		StringName name;
@@ -0,0 +1,276 @@
+/**************************************************************************/
+/*  task_graph.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "task_graph.h"
+
+TaskGraph::NodeID TaskGraph::_add_node(void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, const String &p_description) {
+	{
+		MutexLock lock(mutex);
+		if (!runs_in_flight.is_empty()) {
+			if (p_template_userdata) {
+				memdelete(p_template_userdata);
+			}
+			ERR_FAIL_V_MSG(INVALID_NODE_ID, "Can't modify a task graph while it has runs in flight.");
+		}
+	}
+
+	Node node;
+	node.native_func = p_func;
+	node.native_func_userdata = p_userdata;
+	node.template_userdata = p_template_userdata;
+	node.description = p_description;
+	nodes.push_back(node);
+	return nodes.size() - 1;
+}
+
+TaskGraph::NodeID TaskGraph::add_native_task(void (*p_func)(void *), void *p_userdata, const String &p_description) {
+	return _add_node(p_func, p_userdata, nullptr, p_description);
+}
+
+TaskGraph::NodeID TaskGraph::add_native_continuation(NodeID p_predecessor, void (*p_func)(void *), void *p_userdata, const String &p_description) {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_predecessor, nodes.size(), INVALID_NODE_ID);
+	NodeID node = _add_node(p_func, p_userdata, nullptr, p_description);
+	if (node != INVALID_NODE_ID) {
+		add_dependency(node, p_predecessor);
+	}
+	return node;
+}
+
+void TaskGraph::add_dependency(NodeID p_node, NodeID p_predecessor) {
+	ERR_FAIL_UNSIGNED_INDEX(p_node, nodes.size());
+	ERR_FAIL_UNSIGNED_INDEX(p_predecessor, nodes.size());
+	ERR_FAIL_COND_MSG(p_node == p_predecessor, "A task can't depend on itself.");
+	{
+		MutexLock lock(mutex);
+		ERR_FAIL_COND_MSG(!runs_in_flight.is_empty(), "Can't modify a task graph while it has runs in flight.");
+	}
+
+	Node &predecessor = nodes[p_predecessor];
+	if (predecessor.successors.has(p_node)) {
+		return;
+	}
+	predecessor.successors.push_back(p_node);
+	nodes[p_node].predecessor_count++;
+	validated = false;
+}
+
+void TaskGraph::set_high_priority(bool p_high_priority) {
+	high_priority = p_high_priority;
+}
+
+void TaskGraph::clear() {
+	wait_all();
+	for (Node &node : nodes) {
+		if (node.template_userdata) {
+			memdelete(node.template_userdata);
+		}
+	}
+	nodes.clear();
+	validated = true;
+}
+
+bool TaskGraph::_validate() {
+	if (validated) {
+		return true;
+	}
+
+	// Kahn's algorithm: if some task is never freed of predecessors, there's a cycle.
+	LocalVector<uint32_t> pending;
+	LocalVector<NodeID> ready;
+	pending.resize(nodes.size());
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		pending[i] = nodes[i].predecessor_count;
+		if (pending[i] == 0) {
+			ready.push_back(i);
+		}
+	}
+
+	uint32_t visited = 0;
+	while (!ready.is_empty()) {
+		NodeID node = ready[ready.size() - 1];
+		ready.remove_at(ready.size() - 1);
+		visited++;
+		for (NodeID successor : nodes[node].successors) {
+			if (--pending[successor] == 0) {
+				ready.push_back(successor);
+			}
+		}
+	}
+
+	validated = visited == nodes.size();
+	return validated;
+}
+
+void TaskGraph::_run_node(void *p_node_run) {
+	NodeRun *node_run = (NodeRun *)p_node_run;
+	Run *run = node_run->run;
+	NodeID node_id = node_run->node;
+	const Node &node = run->graph->nodes[node_id];
+
+	if (node.native_func) {
+		node.native_func(node.native_func_userdata);
+	} else if (node.template_userdata) {
+		node.template_userdata->callback();
+	}
+
+	run->graph->_node_finished(run, node_id);
+}
+
+void TaskGraph::_post_node(Run *p_run, NodeID p_node) {
+	WorkerThreadPool::get_singleton()->_add_detached_native_task(&TaskGraph::_run_node, &p_run->node_runs[p_node], high_priority, nodes[p_node].description);
+}
+
+void TaskGraph::_node_finished(Run *p_run, NodeID p_node) {
+	for (NodeID successor : nodes[p_node].successors) {
+		if (p_run->pending_predecessors[successor].decrement() == 0) {
+			_post_node(p_run, successor);
+		}
+	}
+
+	// The same task in the next run may have been waiting for this one.
+	Run *next = nullptr;
+	{
+		MutexLock lock(mutex);
+		p_run->finished[p_node] = true;
+		next = p_run->next;
+	}
+	if (next && next->pending_predecessors[p_node].decrement() == 0) {
+		_post_node(next, p_node);
+	}
+
+	// The run may be freed as soon as this is done, so it must be the last access to it.
+	if (p_run->remaining.decrement() == 0) {
+		p_run->done.post();
+	}
+}
+
+TaskGraph::RunID TaskGraph::submit() {
+	ERR_FAIL_COND_V_MSG(!_validate(), INVALID_RUN_ID, "The task graph has a dependency cycle.");
+
+	Run *run = memnew(Run);
+	run->graph = this;
+	run->pending_predecessors.resize(nodes.size());
+	run->node_runs.resize(nodes.size());
+	run->finished.resize(nodes.size());
+	run->remaining.set(nodes.size());
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		run->node_runs[i].run = run;
+		run->node_runs[i].node = i;
+		run->finished[i] = false;
+	}
+
+	LocalVector<NodeID> ready;
+	RunID id;
+	{
+		MutexLock lock(mutex);
+		id = ++last_run_id;
+		run->id = id;
+
+		Run *previous = runs_in_flight.is_empty() ? nullptr : runs_in_flight[runs_in_flight.size() - 1];
+		for (uint32_t i = 0; i < nodes.size(); i++) {
+			uint32_t pending = nodes[i].predecessor_count;
+			if (previous && !previous->finished[i]) {
+				pending++; // Wait for the same task in the previous run.
+			}
+			run->pending_predecessors[i].set(pending);
+			if (pending == 0) {
+				ready.push_back(i);
+			}
+		}
+		if (previous) {
+			previous->next = run;
+		}
+		runs_in_flight.push_back(run);
+	}
+
+	if (nodes.is_empty()) {
+		run->done.post();
+	}
+	for (NodeID node : ready) {
+		_post_node(run, node);
+	}
+
+	return id;
+}
+
+bool TaskGraph::is_run_completed(RunID p_run) {
+	MutexLock lock(mutex);
+	ERR_FAIL_COND_V_MSG(p_run == INVALID_RUN_ID || p_run > last_run_id, false, "Invalid run ID.");
+	for (Run *run : runs_in_flight) {
+		if (run->id == p_run) {
+			return run->remaining.get() == 0;
+		}
+	}
+	return true; // Already waited for.
+}
+
+void TaskGraph::wait(RunID p_run) {
+	Run *run = nullptr;
+	{
+		MutexLock lock(mutex);
+		for (Run *E : runs_in_flight) {
+			if (E->id == p_run) {
+				run = E;
+				break;
+			}
+		}
+	}
+	ERR_FAIL_NULL_MSG(run, "Invalid run ID, or already waited for.");
+
+	run->done.wait();
+
+	MutexLock lock(mutex);
+	for (uint32_t i = 0; i < runs_in_flight.size(); i++) {
+		if (runs_in_flight[i]->next == run) {
+			// Nothing of it will be needed anymore.
+			runs_in_flight[i]->next = nullptr;
+		}
+	}
+	runs_in_flight.erase(run);
+	memdelete(run);
+}
+
+void TaskGraph::wait_all() {
+	while (true) {
+		RunID oldest = INVALID_RUN_ID;
+		{
+			MutexLock lock(mutex);
+			if (runs_in_flight.is_empty()) {
+				return;
+			}
+			oldest = runs_in_flight[0]->id;
+		}
+		wait(oldest);
+	}
+}
+
+TaskGraph::~TaskGraph() {
+	clear();
+}
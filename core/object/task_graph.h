@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*  task_graph.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+// A set of tasks with dependencies among them, run on the WorkerThreadPool.
+// Each task is posted as soon as all its predecessors are done, so independent chains
+// make progress without meeting at a barrier. The graph is built once and can be submitted
+// again and again (e.g., once per frame).
+//
+// A run may be submitted while the previous ones are still in flight. In that case, each task
+// of the new run also waits for the same task of the previous run, but not for the rest of it.
+// That lets consecutive runs overlap like a pipeline, while a task never overlaps with itself.
+//
+// The graph can't be modified while there are runs in flight. Runs must be waited for,
+// which, as with group tasks, blocks the calling thread.
+
+class TaskGraph {
+public:
+	typedef uint32_t NodeID;
+	typedef uint64_t RunID;
+
+	enum {
+		INVALID_NODE_ID = UINT32_MAX,
+		INVALID_RUN_ID = 0,
+	};
+
+private:
+	struct BaseTemplateUserdata {
+		virtual void callback() {}
+		virtual ~BaseTemplateUserdata() {}
+	};
+
+	template <typename C, typename M, typename U>
+	struct TaskUserData : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback() override {
+			(instance->*method)(userdata);
+		}
+	};
+
+	struct Node {
+		void (*native_func)(void *) = nullptr;
+		void *native_func_userdata = nullptr;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		String description;
+		LocalVector<NodeID> successors;
+		uint32_t predecessor_count = 0;
+	};
+
+	struct Run;
+
+	struct NodeRun {
+		Run *run = nullptr;
+		NodeID node = INVALID_NODE_ID;
+	};
+
+	struct Run {
+		RunID id = INVALID_RUN_ID;
+		TaskGraph *graph = nullptr;
+		LocalVector<SafeNumeric<uint32_t>> pending_predecessors;
+		LocalVector<NodeRun> node_runs; // Userdata of the posted tasks.
+		LocalVector<uint8_t> finished; // Guarded by the graph mutex.
+		Run *next = nullptr; // Guarded by the graph mutex.
+		SafeNumeric<uint32_t> remaining;
+		Semaphore done;
+	};
+
+	LocalVector<Node> nodes;
+	bool high_priority = true;
+	bool validated = true;
+
+	BinaryMutex mutex;
+	LocalVector<Run *> runs_in_flight; // In submission order.
+	RunID last_run_id = INVALID_RUN_ID;
+
+	static void _run_node(void *p_node_run);
+	void _post_node(Run *p_run, NodeID p_node);
+	void _node_finished(Run *p_run, NodeID p_node);
+	bool _validate();
+	NodeID _add_node(void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, const String &p_description);
+
+public:
+	NodeID add_native_task(void (*p_func)(void *), void *p_userdata, const String &p_description = String());
+
+	template <typename C, typename M, typename U>
+	NodeID add_template_task(C *p_instance, M p_method, U p_userdata, const String &p_description = String()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_node(nullptr, nullptr, ud, p_description);
+	}
+
+	// Adds a task that runs once p_predecessor is done.
+	NodeID add_native_continuation(NodeID p_predecessor, void (*p_func)(void *), void *p_userdata, const String &p_description = String());
+	void add_dependency(NodeID p_node, NodeID p_predecessor);
+
+	void set_high_priority(bool p_high_priority);
+	bool is_high_priority() const { return high_priority; }
+	uint32_t get_task_count() const { return nodes.size(); }
+	void clear();
+
+	RunID submit();
+	bool is_run_completed(RunID p_run);
+	void wait(RunID p_run);
+	void wait_all();
+
+	TaskGraph() {}
+	~TaskGraph();
+};
+
+#endif // TASK_GRAPH_H
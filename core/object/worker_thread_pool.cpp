@@ -31,6 +31,7 @@
 #include "worker_thread_pool.h"
 
 #include "core/object/script_language.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/os/thread_safe.h"
 #include "core/templates/command_queue_mt.h"
@@ -53,6 +54,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 	int pool_thread_index = thread_ids[Thread::get_caller_id()];
 	ThreadData &curr_thread = threads[pool_thread_index];
 	Task *prev_task = nullptr; // In case this is recursively called.
+	bool low_priority = p_task->low_priority; // Read now, since the task may be freed before it's needed.
 
 	bool safe_for_nodes_backup = is_current_thread_safe_for_nodes();
 	CallQueue *call_queue_backup = MessageQueue::get_singleton() != MessageQueue::get_main_singleton() ? MessageQueue::get_singleton() : nullptr;
@@ -71,6 +73,9 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			task_mutex.lock();
 			curr_thread.ready_for_scripting = true;
 		}
+		// Tasks may be taken without the mutex, so clear any wakeup still pending for this thread,
+		// or notifiers would skip it as if it were about to look for work.
+		curr_thread.signaled = false;
 		p_task->pool_thread_index = pool_thread_index;
 		prev_task = curr_thread.current_task;
 		curr_thread.current_task = p_task;
@@ -81,6 +86,9 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 	}
 #endif
 
+	// Anything the task takes from the thread's FrameArena is reclaimed once it's done.
+	FrameArena::Scope arena_scope;
+
 	if (p_task->group) {
 		// Handling a group
 		bool do_post = false;
@@ -140,16 +148,21 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		}
 
 		task_mutex.lock();
-		p_task->completed = true;
-		p_task->pool_thread_index = -1;
-		if (p_task->waiting_user) {
-			p_task->done_semaphore.post(p_task->waiting_user);
-		}
-		// Let awaiters know.
-		for (uint32_t i = 0; i < threads.size(); i++) {
-			if (threads[i].awaited_task == p_task) {
-				threads[i].cond_var.notify_one();
-				threads[i].signaled = true;
+		if (p_task->detached) {
+			// Nobody can wait for it, so it's done with.
+			task_allocator.free(p_task);
+		} else {
+			p_task->completed = true;
+			p_task->pool_thread_index = -1;
+			if (p_task->waiting_user) {
+				p_task->done_semaphore.post(p_task->waiting_user);
+			}
+			// Let awaiters know.
+			for (uint32_t i = 0; i < threads.size(); i++) {
+				if (threads[i].awaited_task == p_task) {
+					threads[i].cond_var.notify_one();
+					threads[i].signaled = true;
+				}
 			}
 		}
 	}
@@ -157,7 +170,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 #ifdef THREADS_ENABLED
 	{
 		curr_thread.current_task = prev_task;
-		if (p_task->low_priority) {
+		if (low_priority) {
 			low_priority_threads_used--;
 
 			if (_try_promote_low_priority_task()) {
@@ -175,11 +188,40 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 #endif
 }
 
+WorkerThreadPool::Task *WorkerThreadPool::_pop_or_steal_task(ThreadData *p_thread_data) {
+	Task *task = nullptr;
+	if (p_thread_data->work_queue.pop(task) || p_thread_data->injection_queue.steal(task)) {
+		return task;
+	}
+
+	// Start with the next thread so thieves spread across victims.
+	uint32_t thread_count = threads.size();
+	for (uint32_t i = 1; i < thread_count; i++) {
+		ThreadData &victim = threads[(p_thread_data->index + i) % thread_count];
+		if (victim.work_queue.steal(task) || victim.injection_queue.steal(task)) {
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+bool WorkerThreadPool::_are_work_queues_empty() const {
+	for (const ThreadData &th : threads) {
+		if (!th.work_queue.is_empty() || !th.injection_queue.is_empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void WorkerThreadPool::_thread_function(void *p_user) {
 	ThreadData *thread_data = (ThreadData *)p_user;
 	while (true) {
-		Task *task_to_process = nullptr;
-		{
+		// Fast path: own queue first, then steal from the others, without locking.
+		Task *task_to_process = singleton->_pop_or_steal_task(thread_data);
+
+		if (!task_to_process) {
 			MutexLock lock(singleton->task_mutex);
 			if (singleton->exit_threads) {
 				return;
@@ -189,7 +231,8 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 			if (singleton->task_queue.first()) {
 				task_to_process = singleton->task_queue.first()->self();
 				singleton->task_queue.remove(singleton->task_queue.first());
-			} else {
+			} else if (singleton->_are_work_queues_empty()) {
+				// Work queues are only pushed to with the mutex held, so nothing can be missed here.
 				thread_data->cond_var.wait(lock);
 				DEV_ASSERT(singleton->exit_threads || thread_data->signaled);
 			}
@@ -222,7 +265,19 @@ void WorkerThreadPool::_post_tasks_and_unlock(Task **p_tasks, uint32_t p_count,
 	for (uint32_t i = 0; i < p_count; i++) {
 		p_tasks[i]->low_priority = !p_high_priority;
 		if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
-			task_queue.add_last(&p_tasks[i]->task_elem);
+			// Pool threads keep the tasks they post in their own queue, where others can steal them
+			// without contending on the mutex. Other threads spread theirs across the injection queues.
+			// A full queue falls back to the shared one.
+			bool queued = false;
+			if (caller_pool_thread) {
+				queued = caller_pool_thread->work_queue.push(p_tasks[i]);
+			} else {
+				queued = threads[injection_index].injection_queue.push(p_tasks[i]);
+				injection_index = (injection_index + 1) % threads.size();
+			}
+			if (!queued) {
+				task_queue.add_last(&p_tasks[i]->task_elem);
+			}
 			if (!p_high_priority) {
 				low_priority_threads_used++;
 			}
@@ -337,6 +392,18 @@ WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable,
 	return id;
 }
 
+void WorkerThreadPool::_add_detached_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
+	task_mutex.lock();
+	Task *task = task_allocator.alloc();
+	task->native_func = p_func;
+	task->native_func_userdata = p_userdata;
+	task->description = p_description;
+	task->detached = true;
+	// No task ID is used.
+
+	_post_tasks_and_unlock(&task, 1, p_high_priority);
+}
+
 WorkerThreadPool::TaskID WorkerThreadPool::add_task(const Callable &p_action, bool p_high_priority, const String &p_description) {
 	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description);
 }
@@ -436,7 +503,7 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				if (!exit_threads && was_signaled) {
 					// This thread was awaken for some additional reason, but it's about to exit.
 					// Let's find out what may be pending and forward the requests.
-					uint32_t to_process = task_queue.first() ? 1 : 0;
+					uint32_t to_process = (task_queue.first() || !_are_work_queues_empty()) ? 1 : 0;
 					uint32_t to_promote = p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
 					if (to_process || to_promote) {
 						// This thread must be left alone since it won't loop again.
@@ -455,12 +522,17 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 					}
 				}
 
-				if (singleton->task_queue.first()) {
-					task_to_process = task_queue.first()->self();
-					task_queue.remove(task_queue.first());
+				// Own queue first, since the awaited task is likely there.
+				if (!p_caller_pool_thread->work_queue.pop(task_to_process)) {
+					if (task_queue.first()) {
+						task_to_process = task_queue.first()->self();
+						task_queue.remove(task_queue.first());
+					} else {
+						task_to_process = _pop_or_steal_task(p_caller_pool_thread);
+					}
 				}
 
-				if (!task_to_process) {
+				if (!task_to_process && _are_work_queues_empty()) {
 					p_caller_pool_thread->awaited_task = p_task;
 
 					if (flushing_cmd_queue) {
@@ -514,7 +586,7 @@ void WorkerThreadPool::notify_yield_over(TaskID p_task_id) {
 	task_mutex.unlock();
 }
 
-WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, Group **r_group) {
 	ERR_FAIL_COND_V(p_elements < 0, INVALID_TASK_ID);
 	if (p_tasks < 0) {
 		p_tasks = MAX(1u, threads.size());
@@ -554,6 +626,9 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 	}
 
 	groups[id] = group;
+	if (r_group) {
+		*r_group = group;
+	}
 
 	_post_tasks_and_unlock(tasks_posted, p_tasks, p_high_priority);
 
@@ -568,6 +643,108 @@ WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(const Callable &p_act
 	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description);
 }
 
+void WorkerThreadPool::_parallel_for_participant(void *p_parallel_for, uint32_t p_participant) {
+	ParallelFor *pf = (ParallelFor *)p_parallel_for;
+	std::atomic<uint64_t> &own = pf->ranges[p_participant].bounds;
+
+	while (true) {
+		// Consume the own range from the front, one grain at a time.
+		uint64_t bounds = own.load(std::memory_order_acquire);
+		while (true) {
+			uint32_t from = bounds >> 32;
+			uint32_t to = bounds & 0xFFFFFFFF;
+			if (from >= to) {
+				break;
+			}
+			uint32_t chunk_to = from + MIN(pf->grain, to - from);
+			if (own.compare_exchange_weak(bounds, ((uint64_t)chunk_to << 32) | to, std::memory_order_acq_rel, std::memory_order_acquire)) {
+				pf->func(pf->userdata, from, chunk_to);
+				bounds = own.load(std::memory_order_acquire);
+			}
+		}
+
+		// Out of work, so take the back half of what another participant has left.
+		// Work is never lost: the stolen part is only ever held by the thief until it stores it as its own.
+		bool stolen = false;
+		for (uint32_t i = 1; i < pf->participant_count && !stolen; i++) {
+			std::atomic<uint64_t> &victim = pf->ranges[(p_participant + i) % pf->participant_count].bounds;
+			uint64_t victim_bounds = victim.load(std::memory_order_acquire);
+			while (true) {
+				uint32_t from = victim_bounds >> 32;
+				uint32_t to = victim_bounds & 0xFFFFFFFF;
+				if (from >= to) {
+					break;
+				}
+				// Take all of it if it's not worth splitting further.
+				uint32_t split = (to - from) <= pf->grain ? from : from + (to - from) / 2;
+				if (victim.compare_exchange_weak(victim_bounds, ((uint64_t)from << 32) | split, std::memory_order_acq_rel, std::memory_order_acquire)) {
+					own.store(((uint64_t)split << 32) | to, std::memory_order_release);
+					stolen = true;
+					break;
+				}
+			}
+		}
+
+		if (!stolen) {
+			return;
+		}
+	}
+}
+
+void WorkerThreadPool::_parallel_for(uint32_t p_begin, uint32_t p_end, uint32_t p_grain, void (*p_func)(void *, uint32_t, uint32_t), void *p_userdata, bool p_high_priority, const String &p_description) {
+	if (p_end <= p_begin) {
+		return;
+	}
+
+	uint32_t count = p_end - p_begin;
+	uint32_t max_participants = threads.size() + 1; // The calling thread takes part too.
+	uint32_t grain = p_grain;
+	if (grain == 0) {
+		// A few ranges per participant, so there's some room to balance before having to steal.
+		grain = MAX(1u, count / (max_participants * 4));
+	}
+	uint32_t participant_count = MIN(max_participants, count / grain + (count % grain ? 1 : 0));
+
+	if (participant_count <= 1) {
+		for (uint32_t done = 0; done < count; done += MIN(grain, count - done)) {
+			p_func(p_userdata, p_begin + done, p_begin + done + MIN(grain, count - done));
+		}
+		return;
+	}
+
+	ParallelFor pf;
+	pf.func = p_func;
+	pf.userdata = p_userdata;
+	pf.grain = grain;
+	pf.participant_count = participant_count;
+	pf.ranges = (ParallelFor::Range *)alloca(sizeof(ParallelFor::Range) * participant_count);
+	for (uint32_t i = 0; i < participant_count; i++) {
+		uint32_t from = p_begin + (uint64_t)count * i / participant_count;
+		uint32_t to = p_begin + (uint64_t)count * (i + 1) / participant_count;
+		memnew_placement(&pf.ranges[i], ParallelFor::Range);
+		pf.ranges[i].bounds.store(((uint64_t)from << 32) | to, std::memory_order_relaxed);
+	}
+
+	Group *group = nullptr;
+	GroupID group_id = _add_group_task(Callable(), &WorkerThreadPool::_parallel_for_participant, &pf, nullptr, participant_count, participant_count - 1, p_high_priority, p_description, &group);
+
+	// Join in, taking the participant slots no pool thread has claimed yet.
+	// This way, this thread never ends up waiting for tasks that haven't even started.
+	while (true) {
+		uint32_t work_index = group->index.postincrement();
+		if (work_index >= group->max) {
+			break;
+		}
+		_parallel_for_participant(&pf, work_index);
+		if (group->completed_index.increment() == group->max) {
+			group->done_semaphore.post();
+			group->completed.set_to(true);
+		}
+	}
+
+	wait_for_group_task_completion(group_id);
+}
+
 uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
 	task_mutex.lock();
 	const Group *const *groupp = groups.getptr(p_group);
@@ -40,11 +40,16 @@
 #include "core/templates/paged_allocator.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
+#include "core/templates/work_stealing_deque.h"
 
 class CommandQueueMT;
+class TaskGraph;
 
 class WorkerThreadPool : public Object {
 	GDCLASS(WorkerThreadPool, Object)
+
+	friend class TaskGraph;
+
 public:
 	enum {
 		INVALID_TASK_ID = -1
@@ -88,6 +93,7 @@ private:
 		uint32_t waiting_pool = 0;
 		uint32_t waiting_user = 0;
 		bool low_priority = false;
+		bool detached = false; // Not in the task map and freed when done, since nobody waits for it.
 		BaseTemplateUserdata *template_userdata = nullptr;
 		int pool_thread_index = -1;
 
@@ -120,6 +126,14 @@ private:
 		Task *current_task = nullptr;
 		Task *awaited_task = nullptr; // Null if not awaiting the condition variable, or special value (YIELDING).
 		ConditionVariable cond_var;
+		// Tasks posted by this thread. Only pushed to by this thread, with the task mutex held,
+		// so checking all of them under the mutex is enough to know if there's work before sleeping.
+		// Popped by this thread and stolen by the others without locking.
+		WorkStealingDeque<Task *> work_queue;
+		// Tasks posted from outside the pool, which are spread across threads in turn.
+		// Pushed to by any thread, but always with the task mutex held, and only ever stolen from,
+		// so no pop by an owner can race with the pushes.
+		WorkStealingDeque<Task *> injection_queue;
 
 		ThreadData() :
 				ready_for_scripting(false),
@@ -149,6 +163,7 @@ private:
 	uint32_t max_low_priority_threads = 0;
 	uint32_t low_priority_threads_used = 0;
 	uint32_t notify_index = 0; // For rotating across threads, no help distributing load.
+	uint32_t injection_index = 0; // For rotating across the queues of tasks posted from outside the pool.
 
 	uint64_t last_task = 1;
 
@@ -156,6 +171,9 @@ private:
 
 	void _process_task(Task *task);
 
+	Task *_pop_or_steal_task(ThreadData *p_thread_data);
+	bool _are_work_queues_empty() const;
+
 	void _post_tasks_and_unlock(Task **p_tasks, uint32_t p_count, bool p_high_priority);
 	void _notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count);
 
@@ -166,7 +184,29 @@ private:
 	static thread_local CommandQueueMT *flushing_cmd_queue;
 
 	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description);
-	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description);
+	void _add_detached_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description);
+	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, Group **r_group = nullptr);
+
+	struct ParallelFor {
+		struct Range {
+			std::atomic<uint64_t> bounds; // Begin in the high half, end in the low one.
+			uint8_t _pad[64 - sizeof(std::atomic<uint64_t>)]; // Avoid false sharing among participants.
+		};
+
+		void (*func)(void *, uint32_t, uint32_t) = nullptr;
+		void *userdata = nullptr;
+		uint32_t grain = 1;
+		uint32_t participant_count = 0;
+		Range *ranges = nullptr;
+	};
+
+	template <typename F>
+	static void _parallel_for_callback(void *p_func, uint32_t p_from, uint32_t p_to) {
+		(*(const F *)p_func)(p_from, p_to);
+	}
+
+	static void _parallel_for_participant(void *p_parallel_for, uint32_t p_participant);
+	void _parallel_for(uint32_t p_begin, uint32_t p_end, uint32_t p_grain, void (*p_func)(void *, uint32_t, uint32_t), void *p_userdata, bool p_high_priority, const String &p_description);
 
 	template <typename C, typename M, typename U>
 	struct TaskUserData : public BaseTemplateUserdata {
@@ -223,6 +263,14 @@ public:
 	}
 	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	GroupID add_group_task(const Callable &p_action, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+
+	// Calls p_func(from, to) for consecutive ranges covering [p_begin, p_end), of at most p_grain elements each
+	// (0 lets the pool choose), and returns once all of them are done. The calling thread takes part.
+	// Each participant starts with an even share, and idle ones split off half of what's left to another.
+	template <typename F>
+	void parallel_for(uint32_t p_begin, uint32_t p_end, uint32_t p_grain, const F &p_func, bool p_high_priority = true, const String &p_description = String()) {
+		_parallel_for(p_begin, p_end, p_grain, &_parallel_for_callback<F>, (void *)&p_func, p_high_priority, p_description);
+	}
 	uint32_t get_group_processed_element_count(GroupID p_group) const;
 	bool is_group_task_completed(GroupID p_group) const;
 	void wait_for_group_task_completion(GroupID p_group);
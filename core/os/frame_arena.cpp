@@ -0,0 +1,146 @@
+/**************************************************************************/
+/*  frame_arena.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "frame_arena.h"
+
+static thread_local FrameArena thread_arena;
+
+FrameArena *FrameArena::get_thread_arena() {
+	return &thread_arena;
+}
+
+void FrameArena::_set_current(Chunk *p_chunk, uint8_t *p_pos) {
+	current = p_chunk;
+	if (p_chunk) {
+		pos = p_pos ? p_pos : _chunk_data(p_chunk);
+		end = _chunk_data(p_chunk) + p_chunk->size;
+	} else {
+		pos = nullptr;
+		end = nullptr;
+	}
+}
+
+void *FrameArena::_alloc_slow(size_t p_bytes, size_t p_align) {
+	// Reuse the chunks kept from before the last rewind, skipping those that are too small.
+	while (current && current->next) {
+		_set_current(current->next, nullptr);
+		uint8_t *block = _align(pos, p_align);
+		if (block <= end && p_bytes <= (size_t)(end - block)) {
+			pos = block + p_bytes;
+			return block;
+		}
+	}
+
+	size_t size = MAX(chunk_size, current ? current->size * 2 : 0);
+	if (size < p_bytes + p_align) {
+		size = nearest_power_of_2_templated(p_bytes + p_align);
+	}
+
+	Chunk *chunk = (Chunk *)memalloc(CHUNK_HEADER_SIZE + size);
+	ERR_FAIL_NULL_V(chunk, nullptr);
+	chunk->next = nullptr;
+	chunk->size = size;
+
+	if (current) {
+		current->next = chunk;
+	} else {
+		first = chunk;
+	}
+	_set_current(chunk, nullptr);
+
+	uint8_t *block = _align(pos, p_align);
+	pos = block + p_bytes;
+	return block;
+}
+
+void FrameArena::_merge_chunks() {
+	size_t total_size = 0;
+	Chunk *chunk = first;
+	while (chunk) {
+		Chunk *next = chunk->next;
+		total_size += chunk->size;
+		memfree(chunk);
+		chunk = next;
+	}
+
+	first = (Chunk *)memalloc(CHUNK_HEADER_SIZE + total_size);
+	if (first) {
+		first->next = nullptr;
+		first->size = total_size;
+	}
+	_set_current(first, nullptr);
+}
+
+void FrameArena::rewind(const Marker &p_marker) {
+	_set_current(p_marker.chunk ? p_marker.chunk : first, p_marker.pos);
+}
+
+void FrameArena::reset() {
+	if (scope_depth > 0) {
+		return;
+	}
+
+	if (first && first->next) {
+		// The last cycle needed more than one chunk. Merging is only safe here,
+		// as an open Scope could still hold a marker into any of them.
+		_merge_chunks();
+	} else {
+		rewind(Marker());
+	}
+}
+
+size_t FrameArena::get_capacity() const {
+	size_t capacity = 0;
+	for (Chunk *chunk = first; chunk; chunk = chunk->next) {
+		capacity += chunk->size;
+	}
+	return capacity;
+}
+
+uint32_t FrameArena::get_chunk_count() const {
+	uint32_t count = 0;
+	for (Chunk *chunk = first; chunk; chunk = chunk->next) {
+		count++;
+	}
+	return count;
+}
+
+FrameArena::FrameArena(size_t p_chunk_size) {
+	chunk_size = p_chunk_size;
+}
+
+FrameArena::~FrameArena() {
+	Chunk *chunk = first;
+	while (chunk) {
+		Chunk *next = chunk->next;
+		memfree(chunk);
+		chunk = next;
+	}
+}
@@ -0,0 +1,159 @@
+/**************************************************************************/
+/*  frame_arena.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+
+// Bump allocator for short-lived scratch memory.
+//
+// Allocating is a pointer increment, and individual blocks are never freed:
+// everything is reclaimed at once when the arena is rewound. Chunks are kept
+// across rewinds, and when the arena is reset they are merged into a single
+// one, so a workload that repeats every frame stops hitting the system
+// allocator after a few frames.
+//
+// Each thread has its own arena, returned by get_thread_arena(). The one on
+// the main thread is reset at the end of every Main::iteration(), so memory
+// taken from it without a Scope lives until the end of the frame. Each
+// WorkerThreadPool task runs inside a Scope, so its allocations are reclaimed
+// when it finishes. On any other thread, open a Scope before allocating.
+
+class FrameArena {
+	struct Chunk {
+		Chunk *next = nullptr;
+		size_t size = 0;
+	};
+
+	// Keeps chunk data 16-byte aligned.
+	static constexpr size_t CHUNK_HEADER_SIZE = 16;
+	static_assert(sizeof(Chunk) <= CHUNK_HEADER_SIZE);
+
+	Chunk *first = nullptr;
+	Chunk *current = nullptr;
+	uint8_t *pos = nullptr;
+	uint8_t *end = nullptr;
+	size_t chunk_size = 0;
+	uint32_t scope_depth = 0;
+
+	_FORCE_INLINE_ static uint8_t *_chunk_data(Chunk *p_chunk) { return (uint8_t *)p_chunk + CHUNK_HEADER_SIZE; }
+	_FORCE_INLINE_ static uint8_t *_align(uint8_t *p_ptr, size_t p_align) { return (uint8_t *)(((uintptr_t)p_ptr + p_align - 1) & ~(uintptr_t)(p_align - 1)); }
+
+	void _set_current(Chunk *p_chunk, uint8_t *p_pos);
+	void *_alloc_slow(size_t p_bytes, size_t p_align);
+	void _merge_chunks();
+
+public:
+	static constexpr size_t DEFAULT_ALIGN = 16;
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+	struct Marker {
+		Chunk *chunk = nullptr;
+		uint8_t *pos = nullptr;
+	};
+
+	// Rewinds the arena to where it was when the scope was opened.
+	class Scope {
+		FrameArena *arena = nullptr;
+		Marker marker;
+
+	public:
+		_FORCE_INLINE_ FrameArena *get_arena() const { return arena; }
+
+		Scope(FrameArena *p_arena = get_thread_arena()) :
+				arena(p_arena), marker(p_arena->get_marker()) {
+			arena->scope_depth++;
+		}
+		~Scope() {
+			arena->scope_depth--;
+			arena->rewind(marker);
+		}
+	};
+
+	// Returns uninitialized memory, valid until the arena is rewound past it.
+	_FORCE_INLINE_ void *alloc(size_t p_bytes, size_t p_align = DEFAULT_ALIGN) {
+		uint8_t *block = _align(pos, p_align);
+		if (likely(block <= end && p_bytes <= (size_t)(end - block))) {
+			pos = block + p_bytes;
+			return block;
+		}
+		return _alloc_slow(p_bytes, p_align);
+	}
+
+	template <typename T>
+	_FORCE_INLINE_ T *alloc_array(size_t p_count) {
+		return (T *)alloc(p_count * sizeof(T), alignof(T) > DEFAULT_ALIGN ? alignof(T) : DEFAULT_ALIGN);
+	}
+
+	// Grows or shrinks the block in place if it was the last one allocated and
+	// there is room left in its chunk.
+	_FORCE_INLINE_ bool resize_last(void *p_block, size_t p_old_bytes, size_t p_new_bytes) {
+		uint8_t *block = (uint8_t *)p_block;
+		if (block + p_old_bytes == pos && block + p_new_bytes <= end) {
+			pos = block + p_new_bytes;
+			return true;
+		}
+		return false;
+	}
+
+	// Gives the memory back if the block was the last one allocated, otherwise
+	// it is only reclaimed when the arena is rewound.
+	_FORCE_INLINE_ void release(void *p_block, size_t p_bytes) {
+		if ((uint8_t *)p_block + p_bytes == pos) {
+			pos = (uint8_t *)p_block;
+		}
+	}
+
+	_FORCE_INLINE_ Marker get_marker() const { return { current, pos }; }
+	void rewind(const Marker &p_marker);
+	// Does nothing while a Scope is open on this arena.
+	void reset();
+
+	size_t get_capacity() const;
+	uint32_t get_chunk_count() const;
+
+	static FrameArena *get_thread_arena();
+
+	FrameArena(size_t p_chunk_size = DEFAULT_CHUNK_SIZE);
+	~FrameArena();
+};
+
+// Stateless allocator for List, HashMap, RBMap and others taking a
+// DefaultAllocator-like parameter. Uses the calling thread's arena, so the
+// container must not outlive the Scope or frame it was created in.
+class FrameArenaAllocator {
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return FrameArena::get_thread_arena()->alloc(p_memory); }
+	_FORCE_INLINE_ static void free(void *p_ptr) {}
+};
+
+#endif // FRAME_ARENA_H
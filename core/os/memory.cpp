@@ -33,9 +33,44 @@
 #include "core/error/error_macros.h"
 #include "core/templates/safe_refcount.h"
 
+#ifdef SLAB_ALLOCATOR_ENABLED
+#include "core/os/slab_allocator.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 
+static _FORCE_INLINE_ void *_system_alloc(size_t p_bytes) {
+#ifdef SLAB_ALLOCATOR_ENABLED
+	if (p_bytes <= SlabAllocator::MAX_BLOCK_SIZE) {
+		void *mem = SlabAllocator::alloc(p_bytes);
+		if (mem) {
+			return mem;
+		}
+	}
+#endif
+	return malloc(p_bytes);
+}
+
+static _FORCE_INLINE_ void *_system_realloc(void *p_memory, size_t p_bytes) {
+#ifdef SLAB_ALLOCATOR_ENABLED
+	if (SlabAllocator::owns(p_memory)) {
+		return SlabAllocator::realloc(p_memory, p_bytes);
+	}
+#endif
+	return realloc(p_memory, p_bytes);
+}
+
+static _FORCE_INLINE_ void _system_free(void *p_memory) {
+#ifdef SLAB_ALLOCATOR_ENABLED
+	if (SlabAllocator::owns(p_memory)) {
+		SlabAllocator::free(p_memory);
+		return;
+	}
+#endif
+	free(p_memory);
+}
+
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
 }
@@ -72,7 +107,7 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? DATA_OFFSET : 0));
+	void *mem = _system_alloc(p_bytes + (prepad ? DATA_OFFSET : 0));
 
 	ERR_FAIL_NULL_V(mem, nullptr);
 
@@ -121,12 +156,12 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+			_system_free(mem);
 			return nullptr;
 		} else {
 			*s = p_bytes;
 
-			mem = (uint8_t *)realloc(mem, p_bytes + DATA_OFFSET);
+			mem = (uint8_t *)_system_realloc(mem, p_bytes + DATA_OFFSET);
 			ERR_FAIL_NULL_V(mem, nullptr);
 
 			s = (uint64_t *)(mem + SIZE_OFFSET);
@@ -136,7 +171,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 			return mem + DATA_OFFSET;
 		}
 	} else {
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)_system_realloc(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
 
@@ -165,9 +200,9 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 		mem_usage.sub(*s);
 #endif
 
-		free(mem);
+		_system_free(mem);
 	} else {
-		free(mem);
+		_system_free(mem);
 	}
 }
 
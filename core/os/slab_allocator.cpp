@@ -0,0 +1,540 @@
+/**************************************************************************/
+/*  slab_allocator.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "slab_allocator.h"
+
+#include "core/os/spin_lock.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+struct ThreadCache;
+
+struct Span {
+	std::atomic<ThreadCache *> owner;
+	std::atomic<void *> remote_free;
+	Span *prev;
+	Span *next;
+	void *local_free;
+	uint8_t *bump;
+	uint8_t *end;
+	uint32_t size_class;
+	uint32_t block_size;
+	uint32_t used;
+	bool full;
+};
+
+// Blocks start after the header, keeping them 16-byte aligned.
+constexpr size_t SPAN_HEADER_SIZE = 128;
+static_assert(sizeof(Span) <= SPAN_HEADER_SIZE, "Span header doesn't fit.");
+
+// Open-addressed set of span base addresses, used to tell whether a pointer
+// belongs to the allocator. Entries are never removed, so lookups can stop at
+// the first empty slot. Capped at 3/4 load, which allows 3 GiB of spans.
+constexpr uint32_t SPAN_REGISTRY_SIZE = 1 << 16;
+constexpr uint32_t MAX_SPANS = SPAN_REGISTRY_SIZE / 4 * 3;
+
+struct ThreadCache {
+	Span *current[SlabAllocator::SIZE_CLASS_COUNT];
+	Span *partial[SlabAllocator::SIZE_CLASS_COUNT];
+	Span *full[SlabAllocator::SIZE_CLASS_COUNT];
+
+	// Only written by the owner thread, read by get_stats().
+	std::atomic<uint64_t> cache_hits;
+	std::atomic<uint64_t> cache_misses;
+	std::atomic<uint64_t> fallbacks;
+	std::atomic<uint64_t> remote_frees;
+
+	ThreadCache *prev;
+	ThreadCache *next;
+};
+
+std::atomic<uintptr_t> span_registry[SPAN_REGISTRY_SIZE];
+std::atomic<uint32_t> span_count;
+
+// Guards everything below.
+SpinLock global_lock;
+Span *free_spans = nullptr;
+Span *abandoned_spans[SlabAllocator::SIZE_CLASS_COUNT] = {};
+ThreadCache *thread_caches = nullptr;
+SlabAllocator::Stats retired_stats;
+
+thread_local ThreadCache *tls_cache = nullptr;
+thread_local bool tls_cache_released = false;
+
+_FORCE_INLINE_ void _count(std::atomic<uint64_t> &p_counter) {
+	// Single writer, so no atomic read-modify-write is needed.
+	p_counter.store(p_counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+_FORCE_INLINE_ uint32_t _registry_slot(uintptr_t p_base) {
+	return (uint32_t)(((uint64_t)(p_base / SlabAllocator::SPAN_SIZE) * 0x9E3779B97F4A7C15ull) >> 48) & (SPAN_REGISTRY_SIZE - 1);
+}
+
+bool _register_span(uintptr_t p_base) {
+	uint32_t slot = _registry_slot(p_base);
+	for (uint32_t i = 0; i < SPAN_REGISTRY_SIZE; i++) {
+		uintptr_t expected = 0;
+		if (span_registry[slot].compare_exchange_strong(expected, p_base, std::memory_order_release, std::memory_order_relaxed)) {
+			return true;
+		}
+		slot = (slot + 1) & (SPAN_REGISTRY_SIZE - 1);
+	}
+	return false;
+}
+
+_FORCE_INLINE_ Span *_get_span(const void *p_memory) {
+	return (Span *)((uintptr_t)p_memory & ~(uintptr_t)(SlabAllocator::SPAN_SIZE - 1));
+}
+
+void _list_push(Span *&r_head, Span *p_span) {
+	p_span->prev = nullptr;
+	p_span->next = r_head;
+	if (r_head) {
+		r_head->prev = p_span;
+	}
+	r_head = p_span;
+}
+
+void _list_remove(Span *&r_head, Span *p_span) {
+	if (p_span->prev) {
+		p_span->prev->next = p_span->next;
+	} else {
+		r_head = p_span->next;
+	}
+	if (p_span->next) {
+		p_span->next->prev = p_span->prev;
+	}
+	p_span->prev = nullptr;
+	p_span->next = nullptr;
+}
+
+_FORCE_INLINE_ bool _has_free_blocks(const Span *p_span) {
+	return p_span->local_free || p_span->bump < p_span->end;
+}
+
+_FORCE_INLINE_ void *_alloc_from(Span *p_span) {
+	void *block = p_span->local_free;
+	if (block) {
+		p_span->local_free = *(void **)block;
+	} else {
+		block = p_span->bump;
+		p_span->bump += p_span->block_size;
+	}
+	p_span->used++;
+	return block;
+}
+
+// Moves the blocks freed by other threads to the local free list.
+bool _collect_remote_frees(Span *p_span) {
+	void *block = p_span->remote_free.exchange(nullptr, std::memory_order_acquire);
+	if (!block) {
+		return false;
+	}
+	while (block) {
+		void *next = *(void **)block;
+		*(void **)block = p_span->local_free;
+		p_span->local_free = block;
+		p_span->used--;
+		block = next;
+	}
+	return true;
+}
+
+void _init_span(Span *p_span, uint32_t p_size_class) {
+	uint32_t block_size = (uint32_t)SlabAllocator::get_size_class_block_size(p_size_class);
+	uint32_t capacity = (uint32_t)((SlabAllocator::SPAN_SIZE - SPAN_HEADER_SIZE) / block_size);
+	p_span->remote_free.store(nullptr, std::memory_order_relaxed);
+	p_span->prev = nullptr;
+	p_span->next = nullptr;
+	p_span->local_free = nullptr;
+	p_span->bump = (uint8_t *)p_span + SPAN_HEADER_SIZE;
+	p_span->end = p_span->bump + (size_t)capacity * block_size;
+	p_span->size_class = p_size_class;
+	p_span->block_size = block_size;
+	p_span->used = 0;
+	p_span->full = false;
+}
+
+Span *_allocate_span() {
+	if (span_count.fetch_add(1, std::memory_order_relaxed) >= MAX_SPANS) {
+		span_count.fetch_sub(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	void *mem = nullptr;
+#ifdef _WIN32
+	mem = _aligned_malloc(SlabAllocator::SPAN_SIZE, SlabAllocator::SPAN_SIZE);
+#else
+	if (posix_memalign(&mem, SlabAllocator::SPAN_SIZE, SlabAllocator::SPAN_SIZE) != 0) {
+		mem = nullptr;
+	}
+#endif
+	if (!mem) {
+		span_count.fetch_sub(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	// Can't fail while below MAX_SPANS.
+	_register_span((uintptr_t)mem);
+
+	Span *span = (Span *)mem;
+	new (&span->owner) std::atomic<ThreadCache *>(nullptr);
+	new (&span->remote_free) std::atomic<void *>(nullptr);
+	return span;
+}
+
+// Returns a span that has free blocks, owned by p_cache but not linked in any
+// of its lists, or nullptr if the span limit was reached.
+Span *_acquire_span(ThreadCache *p_cache, uint32_t p_size_class) {
+	while (true) {
+		bool fresh = false;
+
+		global_lock.lock();
+		Span *span = abandoned_spans[p_size_class];
+		if (span) {
+			_list_remove(abandoned_spans[p_size_class], span);
+		} else if (free_spans) {
+			span = free_spans;
+			_list_remove(free_spans, span);
+			fresh = true;
+		}
+		global_lock.unlock();
+
+		if (!span) {
+			span = _allocate_span();
+			if (!span) {
+				return nullptr;
+			}
+			fresh = true;
+		}
+
+		if (fresh) {
+			_init_span(span, p_size_class);
+		}
+		span->owner.store(p_cache, std::memory_order_relaxed);
+		if (fresh) {
+			return span;
+		}
+
+		_collect_remote_frees(span);
+		if (_has_free_blocks(span)) {
+			span->full = false;
+			return span;
+		}
+		span->full = true;
+		_list_push(p_cache->full[p_size_class], span);
+	}
+}
+
+void _release_span(Span *p_span) {
+	p_span->owner.store(nullptr, std::memory_order_relaxed);
+	global_lock.lock();
+	_list_push(free_spans, p_span);
+	global_lock.unlock();
+}
+
+void *_alloc_slow(ThreadCache *p_cache, uint32_t p_size_class) {
+	Span *current = p_cache->current[p_size_class];
+	if (current) {
+		if (_collect_remote_frees(current)) {
+			_count(p_cache->cache_misses);
+			return _alloc_from(current);
+		}
+		current->full = true;
+		_list_push(p_cache->full[p_size_class], current);
+		p_cache->current[p_size_class] = nullptr;
+	}
+
+	if (!p_cache->partial[p_size_class]) {
+		// Look for full spans that got blocks back from other threads.
+		Span *span = p_cache->full[p_size_class];
+		while (span) {
+			Span *next = span->next;
+			if (_collect_remote_frees(span)) {
+				_list_remove(p_cache->full[p_size_class], span);
+				span->full = false;
+				_list_push(p_cache->partial[p_size_class], span);
+			}
+			span = next;
+		}
+	}
+
+	Span *span = p_cache->partial[p_size_class];
+	if (span) {
+		_list_remove(p_cache->partial[p_size_class], span);
+		_collect_remote_frees(span);
+	} else {
+		span = _acquire_span(p_cache, p_size_class);
+		if (!span) {
+			_count(p_cache->fallbacks);
+			return nullptr;
+		}
+	}
+
+	_count(p_cache->cache_misses);
+	p_cache->current[p_size_class] = span;
+	return _alloc_from(span);
+}
+
+void _release_thread_cache() {
+	ThreadCache *cache = tls_cache;
+	tls_cache = nullptr;
+	tls_cache_released = true;
+	if (!cache) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < SlabAllocator::SIZE_CLASS_COUNT; i++) {
+		if (cache->current[i]) {
+			_list_push(cache->partial[i], cache->current[i]);
+			cache->current[i] = nullptr;
+		}
+		Span **lists[2] = { &cache->partial[i], &cache->full[i] };
+		for (Span **list : lists) {
+			while (*list) {
+				Span *span = *list;
+				_list_remove(*list, span);
+				_collect_remote_frees(span);
+				span->owner.store(nullptr, std::memory_order_relaxed);
+
+				global_lock.lock();
+				// Blocks freed from now on go to the remote-free list, until
+				// another thread adopts the span.
+				_list_push(span->used == 0 ? free_spans : abandoned_spans[i], span);
+				global_lock.unlock();
+			}
+		}
+	}
+
+	global_lock.lock();
+	retired_stats.cache_hits += cache->cache_hits.load(std::memory_order_relaxed);
+	retired_stats.cache_misses += cache->cache_misses.load(std::memory_order_relaxed);
+	retired_stats.fallbacks += cache->fallbacks.load(std::memory_order_relaxed);
+	retired_stats.remote_frees += cache->remote_frees.load(std::memory_order_relaxed);
+	if (cache->prev) {
+		cache->prev->next = cache->next;
+	} else {
+		thread_caches = cache->next;
+	}
+	if (cache->next) {
+		cache->next->prev = cache->prev;
+	}
+	global_lock.unlock();
+
+	::free(cache);
+}
+
+struct ThreadCacheReleaser {
+	~ThreadCacheReleaser() {
+		_release_thread_cache();
+	}
+};
+
+thread_local ThreadCacheReleaser tls_cache_releaser;
+
+ThreadCache *_create_thread_cache() {
+	if (tls_cache_released) {
+		// Allocating from thread-local destructors after ours has run.
+		return nullptr;
+	}
+
+	ThreadCache *cache = (ThreadCache *)::calloc(1, sizeof(ThreadCache));
+	if (!cache) {
+		return nullptr;
+	}
+	new (&cache->cache_hits) std::atomic<uint64_t>(0);
+	new (&cache->cache_misses) std::atomic<uint64_t>(0);
+	new (&cache->fallbacks) std::atomic<uint64_t>(0);
+	new (&cache->remote_frees) std::atomic<uint64_t>(0);
+
+	global_lock.lock();
+	cache->next = thread_caches;
+	if (thread_caches) {
+		thread_caches->prev = cache;
+	}
+	thread_caches = cache;
+	global_lock.unlock();
+
+	// Makes sure the cache is released when the thread exits.
+	(void)&tls_cache_releaser;
+
+	tls_cache = cache;
+	return cache;
+}
+
+} // namespace
+
+uint32_t SlabAllocator::get_size_class(size_t p_bytes) {
+	// 16-byte steps up to 128, then four classes per power of two.
+	if (p_bytes <= 128) {
+		return p_bytes == 0 ? 0 : (uint32_t)((p_bytes - 1) >> 4);
+	}
+	uint32_t group = 0;
+	while (((p_bytes - 1) >> (8 + group)) != 0) {
+		group++;
+	}
+	return 8 + group * 4 + (uint32_t)((p_bytes - 1) >> (5 + group)) - 4;
+}
+
+size_t SlabAllocator::get_size_class_block_size(uint32_t p_size_class) {
+	if (p_size_class < 8) {
+		return (p_size_class + 1) * 16;
+	}
+	uint32_t group = (p_size_class - 8) / 4;
+	uint32_t step = (p_size_class - 8) % 4;
+	return ((size_t)128 << group) + (step + 1) * ((size_t)32 << group);
+}
+
+void *SlabAllocator::alloc(size_t p_bytes) {
+	if (p_bytes > MAX_BLOCK_SIZE) {
+		return nullptr;
+	}
+
+	ThreadCache *cache = tls_cache;
+	if (unlikely(!cache)) {
+		cache = _create_thread_cache();
+		if (!cache) {
+			return nullptr;
+		}
+	}
+
+	uint32_t size_class = get_size_class(p_bytes);
+	Span *span = cache->current[size_class];
+	if (likely(span && _has_free_blocks(span))) {
+		_count(cache->cache_hits);
+		return _alloc_from(span);
+	}
+	return _alloc_slow(cache, size_class);
+}
+
+void *SlabAllocator::realloc(void *p_memory, size_t p_bytes) {
+	if (p_bytes == 0) {
+		free(p_memory);
+		return nullptr;
+	}
+
+	size_t block_size = _get_span(p_memory)->block_size;
+	if (p_bytes <= block_size) {
+		return p_memory;
+	}
+
+	void *mem = alloc(p_bytes);
+	if (!mem) {
+		mem = ::malloc(p_bytes);
+		if (!mem) {
+			return nullptr;
+		}
+	}
+	memcpy(mem, p_memory, block_size);
+	free(p_memory);
+	return mem;
+}
+
+void SlabAllocator::free(void *p_memory) {
+	Span *span = _get_span(p_memory);
+	ThreadCache *cache = tls_cache;
+
+	if (likely(cache && span->owner.load(std::memory_order_relaxed) == cache)) {
+		*(void **)p_memory = span->local_free;
+		span->local_free = p_memory;
+		span->used--;
+
+		uint32_t size_class = span->size_class;
+		if (span == cache->current[size_class]) {
+			return;
+		}
+		if (span->used == 0) {
+			_list_remove(span->full ? cache->full[size_class] : cache->partial[size_class], span);
+			_release_span(span);
+		} else if (span->full) {
+			span->full = false;
+			_list_remove(cache->full[size_class], span);
+			_list_push(cache->partial[size_class], span);
+		}
+		return;
+	}
+
+	void *head = span->remote_free.load(std::memory_order_relaxed);
+	do {
+		*(void **)p_memory = head;
+	} while (!span->remote_free.compare_exchange_weak(head, p_memory, std::memory_order_release, std::memory_order_relaxed));
+
+	if (!cache) {
+		cache = _create_thread_cache();
+	}
+	if (cache) {
+		_count(cache->remote_frees);
+	}
+}
+
+bool SlabAllocator::owns(const void *p_memory) {
+	if (!p_memory) {
+		return false;
+	}
+	uintptr_t base = (uintptr_t)_get_span(p_memory);
+	uint32_t slot = _registry_slot(base);
+	while (true) {
+		uintptr_t entry = span_registry[slot].load(std::memory_order_acquire);
+		if (entry == base) {
+			return true;
+		}
+		if (entry == 0) {
+			return false;
+		}
+		slot = (slot + 1) & (SPAN_REGISTRY_SIZE - 1);
+	}
+}
+
+size_t SlabAllocator::get_block_size(const void *p_memory) {
+	return _get_span(p_memory)->block_size;
+}
+
+SlabAllocator::Stats SlabAllocator::get_stats() {
+	global_lock.lock();
+	Stats stats = retired_stats;
+	for (ThreadCache *cache = thread_caches; cache; cache = cache->next) {
+		stats.cache_hits += cache->cache_hits.load(std::memory_order_relaxed);
+		stats.cache_misses += cache->cache_misses.load(std::memory_order_relaxed);
+		stats.fallbacks += cache->fallbacks.load(std::memory_order_relaxed);
+		stats.remote_frees += cache->remote_frees.load(std::memory_order_relaxed);
+	}
+	global_lock.unlock();
+	stats.reserved_bytes = (uint64_t)span_count.load(std::memory_order_relaxed) * SPAN_SIZE;
+	return stats;
+}
@@ -0,0 +1,83 @@
+/**************************************************************************/
+/*  slab_allocator.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Thread-caching allocator for small blocks, used by Memory::alloc_static when
+// the engine is built with `slab_allocator=yes`.
+//
+// Memory is carved out of 64 KiB spans, each dedicated to one size class and
+// owned by one thread. The owning thread allocates and frees without any
+// synchronization. Blocks freed from other threads are pushed onto the span's
+// lock-free remote-free list and reclaimed by the owner when it runs out of
+// local blocks. Spans of exiting threads are abandoned and adopted by the next
+// thread that needs a span of the same class.
+//
+// Spans are never returned to the system; empty spans are kept in a global
+// pool and reused for any size class.
+
+class SlabAllocator {
+public:
+	static constexpr size_t SPAN_SIZE = 64 * 1024;
+	static constexpr size_t MAX_BLOCK_SIZE = 1024;
+	static constexpr uint32_t SIZE_CLASS_COUNT = 20;
+
+	struct Stats {
+		uint64_t cache_hits = 0; // Served from the thread's current span.
+		uint64_t cache_misses = 0; // Needed a refill (remote frees, another span, or a new span).
+		uint64_t fallbacks = 0; // Could not be served by a span and went to the system allocator.
+		uint64_t remote_frees = 0; // Freed from a thread that doesn't own the block's span.
+		uint64_t reserved_bytes = 0; // Memory held in spans, used or not.
+	};
+
+	// Returns nullptr if the request can't be served from a span, in which
+	// case the caller is expected to use the system allocator.
+	static void *alloc(size_t p_bytes);
+	// Like realloc(), but p_memory must be owned by the allocator. The new
+	// block may come from the system allocator if it doesn't fit in a span.
+	static void *realloc(void *p_memory, size_t p_bytes);
+	// p_memory must be owned by the allocator.
+	static void free(void *p_memory);
+
+	static bool owns(const void *p_memory);
+	static size_t get_block_size(const void *p_memory);
+
+	static uint32_t get_size_class(size_t p_bytes);
+	static size_t get_size_class_block_size(uint32_t p_size_class);
+
+	static Stats get_stats();
+};
+
+#endif // SLAB_ALLOCATOR_H
@@ -40,6 +40,7 @@ StaticCString StaticCString::create(const char *p_ptr) {
 }
 
 StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+StringName::Shard StringName::shards[STRING_TABLE_SHARD_COUNT];
 
 StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
@@ -80,10 +81,10 @@ void StringName::cleanup() {
 		int unreferenced_stringnames = 0;
 		int rarely_referenced_stringnames = 0;
 		for (int i = 0; i < data.size(); i++) {
-			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references));
-			if (data[i]->debug_references == 0) {
+			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references.get()));
+			if (data[i]->debug_references.get() == 0) {
 				unreferenced_stringnames += 1;
-			} else if (data[i]->debug_references < 5) {
+			} else if (data[i]->debug_references.get() < 5) {
 				rarely_referenced_stringnames += 1;
 			}
 		}
@@ -116,11 +117,56 @@ void StringName::cleanup() {
 	configured = false;
 }
 
+// Must be called with the bucket lock held, either for reading or writing.
+// Entries whose refcount already dropped to zero are about to be removed by
+// unref() and are skipped, a fresh entry is created for them instead.
+template <typename T>
+StringName::_Data *StringName::_find_and_ref(uint32_t p_idx, uint32_t p_hash, const T &p_name, bool p_static) {
+	for (_Data *d = _table[p_idx]; d; d = d->next) {
+		// compare hash first
+		if (d->hash != p_hash || d->get_name() != p_name) {
+			continue;
+		}
+		if (!d->refcount.ref()) {
+			continue;
+		}
+		if (p_static) {
+			d->static_count.increment();
+		}
+#ifdef DEBUG_ENABLED
+		if (unlikely(debug_stringname)) {
+			d->debug_references.increment();
+		}
+#endif
+		return d;
+	}
+	return nullptr;
+}
+
+// Must be called with the bucket lock held for writing.
+void StringName::_insert(_Data *p_data) {
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		// Keep in memory, force static.
+		p_data->refcount.ref();
+		p_data->static_count.increment();
+	}
+#endif
+	p_data->next = _table[p_data->idx];
+	p_data->prev = nullptr;
+	if (_table[p_data->idx]) {
+		_table[p_data->idx]->prev = p_data;
+	}
+	_table[p_data->idx] = p_data;
+}
+
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		// Lookups can't revive an entry once its refcount reached zero, so only
+		// its own bucket needs to be locked to unlink it.
+		RWLockWrite lock(_get_bucket_lock(_data->idx));
 
 		if (CoreGlobals::leak_reporting_enabled && _data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -216,32 +262,24 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
+	RWLock &lock = _get_bucket_lock(idx);
+
+	{
+		// Most names already exist, so look them up under a shared lock first.
+		RWLockRead read_lock(lock);
+		_data = _find_and_ref(idx, hash, p_name, p_static);
+		if (_data) {
+			return;
 		}
-		_data = _data->next;
 	}
 
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
+	RWLockWrite write_lock(lock);
+
+	// Another thread may have added it while the lock was released.
+	_data = _find_and_ref(idx, hash, p_name, p_static);
+	if (_data) {
 		return;
 	}
 
@@ -252,20 +290,7 @@ StringName::StringName(const char *p_name, bool p_static) {
 	_data->hash = hash;
 	_data->idx = idx;
 	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_insert(_data);
 }
 
 StringName::StringName(const StaticCString &p_static_string, bool p_static) {
@@ -275,55 +300,32 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_static_string.ptr);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
+	RWLock &lock = _get_bucket_lock(idx);
 
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
+	{
+		RWLockRead read_lock(lock);
+		_data = _find_and_ref(idx, hash, p_static_string.ptr, p_static);
+		if (_data) {
+			return;
 		}
-		_data = _data->next;
 	}
 
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
+	RWLockWrite write_lock(lock);
+
+	_data = _find_and_ref(idx, hash, p_static_string.ptr, p_static);
+	if (_data) {
 		return;
 	}
 
 	_data = memnew(_Data);
-
 	_data->refcount.init();
 	_data->static_count.set(p_static ? 1 : 0);
 	_data->hash = hash;
 	_data->idx = idx;
 	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_insert(_data);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -335,30 +337,22 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
 	uint32_t idx = hash & STRING_TABLE_MASK;
+	RWLock &lock = _get_bucket_lock(idx);
 
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
+	{
+		RWLockRead read_lock(lock);
+		_data = _find_and_ref(idx, hash, p_name, p_static);
+		if (_data) {
+			return;
 		}
-		_data = _data->next;
 	}
 
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
+	RWLockWrite write_lock(lock);
+
+	_data = _find_and_ref(idx, hash, p_name, p_static);
+	if (_data) {
 		return;
 	}
 
@@ -369,20 +363,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 	_data->hash = hash;
 	_data->idx = idx;
 	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_insert(_data);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -393,32 +374,13 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
+	RWLockRead lock(_get_bucket_lock(idx));
+	_Data *_data = _find_and_ref(idx, hash, p_name, false);
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-
-		return StringName(_data);
-	}
-
-	return StringName(); //does not exist
+	return _data ? StringName(_data) : StringName();
 }
 
 StringName StringName::search(const char32_t *p_name) {
@@ -429,58 +391,25 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
-	}
+	RWLockRead lock(_get_bucket_lock(idx));
+	_Data *_data = _find_and_ref(idx, hash, p_name, false);
 
-	return StringName(); //does not exist
+	return _data ? StringName(_data) : StringName();
 }
 
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return StringName(_data);
-	}
+	RWLockRead lock(_get_bucket_lock(idx));
+	_Data *_data = _find_and_ref(idx, hash, p_name, false);
 
-	return StringName(); //does not exist
+	return _data ? StringName(_data) : StringName();
 }
 
 bool operator==(const String &p_name, const StringName &p_string_name) {
@@ -32,6 +32,7 @@
 #define STRING_NAME_H
 
 #include "core/os/mutex.h"
+#include "core/os/rw_lock.h"
 #include "core/string/ustring.h"
 #include "core/templates/safe_refcount.h"
 
@@ -48,7 +49,11 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		// Buckets are split into shards, each guarded by its own lock.
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARD_COUNT = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_SHARD_MASK = STRING_TABLE_SHARD_COUNT - 1,
 	};
 
 	struct _Data {
@@ -57,7 +62,7 @@ class StringName {
 		const char *cname = nullptr;
 		String name;
 #ifdef DEBUG_ENABLED
-		uint32_t debug_references = 0;
+		SafeNumeric<uint32_t> debug_references;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
 		int idx = 0;
@@ -67,10 +72,23 @@ class StringName {
 		_Data() {}
 	};
 
+	// Padded to a cache line so threads hitting neighboring shards don't contend.
+	struct alignas(64) Shard {
+		RWLock lock;
+	};
+
 	static _Data *_table[STRING_TABLE_LEN];
+	static Shard shards[STRING_TABLE_SHARD_COUNT];
 
 	_Data *_data = nullptr;
 
+	_FORCE_INLINE_ static RWLock &_get_bucket_lock(uint32_t p_idx) {
+		return shards[p_idx & STRING_TABLE_SHARD_MASK].lock;
+	}
+	template <typename T>
+	static _Data *_find_and_ref(uint32_t p_idx, uint32_t p_hash, const T &p_name, bool p_static);
+	static void _insert(_Data *p_data);
+
 	void unref();
 	friend void register_core_types();
 	friend void unregister_core_types();
@@ -82,7 +100,7 @@ class StringName {
 #ifdef DEBUG_ENABLED
 	struct DebugSortReferences {
 		bool operator()(const _Data *p_left, const _Data *p_right) const {
-			return p_left->debug_references > p_right->debug_references;
+			return p_left->debug_references.get() > p_right->debug_references.get();
 		}
 	};
 
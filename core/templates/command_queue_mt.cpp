@@ -33,6 +33,21 @@
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 
+thread_local CommandQueueMT::ProducerCache CommandQueueMT::thread_producers;
+thread_local CommandQueueMT::Producer *CommandQueueMT::thread_last_producer = nullptr;
+
+static std::atomic<uint64_t> last_queue_id = 0;
+
+CommandQueueMT::ProducerCache::~ProducerCache() {
+	for (Producer *producer : producers) {
+		producer->abandoned.store(true, std::memory_order_release);
+		if (producer->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			memdelete(producer);
+		}
+	}
+	thread_last_producer = nullptr;
+}
+
 void CommandQueueMT::lock() {
 	mutex.lock();
 }
@@ -41,9 +56,250 @@ void CommandQueueMT::unlock() {
 	mutex.unlock();
 }
 
-CommandQueueMT::CommandQueueMT() {
-	command_mem.reserve(DEFAULT_COMMAND_MEM_SIZE_KB * 1024);
+CommandQueueMT::Producer *CommandQueueMT::_find_producer() {
+	LocalVector<Producer *> &cached = thread_producers.producers;
+	for (Producer *producer : cached) {
+		if (producer->queue_id == queue_id) {
+			thread_last_producer = producer;
+			return producer;
+		}
+	}
+
+	// Drop records of destroyed queues, which only hold our reference now.
+	thread_last_producer = nullptr;
+	for (uint32_t i = 0; i < cached.size();) {
+		if (cached[i]->refcount.load(std::memory_order_acquire) == 1) {
+			memdelete(cached[i]);
+			cached.remove_at_unordered(i);
+		} else {
+			i++;
+		}
+	}
+
+	Producer *producer = memnew(Producer);
+	producer->queue_id = queue_id;
+	_grow_producer(producer, 0);
+	producer->read_block = producer->write_block;
+
+	Producer *head = producers.load(std::memory_order_relaxed);
+	do {
+		producer->next = head;
+	} while (!producers.compare_exchange_weak(head, producer, std::memory_order_release, std::memory_order_relaxed));
+
+	cached.push_back(producer);
+	thread_last_producer = producer;
+	return producer;
+}
+
+void CommandQueueMT::_grow_producer(Producer *p_producer, uint32_t p_size) {
+	Block *block = nullptr;
+	if (p_size <= LOCK_FREE_BLOCK_SIZE) {
+		block = p_producer->spare.exchange(nullptr, std::memory_order_acquire);
+	}
+	if (!block) {
+		// Oversized commands get a block of their own.
+		uint32_t capacity = MAX(p_size, LOCK_FREE_BLOCK_SIZE);
+		block = memnew_placement(memalloc(sizeof(Block) + capacity), Block);
+		block->capacity = capacity;
+	} else {
+		block->next.store(nullptr, std::memory_order_relaxed);
+		block->committed.store(0, std::memory_order_relaxed);
+	}
+
+	if (p_producer->write_block) {
+		if (p_producer->batch_depth) {
+			_publish_batch(p_producer);
+		}
+		// Everything in the previous block is committed, so the consumer can move on.
+		p_producer->write_block->next.store(block, std::memory_order_release);
+	}
+	p_producer->write_block = block;
+	p_producer->write_pos = 0;
+	p_producer->batch_pos = 0;
+}
+
+CommandQueueMT::CommandHeader *CommandQueueMT::_peek_producer(Producer *p_producer) {
+	while (true) {
+		Block *block = p_producer->read_block;
+		if (p_producer->read_pos < block->committed.load(std::memory_order_acquire)) {
+			return reinterpret_cast<CommandHeader *>(block->get_data() + p_producer->read_pos);
+		}
+
+		Block *next = block->next.load(std::memory_order_acquire);
+		if (!next) {
+			return nullptr;
+		}
+		if (p_producer->read_pos < block->committed.load(std::memory_order_acquire)) {
+			continue; // Committed right before the producer moved on.
+		}
+
+		p_producer->read_block = next;
+		p_producer->read_pos = 0;
+
+		Block *expected = nullptr;
+		if (block->capacity != LOCK_FREE_BLOCK_SIZE || !p_producer->spare.compare_exchange_strong(expected, block, std::memory_order_release, std::memory_order_relaxed)) {
+			memfree(block);
+		}
+	}
+}
+
+void CommandQueueMT::_release_abandoned_producers() {
+	Producer *prev = nullptr;
+	Producer *producer = producers.load(std::memory_order_acquire);
+	while (producer) {
+		Producer *next = producer->next;
+		if (!producer->abandoned.load(std::memory_order_acquire) || _peek_producer(producer)) {
+			prev = producer;
+			producer = next;
+			continue;
+		}
+
+		// Only the consumer unlinks, so the list can only grow at the head meanwhile.
+		if (prev) {
+			prev->next = next;
+		} else {
+			Producer *expected = producer;
+			if (!producers.compare_exchange_strong(expected, next, std::memory_order_acq_rel)) {
+				prev = expected;
+				while (prev->next != producer) {
+					prev = prev->next;
+				}
+				prev->next = next;
+			}
+		}
+
+		if (flush_producer == producer) {
+			flush_producer = nullptr;
+		}
+		memfree(producer->read_block);
+		Block *spare = producer->spare.load(std::memory_order_relaxed);
+		if (spare) {
+			memfree(spare);
+		}
+		if (producer->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			memdelete(producer);
+		}
+		producer = next;
+	}
+}
+
+void CommandQueueMT::_publish_batch(Producer *p_producer) {
+	uint8_t *data = p_producer->write_block->get_data();
+	uint32_t count = 0;
+	for (uint32_t pos = p_producer->batch_pos; pos < p_producer->write_pos; pos += reinterpret_cast<CommandHeader *>(data + pos)->size) {
+		count++;
+	}
+	if (count == 0) {
+		return;
+	}
+
+	// One ticket range for the whole batch.
+	uint32_t seq = push_seq.fetch_add(count);
+	for (uint32_t pos = p_producer->batch_pos; pos < p_producer->write_pos; pos += reinterpret_cast<CommandHeader *>(data + pos)->size) {
+		reinterpret_cast<CommandHeader *>(data + pos)->seq = seq++;
+	}
+	p_producer->batch_pos = p_producer->write_pos;
+	p_producer->write_block->committed.store(p_producer->write_pos, std::memory_order_release);
+	_notify_pump_lock_free();
+}
+
+CommandQueueMT::CommandHeader *CommandQueueMT::_find_command(uint32_t p_seq, Producer *&r_producer) {
+	// Commands of the same producer tend to come in runs, so try it first.
+	CommandHeader *header = r_producer ? _peek_producer(r_producer) : nullptr;
+	if (header && header->seq == p_seq) {
+		return header;
+	}
+	for (Producer *p = producers.load(std::memory_order_acquire); p; p = p->next) {
+		header = _peek_producer(p);
+		if (header && header->seq == p_seq) {
+			r_producer = p;
+			return header;
+		}
+	}
+	return nullptr;
+}
+
+void CommandQueueMT::_flush_lock_free() {
+	// Concurrent calls wait for the flush in progress, so that everything
+	// pushed before they started has run when they return.
+	MutexLock flush_lock(flush_mutex);
+	if (flushing) {
+		// Re-entrant call.
+		return;
+	}
+	flushing = true;
+
+	// Pushes from now on have to notify the pump again. Sequentially consistent,
+	// so those that saw the flag still set are seen by the load below.
+	pump_notified.store(false);
+
+	// Every ticket taken before now must run in this flush, like in the locking mode.
+	const uint32_t end_seq = push_seq.load();
+	uint32_t seq = flush_seq.load(std::memory_order_relaxed);
+	uint32_t start_seq = seq;
+	Producer *producer = flush_producer;
+	while (true) {
+		CommandHeader *header = _find_command(seq, producer);
+		if (!header) {
+			if (int32_t(end_seq - seq) <= 0) {
+				// Done, or the next command is still being written and came after this flush.
+				break;
+			}
+			// Reserved, but not committed yet. Producers commit right after reserving.
+			OS::get_singleton()->yield();
+			continue;
+		}
+
+		CommandBase *cmd = reinterpret_cast<CommandBase *>(reinterpret_cast<uint8_t *>(header) + sizeof(CommandHeader));
+		cmd->call();
+		if (unlikely(cmd->sync)) {
+			mutex.lock();
+			producer->syncs_done.fetch_add(1, std::memory_order_release);
+			mutex.unlock();
+			sync_cond_var.notify_all();
+		}
+		cmd->~CommandBase();
+
+		producer->read_pos += header->size;
+		seq++;
+		flush_seq.store(seq, std::memory_order_relaxed);
+	}
+	flush_producer = producer;
+
+	if (seq != start_seq) {
+		_release_abandoned_producers();
+	}
+
+	flushing = false;
+}
+
+CommandQueueMT::CommandQueueMT(bool p_lock_free) :
+		lock_free(p_lock_free) {
+	if (lock_free) {
+		queue_id = last_queue_id.fetch_add(1, std::memory_order_relaxed) + 1;
+	} else {
+		command_mem.reserve(DEFAULT_COMMAND_MEM_SIZE_KB * 1024);
+	}
 }
 
 CommandQueueMT::~CommandQueueMT() {
+	// Like in the locking mode, commands never flushed are just dropped.
+	Producer *producer = producers.load(std::memory_order_acquire);
+	while (producer) {
+		Producer *next = producer->next;
+		Block *block = producer->read_block;
+		while (block) {
+			Block *next_block = block->next.load(std::memory_order_acquire);
+			memfree(block);
+			block = next_block;
+		}
+		Block *spare = producer->spare.load(std::memory_order_relaxed);
+		if (spare) {
+			memfree(spare);
+		}
+		if (producer->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			memdelete(producer);
+		}
+		producer = next;
+	}
 }
@@ -40,6 +40,8 @@
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -251,6 +253,15 @@
 #define DECL_PUSH(N)                                                            \
 	template <typename T, typename M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>    \
 	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) {    \
+		if (lock_free) {                                                        \
+			Producer *producer = _get_producer();                               \
+			CMD_TYPE(N) *cmd = _allocate_lock_free<CMD_TYPE(N)>(producer);      \
+			cmd->instance = p_instance;                                         \
+			cmd->method = p_method;                                             \
+			SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                \
+			_commit_lock_free(producer);                                        \
+			return;                                                             \
+		}                                                                       \
 		MutexLock mlock(mutex);                                                 \
 		CMD_TYPE(N) *cmd = allocate<CMD_TYPE(N)>();                             \
 		cmd->instance = p_instance;                                             \
@@ -266,6 +277,17 @@
 #define DECL_PUSH_AND_RET(N)                                                                   \
 	template <typename T, typename M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) typename R>       \
 	void push_and_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
+		if (lock_free) {                                                                       \
+			Producer *producer = _get_producer();                                              \
+			CMD_RET_TYPE(N) *cmd = _allocate_lock_free<CMD_RET_TYPE(N)>(producer);             \
+			cmd->instance = p_instance;                                                        \
+			cmd->method = p_method;                                                            \
+			SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                               \
+			cmd->ret = r_ret;                                                                  \
+			_commit_lock_free(producer);                                                       \
+			_wait_for_sync_lock_free(producer);                                                \
+			return;                                                                            \
+		}                                                                                      \
 		MutexLock mlock(mutex);                                                                \
 		CMD_RET_TYPE(N) *cmd = allocate<CMD_RET_TYPE(N)>();                                    \
 		cmd->instance = p_instance;                                                            \
@@ -284,6 +306,16 @@
 #define DECL_PUSH_AND_SYNC(N)                                                         \
 	template <typename T, typename M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>          \
 	void push_and_sync(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
+		if (lock_free) {                                                              \
+			Producer *producer = _get_producer();                                     \
+			CMD_SYNC_TYPE(N) *cmd = _allocate_lock_free<CMD_SYNC_TYPE(N)>(producer);  \
+			cmd->instance = p_instance;                                               \
+			cmd->method = p_method;                                                   \
+			SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                      \
+			_commit_lock_free(producer);                                              \
+			_wait_for_sync_lock_free(producer);                                       \
+			return;                                                                   \
+		}                                                                             \
 		MutexLock mlock(mutex);                                                       \
 		CMD_SYNC_TYPE(N) *cmd = allocate<CMD_SYNC_TYPE(N)>();                         \
 		cmd->instance = p_instance;                                                   \
@@ -333,9 +365,135 @@ class CommandQueueMT {
 	uint32_t sync_head = 0;
 	uint32_t sync_tail = 0;
 	uint32_t sync_awaiters = 0;
-	WorkerThreadPool::TaskID pump_task_id = WorkerThreadPool::INVALID_TASK_ID;
+	std::atomic<WorkerThreadPool::TaskID> pump_task_id = WorkerThreadPool::INVALID_TASK_ID;
 	uint64_t flush_read_ptr = 0;
 
+	/***** LOCK-FREE MODE *******/
+
+	// Each producing thread writes into its own chain of blocks and publishes
+	// every command with a single release store. Commands carry a global
+	// sequence number, so the consumer still runs them in push order. Inside
+	// a batch, commands are only published when it ends, all at once.
+
+	static const uint32_t LOCK_FREE_BLOCK_SIZE = 16 * 1024;
+
+	struct CommandHeader {
+		uint32_t size = 0;
+		uint32_t seq = 0;
+	};
+
+	struct Block {
+		std::atomic<Block *> next = nullptr;
+		std::atomic<uint32_t> committed = 0;
+		uint32_t capacity = 0;
+
+		_FORCE_INLINE_ uint8_t *get_data() { return reinterpret_cast<uint8_t *>(this) + sizeof(Block); }
+	};
+
+	static_assert(sizeof(Block) % 8 == 0);
+
+	struct Producer {
+		// Producer thread side.
+		Block *write_block = nullptr;
+		uint32_t write_pos = 0;
+		uint32_t syncs_requested = 0;
+		uint32_t batch_depth = 0;
+		uint32_t batch_pos = 0; // Start of the commands not published yet.
+		uint64_t queue_id = 0;
+		uint8_t _pad_producer[64];
+		// Consumer side.
+		Block *read_block = nullptr;
+		uint32_t read_pos = 0;
+		std::atomic<uint32_t> syncs_done = 0;
+		std::atomic<Block *> spare = nullptr; // A drained block, handed back for reuse.
+		Producer *next = nullptr;
+		// The queue and the producer thread hold one reference each.
+		std::atomic<uint32_t> refcount = 2;
+		std::atomic<bool> abandoned = false;
+	};
+
+	// Producers created by the current thread, given up when it exits.
+	struct ProducerCache {
+		LocalVector<Producer *> producers;
+		~ProducerCache();
+	};
+
+	static thread_local ProducerCache thread_producers;
+	static thread_local Producer *thread_last_producer;
+
+	const bool lock_free = false;
+	uint64_t queue_id = 0;
+	std::atomic<Producer *> producers = nullptr;
+	std::atomic<uint32_t> push_seq = 0;
+	// Set once the pump task has been notified, until it starts flushing.
+	std::atomic<bool> pump_notified = false;
+	uint8_t _pad_push_seq[64];
+	std::atomic<uint32_t> flush_seq = 0;
+	Mutex flush_mutex;
+	bool flushing = false;
+	Producer *flush_producer = nullptr;
+
+	Producer *_find_producer();
+	void _grow_producer(Producer *p_producer, uint32_t p_size);
+	CommandHeader *_peek_producer(Producer *p_producer);
+	CommandHeader *_find_command(uint32_t p_seq, Producer *&r_producer);
+	void _release_abandoned_producers();
+	void _publish_batch(Producer *p_producer);
+	void _flush_lock_free();
+
+	_FORCE_INLINE_ Producer *_get_producer() {
+		Producer *producer = thread_last_producer;
+		if (likely(producer && producer->queue_id == queue_id)) {
+			return producer;
+		}
+		return _find_producer();
+	}
+
+	template <typename T>
+	T *_allocate_lock_free(Producer *p_producer) {
+		uint32_t alloc_size = sizeof(CommandHeader) + ((sizeof(T) + 8 - 1) & ~(8 - 1));
+		if (unlikely(p_producer->write_pos + alloc_size > p_producer->write_block->capacity)) {
+			_grow_producer(p_producer, alloc_size);
+		}
+		CommandHeader *header = reinterpret_cast<CommandHeader *>(p_producer->write_block->get_data() + p_producer->write_pos);
+		header->size = alloc_size;
+		T *cmd = memnew_placement(reinterpret_cast<uint8_t *>(header) + sizeof(CommandHeader), T);
+		return cmd;
+	}
+
+	_FORCE_INLINE_ void _notify_pump_lock_free() {
+		// Only the first push since the pump started flushing has to wake it up.
+		// Sequentially consistent, so either the flush sees the commands pushed
+		// before this, or this sees the flag cleared and notifies again.
+		WorkerThreadPool::TaskID pump_task = pump_task_id.load(std::memory_order_relaxed);
+		if (pump_task != WorkerThreadPool::INVALID_TASK_ID && !pump_notified.load() && !pump_notified.exchange(true)) {
+			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task);
+		}
+	}
+
+	_FORCE_INLINE_ void _commit_lock_free(Producer *p_producer) {
+		CommandHeader *header = reinterpret_cast<CommandHeader *>(p_producer->write_block->get_data() + p_producer->write_pos);
+		p_producer->write_pos += header->size;
+		if (p_producer->batch_depth) {
+			return;
+		}
+		header->seq = push_seq.fetch_add(1);
+		p_producer->write_block->committed.store(p_producer->write_pos, std::memory_order_release);
+		_notify_pump_lock_free();
+	}
+
+	_FORCE_INLINE_ void _wait_for_sync_lock_free(Producer *p_producer) {
+		if (p_producer->batch_depth) {
+			_publish_batch(p_producer);
+		}
+		// A producer can't have more than one sync pending, since it blocks here.
+		uint32_t goal = ++p_producer->syncs_requested;
+		MutexLock mlock(mutex);
+		while (p_producer->syncs_done.load(std::memory_order_acquire) != goal) {
+			sync_cond_var.wait(mlock);
+		}
+	}
+
 	template <typename T>
 	T *allocate() {
 		// alloc size is size+T+safeguard
@@ -357,6 +515,11 @@ class CommandQueueMT {
 	}
 
 	void _flush() {
+		if (lock_free) {
+			_flush_lock_free();
+			return;
+		}
+
 		if (unlikely(flush_read_ptr)) {
 			// Re-entrant call.
 			return;
@@ -422,6 +585,12 @@ public:
 	SPACE_SEP_LIST(DECL_PUSH_AND_SYNC, 15)
 
 	_FORCE_INLINE_ void flush_if_pending() {
+		if (lock_free) {
+			if (push_seq.load(std::memory_order_acquire) != flush_seq.load(std::memory_order_relaxed)) {
+				_flush_lock_free();
+			}
+			return;
+		}
 		if (unlikely(command_mem.size() > 0)) {
 			_flush();
 		}
@@ -447,7 +616,35 @@ public:
 		unlock();
 	}
 
-	CommandQueueMT();
+	// In lock-free mode, the commands pushed by this thread until the matching
+	// end_batch() are published together, which is cheaper than one at a time.
+	// They still run in push order, but the consumer only sees them once the
+	// batch ends or fills up a block. Batches can be nested, and do nothing in
+	// the locking mode.
+	void begin_batch() {
+		if (lock_free) {
+			Producer *producer = _get_producer();
+			if (producer->batch_depth++ == 0) {
+				producer->batch_pos = producer->write_pos;
+			}
+		}
+	}
+
+	void end_batch() {
+		if (lock_free) {
+			Producer *producer = _get_producer();
+			ERR_FAIL_COND(producer->batch_depth == 0);
+			if (--producer->batch_depth == 0) {
+				_publish_batch(producer);
+			}
+		}
+	}
+
+	_FORCE_INLINE_ bool is_lock_free() const { return lock_free; }
+
+	// In lock-free mode, producers never block each other or the consumer,
+	// except to wait for push_and_ret() and push_and_sync() results.
+	CommandQueueMT(bool p_lock_free = false);
 	~CommandQueueMT();
 };
 
@@ -0,0 +1,584 @@
+/**************************************************************************/
+/*  flat_hash_map.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_MAP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define FLAT_HASH_MAP_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * An unordered HashMap variant using open addressing in the style of Swiss
+ * tables. Next to the key-value slots it keeps one control byte per slot,
+ * which holds the lowest 7 bits of the key hash or marks the slot as empty or
+ * deleted. Lookups compare a whole group of control bytes at once (with SSE2
+ * or NEON when available) and only compare keys on a control byte match.
+ *
+ * Keys and values are stored in place, so lookups only touch a couple of
+ * cache lines. On the other hand, pointers to values are invalidated when the
+ * map grows, and iteration order is unspecified. Use HashMap when either of
+ * those matters.
+ */
+
+struct FlatHashMapGroup {
+	static constexpr int8_t CTRL_EMPTY = -128;
+	static constexpr int8_t CTRL_DELETED = -2;
+	// Full slots hold the 7 lowest bits of the hash, so they are never negative.
+
+#if defined(FLAT_HASH_MAP_SSE2)
+	static constexpr uint32_t WIDTH = 16;
+
+	__m128i ctrl;
+
+	_FORCE_INLINE_ explicit FlatHashMapGroup(const int8_t *p_ctrl) {
+		ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_ctrl));
+	}
+
+	// Each returned mask has one bit per slot in the group.
+	_FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(p_h2), ctrl));
+	}
+	_FORCE_INLINE_ uint32_t match_empty() const {
+		return match(CTRL_EMPTY);
+	}
+	_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+		return _mm_movemask_epi8(ctrl);
+	}
+#else
+	static constexpr uint32_t WIDTH = 8;
+
+	static constexpr uint64_t LSBS = 0x0101010101010101ULL;
+	static constexpr uint64_t MSBS = 0x8080808080808080ULL;
+
+	// Packs the most significant bit of each byte into one bit per slot.
+	static _FORCE_INLINE_ uint32_t _pack(uint64_t p_msbs) {
+		return uint32_t(((p_msbs >> 7) * 0x0102040810204080ULL) >> 56);
+	}
+
+#if defined(FLAT_HASH_MAP_NEON)
+	uint8x8_t ctrl;
+
+	_FORCE_INLINE_ explicit FlatHashMapGroup(const int8_t *p_ctrl) {
+		ctrl = vld1_u8(reinterpret_cast<const uint8_t *>(p_ctrl));
+	}
+
+	_FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+		uint8x8_t eq = vceq_u8(ctrl, vdup_n_u8(uint8_t(p_h2)));
+		return _pack(vget_lane_u64(vreinterpret_u64_u8(eq), 0) & MSBS);
+	}
+	_FORCE_INLINE_ uint32_t match_empty() const {
+		return match(CTRL_EMPTY);
+	}
+	_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+		return _pack(vget_lane_u64(vreinterpret_u64_u8(ctrl), 0) & MSBS);
+	}
+#else
+	uint64_t ctrl;
+
+	_FORCE_INLINE_ explicit FlatHashMapGroup(const int8_t *p_ctrl) {
+		memcpy(&ctrl, p_ctrl, sizeof(ctrl));
+#if defined(BIG_ENDIAN_ENABLED)
+		ctrl = BSWAP64(ctrl);
+#endif
+	}
+
+	// May report false positives next to a real match, which the key comparison rules out.
+	_FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+		uint64_t x = ctrl ^ (LSBS * uint8_t(p_h2));
+		return _pack((x - LSBS) & ~x & MSBS);
+	}
+	_FORCE_INLINE_ uint32_t match_empty() const {
+		return _pack(ctrl & ~(ctrl << 6) & MSBS);
+	}
+	_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+		return _pack(ctrl & MSBS);
+	}
+#endif
+#endif
+
+	static _FORCE_INLINE_ uint32_t first(uint32_t p_mask) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, p_mask);
+		return index;
+#else
+		return __builtin_ctz(p_mask);
+#endif
+	}
+};
+
+template <typename TKey, typename TValue,
+		typename Hasher = HashMapHasherDefault,
+		typename Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+public:
+	static constexpr uint32_t GROUP_WIDTH = FlatHashMapGroup::WIDTH;
+	static constexpr uint32_t MIN_CAPACITY = 16; // Must be a power of two and a multiple of GROUP_WIDTH.
+
+private:
+	typedef KeyValue<TKey, TValue> Slot;
+
+	int8_t *ctrl = nullptr;
+	KeyValue<TKey, TValue> *slots = nullptr;
+	uint32_t capacity = 0;
+	uint32_t num_elements = 0;
+	uint32_t growth_left = 0; // Empty slots that can still be used before growing.
+
+	static _FORCE_INLINE_ uint32_t _get_max_load(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8;
+	}
+
+	static _FORCE_INLINE_ int8_t _h2(uint32_t p_hash) {
+		return int8_t(p_hash & 0x7F);
+	}
+
+	bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		if (num_elements == 0) {
+			return false; // Failed lookups, no elements.
+		}
+
+		const uint32_t hash = Hasher::hash(p_key);
+		const int8_t h2 = _h2(hash);
+		const uint32_t group_mask = capacity / GROUP_WIDTH - 1;
+		uint32_t group = (hash >> 7) & group_mask;
+
+		// Triangular probing over groups visits every group, since their count is a power of two.
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * GROUP_WIDTH;
+			const FlatHashMapGroup g(ctrl + base);
+			for (uint32_t mask = g.match(h2); mask; mask &= mask - 1) {
+				const uint32_t pos = base + FlatHashMapGroup::first(mask);
+				if (Comparator::compare(slots[pos].key, p_key)) {
+					r_pos = pos;
+					return true;
+				}
+			}
+			if (g.match_empty()) {
+				return false;
+			}
+			group = (group + step) & group_mask;
+		}
+	}
+
+	uint32_t _find_free_pos(uint32_t p_hash) const {
+		const uint32_t group_mask = capacity / GROUP_WIDTH - 1;
+		uint32_t group = (p_hash >> 7) & group_mask;
+
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * GROUP_WIDTH;
+			const uint32_t mask = FlatHashMapGroup(ctrl + base).match_empty_or_deleted();
+			if (mask) {
+				return base + FlatHashMapGroup::first(mask);
+			}
+			group = (group + step) & group_mask;
+		}
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		int8_t *old_ctrl = ctrl;
+		KeyValue<TKey, TValue> *old_slots = slots;
+		uint32_t old_capacity = capacity;
+
+		capacity = p_new_capacity;
+		ctrl = reinterpret_cast<int8_t *>(Memory::alloc_static(capacity));
+		slots = reinterpret_cast<KeyValue<TKey, TValue> *>(Memory::alloc_static(sizeof(KeyValue<TKey, TValue>) * capacity));
+		memset(ctrl, FlatHashMapGroup::CTRL_EMPTY, capacity);
+		growth_left = _get_max_load(capacity) - num_elements;
+
+		if (old_ctrl == nullptr) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] < 0) {
+				continue;
+			}
+			const uint32_t hash = Hasher::hash(old_slots[i].key);
+			const uint32_t pos = _find_free_pos(hash);
+			ctrl[pos] = _h2(hash);
+			memnew_placement(&slots[pos], Slot(old_slots[i].key, old_slots[i].value));
+			old_slots[i].~KeyValue<TKey, TValue>();
+		}
+
+		Memory::free_static(old_ctrl);
+		Memory::free_static(old_slots);
+	}
+
+	uint32_t _insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			slots[pos].value = p_value;
+			return pos;
+		}
+
+		if (ctrl == nullptr) {
+			// Allocate on demand to save memory.
+			_resize_and_rehash(MAX(capacity, MIN_CAPACITY));
+		}
+
+		const uint32_t hash = Hasher::hash(p_key);
+		pos = _find_free_pos(hash);
+		if (unlikely(growth_left == 0 && ctrl[pos] == FlatHashMapGroup::CTRL_EMPTY)) {
+			// Only grow if not mostly made up of deleted slots, otherwise just clean them up.
+			_resize_and_rehash(num_elements >= _get_max_load(capacity) / 2 ? capacity * 2 : capacity);
+			pos = _find_free_pos(hash);
+		}
+
+		if (ctrl[pos] == FlatHashMapGroup::CTRL_EMPTY) {
+			growth_left--;
+		}
+		ctrl[pos] = _h2(hash);
+		memnew_placement(&slots[pos], Slot(p_key, p_value));
+		num_elements++;
+		return pos;
+	}
+
+	void _erase_pos(uint32_t p_pos) {
+		slots[p_pos].~KeyValue<TKey, TValue>();
+
+		// Lookups stop at groups with empty slots, so if this group has any, no
+		// probe sequence ever continued past it and the slot can be reused freely.
+		const FlatHashMapGroup g(ctrl + (p_pos & ~(GROUP_WIDTH - 1)));
+		if (g.match_empty()) {
+			ctrl[p_pos] = FlatHashMapGroup::CTRL_EMPTY;
+			growth_left++;
+		} else {
+			ctrl[p_pos] = FlatHashMapGroup::CTRL_DELETED;
+		}
+		num_elements--;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (ctrl == nullptr) {
+			return;
+		}
+		if constexpr (!std::is_trivially_destructible_v<TKey> || !std::is_trivially_destructible_v<TValue>) {
+			for (uint32_t i = 0; i < capacity && num_elements > 0; i++) {
+				if (ctrl[i] >= 0) {
+					slots[i].~KeyValue<TKey, TValue>();
+					num_elements--;
+				}
+			}
+		}
+		memset(ctrl, FlatHashMapGroup::CTRL_EMPTY, capacity);
+		num_elements = 0;
+		growth_left = _get_max_load(capacity);
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return _lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return false;
+		}
+		_erase_pos(pos);
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	void reserve(uint32_t p_new_capacity) {
+		uint32_t new_capacity = MAX(capacity, MIN_CAPACITY);
+		while (_get_max_load(new_capacity) < p_new_capacity) {
+			ERR_FAIL_COND_MSG(new_capacity >= (1u << 31), "Hash table maximum capacity reached.");
+			new_capacity *= 2;
+		}
+
+		if (new_capacity == capacity) {
+			return;
+		}
+
+		if (ctrl == nullptr) {
+			capacity = new_capacity;
+			return; // Unallocated yet.
+		}
+		_resize_and_rehash(new_capacity);
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return *slot;
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return slot; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			if (slot) {
+				ctrl++;
+				slot++;
+				_skip_free();
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return slot == b.slot; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return slot != b.slot; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return slot != nullptr;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const int8_t *p_ctrl, const int8_t *p_ctrl_end, const KeyValue<TKey, TValue> *p_slot) {
+			ctrl = p_ctrl;
+			ctrl_end = p_ctrl_end;
+			slot = p_slot;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		friend class FlatHashMap;
+
+		const int8_t *ctrl = nullptr;
+		const int8_t *ctrl_end = nullptr;
+		const KeyValue<TKey, TValue> *slot = nullptr;
+
+		_FORCE_INLINE_ void _skip_free() {
+			while (ctrl != ctrl_end && *ctrl < 0) {
+				ctrl++;
+				slot++;
+			}
+			if (ctrl == ctrl_end) {
+				slot = nullptr;
+			}
+		}
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return *slot;
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return slot; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (slot) {
+				ctrl++;
+				slot++;
+				_skip_free();
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return slot == b.slot; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return slot != b.slot; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return slot != nullptr;
+		}
+
+		_FORCE_INLINE_ Iterator(const int8_t *p_ctrl, const int8_t *p_ctrl_end, KeyValue<TKey, TValue> *p_slot) {
+			ctrl = p_ctrl;
+			ctrl_end = p_ctrl_end;
+			slot = p_slot;
+		}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(ctrl, ctrl_end, slot);
+		}
+
+	private:
+		friend class FlatHashMap;
+
+		const int8_t *ctrl = nullptr;
+		const int8_t *ctrl_end = nullptr;
+		KeyValue<TKey, TValue> *slot = nullptr;
+
+		_FORCE_INLINE_ void _skip_free() {
+			while (ctrl != ctrl_end && *ctrl < 0) {
+				ctrl++;
+				slot++;
+			}
+			if (ctrl == ctrl_end) {
+				slot = nullptr;
+			}
+		}
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		if (num_elements == 0) {
+			return end();
+		}
+		Iterator it(ctrl, ctrl + capacity, slots);
+		it._skip_free();
+		return it;
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator();
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return Iterator(ctrl + pos, ctrl + capacity, slots + pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			_erase_pos(p_iter.slot - slots);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		if (num_elements == 0) {
+			return end();
+		}
+		ConstIterator it(ctrl, ctrl + capacity, slots);
+		it._skip_free();
+		return it;
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator();
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return ConstIterator(ctrl + pos, ctrl + capacity, slots + pos);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND(!exists);
+		return slots[pos].value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			pos = _insert(p_key, TValue());
+		}
+		return slots[pos].value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t pos = _insert(p_key, p_value);
+		return Iterator(ctrl + pos, ctrl + capacity, slots + pos);
+	}
+
+	/* Constructors */
+
+	FlatHashMap(const FlatHashMap &p_other) {
+		reserve(p_other.num_elements);
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	void operator=(const FlatHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		reserve(p_other.num_elements);
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	FlatHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	FlatHashMap() {}
+
+	~FlatHashMap() {
+		clear();
+
+		if (ctrl != nullptr) {
+			Memory::free_static(ctrl);
+			Memory::free_static(slots);
+		}
+	}
+};
+
+#endif // FLAT_HASH_MAP_H
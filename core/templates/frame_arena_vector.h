@@ -0,0 +1,225 @@
+/**************************************************************************/
+/*  frame_arena_vector.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FRAME_ARENA_VECTOR_H
+#define FRAME_ARENA_VECTOR_H
+
+#include "core/error/error_macros.h"
+#include "core/os/frame_arena.h"
+#include "core/templates/sort_array.h"
+#include "core/templates/vector.h"
+
+#include <type_traits>
+
+// LocalVector-like container storing its elements in a FrameArena.
+// Growing is done in place when the vector is the last thing allocated from
+// the arena, which is the common case for scratch buffers. Like everything
+// else in the arena, it must not outlive the Scope or frame it was made in.
+template <typename T, typename U = uint32_t>
+class FrameArenaVector {
+	FrameArena *arena = nullptr;
+	U count = 0;
+	U capacity = 0;
+	T *data = nullptr;
+
+	void _set_capacity(U p_capacity) {
+		if (data && arena->resize_last(data, capacity * sizeof(T), p_capacity * sizeof(T))) {
+			capacity = p_capacity;
+			return;
+		}
+		T *new_data = arena->alloc_array<T>(p_capacity);
+		CRASH_COND_MSG(!new_data, "Out of memory");
+		if (data) {
+			memcpy((void *)new_data, (void *)data, count * sizeof(T));
+		}
+		data = new_data;
+		capacity = p_capacity;
+	}
+
+public:
+	_FORCE_INLINE_ T *ptr() { return data; }
+	_FORCE_INLINE_ const T *ptr() const { return data; }
+	_FORCE_INLINE_ FrameArena *get_arena() const { return arena; }
+
+	_FORCE_INLINE_ void push_back(T p_elem) {
+		if (unlikely(count == capacity)) {
+			_set_capacity(MAX((U)4, capacity << 1));
+		}
+
+		if constexpr (!std::is_trivially_constructible_v<T>) {
+			memnew_placement(&data[count++], T(p_elem));
+		} else {
+			data[count++] = p_elem;
+		}
+	}
+
+	void remove_at(U p_index) {
+		ERR_FAIL_UNSIGNED_INDEX(p_index, count);
+		count--;
+		for (U i = p_index; i < count; i++) {
+			data[i] = data[i + 1];
+		}
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			data[count].~T();
+		}
+	}
+
+	void remove_at_unordered(U p_index) {
+		ERR_FAIL_INDEX(p_index, count);
+		count--;
+		if (count > p_index) {
+			data[p_index] = data[count];
+		}
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			data[count].~T();
+		}
+	}
+
+	_FORCE_INLINE_ bool erase(const T &p_val) {
+		int64_t idx = find(p_val);
+		if (idx >= 0) {
+			remove_at(idx);
+			return true;
+		}
+		return false;
+	}
+
+	_FORCE_INLINE_ void clear() { resize(0); }
+	_FORCE_INLINE_ bool is_empty() const { return count == 0; }
+	_FORCE_INLINE_ U get_capacity() const { return capacity; }
+	_FORCE_INLINE_ void reserve(U p_size) {
+		if (p_size > capacity) {
+			_set_capacity(p_size);
+		}
+	}
+
+	_FORCE_INLINE_ U size() const { return count; }
+	void resize(U p_size) {
+		if (p_size < count) {
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				for (U i = p_size; i < count; i++) {
+					data[i].~T();
+				}
+			}
+			count = p_size;
+		} else if (p_size > count) {
+			if (unlikely(p_size > capacity)) {
+				_set_capacity(nearest_power_of_2_templated(p_size));
+			}
+			if constexpr (!std::is_trivially_constructible_v<T>) {
+				for (U i = count; i < p_size; i++) {
+					memnew_placement(&data[i], T);
+				}
+			}
+			count = p_size;
+		}
+	}
+
+	_FORCE_INLINE_ const T &operator[](U p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return data[p_index];
+	}
+	_FORCE_INLINE_ T &operator[](U p_index) {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return data[p_index];
+	}
+
+	_FORCE_INLINE_ T *begin() { return data; }
+	_FORCE_INLINE_ T *end() { return data + count; }
+	_FORCE_INLINE_ const T *begin() const { return data; }
+	_FORCE_INLINE_ const T *end() const { return data + count; }
+
+	int64_t find(const T &p_val, U p_from = 0) const {
+		for (U i = p_from; i < count; i++) {
+			if (data[i] == p_val) {
+				return int64_t(i);
+			}
+		}
+		return -1;
+	}
+
+	bool has(const T &p_val) const {
+		return find(p_val) != -1;
+	}
+
+	template <typename C>
+	void sort_custom() {
+		if (count == 0) {
+			return;
+		}
+		SortArray<T, C> sorter;
+		sorter.sort(data, count);
+	}
+
+	void sort() {
+		sort_custom<_DefaultComparator<T>>();
+	}
+
+	operator Vector<T>() const {
+		Vector<T> ret;
+		ret.resize(count);
+		T *w = ret.ptrw();
+		for (U i = 0; i < count; i++) {
+			w[i] = data[i];
+		}
+		return ret;
+	}
+
+	void operator=(const Vector<T> &p_from) {
+		resize(p_from.size());
+		for (U i = 0; i < count; i++) {
+			data[i] = p_from[i];
+		}
+	}
+
+	void operator=(const FrameArenaVector &p_from) {
+		resize(p_from.size());
+		for (U i = 0; i < count; i++) {
+			data[i] = p_from.data[i];
+		}
+	}
+
+	FrameArenaVector(const FrameArenaVector &p_from) :
+			arena(p_from.arena) {
+		*this = p_from;
+	}
+
+	_FORCE_INLINE_ explicit FrameArenaVector(FrameArena *p_arena = FrameArena::get_thread_arena()) :
+			arena(p_arena) {}
+
+	_FORCE_INLINE_ ~FrameArenaVector() {
+		resize(0);
+		if (data) {
+			arena->release(data, capacity * sizeof(T));
+		}
+	}
+};
+
+#endif // FRAME_ARENA_VECTOR_H
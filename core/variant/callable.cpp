@@ -30,6 +30,7 @@
 
 #include "callable.h"
 
+#include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
@@ -70,6 +71,44 @@ void Callable::callp(const Variant **p_arguments, int p_argcount, Variant &r_ret
 	}
 }
 
+void Callable::ptrcall(const void **p_arguments, int p_argcount, void *r_return_value, CallError &r_call_error) const {
+	// Custom callables only report errors.
+	r_call_error.error = CallError::CALL_OK;
+	r_call_error.argument = 0;
+	r_call_error.expected = 0;
+	if (is_null()) {
+		r_call_error.error = CallError::CALL_ERROR_INSTANCE_IS_NULL;
+	} else if (is_custom()) {
+		if (!is_valid()) {
+			r_call_error.error = CallError::CALL_ERROR_INSTANCE_IS_NULL;
+			return;
+		}
+		custom->ptrcall(p_arguments, p_argcount, r_return_value, r_call_error);
+	} else {
+		Object *obj = ObjectDB::get_instance(ObjectID(object));
+		if (!obj) {
+			r_call_error.error = CallError::CALL_ERROR_INSTANCE_IS_NULL;
+			return;
+		}
+		// Script methods take precedence over native ones in Object::callp(), and can't be ptrcalled.
+		if (obj->get_script_instance() && obj->get_script_instance()->has_method(method)) {
+			r_call_error.error = CallError::CALL_ERROR_INVALID_METHOD;
+			return;
+		}
+		MethodBind *mb = ClassDB::get_method(obj->get_class_name(), method);
+		if (!mb || mb->is_vararg()) {
+			r_call_error.error = CallError::CALL_ERROR_INVALID_METHOD;
+			return;
+		}
+		if (p_argcount != mb->get_argument_count()) {
+			r_call_error.error = p_argcount < mb->get_argument_count() ? CallError::CALL_ERROR_TOO_FEW_ARGUMENTS : CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
+			r_call_error.expected = mb->get_argument_count();
+			return;
+		}
+		mb->ptrcall(obj, p_arguments, r_return_value);
+	}
+}
+
 Variant Callable::callv(const Array &p_arguments) const {
 	int argcount = p_arguments.size();
 	const Variant **argptrs = nullptr;
@@ -443,6 +482,12 @@ StringName CallableCustom::get_method() const {
 	ERR_FAIL_V_MSG(StringName(), vformat("Can't get method on CallableCustom \"%s\".", get_as_text()));
 }
 
+void CallableCustom::ptrcall(const void **p_arguments, int p_argcount, void *r_return_value, Callable::CallError &r_call_error) const {
+	r_call_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
+	r_call_error.argument = 0;
+	r_call_error.expected = 0;
+}
+
 Error CallableCustom::rpc(int p_peer_id, const Variant **p_arguments, int p_argcount, Callable::CallError &r_call_error) const {
 	r_call_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
 	r_call_error.argument = 0;
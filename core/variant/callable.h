@@ -72,6 +72,11 @@ public:
 	template <typename... VarArgs>
 	Variant call(VarArgs... p_args) const;
 	void callp(const Variant **p_arguments, int p_argcount, Variant &r_return_value, CallError &r_call_error) const;
+	// Calls with arguments and return value in their ptrcall encoding (see PtrToArg), avoiding Variant boxing.
+	// Types must match the target exactly and default arguments aren't filled in. Only native methods and
+	// custom callables that support it can be called this way, otherwise nothing is called and the error is
+	// CALL_ERROR_INVALID_METHOD, so callers can fall back to callp().
+	void ptrcall(const void **p_arguments, int p_argcount, void *r_return_value, CallError &r_call_error) const;
 	void call_deferredp(const Variant **p_arguments, int p_argcount) const;
 	Variant callv(const Array &p_arguments) const;
 
@@ -154,6 +159,7 @@ public:
 	virtual StringName get_method() const;
 	virtual ObjectID get_object() const = 0;
 	virtual void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const = 0;
+	virtual void ptrcall(const void **p_arguments, int p_argcount, void *r_return_value, Callable::CallError &r_call_error) const;
 	virtual Error rpc(int p_peer_id, const Variant **p_arguments, int p_argcount, Callable::CallError &r_call_error) const;
 	virtual const Callable *get_base_comparator() const;
 	virtual int get_argument_count(bool &r_is_valid) const;
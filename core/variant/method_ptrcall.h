@@ -35,6 +35,8 @@
 #include "core/typedefs.h"
 #include "core/variant/variant.h"
 
+#include <type_traits>
+
 template <typename T>
 struct PtrToArg {};
 
@@ -459,4 +461,19 @@ struct PtrToArg<const Vector<Face3> &> {
 	}
 };
 
+// Whether a type can be passed to or returned from a ptrcall, i.e. it has a PtrToArg specialization.
+// Checked where both Variant and ptrcall paths are instantiated for arbitrary signatures.
+
+template <typename T, typename = void>
+struct PtrToArgCanConvert : std::false_type {};
+
+template <typename T>
+struct PtrToArgCanConvert<T, decltype(PtrToArg<T>::convert(nullptr), void())> : std::true_type {};
+
+template <typename T, typename = void>
+struct PtrToArgCanEncode : std::false_type {};
+
+template <typename T>
+struct PtrToArgCanEncode<T, decltype(PtrToArg<T>::encode(std::declval<T>(), nullptr), void())> : std::true_type {};
+
 #endif // METHOD_PTRCALL_H
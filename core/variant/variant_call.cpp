@@ -34,6 +34,7 @@
 #include "core/debugger/engine_debugger.h"
 #include "core/io/compression.h"
 #include "core/io/marshalls.h"
+#include "core/math/packed_array_math.h"
 #include "core/object/class_db.h"
 #include "core/os/os.h"
 #include "core/templates/local_vector.h"
@@ -657,6 +658,45 @@ static _FORCE_INLINE_ void vc_ptrcall(void (*method)(T *, P...), void *p_base, c
 		}                                                                                                                                                         \
 	};
 
+// How the elements of a packed array are laid out as scalars for PackedArrayMath.
+template <typename T>
+struct PackedMathElement {
+	typedef T Scalar;
+	static constexpr int STRIDE = 1;
+	static Scalar *scalars(T &p_value) { return &p_value; }
+};
+
+template <>
+struct PackedMathElement<Vector2> {
+	typedef real_t Scalar;
+	static constexpr int STRIDE = 2;
+	static Scalar *scalars(Vector2 &p_value) { return p_value.coord; }
+};
+
+template <>
+struct PackedMathElement<Vector3> {
+	typedef real_t Scalar;
+	static constexpr int STRIDE = 3;
+	static Scalar *scalars(Vector3 &p_value) { return p_value.coord; }
+};
+
+template <>
+struct PackedMathElement<Color> {
+	typedef float Scalar;
+	static constexpr int STRIDE = 4;
+	static Scalar *scalars(Color &p_value) { return p_value.components; }
+};
+
+// Views a packed array as a flat buffer of scalars.
+template <typename T>
+struct PackedMathBuffer {
+	typedef typename PackedMathElement<T>::Scalar Scalar;
+
+	static Scalar *write(Vector<T> &p_array) { return reinterpret_cast<Scalar *>(p_array.ptrw()); }
+	static const Scalar *read(const Vector<T> &p_array) { return reinterpret_cast<const Scalar *>(p_array.ptr()); }
+	static int64_t count(const Vector<T> &p_array) { return int64_t(p_array.size()) * PackedMathElement<T>::STRIDE; }
+};
+
 struct _VariantCall {
 	static String func_PackedByteArray_get_string_from_ascii(PackedByteArray *p_instance) {
 		String s;
@@ -1018,6 +1058,113 @@ struct _VariantCall {
 		return len;
 	}
 
+	// Bulk math on packed arrays. Operations without a return value modify the array in place.
+
+	template <typename T>
+	static void func_PackedArray_add_scalar(Vector<T> *p_instance, T p_value) {
+		PackedArrayMath::add_value(PackedMathBuffer<T>::write(*p_instance), PackedMathBuffer<T>::count(*p_instance), PackedMathElement<T>::scalars(p_value), PackedMathElement<T>::STRIDE);
+	}
+
+	template <typename T>
+	static void func_PackedArray_multiply_scalar(Vector<T> *p_instance, T p_value) {
+		PackedArrayMath::multiply_value(PackedMathBuffer<T>::write(*p_instance), PackedMathBuffer<T>::count(*p_instance), PackedMathElement<T>::scalars(p_value), PackedMathElement<T>::STRIDE);
+	}
+
+	template <typename T>
+	static void func_PackedArray_fma_scalar(Vector<T> *p_instance, T p_multiplier, T p_addend) {
+		PackedArrayMath::multiply_add_value(PackedMathBuffer<T>::write(*p_instance), PackedMathBuffer<T>::count(*p_instance), PackedMathElement<T>::scalars(p_multiplier), PackedMathElement<T>::scalars(p_addend), PackedMathElement<T>::STRIDE);
+	}
+
+	template <typename T>
+	static void func_PackedArray_clamp(Vector<T> *p_instance, T p_min, T p_max) {
+		PackedArrayMath::clamp(PackedMathBuffer<T>::write(*p_instance), PackedMathBuffer<T>::count(*p_instance), PackedMathElement<T>::scalars(p_min), PackedMathElement<T>::scalars(p_max), PackedMathElement<T>::STRIDE);
+	}
+
+	template <typename T>
+	static void func_PackedArray_add_array(Vector<T> *p_instance, const Vector<T> &p_array) {
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), vformat("The array sizes don't match (%d and %d).", p_instance->size(), p_array.size()));
+		typename PackedMathBuffer<T>::Scalar *dst = PackedMathBuffer<T>::write(*p_instance);
+		PackedArrayMath::add(dst, PackedMathBuffer<T>::read(p_array), PackedMathBuffer<T>::count(*p_instance));
+	}
+
+	template <typename T>
+	static void func_PackedArray_multiply_array(Vector<T> *p_instance, const Vector<T> &p_array) {
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), vformat("The array sizes don't match (%d and %d).", p_instance->size(), p_array.size()));
+		typename PackedMathBuffer<T>::Scalar *dst = PackedMathBuffer<T>::write(*p_instance);
+		PackedArrayMath::multiply(dst, PackedMathBuffer<T>::read(p_array), PackedMathBuffer<T>::count(*p_instance));
+	}
+
+	template <typename T>
+	static void func_PackedArray_fma_array(Vector<T> *p_instance, const Vector<T> &p_multiplier, const Vector<T> &p_addend) {
+		ERR_FAIL_COND_MSG(p_multiplier.size() != p_instance->size() || p_addend.size() != p_instance->size(), vformat("The array sizes don't match (%d, %d and %d).", p_instance->size(), p_multiplier.size(), p_addend.size()));
+		typename PackedMathBuffer<T>::Scalar *dst = PackedMathBuffer<T>::write(*p_instance);
+		PackedArrayMath::multiply_add(dst, PackedMathBuffer<T>::read(p_multiplier), PackedMathBuffer<T>::read(p_addend), PackedMathBuffer<T>::count(*p_instance));
+	}
+
+	template <typename T>
+	static void func_PackedArray_lerp(Vector<T> *p_instance, const Vector<T> &p_to, double p_weight) {
+		ERR_FAIL_COND_MSG(p_to.size() != p_instance->size(), vformat("The array sizes don't match (%d and %d).", p_instance->size(), p_to.size()));
+		typename PackedMathBuffer<T>::Scalar *dst = PackedMathBuffer<T>::write(*p_instance);
+		PackedArrayMath::lerp(dst, PackedMathBuffer<T>::read(p_to), (typename PackedMathBuffer<T>::Scalar)p_weight, PackedMathBuffer<T>::count(*p_instance));
+	}
+
+	template <typename T>
+	static T func_PackedArray_sum(Vector<T> *p_instance) {
+		T result = T();
+		PackedArrayMath::sum(PackedMathBuffer<T>::read(*p_instance), PackedMathBuffer<T>::count(*p_instance), PackedMathElement<T>::scalars(result), PackedMathElement<T>::STRIDE);
+		return result;
+	}
+
+	template <typename T>
+	static T func_PackedArray_min(Vector<T> *p_instance) {
+		T result = T();
+		PackedArrayMath::min(PackedMathBuffer<T>::read(*p_instance), PackedMathBuffer<T>::count(*p_instance), PackedMathElement<T>::scalars(result), PackedMathElement<T>::STRIDE);
+		return result;
+	}
+
+	template <typename T>
+	static T func_PackedArray_max(Vector<T> *p_instance) {
+		T result = T();
+		PackedArrayMath::max(PackedMathBuffer<T>::read(*p_instance), PackedMathBuffer<T>::count(*p_instance), PackedMathElement<T>::scalars(result), PackedMathElement<T>::STRIDE);
+		return result;
+	}
+
+	template <typename T>
+	static double func_PackedArray_dot(Vector<T> *p_instance, const Vector<T> &p_array) {
+		ERR_FAIL_COND_V_MSG(p_array.size() != p_instance->size(), 0, vformat("The array sizes don't match (%d and %d).", p_instance->size(), p_array.size()));
+		return PackedArrayMath::dot(p_instance->ptr(), p_array.ptr(), p_instance->size());
+	}
+
+	template <typename T>
+	static PackedRealArray func_PackedVectorArray_dot(Vector<T> *p_instance, const Vector<T> &p_array) {
+		PackedRealArray dest;
+		ERR_FAIL_COND_V_MSG(p_array.size() != p_instance->size(), dest, vformat("The array sizes don't match (%d and %d).", p_instance->size(), p_array.size()));
+		dest.resize(p_instance->size());
+		PackedArrayMath::dots(p_instance->ptr(), p_array.ptr(), p_instance->size(), dest.ptrw());
+		return dest;
+	}
+
+	template <typename T>
+	static PackedRealArray func_PackedVectorArray_lengths(Vector<T> *p_instance) {
+		PackedRealArray dest;
+		dest.resize(p_instance->size());
+		PackedArrayMath::lengths(p_instance->ptr(), p_instance->size(), dest.ptrw());
+		return dest;
+	}
+
+	template <typename T>
+	static void func_PackedVectorArray_normalize(Vector<T> *p_instance) {
+		PackedArrayMath::normalize(p_instance->ptrw(), p_instance->size());
+	}
+
+	static void func_PackedVector2Array_transform(PackedVector2Array *p_instance, const Transform2D &p_transform) {
+		PackedArrayMath::transform(p_instance->ptrw(), p_instance->size(), p_transform);
+	}
+
+	static void func_PackedVector3Array_transform(PackedVector3Array *p_instance, const Transform3D &p_transform) {
+		PackedArrayMath::transform(p_instance->ptrw(), p_instance->size(), p_transform);
+	}
+
 	static void func_Callable_call(Variant *v, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
 		Callable *callable = VariantGetInternalPtr<Callable>::get_ptr(v);
 		callable->callp(p_args, p_argcount, r_ret, r_error);
@@ -2268,6 +2415,19 @@ static void _register_variant_builtin_methods_misc() {
 	bind_method(Dictionary, recursive_equal, sarray("dictionary", "recursion_count"), varray());
 }
 
+#define bind_packed_array_math(m_type, m_elem)                                                                                        \
+	bind_functionnc(m_type, add_scalar, _VariantCall::func_PackedArray_add_scalar<m_elem>, sarray("value"), varray());                \
+	bind_functionnc(m_type, multiply_scalar, _VariantCall::func_PackedArray_multiply_scalar<m_elem>, sarray("value"), varray());      \
+	bind_functionnc(m_type, fma_scalar, _VariantCall::func_PackedArray_fma_scalar<m_elem>, sarray("multiplier", "addend"), varray()); \
+	bind_functionnc(m_type, add_array, _VariantCall::func_PackedArray_add_array<m_elem>, sarray("array"), varray());                  \
+	bind_functionnc(m_type, multiply_array, _VariantCall::func_PackedArray_multiply_array<m_elem>, sarray("array"), varray());        \
+	bind_functionnc(m_type, fma_array, _VariantCall::func_PackedArray_fma_array<m_elem>, sarray("multiplier", "addend"), varray());   \
+	bind_functionnc(m_type, clamp, _VariantCall::func_PackedArray_clamp<m_elem>, sarray("min", "max"), varray());                     \
+	bind_functionnc(m_type, lerp, _VariantCall::func_PackedArray_lerp<m_elem>, sarray("to", "weight"), varray());                     \
+	bind_function(m_type, sum, _VariantCall::func_PackedArray_sum<m_elem>, sarray(), varray());                                       \
+	bind_function(m_type, min, _VariantCall::func_PackedArray_min<m_elem>, sarray(), varray());                                       \
+	bind_function(m_type, max, _VariantCall::func_PackedArray_max<m_elem>, sarray(), varray());
+
 static void _register_variant_builtin_methods_array() {
 	/* Array */
 
@@ -2454,6 +2614,8 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedFloat32Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedFloat32Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedFloat32Array, count, sarray("value"), varray());
+	bind_packed_array_math(PackedFloat32Array, float);
+	bind_function(PackedFloat32Array, dot, _VariantCall::func_PackedArray_dot<float>, sarray("array"), varray());
 
 	/* Float64 Array */
 
@@ -2478,6 +2640,8 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedFloat64Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedFloat64Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedFloat64Array, count, sarray("value"), varray());
+	bind_packed_array_math(PackedFloat64Array, double);
+	bind_function(PackedFloat64Array, dot, _VariantCall::func_PackedArray_dot<double>, sarray("array"), varray());
 
 	/* String Array */
 
@@ -2526,6 +2690,11 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedVector2Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedVector2Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedVector2Array, count, sarray("value"), varray());
+	bind_packed_array_math(PackedVector2Array, Vector2);
+	bind_function(PackedVector2Array, dot, _VariantCall::func_PackedVectorArray_dot<Vector2>, sarray("array"), varray());
+	bind_function(PackedVector2Array, lengths, _VariantCall::func_PackedVectorArray_lengths<Vector2>, sarray(), varray());
+	bind_functionnc(PackedVector2Array, normalize, _VariantCall::func_PackedVectorArray_normalize<Vector2>, sarray(), varray());
+	bind_functionnc(PackedVector2Array, transform, _VariantCall::func_PackedVector2Array_transform, sarray("transform"), varray());
 
 	/* Vector3 Array */
 
@@ -2550,6 +2719,11 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedVector3Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedVector3Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedVector3Array, count, sarray("value"), varray());
+	bind_packed_array_math(PackedVector3Array, Vector3);
+	bind_function(PackedVector3Array, dot, _VariantCall::func_PackedVectorArray_dot<Vector3>, sarray("array"), varray());
+	bind_function(PackedVector3Array, lengths, _VariantCall::func_PackedVectorArray_lengths<Vector3>, sarray(), varray());
+	bind_functionnc(PackedVector3Array, normalize, _VariantCall::func_PackedVectorArray_normalize<Vector3>, sarray(), varray());
+	bind_functionnc(PackedVector3Array, transform, _VariantCall::func_PackedVector3Array_transform, sarray("transform"), varray());
 
 	/* Color Array */
 
@@ -2574,6 +2748,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedColorArray, find, sarray("value", "from"), varray(0));
 	bind_method(PackedColorArray, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedColorArray, count, sarray("value"), varray());
+	bind_packed_array_math(PackedColorArray, Color);
 
 	/* Vector4 Array */
 
@@ -34,6 +34,7 @@
 #ifdef GLES3_ENABLED
 
 #include "core/math/projection.h"
+#include "core/templates/local_vector_inline.h"
 #include "core/templates/paged_allocator.h"
 #include "core/templates/rid_owner.h"
 #include "core/templates/self_list.h"
@@ -315,14 +316,16 @@ private:
 
 		uint32_t paired_omni_light_count = 0;
 		uint32_t paired_spot_light_count = 0;
-		LocalVector<RID> paired_omni_lights;
-		LocalVector<RID> paired_spot_lights;
-		LocalVector<uint32_t> omni_light_gl_cache;
-		LocalVector<uint32_t> spot_light_gl_cache;
+		// Most instances are only lit by a few lights, keep those lists inline.
+		LocalVectorInline<RID, 4> paired_omni_lights;
+		LocalVectorInline<RID, 4> paired_spot_lights;
+		LocalVectorInline<uint32_t, 4> omni_light_gl_cache;
+		LocalVectorInline<uint32_t, 4> spot_light_gl_cache;
 
 		LocalVector<RID> paired_reflection_probes;
-		LocalVector<RID> reflection_probe_rid_cache;
-		LocalVector<Transform3D> reflection_probes_local_transform_cache;
+		// At most two reflection probes are used when drawing.
+		LocalVectorInline<RID, 2> reflection_probe_rid_cache;
+		LocalVectorInline<Transform3D, 2> reflection_probes_local_transform_cache;
 
 		RID lightmap_instance;
 		Rect2 lightmap_uv_scale;
@@ -46,6 +46,7 @@
 #include "core/io/ip.h"
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
 #include "core/register_core_types.h"
@@ -125,6 +126,8 @@
 
 #ifdef MODULE_GDSCRIPT_ENABLED
 #include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_cache.h"
+#include "modules/gdscript/gdscript_sampling_profiler.h"
 #if defined(TOOLS_ENABLED) && !defined(GDSCRIPT_NO_LSP)
 #include "modules/gdscript/language_server/gdscript_language_server.h"
 #endif // TOOLS_ENABLED && !GDSCRIPT_NO_LSP
@@ -598,6 +601,9 @@ void Main::print_help(const char *p_binary) {
 	print_help_option("-d, --debug", "Debug (local stdout debugger).\n");
 	print_help_option("-b, --breakpoints", "Breakpoint list as source::line comma-separated pairs, no spaces (use %%20 instead).\n");
 	print_help_option("--profiling", "Enable profiling in the script debugger.\n");
+#if defined(DEBUG_ENABLED) && defined(MODULE_GDSCRIPT_ENABLED)
+	print_help_option("--profile-gdscript <file>", "Sample running GDScript code and write folded stacks to <file> and per-line hit counts to <file>.lines when quitting.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
+#endif
 	print_help_option("--gpu-profile", "Show a GPU profile of the tasks that took the most time during frame rendering.\n");
 	print_help_option("--gpu-validation", "Enable graphics API validation layers for debugging.\n");
 #ifdef DEBUG_ENABLED
@@ -1326,6 +1332,19 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 			use_debug_profiler = true;
 
+#if defined(DEBUG_ENABLED) && defined(MODULE_GDSCRIPT_ENABLED)
+		} else if (arg == "--profile-gdscript") {
+			if (N) {
+				// Will be handled in start().
+				main_args.push_back(arg);
+				main_args.push_back(N->get());
+				N = N->next();
+			} else {
+				OS::get_singleton()->print("Missing output file for --profile-gdscript, aborting.\n");
+				goto error;
+			}
+#endif // DEBUG_ENABLED && MODULE_GDSCRIPT_ENABLED
+
 		} else if (arg == "-l" || arg == "--language") { // language
 
 			if (N) {
@@ -3306,6 +3325,10 @@ int Main::start() {
 				script = E->next()->get();
 			} else if (E->get() == "--main-loop") {
 				main_loop_type = E->next()->get();
+#if defined(DEBUG_ENABLED) && defined(MODULE_GDSCRIPT_ENABLED)
+			} else if (E->get() == "--profile-gdscript") {
+				GDScriptSamplingProfiler::start(GDScriptSamplingProfiler::DEFAULT_INTERVAL_USEC, E->next()->get());
+#endif
 #ifdef TOOLS_ENABLED
 			} else if (E->get() == "--doctool") {
 				doc_tool_path = E->next()->get();
@@ -3637,6 +3660,14 @@ int Main::start() {
 					}
 				}
 
+#ifdef MODULE_GDSCRIPT_ENABLED
+				if (GLOBAL_GET("gdscript/compilation/compile_on_startup")) {
+					OS::get_singleton()->benchmark_begin_measure("Startup", "Compile GDScript");
+					GDScriptCache::compile_project_scripts();
+					OS::get_singleton()->benchmark_end_measure("Startup", "Compile GDScript");
+				}
+#endif
+
 				//second pass, load into global constants
 				List<Node *> to_add;
 				for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : autoloads) {
@@ -4162,6 +4193,11 @@ bool Main::iteration() {
 
 	iterating--;
 
+	if (iterating == 0) {
+		// Scratch memory handed out on the main thread during this frame.
+		FrameArena::get_thread_arena()->reset();
+	}
+
 	// Needed for OSs using input buffering regardless accumulation (like Android)
 	if (Input::get_singleton()->is_using_input_buffering() && !agile_input_event_flushing) {
 		Input::get_singleton()->flush_buffered_events();
@@ -31,6 +31,7 @@
 #include "performance.h"
 
 #include "core/os/os.h"
+#include "core/os/slab_allocator.h"
 #include "core/variant/typed_array.h"
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
@@ -91,6 +92,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_MERGE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
+	BIND_ENUM_CONSTANT(MEMORY_SLAB_HIT_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_SLAB_RESERVED);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -141,6 +144,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("navigation/edges_merged"),
 		PNAME("navigation/edges_connected"),
 		PNAME("navigation/edges_free"),
+		PNAME("memory/slab_hit_rate"),
+		PNAME("memory/slab_reserved"),
 
 	};
 
@@ -225,6 +230,20 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
 		case NAVIGATION_EDGE_FREE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+#ifdef SLAB_ALLOCATOR_ENABLED
+		case MEMORY_SLAB_HIT_RATE: {
+			SlabAllocator::Stats stats = SlabAllocator::get_stats();
+			uint64_t total = stats.cache_hits + stats.cache_misses + stats.fallbacks;
+			return total > 0 ? 100.0 * stats.cache_hits / total : 0.0;
+		}
+		case MEMORY_SLAB_RESERVED:
+			return SlabAllocator::get_stats().reserved_bytes;
+#else
+		case MEMORY_SLAB_HIT_RATE:
+			return 0;
+		case MEMORY_SLAB_RESERVED:
+			return 0;
+#endif // SLAB_ALLOCATOR_ENABLED
 
 		default: {
 		}
@@ -272,6 +291,8 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
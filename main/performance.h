@@ -100,6 +100,8 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		MEMORY_SLAB_HIT_RATE,
+		MEMORY_SLAB_RESERVED,
 		MONITOR_MAX
 	};
 
@@ -33,8 +33,12 @@
 #include "gdscript_analyzer.h"
 #include "gdscript_cache.h"
 #include "gdscript_compiler.h"
+#include "gdscript_coroutine_frame_pool.h"
+#include "gdscript_inline_cache.h"
+#include "gdscript_jit.h"
 #include "gdscript_parser.h"
 #include "gdscript_rpc_callable.h"
+#include "gdscript_sampling_profiler.h"
 #include "gdscript_tokenizer_buffer.h"
 #include "gdscript_warning.h"
 
@@ -731,6 +735,9 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 	reloading = true;
 
+	// Member layouts and functions may change, drop every cached lookup.
+	GDScriptInlineCache::invalidate_all();
+
 	bool has_instances;
 	{
 		MutexLock lock(GDScriptLanguage::singleton->mutex);
@@ -795,12 +802,17 @@ Error GDScript::reload(bool p_keep_state) {
 #endif
 
 	valid = false;
-	GDScriptParser parser;
-	Error err;
-	if (!binary_tokens.is_empty()) {
-		err = parser.parse_binary(binary_tokens, path);
-	} else {
-		err = parser.parse(source, path, false);
+	// Batches of scripts are parsed ahead of time in parallel, see `GDScriptCache::compile_scripts()`.
+	GDScriptParser *parsed_source = GDScriptCache::take_parsed_source(path, source, binary_tokens);
+	GDScriptParser own_parser;
+	GDScriptParser &parser = parsed_source ? *parsed_source : own_parser;
+	Error err = OK;
+	if (!parsed_source) {
+		if (!binary_tokens.is_empty()) {
+			err = parser.parse_binary(binary_tokens, path);
+		} else {
+			err = parser.parse(source, path, false);
+		}
 	}
 	if (err) {
 		if (EngineDebugger::is_active()) {
@@ -1533,6 +1545,8 @@ void GDScript::clear(ClearData *p_clear_data) {
 	}
 	clearing = true;
 
+	GDScriptInlineCache::invalidate_all();
+
 	ClearData data;
 	ClearData *clear_data = p_clear_data;
 	bool is_root = false;
@@ -1551,7 +1565,11 @@ void GDScript::clear(ClearData *p_clear_data) {
 		}
 	}
 
-	RBSet<GDScript *> must_clear_dependencies = get_must_clear_dependencies();
+	// An export copy doesn't own its dependencies, nor the cache entries of its path.
+	RBSet<GDScript *> must_clear_dependencies;
+	if (!export_only) {
+		must_clear_dependencies = get_must_clear_dependencies();
+	}
 	for (GDScript *E : must_clear_dependencies) {
 		clear_data->scripts.insert(E);
 		E->clear(clear_data);
@@ -1606,7 +1624,7 @@ void GDScript::clear(ClearData *p_clear_data) {
 		}
 		for (Ref<Script> &E : clear_data->scripts) {
 			Ref<GDScript> gdscr = E;
-			if (gdscr.is_valid()) {
+			if (gdscr.is_valid() && !export_only) {
 				GDScriptCache::remove_script(gdscr->get_path());
 			}
 		}
@@ -1620,6 +1638,8 @@ GDScript::~GDScript() {
 	}
 	destructing = true;
 
+	GDScriptInlineCache::invalidate_all();
+
 	if (is_print_verbose_enabled()) {
 		MutexLock lock(func_ptrs_to_update_mutex);
 		if (!func_ptrs_to_update.is_empty()) {
@@ -2272,6 +2292,9 @@ String GDScriptLanguage::get_extension() const {
 }
 
 void GDScriptLanguage::finish() {
+	// Saves the results when started with `--profile-gdscript`.
+	GDScriptSamplingProfiler::stop();
+
 	_call_stack.free();
 
 	// Clear the cache before parsing the script_list
@@ -2307,6 +2330,8 @@ void GDScriptLanguage::finish() {
 	}
 	script_list.clear();
 	function_list.clear();
+
+	GDScriptCoroutineFramePool::clear();
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -2583,10 +2608,16 @@ void GDScriptLanguage::reload_scripts(const Array &p_scripts, bool p_soft_reload
 		}
 	}
 
+	Vector<Ref<GDScript>> sources;
+	for (KeyValue<Ref<GDScript>, HashMap<ObjectID, List<Pair<StringName, Variant>>>> &E : to_reload) {
+		E.key->load_source_code(E.key->get_path());
+		sources.push_back(E.key);
+	}
+	GDScriptCache::parse_sources(sources);
+
 	for (KeyValue<Ref<GDScript>, HashMap<ObjectID, List<Pair<StringName, Variant>>>> &E : to_reload) {
 		Ref<GDScript> scr = E.key;
 		print_verbose("GDScript: Reloading: " + scr->get_path());
-		scr->load_source_code(scr->get_path());
 		scr->reload(p_soft_reload);
 
 		//restore state if saved
@@ -2631,6 +2662,8 @@ void GDScriptLanguage::reload_scripts(const Array &p_scripts, bool p_soft_reload
 		//if instance states were saved, set them!
 	}
 
+	GDScriptCache::clear_parsed_sources();
+
 #endif
 }
 
@@ -2885,6 +2918,10 @@ GDScriptLanguage::GDScriptLanguage() {
 		_debug_max_call_stack = 0;
 	}
 
+	GDScriptJIT::set_mode((GDScriptJIT::Mode)(int)GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "gdscript/jit/mode", PROPERTY_HINT_ENUM, "Disabled,Hot Functions,All Functions"), 0));
+	GDScriptJIT::set_hot_call_threshold(GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "gdscript/jit/hot_call_threshold", PROPERTY_HINT_RANGE, "1,100000,1,or_greater"), 1000));
+	GLOBAL_DEF_RST("gdscript/compilation/compile_on_startup", false);
+
 #ifdef DEBUG_ENABLED
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
 	GLOBAL_DEF("debug/gdscript/warnings/exclude_addons", true);
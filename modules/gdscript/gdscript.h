@@ -90,6 +90,9 @@ class GDScript : public Script {
 	friend class GDScriptLambdaSelfCallable;
 	friend class GDScriptLanguage;
 	friend struct GDScriptUtilityFunctionsDefinitions;
+	friend class GDScriptBytecodeCache;
+	friend class GDScriptCache;
+	friend class GDScriptInlineCache;
 
 	Ref<GDScriptNativeClass> native;
 	Ref<GDScript> base;
@@ -177,6 +180,8 @@ private:
 	RBSet<Object *> instances;
 	bool destructing = false;
 	bool clearing = false;
+	// Set on the copies the bytecode cache compiles for release exports, which share their path with the editor's script.
+	bool export_only = false;
 	//exported members
 	String source;
 	Vector<uint8_t> binary_tokens;
@@ -351,6 +356,7 @@ public:
 class GDScriptInstance : public ScriptInstance {
 	friend class GDScript;
 	friend class GDScriptFunction;
+	friend class GDScriptInlineCache;
 	friend class GDScriptLambdaCallable;
 	friend class GDScriptLambdaSelfCallable;
 	friend class GDScriptCompiler;
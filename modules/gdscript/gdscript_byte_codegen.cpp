@@ -31,6 +31,7 @@
 #include "gdscript_byte_codegen.h"
 
 #include "gdscript.h"
+#include "gdscript_inline_cache.h"
 
 #include "core/debugger/engine_debugger.h"
 
@@ -47,6 +48,7 @@ uint32_t GDScriptByteCodeGenerator::add_parameter(const StringName &p_name, bool
 uint32_t GDScriptByteCodeGenerator::add_local(const StringName &p_name, const GDScriptDataType &p_type) {
 	int stack_pos = locals.size() + GDScriptFunction::FIXED_ADDRESSES_MAX;
 	locals.push_back(StackSlot(p_type.builtin_type, p_type.can_contain_object()));
+	initialized_locals.erase(stack_pos);
 	add_stack_identifier(p_name, stack_pos);
 	return stack_pos;
 }
@@ -152,6 +154,7 @@ void GDScriptByteCodeGenerator::start_parameters() {
 	if (function->_default_arg_count > 0) {
 		append(GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT);
 		function->default_arguments.push_back(opcodes.size());
+		last_jump_target = opcodes.size();
 	}
 }
 
@@ -395,6 +398,14 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		function->_lambdas_count = 0;
 	}
 
+	if (inline_cache_count) {
+		function->_inline_cache_count = inline_cache_count;
+		function->_inline_caches_ptr = memnew_arr(GDScriptInlineCache, inline_cache_count);
+	} else {
+		function->_inline_cache_count = 0;
+		function->_inline_caches_ptr = nullptr;
+	}
+
 	if (debug_stack) {
 		function->stack_debug = stack_debug;
 	}
@@ -431,6 +442,98 @@ void GDScriptByteCodeGenerator::set_initial_line(int p_line) {
 #define IS_BUILTIN_TYPE(m_var, m_type) \
 	(m_var.type.has_type && m_var.type.kind == GDScriptDataType::BUILTIN && m_var.type.builtin_type == m_type && m_type != Variant::NIL)
 
+// Returns the position of the validated operator that was just written into `p_result`, or -1 if it can't be fused
+// with the next instruction. Fusing is not possible if anything was emitted after the operator or if a jump lands
+// between them.
+int GDScriptByteCodeGenerator::get_fusable_operator(const Address &p_result) const {
+	if (last_operator_pos < 0 || last_operator_pos + 5 != opcodes.size() || last_jump_target > last_operator_pos) {
+		return -1;
+	}
+	if (p_result.mode != Address::TEMPORARY) {
+		return -1;
+	}
+	const Vector<int> &indices = temporaries[p_result.address].bytecode_indices;
+	if (indices.is_empty() || indices[indices.size() - 1] != last_operator_pos + 3) {
+		return -1;
+	}
+	return last_operator_pos;
+}
+
+// Makes the last validated operator write its result straight into `p_target` instead of going through a temporary.
+bool GDScriptByteCodeGenerator::fuse_operator_target(const Address &p_target, const Address &p_source) {
+	int operator_pos = get_fusable_operator(p_source);
+	if (operator_pos < 0) {
+		return false;
+	}
+
+	// Validated evaluators expect the result storage to already hold the result type. Containers are
+	// also excluded since their evaluators build the result in place, which breaks if it aliases an operand.
+	if (!HAS_BUILTIN_TYPE(p_target) || p_target.type.builtin_type != last_operator_result_type || last_operator_result_type == Variant::NIL || last_operator_result_type >= Variant::OBJECT) {
+		return false;
+	}
+
+	switch (p_target.mode) {
+		case Address::LOCAL_VARIABLE:
+			// The stack slot may still hold a value from a previous scope until the declaration is reached.
+			if (!initialized_locals.has(p_target.address)) {
+				return false;
+			}
+			break;
+		case Address::FUNCTION_PARAMETER:
+			// Typed arguments are converted when the function is called.
+			break;
+		default:
+			// Members may be used before the implicit initializer constructs them.
+			return false;
+	}
+
+	Vector<int> &indices = temporaries.write[p_source.address].bytecode_indices;
+	indices.resize(indices.size() - 1);
+	opcodes.write[operator_pos + 3] = address_of(p_target);
+	last_operator_pos = -1;
+	return true;
+}
+
+// Returns the compare-and-jump opcode for a typed int or float comparison, or the validated one for anything else.
+static GDScriptFunction::Opcode get_operator_jump_opcode(int p_operator_opcode, bool p_jump_if) {
+	switch (p_operator_opcode) {
+#define TYPED_JUMP(m_name)                          \
+	case GDScriptFunction::OPCODE_OPERATOR_##m_name: \
+		return p_jump_if ? GDScriptFunction::OPCODE_OPERATOR_##m_name##_JUMP_IF : GDScriptFunction::OPCODE_OPERATOR_##m_name##_JUMP_IF_NOT;
+		TYPED_JUMP(EQUAL_INT)
+		TYPED_JUMP(NOT_EQUAL_INT)
+		TYPED_JUMP(LESS_INT)
+		TYPED_JUMP(LESS_EQUAL_INT)
+		TYPED_JUMP(GREATER_INT)
+		TYPED_JUMP(GREATER_EQUAL_INT)
+		TYPED_JUMP(EQUAL_FLOAT)
+		TYPED_JUMP(NOT_EQUAL_FLOAT)
+		TYPED_JUMP(LESS_FLOAT)
+		TYPED_JUMP(LESS_EQUAL_FLOAT)
+		TYPED_JUMP(GREATER_FLOAT)
+		TYPED_JUMP(GREATER_EQUAL_FLOAT)
+#undef TYPED_JUMP
+		default:
+			return p_jump_if ? GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF : GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT;
+	}
+}
+
+// Writes a conditional jump and returns the position of its target, to be patched. If the condition was
+// just computed by a validated or typed operator, the jump is folded into it.
+int GDScriptByteCodeGenerator::append_conditional_jump(GDScriptFunction::Opcode p_jump_opcode, const Address &p_condition) {
+	int operator_pos = get_fusable_operator(p_condition);
+	if (operator_pos >= 0) {
+		opcodes.write[operator_pos] = get_operator_jump_opcode(opcodes[operator_pos], p_jump_opcode == GDScriptFunction::OPCODE_JUMP_IF);
+		last_operator_pos = -1;
+	} else {
+		append_opcode(p_jump_opcode);
+		append(p_condition);
+	}
+	int jump_pos = opcodes.size();
+	append(0); // Jump target, will be patched.
+	return jump_pos;
+}
+
 void GDScriptByteCodeGenerator::write_type_adjust(const Address &p_target, Variant::Type p_new_type) {
 	switch (p_new_type) {
 		case Variant::BOOL:
@@ -559,6 +662,8 @@ void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, Variant::NIL);
 
+		last_operator_pos = opcodes.size();
+		last_operator_result_type = Variant::get_operator_return_type(p_operator, p_left_operand.type.builtin_type, Variant::NIL);
 		append_opcode(GDScriptFunction::OPCODE_OPERATOR_VALIDATED);
 		append(p_left_operand);
 		append(Address());
@@ -584,11 +689,105 @@ void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 	}
 }
 
+// Returns the opcode operating directly on the payloads of typed numeric operands, if there's one for this operation.
+static GDScriptFunction::Opcode get_typed_operator_opcode(Variant::Operator p_operator, Variant::Type p_left_type, Variant::Type p_right_type) {
+	if (p_left_type == Variant::INT && p_right_type == Variant::INT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_INT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT;
+			case Variant::OP_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_EQUAL_INT;
+			case Variant::OP_NOT_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_INT;
+			case Variant::OP_LESS:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_INT;
+			case Variant::OP_LESS_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_INT;
+			case Variant::OP_GREATER:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_INT;
+			case Variant::OP_GREATER_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_INT;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::FLOAT && p_right_type == Variant::FLOAT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT;
+			case Variant::OP_DIVIDE:
+				return GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT;
+			case Variant::OP_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_EQUAL_FLOAT;
+			case Variant::OP_NOT_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_NOT_EQUAL_FLOAT;
+			case Variant::OP_LESS:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_FLOAT;
+			case Variant::OP_LESS_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_EQUAL_FLOAT;
+			case Variant::OP_GREATER:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_FLOAT;
+			case Variant::OP_GREATER_EQUAL:
+				return GDScriptFunction::OPCODE_OPERATOR_GREATER_EQUAL_FLOAT;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::VECTOR2 && p_right_type == Variant::VECTOR2) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR2;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR2;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR2;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::VECTOR2 && p_right_type == Variant::FLOAT) {
+		switch (p_operator) {
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT;
+			case Variant::OP_DIVIDE:
+				return GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::VECTOR3 && p_right_type == Variant::VECTOR3) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR3;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR3;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::VECTOR3 && p_right_type == Variant::FLOAT) {
+		switch (p_operator) {
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT;
+			case Variant::OP_DIVIDE:
+				return GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT;
+			default:
+				break;
+		}
+	}
+	return GDScriptFunction::OPCODE_OPERATOR_VALIDATED;
+}
+
 void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
 	// Avoid validated evaluator for modulo and division when operands are int, since there's no check for division by zero.
 	if (HAS_BUILTIN_TYPE(p_left_operand) && HAS_BUILTIN_TYPE(p_right_operand) && ((p_operator != Variant::OP_DIVIDE && p_operator != Variant::OP_MODULE) || p_left_operand.type.builtin_type != Variant::INT || p_right_operand.type.builtin_type != Variant::INT)) {
+		Variant::Type result_type = Variant::get_operator_return_type(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 		if (p_target.mode == Address::TEMPORARY) {
-			Variant::Type result_type = Variant::get_operator_return_type(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 			Variant::Type temp_type = temporaries[p_target.address].type;
 			if (result_type != temp_type) {
 				write_type_adjust(p_target, result_type);
@@ -598,11 +797,13 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
-		append_opcode(GDScriptFunction::OPCODE_OPERATOR_VALIDATED);
+		last_operator_pos = opcodes.size();
+		last_operator_result_type = result_type;
+		append_opcode(get_typed_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type));
 		append(p_left_operand);
 		append(p_right_operand);
 		append(p_target);
-		append(op_func);
+		append(op_func); // Also kept by typed operators, for disassembly and fusing with jumps.
 #ifdef DEBUG_ENABLED
 		add_debug_name(operator_names, get_operation_pos(op_func), Variant::get_operator_name(p_operator));
 #endif
@@ -664,17 +865,11 @@ void GDScriptByteCodeGenerator::write_type_test(const Address &p_target, const A
 }
 
 void GDScriptByteCodeGenerator::write_and_left_operand(const Address &p_left_operand) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_left_operand);
-	logic_op_jump_pos1.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	logic_op_jump_pos1.push_back(append_conditional_jump(GDScriptFunction::OPCODE_JUMP_IF_NOT, p_left_operand));
 }
 
 void GDScriptByteCodeGenerator::write_and_right_operand(const Address &p_right_operand) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_right_operand);
-	logic_op_jump_pos2.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	logic_op_jump_pos2.push_back(append_conditional_jump(GDScriptFunction::OPCODE_JUMP_IF_NOT, p_right_operand));
 }
 
 void GDScriptByteCodeGenerator::write_end_and(const Address &p_target) {
@@ -694,17 +889,11 @@ void GDScriptByteCodeGenerator::write_end_and(const Address &p_target) {
 }
 
 void GDScriptByteCodeGenerator::write_or_left_operand(const Address &p_left_operand) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF);
-	append(p_left_operand);
-	logic_op_jump_pos1.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	logic_op_jump_pos1.push_back(append_conditional_jump(GDScriptFunction::OPCODE_JUMP_IF, p_left_operand));
 }
 
 void GDScriptByteCodeGenerator::write_or_right_operand(const Address &p_right_operand) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF);
-	append(p_right_operand);
-	logic_op_jump_pos2.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	logic_op_jump_pos2.push_back(append_conditional_jump(GDScriptFunction::OPCODE_JUMP_IF, p_right_operand));
 }
 
 void GDScriptByteCodeGenerator::write_end_or(const Address &p_target) {
@@ -728,10 +917,7 @@ void GDScriptByteCodeGenerator::write_start_ternary(const Address &p_target) {
 }
 
 void GDScriptByteCodeGenerator::write_ternary_condition(const Address &p_condition) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_condition);
-	ternary_jump_fail_pos.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	ternary_jump_fail_pos.push_back(append_conditional_jump(GDScriptFunction::OPCODE_JUMP_IF_NOT, p_condition));
 }
 
 void GDScriptByteCodeGenerator::write_ternary_true_expr(const Address &p_expr) {
@@ -759,13 +945,41 @@ void GDScriptByteCodeGenerator::write_end_ternary() {
 	ternary_result.pop_back();
 }
 
+// Packed arrays have their own indexed opcodes, which access the buffer without calling the validated getter or setter.
+static GDScriptFunction::Opcode get_indexed_opcode(Variant::Type p_type, bool p_set) {
+	switch (p_type) {
+		case Variant::PACKED_BYTE_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_BYTE_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_BYTE_ARRAY;
+		case Variant::PACKED_INT32_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_INT32_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_INT32_ARRAY;
+		case Variant::PACKED_INT64_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_INT64_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_INT64_ARRAY;
+		case Variant::PACKED_FLOAT32_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_FLOAT32_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_FLOAT32_ARRAY;
+		case Variant::PACKED_FLOAT64_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_FLOAT64_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_FLOAT64_ARRAY;
+		case Variant::PACKED_STRING_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_STRING_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_STRING_ARRAY;
+		case Variant::PACKED_VECTOR2_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_VECTOR2_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_VECTOR2_ARRAY;
+		case Variant::PACKED_VECTOR3_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_VECTOR3_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_VECTOR3_ARRAY;
+		case Variant::PACKED_COLOR_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_COLOR_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_COLOR_ARRAY;
+		case Variant::PACKED_VECTOR4_ARRAY:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_PACKED_VECTOR4_ARRAY : GDScriptFunction::OPCODE_GET_INDEXED_PACKED_VECTOR4_ARRAY;
+		default:
+			return p_set ? GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED : GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED;
+	}
+}
+
 void GDScriptByteCodeGenerator::write_set(const Address &p_target, const Address &p_index, const Address &p_source) {
 	if (HAS_BUILTIN_TYPE(p_target)) {
 		if (IS_BUILTIN_TYPE(p_index, Variant::INT) && Variant::get_member_validated_indexed_setter(p_target.type.builtin_type) &&
 				IS_BUILTIN_TYPE(p_source, Variant::get_indexed_element_type(p_target.type.builtin_type))) {
 			// Use indexed setter instead.
 			Variant::ValidatedIndexedSetter setter = Variant::get_member_validated_indexed_setter(p_target.type.builtin_type);
-			append_opcode(GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED);
+			append_opcode(get_indexed_opcode(p_target.type.builtin_type, true));
 			append(p_target);
 			append(p_index);
 			append(p_source);
@@ -793,7 +1007,7 @@ void GDScriptByteCodeGenerator::write_get(const Address &p_target, const Address
 		if (IS_BUILTIN_TYPE(p_index, Variant::INT) && Variant::get_member_validated_indexed_getter(p_source.type.builtin_type)) {
 			// Use indexed getter instead.
 			Variant::ValidatedIndexedGetter getter = Variant::get_member_validated_indexed_getter(p_source.type.builtin_type);
-			append_opcode(GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED);
+			append_opcode(get_indexed_opcode(p_source.type.builtin_type, false));
 			append(p_source);
 			append(p_index);
 			append(p_target);
@@ -832,6 +1046,7 @@ void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 	append(p_target);
 	append(p_source);
 	append(p_name);
+	append(inline_cache_count++);
 }
 
 void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -850,6 +1065,7 @@ void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append(inline_cache_count++);
 }
 
 void GDScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
@@ -924,9 +1140,17 @@ void GDScriptByteCodeGenerator::write_assign_with_conversion(const Address &p_ta
 			append(p_source);
 		}
 	}
+
+	if (p_target.mode == Address::LOCAL_VARIABLE) {
+		initialized_locals.insert(p_target.address);
+	}
 }
 
 void GDScriptByteCodeGenerator::write_assign(const Address &p_target, const Address &p_source) {
+	if (fuse_operator_target(p_target, p_source)) {
+		return;
+	}
+
 	if (p_target.type.kind == GDScriptDataType::BUILTIN && p_target.type.builtin_type == Variant::ARRAY && p_target.type.has_container_element_type(0)) {
 		const GDScriptDataType &element_type = p_target.type.get_container_element_type(0);
 		append_opcode(GDScriptFunction::OPCODE_ASSIGN_TYPED_ARRAY);
@@ -946,6 +1170,10 @@ void GDScriptByteCodeGenerator::write_assign(const Address &p_target, const Addr
 		append(p_target);
 		append(p_source);
 	}
+
+	if (p_target.mode == Address::LOCAL_VARIABLE) {
+		initialized_locals.insert(p_target.address);
+	}
 }
 
 void GDScriptByteCodeGenerator::write_assign_null(const Address &p_target) {
@@ -964,17 +1192,21 @@ void GDScriptByteCodeGenerator::write_assign_false(const Address &p_target) {
 }
 
 void GDScriptByteCodeGenerator::write_assign_default_parameter(const Address &p_dst, const Address &p_src, bool p_use_conversion) {
+	// The parameter isn't constructed yet, so the default value can't be written into it directly.
+	last_operator_pos = -1;
 	if (p_use_conversion) {
 		write_assign_with_conversion(p_dst, p_src);
 	} else {
 		write_assign(p_dst, p_src);
 	}
 	function->default_arguments.push_back(opcodes.size());
+	last_jump_target = opcodes.size();
 }
 
 void GDScriptByteCodeGenerator::write_store_global(const Address &p_dst, int p_global_index) {
 	append_opcode(GDScriptFunction::OPCODE_STORE_GLOBAL);
 	append(p_dst);
+	function->global_index_positions.push_back(opcodes.size());
 	append(p_global_index);
 }
 
@@ -1040,6 +1272,7 @@ void GDScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_count++);
 	ct.cleanup();
 }
 
@@ -1065,6 +1298,7 @@ void GDScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_count++);
 	ct.cleanup();
 }
 
@@ -1299,6 +1533,7 @@ void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_count++);
 	ct.cleanup();
 }
 
@@ -1312,6 +1547,7 @@ void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_count++);
 	ct.cleanup();
 }
 
@@ -1325,6 +1561,7 @@ void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_targ
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_count++);
 	ct.cleanup();
 }
 
@@ -1442,10 +1679,7 @@ void GDScriptByteCodeGenerator::write_await(const Address &p_target, const Addre
 }
 
 void GDScriptByteCodeGenerator::write_if(const Address &p_condition) {
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_condition);
-	if_jmp_addrs.push_back(opcodes.size());
-	append(0); // Jump destination, will be patched.
+	if_jmp_addrs.push_back(append_conditional_jump(GDScriptFunction::OPCODE_JUMP_IF_NOT, p_condition));
 }
 
 void GDScriptByteCodeGenerator::write_else() {
@@ -1607,6 +1841,7 @@ void GDScriptByteCodeGenerator::write_for(const Address &p_variable, bool p_use_
 
 	// Next iteration.
 	int continue_addr = opcodes.size();
+	last_jump_target = continue_addr;
 	continue_addrs.push_back(continue_addr);
 	append_opcode(iterate_opcode);
 	append(counter);
@@ -1649,14 +1884,12 @@ void GDScriptByteCodeGenerator::write_endfor() {
 void GDScriptByteCodeGenerator::start_while_condition() {
 	current_breaks_to_patch.push_back(List<int>());
 	continue_addrs.push_back(opcodes.size());
+	last_jump_target = opcodes.size();
 }
 
 void GDScriptByteCodeGenerator::write_while(const Address &p_condition) {
 	// Condition check.
-	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-	append(p_condition);
-	while_jmp_addrs.push_back(opcodes.size());
-	append(0); // End of loop address, will be patched.
+	while_jmp_addrs.push_back(append_conditional_jump(GDScriptFunction::OPCODE_JUMP_IF_NOT, p_condition));
 }
 
 void GDScriptByteCodeGenerator::write_endwhile() {
@@ -1824,6 +2057,7 @@ void GDScriptByteCodeGenerator::clear_address(const Address &p_address) {
 
 	if (p_address.mode == Address::LOCAL_VARIABLE) {
 		dirty_locals.erase(p_address.address);
+		initialized_locals.insert(p_address.address);
 	}
 }
 
@@ -85,6 +85,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	Vector<StackSlot> locals;
 	HashSet<int> dirty_locals;
+	HashSet<int> initialized_locals; // Locals already written since declared, so typed ones hold their exact type.
 
 	Vector<StackSlot> temporaries;
 	List<int> used_temporaries;
@@ -98,6 +99,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	int max_locals = 0;
 	int current_line = 0;
 	int instr_args_max = 0;
+	int inline_cache_count = 0;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
@@ -158,6 +160,11 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	List<List<int>> current_breaks_to_patch;
 
+	// Used to fuse a validated operator with the instruction consuming its result.
+	int last_operator_pos = -1;
+	Variant::Type last_operator_result_type = Variant::NIL;
+	int last_jump_target = 0;
+
 	void add_stack_identifier(const StringName &p_id, int p_stackpos) {
 		if (locals.size() > max_locals) {
 			max_locals = locals.size();
@@ -449,8 +456,13 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	void patch_jump(int p_address) {
 		opcodes.write[p_address] = opcodes.size();
+		last_jump_target = opcodes.size();
 	}
 
+	int get_fusable_operator(const Address &p_result) const;
+	bool fuse_operator_target(const Address &p_target, const Address &p_source);
+	int append_conditional_jump(GDScriptFunction::Opcode p_jump_opcode, const Address &p_condition);
+
 public:
 	virtual uint32_t add_parameter(const StringName &p_name, bool p_is_optional, const GDScriptDataType &p_type) override;
 	virtual uint32_t add_local(const StringName &p_name, const GDScriptDataType &p_type) override;
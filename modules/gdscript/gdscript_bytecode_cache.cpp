@@ -0,0 +1,1814 @@
+/**************************************************************************/
+/*  gdscript_bytecode_cache.cpp                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_bytecode_cache.h"
+
+#include "gdscript_analyzer.h"
+#include "gdscript_cache.h"
+#include "gdscript_compiler.h"
+#include "gdscript_inline_cache.h"
+#include "gdscript_parser.h"
+
+#include "core/io/compression.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rb_map.h"
+#include "core/version.h"
+
+#define BYTECODE_CACHE_VERSION 2
+
+enum {
+	VARIANT_VALUE,
+	VARIANT_ARRAY,
+	VARIANT_DICTIONARY,
+	VARIANT_NULL_OBJECT,
+	VARIANT_SCRIPT,
+	VARIANT_GLOBAL,
+	VARIANT_RESOURCE,
+	VARIANT_EMPTY,
+};
+
+enum {
+	SCRIPT_REF_NONE,
+	SCRIPT_REF_GDSCRIPT,
+	SCRIPT_REF_RESOURCE,
+};
+
+struct GDScriptBytecodeCache::Writer {
+	LocalVector<uint8_t> data;
+	HashMap<String, uint32_t> string_map;
+	Vector<String> strings;
+	String root_path;
+	String error;
+
+	// Reverse lookup of the pointers stored in functions, built on first use.
+	bool symbols_built = false;
+	RBMap<Variant::ValidatedOperatorEvaluator, uint32_t> operators;
+	RBMap<Variant::ValidatedSetter, Pair<Variant::Type, StringName>> setters;
+	RBMap<Variant::ValidatedGetter, Pair<Variant::Type, StringName>> getters;
+	RBMap<Variant::ValidatedKeyedSetter, Variant::Type> keyed_setters;
+	RBMap<Variant::ValidatedKeyedGetter, Variant::Type> keyed_getters;
+	RBMap<Variant::ValidatedIndexedSetter, Variant::Type> indexed_setters;
+	RBMap<Variant::ValidatedIndexedGetter, Variant::Type> indexed_getters;
+	RBMap<Variant::ValidatedBuiltInMethod, Pair<Variant::Type, StringName>> builtin_methods;
+	RBMap<Variant::ValidatedConstructor, Pair<Variant::Type, int>> constructors;
+	RBMap<Variant::ValidatedUtilityFunction, StringName> utilities;
+	RBMap<GDScriptUtilityFunctions::FunctionPtr, StringName> gds_utilities;
+	HashMap<ObjectID, StringName> global_objects;
+	HashMap<int, StringName> global_indices;
+
+	void put_u8(uint8_t p_value) {
+		data.push_back(p_value);
+	}
+
+	void put_u32(uint32_t p_value) {
+		uint32_t pos = data.size();
+		data.resize(pos + 4);
+		encode_uint32(p_value, &data[pos]);
+	}
+
+	void put_i32(int32_t p_value) {
+		put_u32((uint32_t)p_value);
+	}
+
+	void put_string(const String &p_string) {
+		HashMap<String, uint32_t>::ConstIterator E = string_map.find(p_string);
+		if (E) {
+			put_u32(E->value);
+			return;
+		}
+		uint32_t index = strings.size();
+		string_map.insert(p_string, index);
+		strings.push_back(p_string);
+		put_u32(index);
+	}
+
+	bool fail(const String &p_error) {
+		if (error.is_empty()) {
+			error = p_error;
+		}
+		return false;
+	}
+
+	void build_symbols() {
+		if (symbols_built) {
+			return;
+		}
+		symbols_built = true;
+
+		for (int type = 0; type < Variant::VARIANT_MAX; type++) {
+			Variant::Type t = (Variant::Type)type;
+
+			for (int op = 0; op < Variant::OP_MAX; op++) {
+				for (int type_b = 0; type_b < Variant::VARIANT_MAX; type_b++) {
+					Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator((Variant::Operator)op, t, (Variant::Type)type_b);
+					if (evaluator && !operators.has(evaluator)) {
+						operators.insert(evaluator, (op << 16) | (type << 8) | type_b);
+					}
+				}
+			}
+
+			List<StringName> members;
+			Variant::get_member_list(t, &members);
+			for (const StringName &member : members) {
+				Variant::ValidatedSetter setter = Variant::get_member_validated_setter(t, member);
+				if (setter) {
+					setters.insert(setter, Pair<Variant::Type, StringName>(t, member));
+				}
+				Variant::ValidatedGetter getter = Variant::get_member_validated_getter(t, member);
+				if (getter) {
+					getters.insert(getter, Pair<Variant::Type, StringName>(t, member));
+				}
+			}
+
+			if (Variant::get_member_validated_keyed_setter(t)) {
+				keyed_setters.insert(Variant::get_member_validated_keyed_setter(t), t);
+			}
+			if (Variant::get_member_validated_keyed_getter(t)) {
+				keyed_getters.insert(Variant::get_member_validated_keyed_getter(t), t);
+			}
+			if (Variant::get_member_validated_indexed_setter(t)) {
+				indexed_setters.insert(Variant::get_member_validated_indexed_setter(t), t);
+			}
+			if (Variant::get_member_validated_indexed_getter(t)) {
+				indexed_getters.insert(Variant::get_member_validated_indexed_getter(t), t);
+			}
+
+			List<StringName> methods;
+			Variant::get_builtin_method_list(t, &methods);
+			for (const StringName &method : methods) {
+				Variant::ValidatedBuiltInMethod builtin_method = Variant::get_validated_builtin_method(t, method);
+				if (builtin_method) {
+					builtin_methods.insert(builtin_method, Pair<Variant::Type, StringName>(t, method));
+				}
+			}
+
+			for (int i = 0; i < Variant::get_constructor_count(t); i++) {
+				Variant::ValidatedConstructor constructor = Variant::get_validated_constructor(t, i);
+				if (constructor) {
+					constructors.insert(constructor, Pair<Variant::Type, int>(t, i));
+				}
+			}
+		}
+
+		List<StringName> utility_functions;
+		Variant::get_utility_function_list(&utility_functions);
+		for (const StringName &function : utility_functions) {
+			utilities.insert(Variant::get_validated_utility_function(function), function);
+		}
+
+		List<StringName> gds_utility_functions;
+		GDScriptUtilityFunctions::get_function_list(&gds_utility_functions);
+		for (const StringName &function : gds_utility_functions) {
+			gds_utilities.insert(GDScriptUtilityFunctions::get_function(function), function);
+		}
+
+		GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+		for (const KeyValue<StringName, int> &E : language->get_global_map()) {
+			global_indices.insert(E.value, E.key);
+			const Variant &global = language->get_global_array()[E.value];
+			if (global.get_type() == Variant::OBJECT && global.get_validated_object()) {
+				global_objects.insert(global.get_validated_object()->get_instance_id(), E.key);
+			}
+		}
+	}
+};
+
+struct GDScriptBytecodeCache::Reader {
+	const uint8_t *ptr = nullptr;
+	uint32_t size = 0;
+	uint32_t pos = 0;
+	bool failed = false;
+	Vector<String> strings;
+	LocalVector<StringName> names;
+	GDScript *root = nullptr;
+	String error;
+
+	Error init(const Vector<uint8_t> &p_contents) {
+		ptr = p_contents.ptr();
+		size = p_contents.size();
+		pos = 0;
+
+		uint32_t string_count = get_count();
+		strings.resize(string_count);
+		names.resize(string_count);
+		for (uint32_t i = 0; i < string_count; i++) {
+			uint32_t len = get_count();
+			if (failed) {
+				break;
+			}
+			strings.write[i].parse_utf8((const char *)ptr + pos, len);
+			pos += len;
+		}
+		return failed ? ERR_INVALID_DATA : OK;
+	}
+
+	_FORCE_INLINE_ bool has(uint32_t p_bytes) {
+		if (failed || p_bytes > size - pos) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+
+	uint8_t get_u8() {
+		if (!has(1)) {
+			return 0;
+		}
+		return ptr[pos++];
+	}
+
+	uint32_t get_u32() {
+		if (!has(4)) {
+			return 0;
+		}
+		uint32_t value = decode_uint32(ptr + pos);
+		pos += 4;
+		return value;
+	}
+
+	int32_t get_i32() {
+		return (int32_t)get_u32();
+	}
+
+	// Every element takes at least one byte, so bigger counts can only come from corrupted data.
+	uint32_t get_count() {
+		uint32_t count = get_u32();
+		if (!failed && count > size - pos) {
+			failed = true;
+		}
+		return failed ? 0 : count;
+	}
+
+	Variant::Type get_type() {
+		uint8_t type = get_u8();
+		if (type >= Variant::VARIANT_MAX) {
+			failed = true;
+			return Variant::NIL;
+		}
+		return (Variant::Type)type;
+	}
+
+	String get_string() {
+		uint32_t index = get_u32();
+		if (failed || index >= (uint32_t)strings.size()) {
+			failed = true;
+			return String();
+		}
+		return strings[index];
+	}
+
+	StringName get_name() {
+		uint32_t index = get_u32();
+		if (failed || index >= names.size()) {
+			failed = true;
+			return StringName();
+		}
+		if (names[index] == StringName() && !strings[index].is_empty()) {
+			names[index] = strings[index];
+		}
+		return names[index];
+	}
+
+	Error fail(const String &p_error) {
+		if (error.is_empty()) {
+			error = p_error;
+		}
+		return ERR_CANT_RESOLVE;
+	}
+};
+
+struct GDScriptBytecodeCache::ClassData {
+	GDScript *script = nullptr;
+	bool tool = false;
+	Ref<GDScriptNativeClass> native;
+	Ref<GDScript> base;
+	HashMap<StringName, GDScript::MemberInfo> member_indices;
+	HashSet<StringName> members;
+	HashMap<StringName, GDScript::MemberInfo> static_variables_indices;
+	HashMap<StringName, Variant> constants;
+	HashMap<StringName, MethodInfo> signals;
+	Dictionary rpc_config;
+	HashMap<StringName, GDScriptFunction *> member_functions;
+	GDScriptFunction *implicit_initializer = nullptr;
+	GDScriptFunction *implicit_ready = nullptr;
+	GDScriptFunction *static_initializer = nullptr;
+	HashMap<GDScriptFunction *, GDScript::LambdaInfo> lambda_info;
+
+	void free_functions() {
+		for (const KeyValue<StringName, GDScriptFunction *> &E : member_functions) {
+			memdelete(E.value);
+		}
+		member_functions.clear();
+		if (implicit_initializer) {
+			memdelete(implicit_initializer);
+			implicit_initializer = nullptr;
+		}
+		if (implicit_ready) {
+			memdelete(implicit_ready);
+			implicit_ready = nullptr;
+		}
+		if (static_initializer) {
+			memdelete(static_initializer);
+			static_initializer = nullptr;
+		}
+	}
+};
+
+uint32_t GDScriptBytecodeCache::_get_engine_hash(bool p_debug) {
+	uint32_t hash = hash_murmur3_one_32(BYTECODE_CACHE_VERSION);
+	hash = hash_murmur3_one_32(String(VERSION_FULL_BUILD).hash(), hash);
+	hash = hash_murmur3_one_32(String(VERSION_HASH).hash(), hash);
+	hash = hash_murmur3_one_32(GDScriptFunction::OPCODE_END, hash);
+	hash = hash_murmur3_one_32(Variant::VARIANT_MAX, hash);
+	hash = hash_murmur3_one_32(Variant::OP_MAX, hash);
+	hash = hash_murmur3_one_32(sizeof(real_t), hash);
+	// Debug builds emit line, breakpoint and assert opcodes that release builds must not run.
+	hash = hash_murmur3_one_32(p_debug ? 1 : 0, hash);
+	return hash_fmix32(hash);
+}
+
+uint32_t GDScriptBytecodeCache::get_engine_hash() {
+#ifdef DEBUG_ENABLED
+	return _get_engine_hash(true);
+#else
+	return _get_engine_hash(false);
+#endif
+}
+
+String GDScriptBytecodeCache::get_cache_path(const String &p_script_path) {
+	return p_script_path.get_basename() + ".gdbc";
+}
+
+/* Serialization */
+
+// Built-in resources can't be loaded on their own.
+static bool _is_loadable_path(const String &p_path) {
+	return !p_path.is_empty() && !p_path.contains("::");
+}
+
+bool GDScriptBytecodeCache::_write_variant(Writer &p_writer, const Variant &p_variant) {
+	switch (p_variant.get_type()) {
+		case Variant::OBJECT: {
+			Object *obj = p_variant.get_validated_object();
+			if (!obj) {
+				p_writer.put_u8(VARIANT_NULL_OBJECT);
+				return true;
+			}
+
+			const GDScript *gdscript = Object::cast_to<GDScript>(obj);
+			if (gdscript) {
+				p_writer.put_u8(VARIANT_SCRIPT);
+				return _write_script_ref(p_writer, gdscript);
+			}
+
+			p_writer.build_symbols();
+			HashMap<ObjectID, StringName>::ConstIterator E = p_writer.global_objects.find(obj->get_instance_id());
+			if (E) {
+				p_writer.put_u8(VARIANT_GLOBAL);
+				p_writer.put_string(E->value);
+				return true;
+			}
+
+			const Resource *res = Object::cast_to<Resource>(obj);
+			if (res && _is_loadable_path(res->get_path())) {
+				p_writer.put_u8(VARIANT_RESOURCE);
+				p_writer.put_string(res->get_path());
+				return true;
+			}
+
+			return p_writer.fail(vformat(R"(Constant object of class "%s" can't be referenced by path.)", obj->get_class()));
+		}
+		case Variant::ARRAY: {
+			Array array = p_variant;
+			p_writer.put_u8(VARIANT_ARRAY);
+			p_writer.put_u8(array.is_read_only());
+			p_writer.put_u8(array.get_typed_builtin());
+			p_writer.put_string(array.get_typed_class_name());
+			if (!_write_script_ref(p_writer, Object::cast_to<Script>(array.get_typed_script()))) {
+				return false;
+			}
+			p_writer.put_u32(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				if (!_write_variant(p_writer, array[i])) {
+					return false;
+				}
+			}
+			return true;
+		}
+		case Variant::DICTIONARY: {
+			Dictionary dict = p_variant;
+			p_writer.put_u8(VARIANT_DICTIONARY);
+			p_writer.put_u8(dict.is_read_only());
+			p_writer.put_u32(dict.size());
+			List<Variant> keys;
+			dict.get_key_list(&keys);
+			for (const Variant &key : keys) {
+				if (!_write_variant(p_writer, key) || !_write_variant(p_writer, dict[key])) {
+					return false;
+				}
+			}
+			return true;
+		}
+		case Variant::RID:
+		case Variant::CALLABLE:
+		case Variant::SIGNAL: {
+			// Only the empty defaults of typed variables are meaningful outside of this process.
+			if (p_variant.booleanize()) {
+				return p_writer.fail(vformat(R"(Constants of type "%s" can't be serialized.)", Variant::get_type_name(p_variant.get_type())));
+			}
+			p_writer.put_u8(VARIANT_EMPTY);
+			p_writer.put_u8(p_variant.get_type());
+			return true;
+		}
+		default: {
+			int len = 0;
+			Error err = encode_variant(p_variant, nullptr, len, false);
+			if (err != OK) {
+				return p_writer.fail("Error when trying to encode Variant.");
+			}
+			p_writer.put_u8(VARIANT_VALUE);
+			p_writer.put_u32(len);
+			uint32_t pos = p_writer.data.size();
+			p_writer.data.resize(pos + len);
+			encode_variant(p_variant, &p_writer.data[pos], len, false);
+			return true;
+		}
+	}
+}
+
+bool GDScriptBytecodeCache::_write_script_ref(Writer &p_writer, const Script *p_script) {
+	if (!p_script) {
+		p_writer.put_u8(SCRIPT_REF_NONE);
+		return true;
+	}
+
+	const GDScript *gdscript = Object::cast_to<GDScript>(p_script);
+	if (gdscript) {
+		String path = const_cast<GDScript *>(gdscript)->get_root_script()->path;
+		if (!_is_loadable_path(path)) {
+			return p_writer.fail(vformat(R"(Referenced class "%s" is not saved in its own file.)", gdscript->fully_qualified_name));
+		}
+		p_writer.put_u8(SCRIPT_REF_GDSCRIPT);
+		p_writer.put_string(path);
+		p_writer.put_string(gdscript->fully_qualified_name);
+		return true;
+	}
+
+	if (!_is_loadable_path(p_script->get_path())) {
+		return p_writer.fail("Referenced script is not saved in its own file.");
+	}
+	p_writer.put_u8(SCRIPT_REF_RESOURCE);
+	p_writer.put_string(p_script->get_path());
+	return true;
+}
+
+void GDScriptBytecodeCache::_write_property_info(Writer &p_writer, const PropertyInfo &p_info) {
+	p_writer.put_u8(p_info.type);
+	p_writer.put_string(p_info.name);
+	p_writer.put_string(p_info.class_name);
+	p_writer.put_u32(p_info.hint);
+	p_writer.put_string(p_info.hint_string);
+	p_writer.put_u32(p_info.usage);
+}
+
+bool GDScriptBytecodeCache::_write_method_info(Writer &p_writer, const MethodInfo &p_info) {
+	p_writer.put_string(p_info.name);
+	_write_property_info(p_writer, p_info.return_val);
+	p_writer.put_u32(p_info.flags);
+	p_writer.put_i32(p_info.id);
+	p_writer.put_u32(p_info.arguments.size());
+	for (const PropertyInfo &argument : p_info.arguments) {
+		_write_property_info(p_writer, argument);
+	}
+	p_writer.put_u32(p_info.default_arguments.size());
+	for (const Variant &default_argument : p_info.default_arguments) {
+		if (!_write_variant(p_writer, default_argument)) {
+			return false;
+		}
+	}
+	p_writer.put_i32(p_info.return_val_metadata);
+	p_writer.put_u32(p_info.arguments_metadata.size());
+	for (int metadata : p_info.arguments_metadata) {
+		p_writer.put_i32(metadata);
+	}
+	return true;
+}
+
+bool GDScriptBytecodeCache::_write_data_type(Writer &p_writer, const GDScriptDataType &p_type) {
+	p_writer.put_u8(p_type.has_type);
+	p_writer.put_u8(p_type.kind);
+	p_writer.put_u8(p_type.builtin_type);
+	p_writer.put_string(p_type.native_type);
+	if (p_type.kind == GDScriptDataType::SCRIPT || p_type.kind == GDScriptDataType::GDSCRIPT) {
+		if (!_write_script_ref(p_writer, p_type.script_type)) {
+			return false;
+		}
+	}
+	p_writer.put_u32(p_type.container_element_types.size());
+	for (const GDScriptDataType &element_type : p_type.container_element_types) {
+		if (!_write_data_type(p_writer, element_type)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GDScriptBytecodeCache::_write_member_info(Writer &p_writer, const GDScript::MemberInfo &p_info) {
+	p_writer.put_i32(p_info.index);
+	p_writer.put_string(p_info.setter);
+	p_writer.put_string(p_info.getter);
+	_write_property_info(p_writer, p_info.property_info);
+	return _write_data_type(p_writer, p_info.data_type);
+}
+
+bool GDScriptBytecodeCache::_write_function(Writer &p_writer, const GDScriptFunction *p_function) {
+	p_writer.put_string(p_function->name);
+	p_writer.put_u8(p_function->_static);
+	p_writer.put_u32(p_function->argument_types.size());
+	for (const GDScriptDataType &argument_type : p_function->argument_types) {
+		if (!_write_data_type(p_writer, argument_type)) {
+			return false;
+		}
+	}
+	if (!_write_data_type(p_writer, p_function->return_type) || !_write_method_info(p_writer, p_function->method_info) || !_write_variant(p_writer, p_function->rpc_config)) {
+		return false;
+	}
+
+	p_writer.put_i32(p_function->_initial_line);
+	p_writer.put_i32(p_function->_argument_count);
+	p_writer.put_i32(p_function->_stack_size);
+	p_writer.put_i32(p_function->_instruction_args_size);
+	p_writer.put_i32(p_function->_default_arg_count);
+	p_writer.put_u32(p_function->_inline_cache_count);
+
+	p_writer.put_u32(p_function->temporary_slots.size());
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		p_writer.put_i32(E.key);
+		p_writer.put_u8(E.value);
+	}
+
+	p_writer.put_u32(p_function->stack_debug.size());
+	for (const GDScriptFunction::StackDebug &sd : p_function->stack_debug) {
+		p_writer.put_i32(sd.line);
+		p_writer.put_i32(sd.pos);
+		p_writer.put_u8(sd.added);
+		p_writer.put_string(sd.identifier);
+	}
+
+	p_writer.put_u32(p_function->code.size());
+	for (int code : p_function->code) {
+		p_writer.put_i32(code);
+	}
+
+	p_writer.put_u32(p_function->default_arguments.size());
+	for (int default_argument : p_function->default_arguments) {
+		p_writer.put_i32(default_argument);
+	}
+
+	p_writer.put_u32(p_function->constants.size());
+	for (const Variant &constant : p_function->constants) {
+		if (!_write_variant(p_writer, constant)) {
+			return false;
+		}
+	}
+
+	p_writer.put_u32(p_function->global_names.size());
+	for (const StringName &global_name : p_function->global_names) {
+		p_writer.put_string(global_name);
+	}
+
+	p_writer.build_symbols();
+
+	p_writer.put_u32(p_function->operator_funcs.size());
+	for (Variant::ValidatedOperatorEvaluator evaluator : p_function->operator_funcs) {
+		RBMap<Variant::ValidatedOperatorEvaluator, uint32_t>::Element *E = p_writer.operators.find(evaluator);
+		if (!E) {
+			return p_writer.fail("Unknown operator evaluator.");
+		}
+		p_writer.put_u32(E->get());
+	}
+
+	p_writer.put_u32(p_function->setters.size());
+	for (Variant::ValidatedSetter setter : p_function->setters) {
+		RBMap<Variant::ValidatedSetter, Pair<Variant::Type, StringName>>::Element *E = p_writer.setters.find(setter);
+		if (!E) {
+			return p_writer.fail("Unknown member setter.");
+		}
+		p_writer.put_u8(E->get().first);
+		p_writer.put_string(E->get().second);
+	}
+
+	p_writer.put_u32(p_function->getters.size());
+	for (Variant::ValidatedGetter getter : p_function->getters) {
+		RBMap<Variant::ValidatedGetter, Pair<Variant::Type, StringName>>::Element *E = p_writer.getters.find(getter);
+		if (!E) {
+			return p_writer.fail("Unknown member getter.");
+		}
+		p_writer.put_u8(E->get().first);
+		p_writer.put_string(E->get().second);
+	}
+
+	p_writer.put_u32(p_function->keyed_setters.size());
+	for (Variant::ValidatedKeyedSetter keyed_setter : p_function->keyed_setters) {
+		RBMap<Variant::ValidatedKeyedSetter, Variant::Type>::Element *E = p_writer.keyed_setters.find(keyed_setter);
+		if (!E) {
+			return p_writer.fail("Unknown keyed setter.");
+		}
+		p_writer.put_u8(E->get());
+	}
+
+	p_writer.put_u32(p_function->keyed_getters.size());
+	for (Variant::ValidatedKeyedGetter keyed_getter : p_function->keyed_getters) {
+		RBMap<Variant::ValidatedKeyedGetter, Variant::Type>::Element *E = p_writer.keyed_getters.find(keyed_getter);
+		if (!E) {
+			return p_writer.fail("Unknown keyed getter.");
+		}
+		p_writer.put_u8(E->get());
+	}
+
+	p_writer.put_u32(p_function->indexed_setters.size());
+	for (Variant::ValidatedIndexedSetter indexed_setter : p_function->indexed_setters) {
+		RBMap<Variant::ValidatedIndexedSetter, Variant::Type>::Element *E = p_writer.indexed_setters.find(indexed_setter);
+		if (!E) {
+			return p_writer.fail("Unknown indexed setter.");
+		}
+		p_writer.put_u8(E->get());
+	}
+
+	p_writer.put_u32(p_function->indexed_getters.size());
+	for (Variant::ValidatedIndexedGetter indexed_getter : p_function->indexed_getters) {
+		RBMap<Variant::ValidatedIndexedGetter, Variant::Type>::Element *E = p_writer.indexed_getters.find(indexed_getter);
+		if (!E) {
+			return p_writer.fail("Unknown indexed getter.");
+		}
+		p_writer.put_u8(E->get());
+	}
+
+	p_writer.put_u32(p_function->builtin_methods.size());
+	for (Variant::ValidatedBuiltInMethod builtin_method : p_function->builtin_methods) {
+		RBMap<Variant::ValidatedBuiltInMethod, Pair<Variant::Type, StringName>>::Element *E = p_writer.builtin_methods.find(builtin_method);
+		if (!E) {
+			return p_writer.fail("Unknown built-in method.");
+		}
+		p_writer.put_u8(E->get().first);
+		p_writer.put_string(E->get().second);
+	}
+
+	p_writer.put_u32(p_function->constructors.size());
+	for (Variant::ValidatedConstructor constructor : p_function->constructors) {
+		RBMap<Variant::ValidatedConstructor, Pair<Variant::Type, int>>::Element *E = p_writer.constructors.find(constructor);
+		if (!E) {
+			return p_writer.fail("Unknown constructor.");
+		}
+		p_writer.put_u8(E->get().first);
+		p_writer.put_i32(E->get().second);
+	}
+
+	p_writer.put_u32(p_function->utilities.size());
+	for (Variant::ValidatedUtilityFunction utility : p_function->utilities) {
+		RBMap<Variant::ValidatedUtilityFunction, StringName>::Element *E = p_writer.utilities.find(utility);
+		if (!E) {
+			return p_writer.fail("Unknown utility function.");
+		}
+		p_writer.put_string(E->get());
+	}
+
+	p_writer.put_u32(p_function->gds_utilities.size());
+	for (GDScriptUtilityFunctions::FunctionPtr gds_utility : p_function->gds_utilities) {
+		RBMap<GDScriptUtilityFunctions::FunctionPtr, StringName>::Element *E = p_writer.gds_utilities.find(gds_utility);
+		if (!E) {
+			return p_writer.fail("Unknown GDScript utility function.");
+		}
+		p_writer.put_string(E->get());
+	}
+
+	p_writer.put_u32(p_function->methods.size());
+	for (const MethodBind *method : p_function->methods) {
+		p_writer.put_string(method->get_instance_class());
+		p_writer.put_string(method->get_name());
+	}
+
+	p_writer.put_u32(p_function->global_index_positions.size());
+	for (int position : p_function->global_index_positions) {
+		HashMap<int, StringName>::ConstIterator E = p_writer.global_indices.find(p_function->code[position]);
+		if (!E) {
+			return p_writer.fail("Unknown global.");
+		}
+		p_writer.put_i32(position);
+		p_writer.put_string(E->value);
+	}
+
+	p_writer.put_u32(p_function->lambdas.size());
+	for (const GDScriptFunction *lambda : p_function->lambdas) {
+		const GDScript::LambdaInfo *info = lambda->_script->lambda_info.getptr(const_cast<GDScriptFunction *>(lambda));
+		p_writer.put_u8(info != nullptr);
+		if (info) {
+			p_writer.put_i32(info->capture_count);
+			p_writer.put_u8(info->use_self);
+		}
+		if (!_write_function(p_writer, lambda)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void GDScriptBytecodeCache::_write_class_tree(Writer &p_writer, const GDScript *p_script) {
+	p_writer.put_string(p_script->local_name);
+	p_writer.put_string(p_script->global_name);
+	p_writer.put_string(p_script->fully_qualified_name);
+	p_writer.put_string(p_script->simplified_icon_path);
+	p_writer.put_u32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		p_writer.put_string(E.key);
+		_write_class_tree(p_writer, E.value.ptr());
+	}
+}
+
+bool GDScriptBytecodeCache::_write_class(Writer &p_writer, const GDScript *p_script) {
+	p_writer.put_u8(p_script->tool);
+	p_writer.put_string(p_script->native.is_valid() ? p_script->native->get_name() : StringName());
+	if (!_write_script_ref(p_writer, p_script->base.ptr())) {
+		return false;
+	}
+
+	p_writer.put_u32(p_script->member_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->member_indices) {
+		p_writer.put_string(E.key);
+		if (!_write_member_info(p_writer, E.value)) {
+			return false;
+		}
+	}
+
+	p_writer.put_u32(p_script->members.size());
+	for (const StringName &member : p_script->members) {
+		p_writer.put_string(member);
+	}
+
+	p_writer.put_u32(p_script->static_variables_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->static_variables_indices) {
+		p_writer.put_string(E.key);
+		if (!_write_member_info(p_writer, E.value)) {
+			return false;
+		}
+	}
+
+	p_writer.put_u32(p_script->constants.size());
+	for (const KeyValue<StringName, Variant> &E : p_script->constants) {
+		p_writer.put_string(E.key);
+		if (!_write_variant(p_writer, E.value)) {
+			return false;
+		}
+	}
+
+	p_writer.put_u32(p_script->_signals.size());
+	for (const KeyValue<StringName, MethodInfo> &E : p_script->_signals) {
+		p_writer.put_string(E.key);
+		if (!_write_method_info(p_writer, E.value)) {
+			return false;
+		}
+	}
+
+	if (!_write_variant(p_writer, p_script->rpc_config)) {
+		return false;
+	}
+
+	p_writer.put_u32(p_script->member_functions.size());
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		if (!_write_function(p_writer, E.value)) {
+			return false;
+		}
+	}
+
+	const GDScriptFunction *implicit_functions[] = { p_script->implicit_initializer, p_script->implicit_ready, p_script->static_initializer };
+	for (const GDScriptFunction *function : implicit_functions) {
+		p_writer.put_u8(function != nullptr);
+		if (function && !_write_function(p_writer, function)) {
+			return false;
+		}
+	}
+
+	p_writer.put_u32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		p_writer.put_string(E.key);
+		if (!_write_class(p_writer, E.value.ptr())) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+Vector<uint8_t> GDScriptBytecodeCache::_serialize(const Ref<GDScript> &p_script, CompressMode p_compress_mode, bool p_debug) {
+	Writer writer;
+	writer.root_path = p_script->path;
+
+	_write_class_tree(writer, p_script.ptr());
+	{
+		// Release copies don't register themselves, the editor's script of the same name does it for them.
+		MutexLock lock(GDScriptCache::singleton->mutex);
+		writer.put_u8(GDScriptCache::singleton->static_gdscript_cache.has(p_script->fully_qualified_name));
+	}
+	if (!_write_class(writer, p_script.ptr())) {
+		print_verbose(vformat(R"(GDScript: Can't cache the bytecode of "%s": %s)", p_script->path, writer.error));
+		return Vector<uint8_t>();
+	}
+
+	Vector<uint8_t> contents;
+	{
+		LocalVector<CharString> utf8_strings;
+		uint32_t strings_size = 4;
+		for (const String &string : writer.strings) {
+			utf8_strings.push_back(string.utf8());
+			strings_size += 4 + utf8_strings[utf8_strings.size() - 1].length();
+		}
+
+		contents.resize(strings_size + writer.data.size());
+		uint8_t *w = contents.ptrw();
+		w += encode_uint32(utf8_strings.size(), w);
+		for (const CharString &utf8 : utf8_strings) {
+			w += encode_uint32(utf8.length(), w);
+			memcpy(w, utf8.get_data(), utf8.length());
+			w += utf8.length();
+		}
+		memcpy(w, writer.data.ptr(), writer.data.size());
+	}
+
+	Vector<uint8_t> buf;
+
+	// Save header.
+	buf.resize(16);
+	buf.write[0] = 'G';
+	buf.write[1] = 'D';
+	buf.write[2] = 'B';
+	buf.write[3] = 'C';
+	encode_uint32(BYTECODE_CACHE_VERSION, &buf.write[4]);
+	encode_uint32(_get_engine_hash(p_debug), &buf.write[8]);
+
+	switch (p_compress_mode) {
+		case COMPRESS_NONE:
+			encode_uint32(0u, &buf.write[12]);
+			buf.append_array(contents);
+			break;
+
+		case COMPRESS_ZSTD: {
+			encode_uint32(contents.size(), &buf.write[12]);
+			Vector<uint8_t> compressed;
+			int max_size = Compression::get_max_compressed_buffer_size(contents.size(), Compression::MODE_ZSTD);
+			compressed.resize(max_size);
+
+			int compressed_size = Compression::compress(compressed.ptrw(), contents.ptr(), contents.size(), Compression::MODE_ZSTD);
+			ERR_FAIL_COND_V_MSG(compressed_size < 0, Vector<uint8_t>(), "Error compressing GDScript bytecode cache.");
+			compressed.resize(compressed_size);
+
+			buf.append_array(compressed);
+		} break;
+	}
+
+	return buf;
+}
+
+Vector<uint8_t> GDScriptBytecodeCache::serialize(const Ref<GDScript> &p_script, CompressMode p_compress_mode) {
+	ERR_FAIL_COND_V(p_script.is_null() || !p_script->is_valid() || !p_script->is_root_script(), Vector<uint8_t>());
+#ifdef DEBUG_ENABLED
+	return _serialize(p_script, p_compress_mode, true);
+#else
+	return _serialize(p_script, p_compress_mode, false);
+#endif
+}
+
+#ifdef DEBUG_ENABLED
+void GDScriptBytecodeCache::_set_export_only(GDScript *p_script) {
+	p_script->export_only = true;
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		_set_export_only(E.value.ptr());
+	}
+}
+
+Vector<uint8_t> GDScriptBytecodeCache::serialize_for_release(const Ref<GDScript> &p_script, CompressMode p_compress_mode) {
+	ERR_FAIL_COND_V(p_script.is_null() || !p_script->is_valid() || !p_script->is_root_script(), Vector<uint8_t>());
+	if (p_script->source.is_empty()) {
+		return Vector<uint8_t>();
+	}
+
+	// The copy takes the path of the script without taking over its cache entries,
+	// so that the editor keeps using the debug bytecode.
+	Ref<GDScript> script;
+	script.instantiate();
+	script->export_only = true;
+	script->path = p_script->path;
+	script->path_valid = true;
+	script->set_path_cache(p_script->get_path());
+	script->source = p_script->source;
+
+	GDScriptParser parser;
+	Error err = parser.parse(script->source, script->path, false);
+	if (err == OK) {
+		GDScriptAnalyzer analyzer(&parser);
+		err = analyzer.analyze();
+	}
+	if (err == OK) {
+		GDScriptCompiler compiler;
+		compiler.set_release_export(true);
+		err = compiler.compile(&parser, script.ptr());
+	}
+	// The inner classes were made while compiling.
+	_set_export_only(script.ptr());
+
+	if (err != OK || !script->is_valid()) {
+		print_verbose(vformat(R"(GDScript: Can't compile "%s" for the bytecode cache of release builds.)", p_script->path));
+		return Vector<uint8_t>();
+	}
+	return _serialize(script, p_compress_mode, false);
+}
+#endif
+
+/* Deserialization */
+
+Error GDScriptBytecodeCache::decode(const Vector<uint8_t> &p_buffer, Vector<uint8_t> &r_contents) {
+	ERR_FAIL_COND_V(p_buffer.size() < 16 || p_buffer[0] != 'G' || p_buffer[1] != 'D' || p_buffer[2] != 'B' || p_buffer[3] != 'C', ERR_INVALID_DATA);
+
+	// Bytecode from another engine build can't be trusted, the caller is expected to compile the script instead.
+	if (decode_uint32(&p_buffer[4]) != BYTECODE_CACHE_VERSION || decode_uint32(&p_buffer[8]) != get_engine_hash()) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	int decompressed_size = decode_uint32(&p_buffer[12]);
+	if (decompressed_size == 0) {
+		r_contents = p_buffer.slice(16);
+	} else {
+		r_contents.resize(decompressed_size);
+		int result = Compression::decompress(r_contents.ptrw(), r_contents.size(), &p_buffer[16], p_buffer.size() - 16, Compression::MODE_ZSTD);
+		ERR_FAIL_COND_V_MSG(result != decompressed_size, ERR_INVALID_DATA, "Error decompressing GDScript bytecode cache.");
+	}
+
+	return OK;
+}
+
+Error GDScriptBytecodeCache::_read_variant(Reader &p_reader, Variant &r_variant) {
+	switch (p_reader.get_u8()) {
+		case VARIANT_VALUE: {
+			uint32_t len = p_reader.get_count();
+			if (p_reader.failed) {
+				return ERR_INVALID_DATA;
+			}
+			int used = 0;
+			Error err = decode_variant(r_variant, p_reader.ptr + p_reader.pos, len, &used, false);
+			if (err != OK || (uint32_t)used != len) {
+				return ERR_INVALID_DATA;
+			}
+			p_reader.pos += len;
+		} break;
+		case VARIANT_ARRAY: {
+			bool read_only = p_reader.get_u8();
+			Variant::Type typed_builtin = p_reader.get_type();
+			StringName typed_class_name = p_reader.get_name();
+			Ref<Script> typed_script;
+			bool local = false;
+			Error err = _read_script_ref(p_reader, typed_script, local);
+			if (err != OK) {
+				return err;
+			}
+			uint32_t count = p_reader.get_count();
+			if (p_reader.failed) {
+				return ERR_INVALID_DATA;
+			}
+
+			Array array;
+			if (typed_builtin != Variant::NIL) {
+				array.set_typed(typed_builtin, typed_class_name, typed_script);
+			}
+			array.resize(count);
+			for (uint32_t i = 0; i < count; i++) {
+				err = _read_variant(p_reader, array[i]);
+				if (err != OK) {
+					return err;
+				}
+			}
+			if (read_only) {
+				array.make_read_only();
+			}
+			r_variant = array;
+		} break;
+		case VARIANT_DICTIONARY: {
+			bool read_only = p_reader.get_u8();
+			uint32_t count = p_reader.get_count();
+			if (p_reader.failed) {
+				return ERR_INVALID_DATA;
+			}
+
+			Dictionary dict;
+			for (uint32_t i = 0; i < count; i++) {
+				Variant key;
+				Variant value;
+				Error err = _read_variant(p_reader, key);
+				if (err == OK) {
+					err = _read_variant(p_reader, value);
+				}
+				if (err != OK) {
+					return err;
+				}
+				dict[key] = value;
+			}
+			if (read_only) {
+				dict.make_read_only();
+			}
+			r_variant = dict;
+		} break;
+		case VARIANT_NULL_OBJECT: {
+			r_variant = (Object *)nullptr;
+		} break;
+		case VARIANT_SCRIPT: {
+			Ref<Script> script;
+			bool local = false;
+			Error err = _read_script_ref(p_reader, script, local);
+			if (err != OK) {
+				return err;
+			}
+			r_variant = script;
+		} break;
+		case VARIANT_GLOBAL: {
+			StringName name = p_reader.get_name();
+			if (p_reader.failed) {
+				return ERR_INVALID_DATA;
+			}
+			GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+			HashMap<StringName, int>::ConstIterator E = language->get_global_map().find(name);
+			if (!E) {
+				return p_reader.fail(vformat(R"(Unknown global "%s".)", name));
+			}
+			r_variant = language->get_global_array()[E->value];
+		} break;
+		case VARIANT_RESOURCE: {
+			String path = p_reader.get_string();
+			if (p_reader.failed) {
+				return ERR_INVALID_DATA;
+			}
+			Ref<Resource> res = ResourceLoader::load(path);
+			if (res.is_null()) {
+				return p_reader.fail(vformat(R"(Can't load resource "%s".)", path));
+			}
+			r_variant = res;
+		} break;
+		case VARIANT_EMPTY: {
+			Variant::Type type = p_reader.get_type();
+			if (type != Variant::RID && type != Variant::CALLABLE && type != Variant::SIGNAL) {
+				return ERR_INVALID_DATA;
+			}
+			Callable::CallError ce;
+			Variant::construct(type, r_variant, nullptr, 0, ce);
+		} break;
+		default: {
+			return ERR_INVALID_DATA;
+		}
+	}
+
+	return p_reader.failed ? ERR_INVALID_DATA : OK;
+}
+
+Error GDScriptBytecodeCache::_read_script_ref(Reader &p_reader, Ref<Script> &r_script, bool &r_local) {
+	r_local = false;
+
+	switch (p_reader.get_u8()) {
+		case SCRIPT_REF_NONE: {
+			r_script = Ref<Script>();
+		} break;
+		case SCRIPT_REF_GDSCRIPT: {
+			String path = p_reader.get_string();
+			String fully_qualified_name = p_reader.get_string();
+			if (p_reader.failed) {
+				return ERR_INVALID_DATA;
+			}
+
+			Ref<GDScript> root;
+			if (path == p_reader.root->path) {
+				root = Ref<GDScript>(p_reader.root);
+				r_local = true;
+			} else {
+				Error err = OK;
+				root = GDScriptCache::get_shallow_script(path, err, p_reader.root->path);
+				if (err != OK || root.is_null()) {
+					return p_reader.fail(vformat(R"(Can't load script "%s".)", path));
+				}
+			}
+
+			GDScript *script = root->find_class(fully_qualified_name);
+			if (!script) {
+				return p_reader.fail(vformat(R"(Can't find class "%s" in "%s".)", fully_qualified_name, path));
+			}
+			r_script = Ref<Script>(script);
+		} break;
+		case SCRIPT_REF_RESOURCE: {
+			String path = p_reader.get_string();
+			if (p_reader.failed) {
+				return ERR_INVALID_DATA;
+			}
+			r_script = ResourceLoader::load(path, "Script");
+			if (r_script.is_null()) {
+				return p_reader.fail(vformat(R"(Can't load script "%s".)", path));
+			}
+		} break;
+		default: {
+			return ERR_INVALID_DATA;
+		}
+	}
+
+	return p_reader.failed ? ERR_INVALID_DATA : OK;
+}
+
+Error GDScriptBytecodeCache::_read_property_info(Reader &p_reader, PropertyInfo &r_info) {
+	r_info.type = p_reader.get_type();
+	r_info.name = p_reader.get_string();
+	r_info.class_name = p_reader.get_name();
+	r_info.hint = (PropertyHint)p_reader.get_u32();
+	r_info.hint_string = p_reader.get_string();
+	r_info.usage = p_reader.get_u32();
+	return p_reader.failed ? ERR_INVALID_DATA : OK;
+}
+
+Error GDScriptBytecodeCache::_read_method_info(Reader &p_reader, MethodInfo &r_info) {
+	r_info.name = p_reader.get_string();
+	Error err = _read_property_info(p_reader, r_info.return_val);
+	if (err != OK) {
+		return err;
+	}
+	r_info.flags = p_reader.get_u32();
+	r_info.id = p_reader.get_i32();
+
+	uint32_t argument_count = p_reader.get_count();
+	for (uint32_t i = 0; i < argument_count; i++) {
+		PropertyInfo argument;
+		err = _read_property_info(p_reader, argument);
+		if (err != OK) {
+			return err;
+		}
+		r_info.arguments.push_back(argument);
+	}
+
+	uint32_t default_argument_count = p_reader.get_count();
+	r_info.default_arguments.resize(default_argument_count);
+	for (uint32_t i = 0; i < default_argument_count; i++) {
+		err = _read_variant(p_reader, r_info.default_arguments.write[i]);
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	r_info.return_val_metadata = p_reader.get_i32();
+	uint32_t metadata_count = p_reader.get_count();
+	r_info.arguments_metadata.resize(metadata_count);
+	for (uint32_t i = 0; i < metadata_count; i++) {
+		r_info.arguments_metadata.write[i] = p_reader.get_i32();
+	}
+
+	return p_reader.failed ? ERR_INVALID_DATA : OK;
+}
+
+Error GDScriptBytecodeCache::_read_data_type(Reader &p_reader, GDScriptDataType &r_type) {
+	r_type.has_type = p_reader.get_u8();
+	uint8_t kind = p_reader.get_u8();
+	if (kind > GDScriptDataType::GDSCRIPT) {
+		return ERR_INVALID_DATA;
+	}
+	r_type.kind = (GDScriptDataType::Kind)kind;
+	r_type.builtin_type = p_reader.get_type();
+	r_type.native_type = p_reader.get_name();
+
+	if (r_type.kind == GDScriptDataType::SCRIPT || r_type.kind == GDScriptDataType::GDSCRIPT) {
+		Ref<Script> script;
+		bool local = false;
+		Error err = _read_script_ref(p_reader, script, local);
+		if (err != OK) {
+			return err;
+		}
+		// Like the compiler, only hold a strong reference to classes from other files, to avoid cyclic references.
+		if (!local || r_type.kind == GDScriptDataType::SCRIPT) {
+			r_type.script_type_ref = script;
+		}
+		r_type.script_type = script.ptr();
+	}
+
+	uint32_t element_count = p_reader.get_count();
+	for (uint32_t i = 0; i < element_count; i++) {
+		GDScriptDataType element_type;
+		Error err = _read_data_type(p_reader, element_type);
+		if (err != OK) {
+			return err;
+		}
+		r_type.set_container_element_type(i, element_type);
+	}
+
+	return p_reader.failed ? ERR_INVALID_DATA : OK;
+}
+
+Error GDScriptBytecodeCache::_read_member_info(Reader &p_reader, GDScript::MemberInfo &r_info) {
+	r_info.index = p_reader.get_i32();
+	r_info.setter = p_reader.get_name();
+	r_info.getter = p_reader.get_name();
+	Error err = _read_property_info(p_reader, r_info.property_info);
+	if (err != OK) {
+		return err;
+	}
+	return _read_data_type(p_reader, r_info.data_type);
+}
+
+Error GDScriptBytecodeCache::_read_function(Reader &p_reader, GDScript *p_script, ClassData &r_class, GDScriptFunction *&r_function) {
+	GDScriptFunction *function = memnew(GDScriptFunction);
+	r_function = function; // Owned by the caller from now on, even on failure.
+
+	function->_script = p_script;
+	function->source = p_script->get_script_path();
+	function->name = p_reader.get_name();
+	function->_static = p_reader.get_u8();
+
+#define READ_COUNT(m_var)              \
+	uint32_t m_var = p_reader.get_count(); \
+	if (p_reader.failed) {                 \
+		return ERR_INVALID_DATA;           \
+	}
+
+	READ_COUNT(argument_type_count);
+	function->argument_types.resize(argument_type_count);
+	for (uint32_t i = 0; i < argument_type_count; i++) {
+		Error err = _read_data_type(p_reader, function->argument_types.write[i]);
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	Error err = _read_data_type(p_reader, function->return_type);
+	if (err == OK) {
+		err = _read_method_info(p_reader, function->method_info);
+	}
+	if (err == OK) {
+		err = _read_variant(p_reader, function->rpc_config);
+	}
+	if (err != OK) {
+		return err;
+	}
+
+	function->_initial_line = p_reader.get_i32();
+	function->_argument_count = p_reader.get_i32();
+	function->_stack_size = p_reader.get_i32();
+	function->_instruction_args_size = p_reader.get_i32();
+	function->_default_arg_count = p_reader.get_i32();
+
+	READ_COUNT(inline_cache_count);
+	function->_inline_cache_count = inline_cache_count;
+
+	READ_COUNT(temporary_slot_count);
+	for (uint32_t i = 0; i < temporary_slot_count; i++) {
+		int slot = p_reader.get_i32();
+		function->temporary_slots[slot] = p_reader.get_type();
+	}
+
+	READ_COUNT(stack_debug_count);
+	for (uint32_t i = 0; i < stack_debug_count; i++) {
+		GDScriptFunction::StackDebug sd;
+		sd.line = p_reader.get_i32();
+		sd.pos = p_reader.get_i32();
+		sd.added = p_reader.get_u8();
+		sd.identifier = p_reader.get_name();
+		function->stack_debug.push_back(sd);
+	}
+
+	READ_COUNT(code_size);
+	function->code.resize(code_size);
+	for (uint32_t i = 0; i < code_size; i++) {
+		function->code.write[i] = p_reader.get_i32();
+	}
+
+	READ_COUNT(default_argument_count);
+	function->default_arguments.resize(default_argument_count);
+	for (uint32_t i = 0; i < default_argument_count; i++) {
+		function->default_arguments.write[i] = p_reader.get_i32();
+	}
+
+	READ_COUNT(constant_count);
+	function->constants.resize(constant_count);
+	for (uint32_t i = 0; i < constant_count; i++) {
+		err = _read_variant(p_reader, function->constants.write[i]);
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	READ_COUNT(global_name_count);
+	function->global_names.resize(global_name_count);
+	for (uint32_t i = 0; i < global_name_count; i++) {
+		function->global_names.write[i] = p_reader.get_name();
+	}
+
+	READ_COUNT(operator_count);
+	function->operator_funcs.resize(operator_count);
+	for (uint32_t i = 0; i < operator_count; i++) {
+		uint32_t op = p_reader.get_u32();
+		Variant::Operator op_type = (Variant::Operator)(op >> 16);
+		Variant::Type type_a = (Variant::Type)((op >> 8) & 0xFF);
+		Variant::Type type_b = (Variant::Type)(op & 0xFF);
+		if (op_type >= Variant::OP_MAX || type_a >= Variant::VARIANT_MAX || type_b >= Variant::VARIANT_MAX) {
+			return ERR_INVALID_DATA;
+		}
+		function->operator_funcs.write[i] = Variant::get_validated_operator_evaluator(op_type, type_a, type_b);
+		if (!function->operator_funcs[i]) {
+			return p_reader.fail(vformat(R"(Unknown operator "%s" for "%s" and "%s".)", Variant::get_operator_name(op_type), Variant::get_type_name(type_a), Variant::get_type_name(type_b)));
+		}
+#ifdef DEBUG_ENABLED
+		function->operator_names.push_back(Variant::get_operator_name(op_type));
+#endif
+	}
+
+	READ_COUNT(setter_count);
+	function->setters.resize(setter_count);
+	for (uint32_t i = 0; i < setter_count; i++) {
+		Variant::Type type = p_reader.get_type();
+		StringName member = p_reader.get_name();
+		function->setters.write[i] = Variant::get_member_validated_setter(type, member);
+		if (!function->setters[i]) {
+			return p_reader.fail(vformat(R"(Unknown member "%s" of "%s".)", member, Variant::get_type_name(type)));
+		}
+#ifdef DEBUG_ENABLED
+		function->setter_names.push_back(member);
+#endif
+	}
+
+	READ_COUNT(getter_count);
+	function->getters.resize(getter_count);
+	for (uint32_t i = 0; i < getter_count; i++) {
+		Variant::Type type = p_reader.get_type();
+		StringName member = p_reader.get_name();
+		function->getters.write[i] = Variant::get_member_validated_getter(type, member);
+		if (!function->getters[i]) {
+			return p_reader.fail(vformat(R"(Unknown member "%s" of "%s".)", member, Variant::get_type_name(type)));
+		}
+#ifdef DEBUG_ENABLED
+		function->getter_names.push_back(member);
+#endif
+	}
+
+	READ_COUNT(keyed_setter_count);
+	function->keyed_setters.resize(keyed_setter_count);
+	for (uint32_t i = 0; i < keyed_setter_count; i++) {
+		function->keyed_setters.write[i] = Variant::get_member_validated_keyed_setter(p_reader.get_type());
+	}
+
+	READ_COUNT(keyed_getter_count);
+	function->keyed_getters.resize(keyed_getter_count);
+	for (uint32_t i = 0; i < keyed_getter_count; i++) {
+		function->keyed_getters.write[i] = Variant::get_member_validated_keyed_getter(p_reader.get_type());
+	}
+
+	READ_COUNT(indexed_setter_count);
+	function->indexed_setters.resize(indexed_setter_count);
+	for (uint32_t i = 0; i < indexed_setter_count; i++) {
+		function->indexed_setters.write[i] = Variant::get_member_validated_indexed_setter(p_reader.get_type());
+	}
+
+	READ_COUNT(indexed_getter_count);
+	function->indexed_getters.resize(indexed_getter_count);
+	for (uint32_t i = 0; i < indexed_getter_count; i++) {
+		function->indexed_getters.write[i] = Variant::get_member_validated_indexed_getter(p_reader.get_type());
+	}
+
+	READ_COUNT(builtin_method_count);
+	function->builtin_methods.resize(builtin_method_count);
+	for (uint32_t i = 0; i < builtin_method_count; i++) {
+		Variant::Type type = p_reader.get_type();
+		StringName method = p_reader.get_name();
+		function->builtin_methods.write[i] = Variant::get_validated_builtin_method(type, method);
+		if (!function->builtin_methods[i]) {
+			return p_reader.fail(vformat(R"(Unknown method "%s" of "%s".)", method, Variant::get_type_name(type)));
+		}
+#ifdef DEBUG_ENABLED
+		function->builtin_methods_names.push_back(method);
+#endif
+	}
+
+	READ_COUNT(constructor_count);
+	function->constructors.resize(constructor_count);
+	for (uint32_t i = 0; i < constructor_count; i++) {
+		Variant::Type type = p_reader.get_type();
+		int index = p_reader.get_i32();
+		if (index < 0 || index >= Variant::get_constructor_count(type)) {
+			return p_reader.fail(vformat(R"(Unknown constructor of "%s".)", Variant::get_type_name(type)));
+		}
+		function->constructors.write[i] = Variant::get_validated_constructor(type, index);
+#ifdef DEBUG_ENABLED
+		function->constructors_names.push_back(Variant::get_type_name(type));
+#endif
+	}
+
+	READ_COUNT(utility_count);
+	function->utilities.resize(utility_count);
+	for (uint32_t i = 0; i < utility_count; i++) {
+		StringName utility = p_reader.get_name();
+		function->utilities.write[i] = Variant::get_validated_utility_function(utility);
+		if (!function->utilities[i]) {
+			return p_reader.fail(vformat(R"(Unknown utility function "%s".)", utility));
+		}
+#ifdef DEBUG_ENABLED
+		function->utilities_names.push_back(utility);
+#endif
+	}
+
+	READ_COUNT(gds_utility_count);
+	function->gds_utilities.resize(gds_utility_count);
+	for (uint32_t i = 0; i < gds_utility_count; i++) {
+		StringName utility = p_reader.get_name();
+		function->gds_utilities.write[i] = GDScriptUtilityFunctions::get_function(utility);
+		if (!function->gds_utilities[i]) {
+			return p_reader.fail(vformat(R"(Unknown utility function "%s".)", utility));
+		}
+#ifdef DEBUG_ENABLED
+		function->gds_utilities_names.push_back(utility);
+#endif
+	}
+
+	READ_COUNT(method_count);
+	function->methods.resize(method_count);
+	for (uint32_t i = 0; i < method_count; i++) {
+		StringName class_name = p_reader.get_name();
+		StringName method = p_reader.get_name();
+		function->methods.write[i] = ClassDB::get_method(class_name, method);
+		if (!function->methods[i]) {
+			return p_reader.fail(vformat(R"(Unknown method "%s::%s".)", class_name, method));
+		}
+	}
+
+	READ_COUNT(global_index_count);
+	for (uint32_t i = 0; i < global_index_count; i++) {
+		int position = p_reader.get_i32();
+		StringName global = p_reader.get_name();
+		if (p_reader.failed || position < 0 || position >= function->code.size()) {
+			return ERR_INVALID_DATA;
+		}
+		HashMap<StringName, int>::ConstIterator E = GDScriptLanguage::get_singleton()->get_global_map().find(global);
+		if (!E) {
+			return p_reader.fail(vformat(R"(Unknown global "%s".)", global));
+		}
+		function->code.write[position] = E->value;
+		function->global_index_positions.push_back(position);
+	}
+
+	READ_COUNT(lambda_count);
+	for (uint32_t i = 0; i < lambda_count; i++) {
+		bool has_info = p_reader.get_u8();
+		GDScript::LambdaInfo info = { 0, false };
+		if (has_info) {
+			info.capture_count = p_reader.get_i32();
+			info.use_self = p_reader.get_u8();
+		}
+		GDScriptFunction *lambda = nullptr;
+		err = _read_function(p_reader, p_script, r_class, lambda);
+		function->lambdas.push_back(lambda); // Freed with the function.
+		if (err != OK) {
+			return err;
+		}
+		if (has_info) {
+			r_class.lambda_info.insert(lambda, info);
+		}
+	}
+
+#undef READ_COUNT
+
+	if (p_reader.failed) {
+		return ERR_INVALID_DATA;
+	}
+
+	// Same as `GDScriptByteCodeGenerator::write_end()`.
+	function->_code_size = function->code.size();
+	function->_code_ptr = function->_code_size ? function->code.ptrw() : nullptr;
+	function->_default_arg_ptr = function->default_arguments.size() ? function->default_arguments.ptr() : nullptr;
+	function->_constant_count = function->constants.size();
+	function->_constants_ptr = function->_constant_count ? function->constants.ptrw() : nullptr;
+	function->_global_names_count = function->global_names.size();
+	function->_global_names_ptr = function->_global_names_count ? function->global_names.ptr() : nullptr;
+	function->_operator_funcs_count = function->operator_funcs.size();
+	function->_operator_funcs_ptr = function->_operator_funcs_count ? function->operator_funcs.ptr() : nullptr;
+	function->_setters_count = function->setters.size();
+	function->_setters_ptr = function->_setters_count ? function->setters.ptr() : nullptr;
+	function->_getters_count = function->getters.size();
+	function->_getters_ptr = function->_getters_count ? function->getters.ptr() : nullptr;
+	function->_keyed_setters_count = function->keyed_setters.size();
+	function->_keyed_setters_ptr = function->_keyed_setters_count ? function->keyed_setters.ptr() : nullptr;
+	function->_keyed_getters_count = function->keyed_getters.size();
+	function->_keyed_getters_ptr = function->_keyed_getters_count ? function->keyed_getters.ptr() : nullptr;
+	function->_indexed_setters_count = function->indexed_setters.size();
+	function->_indexed_setters_ptr = function->_indexed_setters_count ? function->indexed_setters.ptr() : nullptr;
+	function->_indexed_getters_count = function->indexed_getters.size();
+	function->_indexed_getters_ptr = function->_indexed_getters_count ? function->indexed_getters.ptr() : nullptr;
+	function->_builtin_methods_count = function->builtin_methods.size();
+	function->_builtin_methods_ptr = function->_builtin_methods_count ? function->builtin_methods.ptr() : nullptr;
+	function->_constructors_count = function->constructors.size();
+	function->_constructors_ptr = function->_constructors_count ? function->constructors.ptr() : nullptr;
+	function->_utilities_count = function->utilities.size();
+	function->_utilities_ptr = function->_utilities_count ? function->utilities.ptr() : nullptr;
+	function->_gds_utilities_count = function->gds_utilities.size();
+	function->_gds_utilities_ptr = function->_gds_utilities_count ? function->gds_utilities.ptr() : nullptr;
+	function->_methods_count = function->methods.size();
+	function->_methods_ptr = function->_methods_count ? function->methods.ptrw() : nullptr;
+	function->_lambdas_count = function->lambdas.size();
+	function->_lambdas_ptr = function->_lambdas_count ? function->lambdas.ptrw() : nullptr;
+	function->_inline_caches_ptr = function->_inline_cache_count ? memnew_arr(GDScriptInlineCache, function->_inline_cache_count) : nullptr;
+
+#ifdef DEBUG_ENABLED
+	function->func_cname = (String(function->source) + " - " + String(function->name)).utf8();
+	function->_func_cname = function->func_cname.get_data();
+
+	if (EngineDebugger::is_active()) {
+		String signature = function->source;
+		signature += "::" + itos(function->_initial_line);
+		if (p_script->local_name != StringName()) {
+			signature += "::" + String(p_script->local_name) + "." + String(function->name);
+		} else {
+			signature += "::" + String(function->name);
+		}
+		function->profile.signature = signature;
+	}
+#endif
+
+	return OK;
+}
+
+Error GDScriptBytecodeCache::_read_class_tree(Reader &p_reader, GDScript *p_script) {
+	p_script->local_name = p_reader.get_name();
+	p_script->global_name = p_reader.get_name();
+	p_script->fully_qualified_name = p_reader.get_string();
+	p_script->simplified_icon_path = p_reader.get_string();
+
+	HashMap<StringName, Ref<GDScript>> old_subclasses = p_script->subclasses;
+	p_script->subclasses.clear();
+
+	uint32_t subclass_count = p_reader.get_count();
+	for (uint32_t i = 0; i < subclass_count; i++) {
+		StringName name = p_reader.get_name();
+		if (p_reader.failed) {
+			return ERR_INVALID_DATA;
+		}
+
+		Ref<GDScript> subclass;
+		if (old_subclasses.has(name)) {
+			subclass = old_subclasses[name];
+		} else {
+			subclass = GDScriptLanguage::get_singleton()->get_orphan_subclass(p_script->fully_qualified_name + "::" + name);
+		}
+		if (subclass.is_null()) {
+			subclass.instantiate();
+		}
+
+		subclass->_owner = p_script;
+		subclass->path = p_script->path;
+		p_script->subclasses.insert(name, subclass);
+
+		Error err = _read_class_tree(p_reader, subclass.ptr());
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	return p_reader.failed ? ERR_INVALID_DATA : OK;
+}
+
+Error GDScriptBytecodeCache::_read_class(Reader &p_reader, GDScript *p_script, List<ClassData> &r_classes) {
+	ClassData &data = r_classes.push_back(ClassData())->get();
+	data.script = p_script;
+	data.tool = p_reader.get_u8();
+
+	StringName native_name = p_reader.get_name();
+	if (p_reader.failed) {
+		return ERR_INVALID_DATA;
+	}
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	HashMap<StringName, int>::ConstIterator native_idx = language->get_global_map().find(native_name);
+	if (native_idx) {
+		data.native = language->get_global_array()[native_idx->value];
+	}
+	if (data.native.is_null()) {
+		return p_reader.fail(vformat(R"(Unknown native class "%s".)", native_name));
+	}
+
+	Ref<Script> base;
+	bool local = false;
+	Error err = _read_script_ref(p_reader, base, local);
+	if (err != OK) {
+		return err;
+	}
+	data.base = base;
+
+	uint32_t member_count = p_reader.get_count();
+	for (uint32_t i = 0; i < member_count; i++) {
+		StringName name = p_reader.get_name();
+		err = _read_member_info(p_reader, data.member_indices[name]);
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	uint32_t own_member_count = p_reader.get_count();
+	for (uint32_t i = 0; i < own_member_count; i++) {
+		data.members.insert(p_reader.get_name());
+	}
+
+	uint32_t static_variable_count = p_reader.get_count();
+	for (uint32_t i = 0; i < static_variable_count; i++) {
+		StringName name = p_reader.get_name();
+		err = _read_member_info(p_reader, data.static_variables_indices[name]);
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	uint32_t constant_count = p_reader.get_count();
+	for (uint32_t i = 0; i < constant_count; i++) {
+		StringName name = p_reader.get_name();
+		err = _read_variant(p_reader, data.constants[name]);
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	uint32_t signal_count = p_reader.get_count();
+	for (uint32_t i = 0; i < signal_count; i++) {
+		StringName name = p_reader.get_name();
+		err = _read_method_info(p_reader, data.signals[name]);
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	Variant rpc_config;
+	err = _read_variant(p_reader, rpc_config);
+	if (err != OK) {
+		return err;
+	}
+	data.rpc_config = rpc_config;
+
+	uint32_t function_count = p_reader.get_count();
+	for (uint32_t i = 0; i < function_count; i++) {
+		GDScriptFunction *function = nullptr;
+		err = _read_function(p_reader, p_script, data, function);
+		if (function) {
+			if (data.member_functions.has(function->name)) {
+				memdelete(function);
+				return ERR_INVALID_DATA;
+			}
+			data.member_functions.insert(function->name, function);
+		}
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	GDScriptFunction **implicit_functions[] = { &data.implicit_initializer, &data.implicit_ready, &data.static_initializer };
+	for (GDScriptFunction **function : implicit_functions) {
+		if (p_reader.get_u8()) {
+			err = _read_function(p_reader, p_script, data, *function);
+			if (err != OK) {
+				return err;
+			}
+		}
+	}
+
+	uint32_t subclass_count = p_reader.get_count();
+	if (subclass_count != (uint32_t)p_script->subclasses.size()) {
+		return ERR_INVALID_DATA;
+	}
+	for (uint32_t i = 0; i < subclass_count; i++) {
+		StringName name = p_reader.get_name();
+		HashMap<StringName, Ref<GDScript>>::Iterator E = p_script->subclasses.find(name);
+		if (!E) {
+			return ERR_INVALID_DATA;
+		}
+		err = _read_class(p_reader, E->value.ptr(), r_classes);
+		if (err != OK) {
+			return err;
+		}
+	}
+
+	return p_reader.failed ? ERR_INVALID_DATA : OK;
+}
+
+Error GDScriptBytecodeCache::make_scripts(GDScript *p_script, const Vector<uint8_t> &p_contents) {
+	Reader reader;
+	reader.root = p_script;
+	Error err = reader.init(p_contents);
+	if (err != OK) {
+		return err;
+	}
+	return _read_class_tree(reader, p_script);
+}
+
+Error GDScriptBytecodeCache::load(GDScript *p_script, const Vector<uint8_t> &p_contents) {
+	ERR_FAIL_COND_V(p_script->valid || p_script->reloading, ERR_ALREADY_IN_USE);
+
+	if (!p_script->path.is_empty() && GDScriptCache::get_cached_script(p_script->path).is_null()) {
+		MutexLock lock(GDScriptCache::singleton->mutex);
+		GDScriptCache::singleton->shallow_gdscript_cache[p_script->path] = Ref<GDScript>(p_script);
+	}
+
+	Reader reader;
+	reader.root = p_script;
+	Error err = reader.init(p_contents);
+	if (err == OK) {
+		err = _read_class_tree(reader, p_script);
+	}
+	bool keep_static = reader.get_u8();
+
+	List<ClassData> classes;
+	if (err == OK) {
+		err = _read_class(reader, p_script, classes);
+	}
+	if (err == OK && reader.pos != reader.size) {
+		err = ERR_INVALID_DATA;
+	}
+
+	if (err != OK) {
+		for (ClassData &data : classes) {
+			data.free_functions();
+		}
+		if (err == ERR_CANT_RESOLVE) {
+			print_verbose(vformat(R"(GDScript: Can't use the cached bytecode of "%s": %s)", p_script->path, reader.error));
+		} else {
+			ERR_PRINT(vformat(R"(GDScript: Corrupted bytecode cache for "%s".)", p_script->path));
+		}
+		return err;
+	}
+
+	for (ClassData &data : classes) {
+		GDScript *script = data.script;
+		script->tool = data.tool;
+		script->native = data.native;
+		script->base = data.base;
+		script->_base = data.base.ptr();
+		script->member_indices = data.member_indices;
+		script->members = data.members;
+		script->static_variables_indices = data.static_variables_indices;
+		script->static_variables.clear();
+		script->static_variables.resize(data.static_variables_indices.size());
+		script->constants = data.constants;
+		script->_signals = data.signals;
+		script->rpc_config = data.rpc_config;
+		script->member_functions = data.member_functions;
+		script->initializer = data.member_functions.has(GDScriptLanguage::get_singleton()->strings._init) ? data.member_functions[GDScriptLanguage::get_singleton()->strings._init] : nullptr;
+		script->implicit_initializer = data.implicit_initializer;
+		script->implicit_ready = data.implicit_ready;
+		script->static_initializer = data.static_initializer;
+		script->lambda_info = data.lambda_info;
+		script->valid = true;
+	}
+
+	// Same as the end of `GDScriptCompiler::compile()`. Dependencies may come back to this script while being loaded.
+	if (keep_static) {
+		GDScriptCache::add_static_script(p_script);
+	}
+
+	p_script->reloading = true;
+	err = GDScriptCache::finish_compiling(p_script->path);
+	p_script->reloading = false;
+	if (err) {
+		p_script->valid = false;
+		return err;
+	}
+
+	// Same as the end of `GDScript::reload()`.
+	if (ScriptServer::is_scripting_enabled() || p_script->is_tool()) {
+		err = p_script->_static_init();
+	}
+#ifdef TOOLS_ENABLED
+	else {
+		p_script->_static_default_init();
+	}
+#endif
+
+	return err;
+}
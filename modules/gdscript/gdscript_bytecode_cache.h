@@ -0,0 +1,101 @@
+/**************************************************************************/
+/*  gdscript_bytecode_cache.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_BYTECODE_CACHE_H
+#define GDSCRIPT_BYTECODE_CACHE_H
+
+#include "gdscript.h"
+
+// Serialized form of compiled GDScript classes, shipped next to the binary
+// tokens of exported scripts so they can be loaded without being parsed,
+// analyzed and compiled again.
+//
+// Everything that is a pointer at runtime (validated Variant calls, method
+// binds, native classes, other scripts and resources) is stored by name and
+// resolved on load. Any failure to do so makes the loader fall back to
+// compiling the script.
+class GDScriptBytecodeCache {
+public:
+	enum CompressMode {
+		COMPRESS_NONE,
+		COMPRESS_ZSTD,
+	};
+
+private:
+	struct Writer;
+	struct Reader;
+	struct ClassData;
+
+	static bool _write_variant(Writer &p_writer, const Variant &p_variant);
+	static bool _write_script_ref(Writer &p_writer, const Script *p_script);
+	static void _write_property_info(Writer &p_writer, const PropertyInfo &p_info);
+	static bool _write_method_info(Writer &p_writer, const MethodInfo &p_info);
+	static bool _write_data_type(Writer &p_writer, const GDScriptDataType &p_type);
+	static bool _write_member_info(Writer &p_writer, const GDScript::MemberInfo &p_info);
+	static bool _write_function(Writer &p_writer, const GDScriptFunction *p_function);
+	static void _write_class_tree(Writer &p_writer, const GDScript *p_script);
+	static bool _write_class(Writer &p_writer, const GDScript *p_script);
+
+	static Error _read_variant(Reader &p_reader, Variant &r_variant);
+	static Error _read_script_ref(Reader &p_reader, Ref<Script> &r_script, bool &r_local);
+	static Error _read_property_info(Reader &p_reader, PropertyInfo &r_info);
+	static Error _read_method_info(Reader &p_reader, MethodInfo &r_info);
+	static Error _read_data_type(Reader &p_reader, GDScriptDataType &r_type);
+	static Error _read_member_info(Reader &p_reader, GDScript::MemberInfo &r_info);
+	static Error _read_function(Reader &p_reader, GDScript *p_script, ClassData &r_class, GDScriptFunction *&r_function);
+	static Error _read_class_tree(Reader &p_reader, GDScript *p_script);
+	static Error _read_class(Reader &p_reader, GDScript *p_script, List<ClassData> &r_classes);
+
+	static uint32_t _get_engine_hash(bool p_debug);
+	static Vector<uint8_t> _serialize(const Ref<GDScript> &p_script, CompressMode p_compress_mode, bool p_debug);
+#ifdef DEBUG_ENABLED
+	static void _set_export_only(GDScript *p_script);
+#endif
+
+public:
+	// Hash of everything the serialized bytecode depends on: engine version
+	// and build, debug or release target, cache format, opcode and Variant enumerations.
+	static uint32_t get_engine_hash();
+	static String get_cache_path(const String &p_script_path);
+
+	static Vector<uint8_t> serialize(const Ref<GDScript> &p_script, CompressMode p_compress_mode);
+#ifdef DEBUG_ENABLED
+	// Compiles the script's source again without debug opcodes, for release builds to load.
+	static Vector<uint8_t> serialize_for_release(const Ref<GDScript> &p_script, CompressMode p_compress_mode);
+#endif
+	// Checks the header and returns the uncompressed contents.
+	static Error decode(const Vector<uint8_t> &p_buffer, Vector<uint8_t> &r_contents);
+	// Creates the inner class scripts, like `GDScriptCompiler::make_scripts()`.
+	static Error make_scripts(GDScript *p_script, const Vector<uint8_t> &p_contents);
+	// Fills the script as `GDScriptCompiler::compile()` would. The script is left untouched on failure.
+	static Error load(GDScript *p_script, const Vector<uint8_t> &p_contents);
+};
+
+#endif // GDSCRIPT_BYTECODE_CACHE_H
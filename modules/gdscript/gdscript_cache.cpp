@@ -32,10 +32,14 @@
 
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_compiler.h"
 #include "gdscript_parser.h"
 
+#include "core/config/project_settings.h"
 #include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "core/templates/vector.h"
 
 GDScriptParserRef::Status GDScriptParserRef::get_status() const {
@@ -137,7 +141,11 @@ GDScriptParserRef::~GDScriptParserRef() {
 	clear();
 
 	MutexLock lock(GDScriptCache::singleton->mutex);
-	GDScriptCache::singleton->parser_map.erase(path);
+	// Parsed in parallel, this one may not have been registered if another thread got there first.
+	HashMap<String, GDScriptParserRef *>::Iterator E = GDScriptCache::singleton->parser_map.find(path);
+	if (E && E->value == this) {
+		GDScriptCache::singleton->parser_map.remove(E);
+	}
 }
 
 GDScriptCache *GDScriptCache::singleton = nullptr;
@@ -191,6 +199,7 @@ void GDScriptCache::remove_script(const String &p_path) {
 	singleton->dependencies.erase(p_path);
 	singleton->shallow_gdscript_cache.erase(p_path);
 	singleton->full_gdscript_cache.erase(p_path);
+	singleton->bytecode_cache.erase(p_path);
 }
 
 Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
@@ -264,6 +273,23 @@ Vector<uint8_t> GDScriptCache::get_binary_tokens(const String &p_path) {
 	return buffer;
 }
 
+Vector<uint8_t> GDScriptCache::get_bytecode(const String &p_path) {
+	String cache_path = GDScriptBytecodeCache::get_cache_path(p_path);
+	if (!FileAccess::exists(cache_path)) {
+		return Vector<uint8_t>();
+	}
+
+	Vector<uint8_t> contents;
+	Error err = GDScriptBytecodeCache::decode(FileAccess::get_file_as_bytes(cache_path), contents);
+	if (err == ERR_FILE_UNRECOGNIZED) {
+		print_verbose(vformat(R"(GDScript: Ignoring bytecode cache "%s" made by another engine build.)", cache_path));
+	}
+	if (err != OK) {
+		return Vector<uint8_t>();
+	}
+	return contents;
+}
+
 Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_error, const String &p_owner) {
 	MutexLock lock(singleton->mutex);
 	if (!p_owner.is_empty()) {
@@ -281,12 +307,14 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_e
 	Ref<GDScript> script;
 	script.instantiate();
 	script->set_path(p_path, true);
+	Vector<uint8_t> bytecode;
 	if (remapped_path.get_extension().to_lower() == "gdc") {
 		Vector<uint8_t> buffer = get_binary_tokens(remapped_path);
 		if (buffer.is_empty()) {
 			r_error = ERR_FILE_CANT_READ;
 		}
 		script->set_binary_tokens_source(buffer);
+		bytecode = get_bytecode(remapped_path);
 	} else {
 		r_error = script->load_source_code(remapped_path);
 	}
@@ -295,6 +323,13 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_e
 		return Ref<GDScript>(); // Returns null and does not cache when the script fails to load.
 	}
 
+	if (!bytecode.is_empty() && GDScriptBytecodeCache::make_scripts(script.ptr(), bytecode) == OK) {
+		// Compiled classes are loaded in `get_full_script()`, the tokens are still parsed if something needs them.
+		singleton->bytecode_cache[p_path] = bytecode;
+		singleton->shallow_gdscript_cache[p_path] = script;
+		return script;
+	}
+
 	Ref<GDScriptParserRef> parser_ref = get_parser(p_path, GDScriptParserRef::PARSED, r_error);
 	if (r_error == OK) {
 		GDScriptCompiler::make_scripts(script.ptr(), parser_ref->get_parser()->get_tree(), true);
@@ -328,6 +363,23 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 		}
 	}
 
+	if (!p_update_from_disk && singleton->bytecode_cache.has(p_path)) {
+		Vector<uint8_t> bytecode = singleton->bytecode_cache[p_path];
+		singleton->bytecode_cache.erase(p_path);
+
+		Error err = GDScriptBytecodeCache::load(script.ptr(), bytecode);
+		if (err == OK) {
+			return script;
+		}
+		if (script->is_valid()) {
+			// Only failed to initialize static variables, same as `reload()`.
+			r_error = err;
+			return script;
+		}
+		print_verbose(vformat(R"(GDScript: Compiling "%s" instead of using its cached bytecode.)", p_path));
+	}
+	singleton->bytecode_cache.erase(p_path);
+
 	if (p_update_from_disk) {
 		if (p_path.get_extension().to_lower() == "gdc") {
 			Vector<uint8_t> buffer = get_binary_tokens(p_path);
@@ -405,6 +457,278 @@ void GDScriptCache::remove_static_script(const String &p_fqcn) {
 	singleton->static_gdscript_cache.erase(p_fqcn);
 }
 
+void GDScriptCache::_parse_task(void *p_userdata, uint32_t p_index) {
+	ParseTask &task = static_cast<ParseTask *>(p_userdata)[p_index];
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	if (task.parser_ref.is_valid()) {
+		task.parser_ref->raise_status(GDScriptParserRef::PARSED);
+	}
+
+	if (task.parser) {
+		if (task.read_file) {
+			String remapped_path = ResourceLoader::path_remap(task.path);
+			if (remapped_path.get_extension().to_lower() == "gdc") {
+				task.binary_tokens = get_binary_tokens(remapped_path);
+			} else {
+				task.source = get_source_code(remapped_path);
+			}
+		}
+		if (!task.binary_tokens.is_empty()) {
+			task.source_hash = hash_djb2_buffer(task.binary_tokens.ptr(), task.binary_tokens.size());
+			task.error = task.parser->parse_binary(task.binary_tokens, task.path);
+		} else {
+			task.source_hash = task.source.hash();
+			task.error = task.parser->parse(task.source, task.path, false);
+		}
+	}
+
+	task.usec = OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+void GDScriptCache::_parse_in_parallel(LocalVector<ParseTask> &r_tasks) {
+	if (r_tasks.is_empty()) {
+		return;
+	}
+
+	// Parsers register their annotations when the first one is made, so they are made on this thread.
+	for (ParseTask &task : r_tasks) {
+		if (task.parser_ref.is_valid()) {
+			task.parser_ref->get_parser();
+		}
+		task.parser = memnew(GDScriptParser);
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&GDScriptCache::_parse_task, r_tasks.ptr(), r_tasks.size(), -1, true, SNAME("GDScriptParse"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	MutexLock lock(singleton->mutex);
+	singleton->parsed_sources_thread = Thread::get_caller_id();
+	for (ParseTask &task : r_tasks) {
+		// Only registered now that they are parsed, so other threads can't get them half-built.
+		if (task.parser_ref.is_valid() && !singleton->parser_map.has(task.path)) {
+			singleton->parser_map[task.path] = task.parser_ref.ptr();
+		}
+		if (task.error != OK) {
+			// Let `GDScript::reload()` parse it again and report the errors.
+			memdelete(task.parser);
+			continue;
+		}
+		if (singleton->parsed_sources.has(task.path)) {
+			memdelete(singleton->parsed_sources[task.path].parser);
+		}
+		ParsedSource &parsed = singleton->parsed_sources[task.path];
+		parsed.source_hash = task.source_hash;
+		parsed.parser = task.parser;
+	}
+}
+
+void GDScriptCache::parse_sources(const Vector<Ref<GDScript>> &p_scripts) {
+	LocalVector<ParseTask> tasks;
+	tasks.reserve(p_scripts.size());
+	for (const Ref<GDScript> &script : p_scripts) {
+		if (script.is_null() || script->path.is_empty()) {
+			continue;
+		}
+		ParseTask task;
+		task.path = script->path;
+		task.source = script->source;
+		task.binary_tokens = script->binary_tokens;
+		tasks.push_back(task);
+	}
+	_parse_in_parallel(tasks);
+}
+
+GDScriptParser *GDScriptCache::take_parsed_source(const String &p_path, const String &p_source, const Vector<uint8_t> &p_binary_tokens) {
+	if (singleton == nullptr || p_path.is_empty()) {
+		return nullptr;
+	}
+
+	MutexLock lock(singleton->mutex);
+	if (singleton->parsed_sources.is_empty() || singleton->parsed_sources_thread != Thread::get_caller_id()) {
+		return nullptr;
+	}
+	HashMap<String, ParsedSource>::Iterator E = singleton->parsed_sources.find(p_path);
+	if (!E) {
+		return nullptr;
+	}
+
+	uint32_t source_hash = p_binary_tokens.is_empty() ? p_source.hash() : hash_djb2_buffer(p_binary_tokens.ptr(), p_binary_tokens.size());
+	GDScriptParser *parser = E->value.parser;
+	const bool matches = E->value.source_hash == source_hash;
+	singleton->parsed_sources.remove(E);
+	if (!matches) {
+		memdelete(parser);
+		return nullptr;
+	}
+	// Kept until the batch ends, since the caller can't know whether the parser was its own.
+	singleton->taken_parsers.push_back(parser);
+	return parser;
+}
+
+void GDScriptCache::clear_parsed_sources() {
+	if (singleton == nullptr) {
+		return;
+	}
+
+	LocalVector<GDScriptParser *> parsers;
+	{
+		MutexLock lock(singleton->mutex);
+		for (KeyValue<String, ParsedSource> &E : singleton->parsed_sources) {
+			parsers.push_back(E.value.parser);
+		}
+		for (GDScriptParser *parser : singleton->taken_parsers) {
+			parsers.push_back(parser);
+		}
+		singleton->parsed_sources.clear();
+		singleton->taken_parsers.clear();
+		singleton->parsed_sources_thread = Thread::UNASSIGNED_ID;
+	}
+
+	// Freeing parsers can release the last reference to other parsers, which locks the cache.
+	for (GDScriptParser *parser : parsers) {
+		memdelete(parser);
+	}
+}
+
+// Finds the scripts a class extends or preloads in constants, which are compiled along with it.
+static void _get_class_dependencies(const GDScriptParser::ClassNode *p_class, const String &p_path, HashSet<String> &r_dependencies) {
+	if (!p_class->extends_path.is_empty()) {
+		r_dependencies.insert((p_class->extends_path.is_relative_path() ? p_path.get_base_dir().path_join(p_class->extends_path) : p_class->extends_path).simplify_path());
+	} else if (!p_class->extends.is_empty() && ScriptServer::is_global_class(p_class->extends[0]->name)) {
+		r_dependencies.insert(ScriptServer::get_global_class_path(p_class->extends[0]->name).simplify_path());
+	}
+
+	for (const GDScriptParser::ClassNode::Member &member : p_class->members) {
+		if (member.type == GDScriptParser::ClassNode::Member::CLASS) {
+			_get_class_dependencies(member.m_class, p_path, r_dependencies);
+		} else if (member.type == GDScriptParser::ClassNode::Member::CONSTANT && member.constant->initializer && member.constant->initializer->type == GDScriptParser::Node::PRELOAD) {
+			const GDScriptParser::PreloadNode *preload = static_cast<const GDScriptParser::PreloadNode *>(member.constant->initializer);
+			if (preload->path && preload->path->type == GDScriptParser::Node::LITERAL) {
+				const String path = static_cast<const GDScriptParser::LiteralNode *>(preload->path)->value;
+				r_dependencies.insert((path.is_relative_path() ? p_path.get_base_dir().path_join(path) : path).simplify_path());
+			}
+		}
+	}
+}
+
+Vector<GDScriptCache::CompileTime> GDScriptCache::compile_scripts(const Vector<String> &p_paths) {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	// Parse every script not compiled yet in parallel. Each one is parsed twice: once to be shared
+	// with the analyzers of the scripts depending on it, and once for its own compilation.
+	LocalVector<ParseTask> tasks;
+	{
+		MutexLock lock(singleton->mutex);
+		HashSet<String> added;
+		for (const String &path : p_paths) {
+			if (path.is_empty() || added.has(path) || singleton->full_gdscript_cache.has(path) || singleton->parser_map.has(path)) {
+				continue;
+			}
+			added.insert(path);
+			String remapped_path = ResourceLoader::path_remap(path);
+			if (!FileAccess::exists(remapped_path) || FileAccess::exists(GDScriptBytecodeCache::get_cache_path(remapped_path))) {
+				continue; // Missing scripts report errors below, cached ones aren't parsed.
+			}
+
+			ParseTask task;
+			task.path = path;
+			task.read_file = true;
+			task.parser_ref.instantiate();
+			task.parser_ref->path = path;
+			tasks.push_back(task);
+		}
+	}
+	_parse_in_parallel(tasks);
+	uint64_t parse_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	// The graph uses simplified paths, since dependencies are resolved relative to their scripts.
+	HashMap<String, String> batch_paths;
+	HashMap<String, uint64_t> parse_times;
+	HashMap<String, HashSet<String>> dependencies;
+	for (const ParseTask &task : tasks) {
+		const String simplified_path = task.path.simplify_path();
+		batch_paths[simplified_path] = task.path;
+		parse_times[simplified_path] = task.usec;
+
+		GDScriptParserRef *parser_ref = task.parser_ref.ptr();
+		if (parser_ref->get_status() == GDScriptParserRef::PARSED && parser_ref->result == OK) {
+			_get_class_dependencies(parser_ref->get_parser()->get_tree(), task.path, dependencies[simplified_path]);
+		}
+	}
+
+	// Compile along the dependency graph, so the time of each script doesn't include its dependencies.
+	Vector<String> order;
+	HashSet<String> visited;
+	for (const String &path : p_paths) {
+		LocalVector<String> stack;
+		stack.push_back(path.simplify_path());
+		while (!stack.is_empty()) {
+			const String current = stack[stack.size() - 1];
+			if (visited.has(current)) {
+				stack.remove_at(stack.size() - 1);
+				continue;
+			}
+			bool ready = true;
+			if (dependencies.has(current)) {
+				for (const String &dependency : dependencies[current]) {
+					if (!visited.has(dependency) && parse_times.has(dependency) && !stack.has(dependency)) {
+						stack.push_back(dependency);
+						ready = false;
+					}
+				}
+			}
+			if (ready) {
+				visited.insert(current);
+				order.push_back(batch_paths.has(current) ? batch_paths[current] : current);
+				stack.remove_at(stack.size() - 1);
+			}
+		}
+	}
+
+	Vector<CompileTime> times;
+	for (const String &path : order) {
+		CompileTime time;
+		time.path = path;
+		if (parse_times.has(path.simplify_path())) {
+			time.parse_usec = parse_times[path.simplify_path()];
+		}
+		uint64_t compile_begin = OS::get_singleton()->get_ticks_usec();
+		get_full_script(path, time.error);
+		time.compile_usec = OS::get_singleton()->get_ticks_usec() - compile_begin;
+		times.push_back(time);
+
+		if (time.error == OK) {
+			print_verbose(vformat(R"(GDScript: Compiled "%s" in %.2f ms, parsed in %.2f ms.)", path, time.compile_usec / 1000.0, time.parse_usec / 1000.0));
+		}
+	}
+
+	clear_parsed_sources();
+
+	print_verbose(vformat("GDScript: Compiled %d scripts in %.2f ms, parsing %d of them in parallel took %.2f ms.", times.size(), (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0, (int)tasks.size(), parse_usec / 1000.0));
+	return times;
+}
+
+void GDScriptCache::compile_project_scripts() {
+	Vector<String> paths;
+
+	List<StringName> global_classes;
+	ScriptServer::get_global_class_list(&global_classes);
+	for (const StringName &name : global_classes) {
+		if (ScriptServer::get_global_class_language(name) == GDScriptLanguage::get_singleton()->get_name()) {
+			paths.push_back(ScriptServer::get_global_class_path(name));
+		}
+	}
+
+	for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : ProjectSettings::get_singleton()->get_autoload_list()) {
+		if (ResourceLoader::get_resource_type(E.value.path) == "GDScript") {
+			paths.push_back(E.value.path);
+		}
+	}
+
+	compile_scripts(paths);
+}
+
 void GDScriptCache::clear() {
 	if (singleton == nullptr) {
 		return;
@@ -431,8 +755,17 @@ void GDScriptCache::clear() {
 	}
 
 	parser_map_refs.clear();
+	for (KeyValue<String, ParsedSource> &E : singleton->parsed_sources) {
+		memdelete(E.value.parser);
+	}
+	singleton->parsed_sources.clear();
+	for (GDScriptParser *parser : singleton->taken_parsers) {
+		memdelete(parser);
+	}
+	singleton->taken_parsers.clear();
 	singleton->shallow_gdscript_cache.clear();
 	singleton->full_gdscript_cache.clear();
+	singleton->bytecode_cache.clear();
 }
 
 GDScriptCache::GDScriptCache() {
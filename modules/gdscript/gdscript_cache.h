@@ -35,8 +35,10 @@
 
 #include "core/object/ref_counted.h"
 #include "core/os/mutex.h"
+#include "core/os/thread.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
 
 class GDScriptAnalyzer;
 class GDScriptParser;
@@ -77,16 +79,49 @@ public:
 };
 
 class GDScriptCache {
+public:
+	struct CompileTime {
+		String path;
+		uint64_t parse_usec = 0;
+		uint64_t compile_usec = 0;
+		Error error = OK;
+	};
+
+private:
+	struct ParseTask {
+		String path;
+		String source;
+		Vector<uint8_t> binary_tokens;
+		bool read_file = false;
+		Ref<GDScriptParserRef> parser_ref; // Shared with the analyzers of dependent scripts.
+		GDScriptParser *parser = nullptr; // Used by `GDScript::reload()`.
+		uint32_t source_hash = 0;
+		Error error = OK;
+		uint64_t usec = 0;
+	};
+
+	struct ParsedSource {
+		uint32_t source_hash = 0;
+		GDScriptParser *parser = nullptr;
+	};
+
 	// String key is full path.
 	HashMap<String, GDScriptParserRef *> parser_map;
 	HashMap<String, Ref<GDScript>> shallow_gdscript_cache;
 	HashMap<String, Ref<GDScript>> full_gdscript_cache;
 	HashMap<String, Ref<GDScript>> static_gdscript_cache;
 	HashMap<String, HashSet<String>> dependencies;
+	// Decoded bytecode of scripts whose classes were made from it, until they are fully loaded.
+	HashMap<String, Vector<uint8_t>> bytecode_cache;
+	// Sources parsed ahead of `GDScript::reload()`, only handed out to the thread that parsed them.
+	HashMap<String, ParsedSource> parsed_sources;
+	LocalVector<GDScriptParser *> taken_parsers;
+	Thread::ID parsed_sources_thread = Thread::UNASSIGNED_ID;
 
 	friend class GDScript;
 	friend class GDScriptParserRef;
 	friend class GDScriptInstance;
+	friend class GDScriptBytecodeCache;
 
 	static GDScriptCache *singleton;
 
@@ -94,6 +129,9 @@ class GDScriptCache {
 
 	Mutex mutex;
 
+	static void _parse_task(void *p_userdata, uint32_t p_index);
+	static void _parse_in_parallel(LocalVector<ParseTask> &r_tasks);
+
 public:
 	static void move_script(const String &p_from, const String &p_to);
 	static void remove_script(const String &p_path);
@@ -102,6 +140,7 @@ public:
 	static void remove_parser(const String &p_path);
 	static String get_source_code(const String &p_path);
 	static Vector<uint8_t> get_binary_tokens(const String &p_path);
+	static Vector<uint8_t> get_bytecode(const String &p_path);
 	static Ref<GDScript> get_shallow_script(const String &p_path, Error &r_error, const String &p_owner = String());
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String(), bool p_update_from_disk = false);
 	static Ref<GDScript> get_cached_script(const String &p_path);
@@ -109,6 +148,12 @@ public:
 	static void add_static_script(Ref<GDScript> p_script);
 	static void remove_static_script(const String &p_fqcn);
 
+	static void parse_sources(const Vector<Ref<GDScript>> &p_scripts);
+	static GDScriptParser *take_parsed_source(const String &p_path, const String &p_source, const Vector<uint8_t> &p_binary_tokens);
+	static void clear_parsed_sources();
+	static Vector<CompileTime> compile_scripts(const Vector<String> &p_paths);
+	static void compile_project_scripts();
+
 	static void clear();
 
 	GDScriptCache();
@@ -1873,7 +1873,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 
 #ifdef DEBUG_ENABLED
 		// Add a newline before each statement, since the debugger needs those.
-		gen->write_newline(s->start_line);
+		if (!release_export) {
+			gen->write_newline(s->start_line);
+		}
 #endif
 
 		switch (s->type) {
@@ -1925,7 +1927,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 
 #ifdef DEBUG_ENABLED
 					// Add a newline before each branch, since the debugger needs those.
-					gen->write_newline(branch->start_line);
+					if (!release_export) {
+						gen->write_newline(branch->start_line);
+					}
 #endif
 					// For each pattern in branch.
 					GDScriptCodeGenerator::Address pattern_result = codegen.add_temporary();
@@ -2105,6 +2109,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			} break;
 			case GDScriptParser::Node::ASSERT: {
 #ifdef DEBUG_ENABLED
+				if (release_export) {
+					break;
+				}
 				const GDScriptParser::AssertNode *as = static_cast<const GDScriptParser::AssertNode *>(s);
 
 				GDScriptCodeGenerator::Address condition = _parse_expression(codegen, err, as->condition);
@@ -2132,7 +2139,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			} break;
 			case GDScriptParser::Node::BREAKPOINT: {
 #ifdef DEBUG_ENABLED
-				gen->write_breakpoint();
+				if (!release_export) {
+					gen->write_breakpoint();
+				}
 #endif
 			} break;
 			case GDScriptParser::Node::VARIABLE: {
@@ -3224,7 +3233,7 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 	_get_function_ptr_replacements(func_ptr_replacements, old_lambda_info, &new_lambda_info);
 	main_script->_recurse_replace_function_ptrs(func_ptr_replacements);
 
-	if (has_static_data && !root->annotated_static_unload) {
+	if (has_static_data && !root->annotated_static_unload && !release_export) {
 		GDScriptCache::add_static_script(p_script);
 	}
 
@@ -3247,5 +3256,9 @@ int GDScriptCompiler::get_error_column() const {
 	return err_column;
 }
 
+void GDScriptCompiler::set_release_export(bool p_enabled) {
+	release_export = p_enabled;
+}
+
 GDScriptCompiler::GDScriptCompiler() {
 }
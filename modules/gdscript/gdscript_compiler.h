@@ -174,6 +174,7 @@ class GDScriptCompiler {
 	String error;
 	GDScriptParser::ExpressionNode *awaited_node = nullptr;
 	bool has_static_data = false;
+	bool release_export = false;
 
 public:
 	static void convert_to_initializer_type(Variant &p_variant, const GDScriptParser::VariableNode *p_node);
@@ -184,6 +185,10 @@ public:
 	int get_error_line() const;
 	int get_error_column() const;
 
+	// Leaves out the line, breakpoint and assert opcodes of debug builds, as a release build would,
+	// and doesn't register the script's static data. Used for the bytecode of release exports.
+	void set_release_export(bool p_enabled);
+
 	GDScriptCompiler();
 };
 
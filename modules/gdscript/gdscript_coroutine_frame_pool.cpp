@@ -0,0 +1,118 @@
+/**************************************************************************/
+/*  gdscript_coroutine_frame_pool.cpp                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_coroutine_frame_pool.h"
+
+#include "core/os/memory.h"
+
+SpinLock GDScriptCoroutineFramePool::spin_lock;
+GDScriptCoroutineFramePool::SizeClass GDScriptCoroutineFramePool::size_classes[SIZE_CLASS_COUNT];
+
+uint32_t GDScriptCoroutineFramePool::_get_size_class(uint32_t p_size) {
+	uint32_t size_class = 0;
+	while (size_class < SIZE_CLASS_COUNT && p_size > (1u << (MIN_SIZE_SHIFT + size_class))) {
+		size_class++;
+	}
+	return size_class;
+}
+
+uint8_t *GDScriptCoroutineFramePool::allocate(uint32_t p_size) {
+	const uint32_t size_class = _get_size_class(p_size);
+	if (size_class == SIZE_CLASS_COUNT) {
+		return (uint8_t *)memalloc(p_size);
+	}
+
+	spin_lock.lock();
+	SizeClass &sc = size_classes[size_class];
+	FreeFrame *frame = sc.free_frames;
+	if (frame) {
+		sc.free_frames = frame->next;
+		sc.free_count--;
+	}
+	spin_lock.unlock();
+
+	if (frame) {
+		return (uint8_t *)frame;
+	}
+	return (uint8_t *)memalloc(1u << (MIN_SIZE_SHIFT + size_class));
+}
+
+void GDScriptCoroutineFramePool::release(uint8_t *p_frame, uint32_t p_size) {
+	if (p_frame == nullptr) {
+		return;
+	}
+
+	const uint32_t size_class = _get_size_class(p_size);
+	if (size_class < SIZE_CLASS_COUNT) {
+		spin_lock.lock();
+		SizeClass &sc = size_classes[size_class];
+		if (sc.free_count < (MAX_FREE_BYTES >> (MIN_SIZE_SHIFT + size_class))) {
+			FreeFrame *frame = (FreeFrame *)p_frame;
+			frame->next = sc.free_frames;
+			sc.free_frames = frame;
+			sc.free_count++;
+			p_frame = nullptr;
+		}
+		spin_lock.unlock();
+	}
+
+	if (p_frame) {
+		memfree(p_frame);
+	}
+}
+
+uint32_t GDScriptCoroutineFramePool::get_free_frame_count() {
+	spin_lock.lock();
+	uint32_t count = 0;
+	for (const SizeClass &sc : size_classes) {
+		count += sc.free_count;
+	}
+	spin_lock.unlock();
+	return count;
+}
+
+void GDScriptCoroutineFramePool::clear() {
+	spin_lock.lock();
+	FreeFrame *frames[SIZE_CLASS_COUNT];
+	for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+		frames[i] = size_classes[i].free_frames;
+		size_classes[i].free_frames = nullptr;
+		size_classes[i].free_count = 0;
+	}
+	spin_lock.unlock();
+
+	for (FreeFrame *frame : frames) {
+		while (frame) {
+			FreeFrame *next = frame->next;
+			memfree(frame);
+			frame = next;
+		}
+	}
+}
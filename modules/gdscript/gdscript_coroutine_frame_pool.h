@@ -0,0 +1,69 @@
+/**************************************************************************/
+/*  gdscript_coroutine_frame_pool.h                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_COROUTINE_FRAME_POOL_H
+#define GDSCRIPT_COROUTINE_FRAME_POOL_H
+
+#include "core/os/spin_lock.h"
+#include "core/typedefs.h"
+
+// Stack frames of functions suspended by `await`.
+//
+// Frames are rounded up to power of two size classes and recycled through free lists, so awaiting
+// doesn't allocate once a steady state is reached. Each class keeps at most `MAX_FREE_BYTES` of
+// unused frames, and frames larger than the biggest class aren't pooled.
+class GDScriptCoroutineFramePool {
+	static const uint32_t MIN_SIZE_SHIFT = 8;
+	static const uint32_t SIZE_CLASS_COUNT = 12;
+	static const uint32_t MAX_FREE_BYTES = 4 * 1024 * 1024;
+
+	struct FreeFrame {
+		FreeFrame *next = nullptr;
+	};
+
+	struct SizeClass {
+		FreeFrame *free_frames = nullptr;
+		uint32_t free_count = 0;
+	};
+
+	static SpinLock spin_lock;
+	static SizeClass size_classes[SIZE_CLASS_COUNT];
+
+	static uint32_t _get_size_class(uint32_t p_size);
+
+public:
+	static uint8_t *allocate(uint32_t p_size);
+	static void release(uint8_t *p_frame, uint32_t p_size);
+
+	static uint32_t get_free_frame_count();
+	static void clear();
+};
+
+#endif // GDSCRIPT_COROUTINE_FRAME_POOL_H
@@ -128,8 +128,37 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 7 + _pointer_size;
 			} break;
-			case OPCODE_OPERATOR_VALIDATED: {
-				text += "validated operator ";
+			case OPCODE_OPERATOR_VALIDATED:
+			case OPCODE_OPERATOR_ADD_INT:
+			case OPCODE_OPERATOR_SUBTRACT_INT:
+			case OPCODE_OPERATOR_MULTIPLY_INT:
+			case OPCODE_OPERATOR_EQUAL_INT:
+			case OPCODE_OPERATOR_NOT_EQUAL_INT:
+			case OPCODE_OPERATOR_LESS_INT:
+			case OPCODE_OPERATOR_LESS_EQUAL_INT:
+			case OPCODE_OPERATOR_GREATER_INT:
+			case OPCODE_OPERATOR_GREATER_EQUAL_INT:
+			case OPCODE_OPERATOR_ADD_FLOAT:
+			case OPCODE_OPERATOR_SUBTRACT_FLOAT:
+			case OPCODE_OPERATOR_MULTIPLY_FLOAT:
+			case OPCODE_OPERATOR_DIVIDE_FLOAT:
+			case OPCODE_OPERATOR_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_NOT_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_LESS_FLOAT:
+			case OPCODE_OPERATOR_LESS_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_GREATER_FLOAT:
+			case OPCODE_OPERATOR_GREATER_EQUAL_FLOAT:
+			case OPCODE_OPERATOR_ADD_VECTOR2:
+			case OPCODE_OPERATOR_SUBTRACT_VECTOR2:
+			case OPCODE_OPERATOR_MULTIPLY_VECTOR2:
+			case OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT:
+			case OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT:
+			case OPCODE_OPERATOR_ADD_VECTOR3:
+			case OPCODE_OPERATOR_SUBTRACT_VECTOR3:
+			case OPCODE_OPERATOR_MULTIPLY_VECTOR3:
+			case OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT:
+			case OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT: {
+				text += _code_ptr[ip] == OPCODE_OPERATOR_VALIDATED ? "validated operator " : "typed operator ";
 
 				text += DADDR(3);
 				text += " = ";
@@ -141,6 +170,51 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_OPERATOR_VALIDATED_JUMP_IF:
+			case OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_EQUAL_INT_JUMP_IF:
+			case OPCODE_OPERATOR_EQUAL_INT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_NOT_EQUAL_INT_JUMP_IF:
+			case OPCODE_OPERATOR_NOT_EQUAL_INT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_LESS_INT_JUMP_IF:
+			case OPCODE_OPERATOR_LESS_INT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_LESS_EQUAL_INT_JUMP_IF:
+			case OPCODE_OPERATOR_LESS_EQUAL_INT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_GREATER_INT_JUMP_IF:
+			case OPCODE_OPERATOR_GREATER_INT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_GREATER_EQUAL_INT_JUMP_IF:
+			case OPCODE_OPERATOR_GREATER_EQUAL_INT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_EQUAL_FLOAT_JUMP_IF:
+			case OPCODE_OPERATOR_EQUAL_FLOAT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_NOT_EQUAL_FLOAT_JUMP_IF:
+			case OPCODE_OPERATOR_NOT_EQUAL_FLOAT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_LESS_FLOAT_JUMP_IF:
+			case OPCODE_OPERATOR_LESS_FLOAT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_LESS_EQUAL_FLOAT_JUMP_IF:
+			case OPCODE_OPERATOR_LESS_EQUAL_FLOAT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_GREATER_FLOAT_JUMP_IF:
+			case OPCODE_OPERATOR_GREATER_FLOAT_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_GREATER_EQUAL_FLOAT_JUMP_IF:
+			case OPCODE_OPERATOR_GREATER_EQUAL_FLOAT_JUMP_IF_NOT: {
+				bool is_typed = _code_ptr[ip] >= OPCODE_OPERATOR_EQUAL_INT_JUMP_IF;
+				// Typed compare-and-jump opcodes come in pairs, the jump-if one first.
+				bool jump_if = is_typed ? (_code_ptr[ip] - OPCODE_OPERATOR_EQUAL_INT_JUMP_IF) % 2 == 0 : _code_ptr[ip] == OPCODE_OPERATOR_VALIDATED_JUMP_IF;
+				text += is_typed ? "typed operator " : "validated operator ";
+
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += " ";
+				text += operator_names[_code_ptr[ip + 4]];
+				text += " ";
+				text += DADDR(2);
+				text += jump_if ? ", jump-if " : ", jump-if-not ";
+				text += DADDR(3);
+				text += " to ";
+				text += itos(_code_ptr[ip + 5]);
+
+				incr += 6;
+			} break;
 			case OPCODE_TYPE_TEST_BUILTIN: {
 				text += "type test ";
 				text += DADDR(1);
@@ -216,8 +290,18 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
-			case OPCODE_SET_INDEXED_VALIDATED: {
-				text += "set indexed validated ";
+			case OPCODE_SET_INDEXED_VALIDATED:
+			case OPCODE_SET_INDEXED_PACKED_BYTE_ARRAY:
+			case OPCODE_SET_INDEXED_PACKED_INT32_ARRAY:
+			case OPCODE_SET_INDEXED_PACKED_INT64_ARRAY:
+			case OPCODE_SET_INDEXED_PACKED_FLOAT32_ARRAY:
+			case OPCODE_SET_INDEXED_PACKED_FLOAT64_ARRAY:
+			case OPCODE_SET_INDEXED_PACKED_STRING_ARRAY:
+			case OPCODE_SET_INDEXED_PACKED_VECTOR2_ARRAY:
+			case OPCODE_SET_INDEXED_PACKED_VECTOR3_ARRAY:
+			case OPCODE_SET_INDEXED_PACKED_COLOR_ARRAY:
+			case OPCODE_SET_INDEXED_PACKED_VECTOR4_ARRAY: {
+				text += _code_ptr[ip] == OPCODE_SET_INDEXED_VALIDATED ? "set indexed validated " : "set indexed packed ";
 				text += DADDR(1);
 				text += "[";
 				text += DADDR(2);
@@ -248,8 +332,18 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
-			case OPCODE_GET_INDEXED_VALIDATED: {
-				text += "get indexed validated ";
+			case OPCODE_GET_INDEXED_VALIDATED:
+			case OPCODE_GET_INDEXED_PACKED_BYTE_ARRAY:
+			case OPCODE_GET_INDEXED_PACKED_INT32_ARRAY:
+			case OPCODE_GET_INDEXED_PACKED_INT64_ARRAY:
+			case OPCODE_GET_INDEXED_PACKED_FLOAT32_ARRAY:
+			case OPCODE_GET_INDEXED_PACKED_FLOAT64_ARRAY:
+			case OPCODE_GET_INDEXED_PACKED_STRING_ARRAY:
+			case OPCODE_GET_INDEXED_PACKED_VECTOR2_ARRAY:
+			case OPCODE_GET_INDEXED_PACKED_VECTOR3_ARRAY:
+			case OPCODE_GET_INDEXED_PACKED_COLOR_ARRAY:
+			case OPCODE_GET_INDEXED_PACKED_VECTOR4_ARRAY: {
+				text += _code_ptr[ip] == OPCODE_GET_INDEXED_VALIDATED ? "get indexed validated " : "get indexed packed ";
 				text += DADDR(3);
 				text += " = ";
 				text += DADDR(1);
@@ -267,7 +361,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += "\"] = ";
 				text += DADDR(2);
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_SET_NAMED_VALIDATED: {
 				text += "set_named validated ";
@@ -288,7 +382,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -597,7 +691,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
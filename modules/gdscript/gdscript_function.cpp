@@ -31,6 +31,9 @@
 #include "gdscript_function.h"
 
 #include "gdscript.h"
+#include "gdscript_coroutine_frame_pool.h"
+#include "gdscript_inline_cache.h"
+#include "gdscript_jit.h"
 
 Variant GDScriptFunction::get_constant(int p_idx) const {
 	ERR_FAIL_INDEX_V(p_idx, constants.size(), "<errconst>");
@@ -117,6 +120,12 @@ GDScriptFunction::GDScriptFunction() {
 GDScriptFunction::~GDScriptFunction() {
 	get_script()->member_functions.erase(name);
 
+	GDScriptJIT::free_function(this);
+
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+	}
+
 	for (int i = 0; i < lambdas.size(); i++) {
 		memdelete(lambdas[i]);
 	}
@@ -134,25 +143,28 @@ GDScriptFunction::~GDScriptFunction() {
 
 /////////////////////
 
+Variant GDScriptFunctionState::_get_signal_result(const Variant **p_args, int p_argcount) {
+	if (p_argcount == 0) {
+		return Variant();
+	} else if (p_argcount == 1) {
+		return *p_args[0];
+	}
+	Array extra_args;
+	for (int i = 0; i < p_argcount; i++) {
+		extra_args.push_back(*p_args[i]);
+	}
+	return extra_args;
+}
+
 Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
-	Variant arg;
 	r_error.error = Callable::CallError::CALL_OK;
 
 	if (p_argcount == 0) {
 		r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
 		r_error.expected = 1;
 		return Variant();
-	} else if (p_argcount == 1) {
-		//noooneee
-	} else if (p_argcount == 2) {
-		arg = *p_args[0];
-	} else {
-		Array extra_args;
-		for (int i = 0; i < p_argcount - 1; i++) {
-			extra_args.push_back(*p_args[i]);
-		}
-		arg = extra_args;
 	}
+	Variant arg = _get_signal_result(p_args, p_argcount - 1);
 
 	Ref<GDScriptFunctionState> self = *p_args[p_argcount - 1];
 
@@ -241,23 +253,28 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 		if (EngineDebugger::is_active()) {
 			GDScriptLanguage::get_singleton()->exit_function();
 		}
+#endif
 
 		_clear_stack();
-#endif
 	}
 
 	return ret;
 }
 
 void GDScriptFunctionState::_clear_stack() {
-	if (state.stack_size) {
-		Variant *stack = (Variant *)state.stack.ptr();
-		// The first 3 are special addresses and not copied to the state, so we skip them here.
-		for (int i = 3; i < state.stack_size; i++) {
-			stack[i].~Variant();
-		}
-		state.stack_size = 0;
+	// Detached first, since freeing the stack may free this state too.
+	uint8_t *frame = state.stack;
+	int stack_size = state.stack_size;
+	uint32_t frame_size = state.alloca_size;
+	state.stack = nullptr;
+	state.stack_size = 0;
+
+	Variant *stack = (Variant *)frame;
+	// The first 3 are special addresses and not copied to the state, so we skip them here.
+	for (int i = 3; i < stack_size; i++) {
+		stack[i].~Variant();
 	}
+	GDScriptCoroutineFramePool::release(frame, frame_size);
 }
 
 void GDScriptFunctionState::_clear_connections() {
@@ -288,4 +305,49 @@ GDScriptFunctionState::~GDScriptFunctionState() {
 		scripts_list.remove_from_list();
 		instances_list.remove_from_list();
 	}
+	_clear_stack();
+}
+
+bool GDScriptFunctionStateCallable::compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+	// Only compared by reference, each await connects its own callable.
+	return p_a == p_b;
+}
+
+bool GDScriptFunctionStateCallable::compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+	return p_a < p_b;
+}
+
+uint32_t GDScriptFunctionStateCallable::hash() const {
+	return hash_murmur3_one_64((uint64_t)state->get_instance_id());
+}
+
+String GDScriptFunctionStateCallable::get_as_text() const {
+	return "GDScriptFunctionState::_signal_callback";
+}
+
+CallableCustom::CompareEqualFunc GDScriptFunctionStateCallable::get_compare_equal_func() const {
+	return compare_equal;
+}
+
+CallableCustom::CompareLessFunc GDScriptFunctionStateCallable::get_compare_less_func() const {
+	return compare_less;
+}
+
+ObjectID GDScriptFunctionStateCallable::get_object() const {
+	return state->get_instance_id();
+}
+
+StringName GDScriptFunctionStateCallable::get_method() const {
+	return SNAME("_signal_callback");
+}
+
+void GDScriptFunctionStateCallable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const {
+	r_call_error.error = Callable::CallError::CALL_OK;
+	// Keeps the state alive even if resuming disconnects this callable.
+	Ref<GDScriptFunctionState> self = state;
+	r_return_value = self->resume(GDScriptFunctionState::_get_signal_result(p_arguments, p_argcount));
+}
+
+GDScriptFunctionStateCallable::GDScriptFunctionStateCallable(const Ref<GDScriptFunctionState> &p_state) :
+		state(p_state) {
 }
@@ -41,6 +41,7 @@
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
 
+class GDScriptInlineCache;
 class GDScriptInstance;
 class GDScript;
 
@@ -218,6 +219,61 @@ public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		OPCODE_OPERATOR_VALIDATED_JUMP_IF,
+		OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT,
+		OPCODE_OPERATOR_ADD_INT,
+		OPCODE_OPERATOR_SUBTRACT_INT,
+		OPCODE_OPERATOR_MULTIPLY_INT,
+		OPCODE_OPERATOR_EQUAL_INT,
+		OPCODE_OPERATOR_NOT_EQUAL_INT,
+		OPCODE_OPERATOR_LESS_INT,
+		OPCODE_OPERATOR_LESS_EQUAL_INT,
+		OPCODE_OPERATOR_GREATER_INT,
+		OPCODE_OPERATOR_GREATER_EQUAL_INT,
+		OPCODE_OPERATOR_ADD_FLOAT,
+		OPCODE_OPERATOR_SUBTRACT_FLOAT,
+		OPCODE_OPERATOR_MULTIPLY_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_FLOAT,
+		OPCODE_OPERATOR_EQUAL_FLOAT,
+		OPCODE_OPERATOR_NOT_EQUAL_FLOAT,
+		OPCODE_OPERATOR_LESS_FLOAT,
+		OPCODE_OPERATOR_LESS_EQUAL_FLOAT,
+		OPCODE_OPERATOR_GREATER_FLOAT,
+		OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,
+		OPCODE_OPERATOR_ADD_VECTOR2,
+		OPCODE_OPERATOR_SUBTRACT_VECTOR2,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR2,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT,
+		OPCODE_OPERATOR_ADD_VECTOR3,
+		OPCODE_OPERATOR_SUBTRACT_VECTOR3,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR3,
+		OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT,
+		OPCODE_OPERATOR_EQUAL_INT_JUMP_IF,
+		OPCODE_OPERATOR_EQUAL_INT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_NOT_EQUAL_INT_JUMP_IF,
+		OPCODE_OPERATOR_NOT_EQUAL_INT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_LESS_INT_JUMP_IF,
+		OPCODE_OPERATOR_LESS_INT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_LESS_EQUAL_INT_JUMP_IF,
+		OPCODE_OPERATOR_LESS_EQUAL_INT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_GREATER_INT_JUMP_IF,
+		OPCODE_OPERATOR_GREATER_INT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_GREATER_EQUAL_INT_JUMP_IF,
+		OPCODE_OPERATOR_GREATER_EQUAL_INT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_EQUAL_FLOAT_JUMP_IF,
+		OPCODE_OPERATOR_EQUAL_FLOAT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_NOT_EQUAL_FLOAT_JUMP_IF,
+		OPCODE_OPERATOR_NOT_EQUAL_FLOAT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_LESS_FLOAT_JUMP_IF,
+		OPCODE_OPERATOR_LESS_FLOAT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_LESS_EQUAL_FLOAT_JUMP_IF,
+		OPCODE_OPERATOR_LESS_EQUAL_FLOAT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_GREATER_FLOAT_JUMP_IF,
+		OPCODE_OPERATOR_GREATER_FLOAT_JUMP_IF_NOT,
+		OPCODE_OPERATOR_GREATER_EQUAL_FLOAT_JUMP_IF,
+		OPCODE_OPERATOR_GREATER_EQUAL_FLOAT_JUMP_IF_NOT,
 		OPCODE_TYPE_TEST_BUILTIN,
 		OPCODE_TYPE_TEST_ARRAY,
 		OPCODE_TYPE_TEST_NATIVE,
@@ -225,9 +281,29 @@ public:
 		OPCODE_SET_KEYED,
 		OPCODE_SET_KEYED_VALIDATED,
 		OPCODE_SET_INDEXED_VALIDATED,
+		OPCODE_SET_INDEXED_PACKED_BYTE_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_INT32_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_INT64_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_FLOAT32_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_FLOAT64_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_STRING_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_VECTOR2_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_VECTOR3_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_COLOR_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_VECTOR4_ARRAY,
 		OPCODE_GET_KEYED,
 		OPCODE_GET_KEYED_VALIDATED,
 		OPCODE_GET_INDEXED_VALIDATED,
+		OPCODE_GET_INDEXED_PACKED_BYTE_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_INT32_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_INT64_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_FLOAT32_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_FLOAT64_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_STRING_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_VECTOR2_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_VECTOR3_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_COLOR_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_VECTOR4_ARRAY,
 		OPCODE_SET_NAMED,
 		OPCODE_SET_NAMED_VALIDATED,
 		OPCODE_GET_NAMED,
@@ -402,6 +478,12 @@ private:
 	friend class GDScriptCompiler;
 	friend class GDScriptByteCodeGenerator;
 	friend class GDScriptLanguage;
+	friend class GDScriptBytecodeCache;
+	friend class GDScriptJIT;
+
+	// Native code generated by GDScriptJIT. Starts at the function entry, or at `p_entry` which
+	// must be the native code of the instruction at `p_ip`. Returns the position where the VM must continue.
+	typedef int (*JITFunction)(Variant **p_addresses, int *r_line, int p_ip, const void *p_entry);
 
 	StringName name;
 	StringName source;
@@ -439,6 +521,7 @@ private:
 	Vector<GDScriptUtilityFunctions::FunctionPtr> gds_utilities;
 	Vector<MethodBind *> methods;
 	Vector<GDScriptFunction *> lambdas;
+	Vector<int> global_index_positions; // Code positions holding indices into the global array.
 
 	int _code_size = 0;
 	int _default_arg_count = 0;
@@ -457,6 +540,7 @@ private:
 	int _gds_utilities_count = 0;
 	int _methods_count = 0;
 	int _lambdas_count = 0;
+	int _inline_cache_count = 0;
 
 	int *_code_ptr = nullptr;
 	const int *_default_arg_ptr = nullptr;
@@ -475,6 +559,12 @@ private:
 	const GDScriptUtilityFunctions::FunctionPtr *_gds_utilities_ptr = nullptr;
 	MethodBind **_methods_ptr = nullptr;
 	GDScriptFunction **_lambdas_ptr = nullptr;
+	GDScriptInlineCache *_inline_caches_ptr = nullptr;
+
+	SafeNumeric<uint32_t> jit_call_count;
+	std::atomic<JITFunction> jit_function = { nullptr };
+	uint32_t jit_code_size = 0;
+	HashMap<int, uint32_t> jit_entries; // Offsets of the native code of each instruction the VM can jump back into.
 
 #ifdef DEBUG_ENABLED
 	CharString func_cname;
@@ -522,7 +612,7 @@ public:
 		StringName function_name;
 		String script_path;
 #endif
-		Vector<uint8_t> stack;
+		uint8_t *stack = nullptr; // From `GDScriptCoroutineFramePool`, `alloca_size` bytes.
 		int stack_size = 0;
 		uint32_t alloca_size = 0;
 		int ip = 0;
@@ -558,8 +648,10 @@ public:
 class GDScriptFunctionState : public RefCounted {
 	GDCLASS(GDScriptFunctionState, RefCounted);
 	friend class GDScriptFunction;
+	friend class GDScriptFunctionStateCallable;
 	GDScriptFunction *function = nullptr;
 	GDScriptFunction::CallState state;
+	static Variant _get_signal_result(const Variant **p_args, int p_argcount);
 	Variant _signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	Ref<GDScriptFunctionState> first_state;
 
@@ -580,4 +672,24 @@ public:
 	~GDScriptFunctionState();
 };
 
+// Connected to the signal a function awaits, resumes its state directly instead of going
+// through a bound `_signal_callback` method call.
+class GDScriptFunctionStateCallable : public CallableCustom {
+	Ref<GDScriptFunctionState> state;
+
+	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b);
+	static bool compare_less(const CallableCustom *p_a, const CallableCustom *p_b);
+
+public:
+	uint32_t hash() const override;
+	String get_as_text() const override;
+	CompareEqualFunc get_compare_equal_func() const override;
+	CompareLessFunc get_compare_less_func() const override;
+	ObjectID get_object() const override;
+	StringName get_method() const override;
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override;
+
+	GDScriptFunctionStateCallable(const Ref<GDScriptFunctionState> &p_state);
+};
+
 #endif // GDSCRIPT_FUNCTION_H
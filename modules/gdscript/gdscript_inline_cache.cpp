@@ -0,0 +1,426 @@
+/**************************************************************************/
+/*  gdscript_inline_cache.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_inline_cache.h"
+
+#include "gdscript.h"
+
+#include "core/config/engine.h"
+#include "core/object/class_db.h"
+#include "core/variant/variant_internal.h"
+#include "scene/scene_string_names.h"
+
+SafeNumeric<uint32_t> GDScriptInlineCache::epoch;
+
+bool GDScriptInlineCache::_get_receiver(const Variant *p_base, Receiver &r_receiver) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		// Builtin types can't be confused with pointers.
+		r_receiver.type_key = (const void *)(uintptr_t)(p_base->get_type() + 1);
+		return true;
+	}
+
+	Object *object = p_base->get_validated_object();
+	if (unlikely(!object)) {
+		return false; // Let the generic path report the error.
+	}
+	ScriptInstance *script_instance = object->get_script_instance();
+	if (script_instance) {
+		if (script_instance->is_placeholder() || script_instance->get_language() != GDScriptLanguage::get_singleton()) {
+			return false;
+		}
+		r_receiver.instance = static_cast<GDScriptInstance *>(script_instance);
+		r_receiver.script = r_receiver.instance->script.ptr();
+	}
+	r_receiver.object = object;
+	r_receiver.type_key = object->get_class_name().data_unique_pointer();
+	return true;
+}
+
+GDScriptFunction *GDScriptInlineCache::_find_function(GDScript *p_script, const StringName &p_name) {
+	for (GDScript *script = p_script; script; script = script->_base) {
+		HashMap<StringName, GDScriptFunction *>::Iterator E = script->member_functions.find(p_name);
+		if (E) {
+			return E->value;
+		}
+	}
+	return nullptr;
+}
+
+// Whether anything in the script, other than members, answers to the name before the native class.
+bool GDScriptInlineCache::_has_script_name(GDScript *p_script, const StringName &p_name, const StringName &p_fallback_function) {
+	for (GDScript *script = p_script; script; script = script->_base) {
+		if (script->constants.has(p_name) || script->static_variables_indices.has(p_name) || script->_signals.has(p_name) ||
+				script->member_functions.has(p_name) || script->subclasses.has(p_name) || script->member_functions.has(p_fallback_function)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool GDScriptInlineCache::_is_native_cacheable(const Receiver &p_receiver) {
+	// Extensions can intercept properties before ClassDB.
+	ClassDB::APIType api = ClassDB::get_api_type(p_receiver.object->get_class_name());
+	return api != ClassDB::API_EXTENSION && api != ClassDB::API_EDITOR_EXTENSION;
+}
+
+bool GDScriptInlineCache::_find(const Receiver &p_receiver, Entry &r_entry, bool &r_can_add) const {
+	uint32_t current_state = state.load(std::memory_order_acquire);
+	if (current_state & STATE_LOCKED) {
+		r_can_add = false; // Another thread is adding an entry, use the generic path meanwhile.
+		return false;
+	}
+	if ((current_state >> STATE_EPOCH_SHIFT) != _get_epoch_bits()) {
+		r_can_add = true;
+		return false;
+	}
+	const Entry *current_entries = entries.load(std::memory_order_acquire);
+	int count = current_state & STATE_COUNT_MASK;
+	for (int i = 0; i < count; i++) {
+		const Entry &entry = current_entries[i];
+		if (entry.type_key == p_receiver.type_key && entry.script == p_receiver.script) {
+			r_entry = entry;
+			// Existing entries are only rewritten after the epoch changed, check it didn't while copying.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint32_t new_state = state.load(std::memory_order_relaxed);
+			r_can_add = false;
+			return (new_state & ~STATE_COUNT_MASK) == (current_state & ~STATE_COUNT_MASK);
+		}
+	}
+	r_can_add = count < MAX_ENTRIES;
+	return false;
+}
+
+void GDScriptInlineCache::_add(const Entry &p_entry) {
+	Entry *current_entries = entries.load(std::memory_order_acquire);
+	if (!current_entries) {
+		Entry *new_entries = memnew_arr(Entry, MAX_ENTRIES);
+		if (entries.compare_exchange_strong(current_entries, new_entries, std::memory_order_acq_rel)) {
+			current_entries = new_entries;
+		} else {
+			memdelete_arr(new_entries);
+		}
+	}
+
+	uint32_t current_state = state.load(std::memory_order_relaxed);
+	if ((current_state & STATE_LOCKED) || !state.compare_exchange_strong(current_state, current_state | STATE_LOCKED, std::memory_order_acquire)) {
+		return; // Another thread is updating the site, this execution can still use the resolved entry.
+	}
+	// Readers that see the new entry data must also see the lock.
+	std::atomic_thread_fence(std::memory_order_release);
+
+	uint32_t epoch_bits = _get_epoch_bits();
+	uint32_t count = (current_state >> STATE_EPOCH_SHIFT) == epoch_bits ? (current_state & STATE_COUNT_MASK) : 0;
+	if (count < MAX_ENTRIES) {
+		current_entries[count++] = p_entry;
+	}
+	state.store((epoch_bits << STATE_EPOCH_SHIFT) | count, std::memory_order_release);
+}
+
+void GDScriptInlineCache::_resolve_get(const Receiver &p_receiver, const StringName &p_name, Entry &r_entry) {
+	if (!p_receiver.object) {
+		Variant::Type type = Variant::Type((uintptr_t)p_receiver.type_key - 1);
+		r_entry.getter = Variant::get_member_validated_getter(type, p_name);
+		if (r_entry.getter) {
+			r_entry.value_type = Variant::get_member_type(type, p_name);
+			r_entry.kind = KIND_BUILTIN_MEMBER;
+		}
+		return;
+	}
+
+	if (p_receiver.script) {
+		if (!p_receiver.script->valid) {
+			return;
+		}
+		HashMap<StringName, GDScript::MemberInfo>::ConstIterator E = p_receiver.script->member_indices.find(p_name);
+		if (E) {
+			r_entry.index = E->value.index;
+			r_entry.function = E->value.getter ? _find_function(p_receiver.script, E->value.getter) : nullptr;
+			r_entry.kind = r_entry.function ? KIND_SCRIPT_FUNCTION : KIND_SCRIPT_MEMBER;
+			return;
+		}
+		if (_has_script_name(p_receiver.script, p_name, GDScriptLanguage::get_singleton()->strings._get)) {
+			return;
+		}
+	}
+
+	if (!_is_native_cacheable(p_receiver)) {
+		return;
+	}
+	const StringName &class_name = p_receiver.object->get_class_name();
+	StringName getter = ClassDB::get_property_getter(class_name, p_name);
+	if (getter == StringName()) {
+		return;
+	}
+	r_entry.index = ClassDB::get_property_index(class_name, p_name);
+	if (r_entry.index >= 0 && p_receiver.script) {
+		return; // Indexed getters are called by name, so scripts could override them.
+	}
+	r_entry.method = ClassDB::get_method(class_name, getter);
+	if (r_entry.method) {
+		r_entry.kind = KIND_NATIVE_METHOD;
+	}
+}
+
+void GDScriptInlineCache::_resolve_set(const Receiver &p_receiver, const StringName &p_name, Entry &r_entry) {
+	if (!p_receiver.object) {
+		Variant::Type type = Variant::Type((uintptr_t)p_receiver.type_key - 1);
+		r_entry.setter = Variant::get_member_validated_setter(type, p_name);
+		if (r_entry.setter) {
+			r_entry.value_type = Variant::get_member_type(type, p_name);
+			r_entry.kind = KIND_BUILTIN_MEMBER;
+		}
+		return;
+	}
+
+	if (p_receiver.script) {
+		if (!p_receiver.script->valid) {
+			return;
+		}
+		HashMap<StringName, GDScript::MemberInfo>::ConstIterator E = p_receiver.script->member_indices.find(p_name);
+		if (E) {
+			r_entry.index = E->value.index;
+			r_entry.data_type = E->value.data_type.has_type ? &E->value.data_type : nullptr;
+			if (E->value.setter) {
+				r_entry.function = _find_function(p_receiver.script, E->value.setter);
+				if (r_entry.function) {
+					r_entry.kind = KIND_SCRIPT_FUNCTION;
+				}
+			} else {
+				r_entry.kind = KIND_SCRIPT_MEMBER;
+			}
+			return;
+		}
+		for (GDScript *script = p_receiver.script; script; script = script->_base) {
+			if (script->static_variables_indices.has(p_name) || script->member_functions.has(GDScriptLanguage::get_singleton()->strings._set)) {
+				return;
+			}
+		}
+	}
+
+	if (!_is_native_cacheable(p_receiver)) {
+		return;
+	}
+	const StringName &class_name = p_receiver.object->get_class_name();
+	StringName setter = ClassDB::get_property_setter(class_name, p_name);
+	if (setter == StringName()) {
+		return;
+	}
+	r_entry.index = ClassDB::get_property_index(class_name, p_name);
+	if (r_entry.index >= 0 && p_receiver.script) {
+		return; // Indexed setters are called by name, so scripts could override them.
+	}
+	r_entry.method = ClassDB::get_method(class_name, setter);
+	if (r_entry.method) {
+		r_entry.kind = KIND_NATIVE_METHOD;
+	}
+}
+
+void GDScriptInlineCache::_resolve_call(const Receiver &p_receiver, const StringName &p_name, Entry &r_entry) {
+	if (!p_receiver.object || p_name == CoreStringName(free_)) {
+		return;
+	}
+
+	if (p_receiver.script) {
+		if (!p_receiver.script->valid || p_name == SceneStringName(_ready)) {
+			return; // `_ready()` also runs the implicit initializers.
+		}
+		r_entry.function = _find_function(p_receiver.script, p_name);
+		if (r_entry.function) {
+			r_entry.kind = KIND_SCRIPT_FUNCTION;
+			return;
+		}
+	}
+
+	r_entry.method = ClassDB::get_method(p_receiver.object->get_class_name(), p_name);
+	if (r_entry.method) {
+		r_entry.kind = KIND_NATIVE_METHOD;
+	}
+}
+
+bool GDScriptInlineCache::get_named(const Variant *p_base, const StringName &p_name, Variant &r_value) {
+	Receiver receiver;
+	if (!_get_receiver(p_base, receiver)) {
+		return false;
+	}
+
+	// Copied, since the calls below can run code that updates this site.
+	Entry entry;
+	bool can_add = false;
+	if (!_find(receiver, entry, can_add)) {
+		if (!can_add) {
+			return false;
+		}
+		entry.script = receiver.script;
+		entry.type_key = receiver.type_key;
+		_resolve_get(receiver, p_name, entry);
+		_add(entry);
+	}
+
+	switch (entry.kind) {
+		case KIND_SCRIPT_MEMBER: {
+			r_value = receiver.instance->members[entry.index];
+		} break;
+		case KIND_SCRIPT_FUNCTION: {
+			Callable::CallError err;
+			r_value = entry.function->call(receiver.instance, nullptr, 0, err);
+			if (err.error != Callable::CallError::CALL_OK) {
+				r_value = receiver.instance->members[entry.index];
+			}
+		} break;
+		case KIND_NATIVE_METHOD: {
+			Callable::CallError err;
+			if (entry.index >= 0) {
+				Variant index = entry.index;
+				const Variant *args[1] = { &index };
+				r_value = entry.method->call(receiver.object, args, 1, err);
+			} else {
+				r_value = entry.method->call(receiver.object, nullptr, 0, err);
+			}
+		} break;
+		case KIND_BUILTIN_MEMBER: {
+			VariantInternal::initialize(&r_value, entry.value_type);
+			entry.getter(p_base, &r_value);
+		} break;
+		case KIND_NONE: {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GDScriptInlineCache::set_named(Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid) {
+#ifdef TOOLS_ENABLED
+	if (p_base->get_type() == Variant::OBJECT && Engine::get_singleton()->is_editor_hint()) {
+		return false; // The generic path also marks the object as edited.
+	}
+#endif
+
+	Receiver receiver;
+	if (!_get_receiver(p_base, receiver)) {
+		return false;
+	}
+
+	Entry entry;
+	bool can_add = false;
+	if (!_find(receiver, entry, can_add)) {
+		if (!can_add) {
+			return false;
+		}
+		entry.script = receiver.script;
+		entry.type_key = receiver.type_key;
+		_resolve_set(receiver, p_name, entry);
+		_add(entry);
+	}
+
+	switch (entry.kind) {
+		case KIND_SCRIPT_MEMBER:
+		case KIND_SCRIPT_FUNCTION: {
+			if (entry.data_type && !entry.data_type->is_type(p_value)) {
+				return false; // Let the generic path convert the value.
+			}
+			if (entry.kind == KIND_SCRIPT_MEMBER) {
+				receiver.instance->members.write[entry.index] = p_value;
+				r_valid = true;
+			} else {
+				const Variant *args[1] = { &p_value };
+				Callable::CallError err;
+				entry.function->call(receiver.instance, args, 1, err);
+				r_valid = err.error == Callable::CallError::CALL_OK;
+			}
+		} break;
+		case KIND_NATIVE_METHOD: {
+			Callable::CallError err;
+			if (entry.index >= 0) {
+				Variant index = entry.index;
+				const Variant *args[2] = { &index, &p_value };
+				entry.method->call(receiver.object, args, 2, err);
+			} else {
+				const Variant *args[1] = { &p_value };
+				entry.method->call(receiver.object, args, 1, err);
+			}
+			r_valid = err.error == Callable::CallError::CALL_OK;
+		} break;
+		case KIND_BUILTIN_MEMBER: {
+			if (p_value.get_type() != entry.value_type) {
+				return false;
+			}
+			entry.setter(p_base, &p_value);
+			r_valid = true;
+		} break;
+		case KIND_NONE: {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GDScriptInlineCache::call(Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
+	Receiver receiver;
+	if (p_base->get_type() != Variant::OBJECT || !_get_receiver(p_base, receiver)) {
+		return false;
+	}
+
+	Entry entry;
+	bool can_add = false;
+	if (!_find(receiver, entry, can_add)) {
+		if (!can_add) {
+			return false;
+		}
+		entry.script = receiver.script;
+		entry.type_key = receiver.type_key;
+		_resolve_call(receiver, p_name, entry);
+		_add(entry);
+	}
+
+#ifdef DEBUG_ENABLED
+	// Same as `Object::callp()`, the object can't be freed while the call runs.
+	_ObjectDebugLock debug_lock(receiver.object);
+#endif
+
+	switch (entry.kind) {
+		case KIND_SCRIPT_FUNCTION: {
+			r_ret = entry.function->call(receiver.instance, p_args, p_argcount, r_error);
+		} break;
+		case KIND_NATIVE_METHOD: {
+			r_ret = entry.method->call(receiver.object, p_args, p_argcount, r_error);
+		} break;
+		default: {
+			return false;
+		}
+	}
+	return true;
+}
+
+GDScriptInlineCache::~GDScriptInlineCache() {
+	Entry *current_entries = entries.load(std::memory_order_acquire);
+	if (current_entries) {
+		memdelete_arr(current_entries);
+	}
+}
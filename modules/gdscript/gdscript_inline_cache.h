@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*  gdscript_inline_cache.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_INLINE_CACHE_H
+#define GDSCRIPT_INLINE_CACHE_H
+
+#include "core/templates/safe_refcount.h"
+#include "core/variant/variant.h"
+
+class GDScript;
+class GDScriptDataType;
+class GDScriptFunction;
+class GDScriptInstance;
+class MethodBind;
+class Object;
+
+// Cache of a single named access or call site for untyped receivers.
+//
+// Entries are keyed on the receiver's script and native class (or builtin type), and store what
+// the generic lookup resolved for them: a script member index, a script function, a MethodBind or
+// a validated builtin accessor. Up to `MAX_ENTRIES` receiver types are remembered, after which
+// the site is considered megamorphic and always uses the generic path.
+//
+// Entries live in a fixed array that is only appended to until the epoch changes, and `state`
+// packs the epoch and entry count. Readers copy an entry out and check that `state` still has the
+// same epoch afterwards, so threads can read without locking and nothing needs to be reclaimed.
+// Writers take the lock bit of `state`, and give up if another thread holds it. Reloading or
+// freeing any script invalidates all caches.
+class GDScriptInlineCache {
+public:
+	static const int MAX_ENTRIES = 4;
+
+private:
+	enum Kind {
+		KIND_NONE, // Not cacheable, use the generic path.
+		KIND_SCRIPT_MEMBER,
+		KIND_SCRIPT_FUNCTION, // Also script getters and setters.
+		KIND_NATIVE_METHOD, // Also native getters and setters, with `index` for indexed properties.
+		KIND_BUILTIN_MEMBER,
+	};
+
+	struct Receiver {
+		Object *object = nullptr;
+		GDScriptInstance *instance = nullptr;
+		GDScript *script = nullptr;
+		const void *type_key = nullptr; // Native class name, or builtin type.
+	};
+
+	struct Entry {
+		GDScript *script = nullptr;
+		const void *type_key = nullptr;
+		Kind kind = KIND_NONE;
+		int index = -1;
+		const GDScriptDataType *data_type = nullptr; // Of typed script members.
+		Variant::Type value_type = Variant::NIL; // Of builtin members.
+		GDScriptFunction *function = nullptr;
+		MethodBind *method = nullptr;
+		Variant::ValidatedGetter getter = nullptr;
+		Variant::ValidatedSetter setter = nullptr;
+	};
+
+	static const uint32_t STATE_COUNT_MASK = 0x7;
+	static const uint32_t STATE_LOCKED = 0x8;
+	static const int STATE_EPOCH_SHIFT = 4;
+
+	static SafeNumeric<uint32_t> epoch;
+
+	std::atomic<uint32_t> state = { 0 };
+	std::atomic<Entry *> entries = { nullptr }; // Allocated on first use, `MAX_ENTRIES` long.
+
+	static bool _get_receiver(const Variant *p_base, Receiver &r_receiver);
+	static GDScriptFunction *_find_function(GDScript *p_script, const StringName &p_name);
+	static bool _has_script_name(GDScript *p_script, const StringName &p_name, const StringName &p_fallback_function);
+	static bool _is_native_cacheable(const Receiver &p_receiver);
+	static uint32_t _get_epoch_bits() { return epoch.get() & (UINT32_MAX >> STATE_EPOCH_SHIFT); }
+
+	// Copies the entry for the receiver, or returns whether a new one must be resolved.
+	bool _find(const Receiver &p_receiver, Entry &r_entry, bool &r_can_add) const;
+	void _add(const Entry &p_entry);
+
+	static void _resolve_get(const Receiver &p_receiver, const StringName &p_name, Entry &r_entry);
+	static void _resolve_set(const Receiver &p_receiver, const StringName &p_name, Entry &r_entry);
+	static void _resolve_call(const Receiver &p_receiver, const StringName &p_name, Entry &r_entry);
+
+public:
+	static void invalidate_all() { epoch.increment(); }
+
+	// These return false when the access isn't cacheable, and the generic path must be used instead.
+	bool get_named(const Variant *p_base, const StringName &p_name, Variant &r_value);
+	bool set_named(Variant *p_base, const StringName &p_name, const Variant &p_value, bool &r_valid);
+	bool call(Variant *p_base, const StringName &p_name, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
+
+	~GDScriptInlineCache();
+};
+
+#endif // GDSCRIPT_INLINE_CACHE_H
@@ -0,0 +1,899 @@
+/**************************************************************************/
+/*  gdscript_jit.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_jit.h"
+
+#include "gdscript.h"
+
+#include "core/variant/variant_internal.h"
+
+GDScriptJIT::Mode GDScriptJIT::mode = GDScriptJIT::MODE_DISABLED;
+uint32_t GDScriptJIT::hot_call_threshold = 1000;
+
+void GDScriptJIT::set_mode(Mode p_mode) {
+	mode = is_supported() ? p_mode : MODE_DISABLED;
+}
+
+void GDScriptJIT::set_hot_call_threshold(uint32_t p_threshold) {
+	ERR_FAIL_COND(p_threshold == 0);
+	hot_call_threshold = p_threshold;
+}
+
+#ifdef GDSCRIPT_JIT_ENABLED
+
+#include <sys/mman.h>
+
+namespace {
+
+// Helpers called from native code for the paths that aren't worth inlining.
+
+bool _booleanize(const Variant *p_value) {
+	return p_value->booleanize();
+}
+
+void _assign(Variant *p_dst, const Variant *p_src) {
+	*p_dst = *p_src;
+}
+
+void _assign_null(Variant *p_dst) {
+	*p_dst = Variant();
+}
+
+void _assign_bool(Variant *p_dst, bool p_value) {
+	*p_dst = p_value;
+}
+
+template <typename T>
+void _type_adjust(Variant *p_dst) {
+	VariantTypeAdjust<T>::adjust(p_dst);
+}
+
+enum Register {
+	RAX = 0,
+	RCX = 1,
+	RDX = 2,
+	RBX = 3,
+	RSP = 4,
+	RBP = 5,
+	RSI = 6,
+	RDI = 7,
+	R12 = 12,
+	R13 = 13,
+	R14 = 14,
+	R15 = 15,
+	XMM0 = 0,
+};
+
+// Condition codes, as used by `jcc` and `setcc`.
+enum Condition {
+	CC_B = 0x2,
+	CC_AE = 0x3,
+	CC_E = 0x4,
+	CC_NE = 0x5,
+	CC_A = 0x7,
+	CC_P = 0xA,
+	CC_NP = 0xB,
+	CC_L = 0xC,
+	CC_GE = 0xD,
+	CC_LE = 0xE,
+	CC_G = 0xF,
+};
+
+// Minimal x86-64 encoder. Memory operands always use a 32-bit displacement.
+struct Assembler {
+	LocalVector<uint8_t> code;
+
+	void emit(uint8_t p_byte) { code.push_back(p_byte); }
+
+	void emit32(uint32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			code.push_back((p_value >> (i * 8)) & 0xFF);
+		}
+	}
+
+	void emit64(uint64_t p_value) {
+		for (int i = 0; i < 8; i++) {
+			code.push_back((p_value >> (i * 8)) & 0xFF);
+		}
+	}
+
+	void patch32(uint32_t p_pos, uint32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			code[p_pos + i] = (p_value >> (i * 8)) & 0xFF;
+		}
+	}
+
+	// Emits `[p_prefix] [REX] p_opcode ModRM(p_reg, [p_base + p_disp])`.
+	void mem_op(uint8_t p_prefix, bool p_wide, std::initializer_list<uint8_t> p_opcode, int p_reg, int p_base, int32_t p_disp) {
+		if (p_prefix) {
+			emit(p_prefix);
+		}
+		uint8_t rex = 0x40 | (p_wide ? 0x08 : 0) | ((p_reg & 8) ? 0x04 : 0) | ((p_base & 8) ? 0x01 : 0);
+		if (rex != 0x40) {
+			emit(rex);
+		}
+		for (uint8_t byte : p_opcode) {
+			emit(byte);
+		}
+		emit(0x80 | ((p_reg & 7) << 3) | (p_base & 7));
+		if ((p_base & 7) == RSP) {
+			emit(0x24); // SIB for base-only addressing.
+		}
+		emit32(p_disp);
+	}
+
+	void push(int p_reg) {
+		if (p_reg & 8) {
+			emit(0x41);
+		}
+		emit(0x50 | (p_reg & 7));
+	}
+
+	void pop(int p_reg) {
+		if (p_reg & 8) {
+			emit(0x41);
+		}
+		emit(0x58 | (p_reg & 7));
+	}
+
+	void ret() { emit(0xC3); }
+
+	void mov_r64_imm64(int p_reg, uint64_t p_value) {
+		emit(0x48 | ((p_reg & 8) ? 0x01 : 0));
+		emit(0xB8 | (p_reg & 7));
+		emit64(p_value);
+	}
+
+	void mov_r32_imm32(int p_reg, uint32_t p_value) {
+		if (p_reg & 8) {
+			emit(0x41);
+		}
+		emit(0xB8 | (p_reg & 7));
+		emit32(p_value);
+	}
+
+	void call(const void *p_function) {
+		mov_r64_imm64(RAX, (uint64_t)p_function);
+		emit(0xFF); // call rax
+		emit(0xD0);
+	}
+
+	uint32_t jmp() {
+		emit(0xE9);
+		emit32(0);
+		return code.size() - 4;
+	}
+
+	uint32_t jcc(Condition p_condition) {
+		emit(0x0F);
+		emit(0x80 | p_condition);
+		emit32(0);
+		return code.size() - 4;
+	}
+
+	// Makes the rel32 at `p_pos` point to `p_target`.
+	void bind(uint32_t p_pos, uint32_t p_target) {
+		patch32(p_pos, p_target - (p_pos + 4));
+	}
+
+	void setcc_al(Condition p_condition) {
+		emit(0x0F);
+		emit(0x90 | p_condition);
+		emit(0xC0);
+	}
+
+	void setcc_cl(Condition p_condition) {
+		emit(0x0F);
+		emit(0x90 | p_condition);
+		emit(0xC1);
+	}
+};
+
+} // namespace
+
+class GDScriptJIT::Compiler {
+	const GDScriptFunction *function = nullptr;
+	Assembler as;
+
+	int data_offset = 0;
+	bool uses_members = false;
+
+	HashMap<int, uint32_t> ip_offsets; // Native code of each compiled instruction.
+	HashMap<int, uint32_t> entries; // Instructions that were compiled, rather than left to the VM.
+	LocalVector<int> pending_ips;
+	LocalVector<Pair<uint32_t, int>> jumps; // Jumps to the instruction at the given position.
+	LocalVector<Pair<uint32_t, int>> exits; // Exits to the VM at the given position.
+	LocalVector<uint32_t> epilogue_jumps;
+
+	struct Operand {
+		int base = R12;
+		int32_t offset = 0;
+		// Constant types are known when compiling, so they never need a guard.
+		bool is_constant = false;
+		Variant::Type constant_type = Variant::NIL;
+	};
+
+	bool decode_operand(int p_address, Operand &r_operand) {
+		int index = p_address & GDScriptFunction::ADDR_MASK;
+		switch ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+			case GDScriptFunction::ADDR_TYPE_STACK:
+				if (index >= function->_stack_size) {
+					return false;
+				}
+				r_operand.base = R12;
+				break;
+			case GDScriptFunction::ADDR_TYPE_CONSTANT:
+				if (index >= function->_constant_count) {
+					return false;
+				}
+				r_operand.base = R13;
+				r_operand.is_constant = true;
+				r_operand.constant_type = function->_constants_ptr[index].get_type();
+				break;
+			case GDScriptFunction::ADDR_TYPE_MEMBER:
+				if (!function->_script || index >= (int)function->_script->debug_get_member_indices().size()) {
+					return false;
+				}
+				r_operand.base = R14;
+				uses_members = true;
+				break;
+			default:
+				return false;
+		}
+		r_operand.offset = index * int32_t(sizeof(Variant));
+		return true;
+	}
+
+	bool decode_operands(int p_ip, int p_count, Operand *r_operands) {
+		for (int i = 0; i < p_count; i++) {
+			if (!decode_operand(function->_code_ptr[p_ip + 1 + i], r_operands[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	int32_t type_offset(const Operand &p_operand) const { return p_operand.offset; }
+	int32_t value_offset(const Operand &p_operand) const { return p_operand.offset + data_offset; }
+
+	void exit_to(int p_ip, uint32_t p_patch_pos) {
+		exits.push_back(Pair<uint32_t, int>(p_patch_pos, p_ip));
+	}
+
+	void jump_to(int p_ip, uint32_t p_patch_pos) {
+		jumps.push_back(Pair<uint32_t, int>(p_patch_pos, p_ip));
+		pending_ips.push_back(p_ip);
+	}
+
+	// Leaves the native code before the instruction at `p_ip` if the operand doesn't hold `p_type`.
+	// Returns false if the guard fails for sure, which happens only for constants.
+	bool guard_type(int p_ip, const Operand &p_operand, Variant::Type p_type) {
+		if (p_operand.is_constant) {
+			return p_operand.constant_type == p_type;
+		}
+		as.mem_op(0, false, { 0x81 }, 7, p_operand.base, type_offset(p_operand)); // cmp dword [m], imm32
+		as.emit32(p_type);
+		exit_to(p_ip, as.jcc(CC_NE));
+		return true;
+	}
+
+	// Leaves the native code if the operand holds a type that needs construction or destruction.
+	bool guard_trivial(int p_ip, const Operand &p_operand) {
+		if (p_operand.is_constant) {
+			return p_operand.constant_type <= Variant::FLOAT;
+		}
+		as.mem_op(0, false, { 0x81 }, 7, p_operand.base, type_offset(p_operand)); // cmp dword [m], imm32
+		as.emit32(Variant::FLOAT);
+		exit_to(p_ip, as.jcc(CC_A));
+		return true;
+	}
+
+	void lea(int p_reg, const Operand &p_operand) {
+		as.mem_op(0, true, { 0x8D }, p_reg, p_operand.base, p_operand.offset);
+	}
+
+	void store_bool_al(const Operand &p_dst) {
+		as.mem_op(0, false, { 0x88 }, RAX, p_dst.base, value_offset(p_dst)); // mov byte [m], al
+	}
+
+	// Emits a typed int or float operation, writing into `dst`. For comparisons the result is also left in `al`.
+	bool emit_typed_operator(int p_ip, Variant::Operator p_operator, Variant::Type p_type, const Operand &p_a, const Operand &p_b, const Operand &p_dst) {
+		bool is_comparison = p_operator <= Variant::OP_GREATER_EQUAL;
+		if (!guard_type(p_ip, p_a, p_type) || !guard_type(p_ip, p_b, p_type) || !guard_type(p_ip, p_dst, is_comparison ? Variant::BOOL : p_type) || p_dst.is_constant) {
+			return false;
+		}
+
+		if (p_type == Variant::INT) {
+			as.mem_op(0, true, { 0x8B }, RAX, p_a.base, value_offset(p_a)); // mov rax, [a]
+			switch (p_operator) {
+				case Variant::OP_ADD:
+					as.mem_op(0, true, { 0x03 }, RAX, p_b.base, value_offset(p_b));
+					break;
+				case Variant::OP_SUBTRACT:
+					as.mem_op(0, true, { 0x2B }, RAX, p_b.base, value_offset(p_b));
+					break;
+				case Variant::OP_MULTIPLY:
+					as.mem_op(0, true, { 0x0F, 0xAF }, RAX, p_b.base, value_offset(p_b));
+					break;
+				default: {
+					static const Condition conditions[] = { CC_E, CC_NE, CC_L, CC_LE, CC_G, CC_GE };
+					as.mem_op(0, true, { 0x3B }, RAX, p_b.base, value_offset(p_b)); // cmp rax, [b]
+					as.setcc_al(conditions[p_operator]);
+					store_bool_al(p_dst);
+					return true;
+				}
+			}
+			as.mem_op(0, true, { 0x89 }, RAX, p_dst.base, value_offset(p_dst)); // mov [dst], rax
+			return true;
+		}
+
+		// Floats. Comparisons are arranged so unordered results (NaN) are false, except for `!=`.
+		switch (p_operator) {
+			case Variant::OP_LESS:
+			case Variant::OP_LESS_EQUAL:
+				as.mem_op(0xF2, false, { 0x0F, 0x10 }, XMM0, p_b.base, value_offset(p_b)); // movsd xmm0, [b]
+				as.mem_op(0x66, false, { 0x0F, 0x2E }, XMM0, p_a.base, value_offset(p_a)); // ucomisd xmm0, [a]
+				as.setcc_al(p_operator == Variant::OP_LESS ? CC_A : CC_AE);
+				store_bool_al(p_dst);
+				return true;
+			case Variant::OP_GREATER:
+			case Variant::OP_GREATER_EQUAL:
+			case Variant::OP_EQUAL:
+			case Variant::OP_NOT_EQUAL:
+				as.mem_op(0xF2, false, { 0x0F, 0x10 }, XMM0, p_a.base, value_offset(p_a)); // movsd xmm0, [a]
+				as.mem_op(0x66, false, { 0x0F, 0x2E }, XMM0, p_b.base, value_offset(p_b)); // ucomisd xmm0, [b]
+				if (p_operator == Variant::OP_EQUAL) {
+					as.setcc_al(CC_E);
+					as.setcc_cl(CC_NP);
+					as.emit(0x20); // and al, cl
+					as.emit(0xC8);
+				} else if (p_operator == Variant::OP_NOT_EQUAL) {
+					as.setcc_al(CC_NE);
+					as.setcc_cl(CC_P);
+					as.emit(0x08); // or al, cl
+					as.emit(0xC8);
+				} else {
+					as.setcc_al(p_operator == Variant::OP_GREATER ? CC_A : CC_AE);
+				}
+				store_bool_al(p_dst);
+				return true;
+			default:
+				break;
+		}
+
+		uint8_t sse_opcode = 0;
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				sse_opcode = 0x58;
+				break;
+			case Variant::OP_SUBTRACT:
+				sse_opcode = 0x5C;
+				break;
+			case Variant::OP_MULTIPLY:
+				sse_opcode = 0x59;
+				break;
+			case Variant::OP_DIVIDE:
+				sse_opcode = 0x5E;
+				break;
+			default:
+				return false;
+		}
+		as.mem_op(0xF2, false, { 0x0F, 0x10 }, XMM0, p_a.base, value_offset(p_a)); // movsd xmm0, [a]
+		as.mem_op(0xF2, false, { 0x0F, sse_opcode }, XMM0, p_b.base, value_offset(p_b));
+		as.mem_op(0xF2, false, { 0x0F, 0x11 }, XMM0, p_dst.base, value_offset(p_dst)); // movsd [dst], xmm0
+		return true;
+	}
+
+	void emit_operator_call(int p_ip, const Operand &p_a, const Operand &p_b, const Operand &p_dst) {
+		lea(RDI, p_a);
+		lea(RSI, p_b);
+		lea(RDX, p_dst);
+		as.call((const void *)function->_operator_funcs_ptr[function->_code_ptr[p_ip + 4]]);
+	}
+
+	// Leaves the booleanized value of the operand in `al`.
+	void emit_booleanize(const Operand &p_value) {
+		if (p_value.is_constant) {
+			as.mov_r32_imm32(RAX, function->_constants_ptr[p_value.offset / int32_t(sizeof(Variant))].booleanize());
+			return;
+		}
+		as.mem_op(0, false, { 0x81 }, 7, p_value.base, type_offset(p_value)); // cmp dword [m], BOOL
+		as.emit32(Variant::BOOL);
+		uint32_t slow = as.jcc(CC_NE);
+		as.mem_op(0, false, { 0x0F, 0xB6 }, RAX, p_value.base, value_offset(p_value)); // movzx eax, byte [m]
+		uint32_t done = as.jmp();
+		as.bind(slow, as.code.size());
+		lea(RDI, p_value);
+		as.call((const void *)&_booleanize);
+		as.bind(done, as.code.size());
+	}
+
+	void emit_branch(bool p_jump_if, int p_target) {
+		as.emit(0x84); // test al, al
+		as.emit(0xC0);
+		jump_to(p_target, as.jcc(p_jump_if ? CC_NE : CC_E));
+	}
+
+	bool valid_target(int p_target) const {
+		return p_target >= 0 && p_target < function->_code_size;
+	}
+
+	// Emits the instruction at `p_ip`. Returns its size, or 0 if it must be left to the VM.
+	// `r_falls_through` is set to false after unconditional jumps.
+	int emit_instruction(int p_ip, bool &r_falls_through) {
+		const int *code = function->_code_ptr;
+		int space = function->_code_size - p_ip;
+		int opcode = code[p_ip];
+		Operand ops[4];
+
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_LINE: {
+				if (space < 2) {
+					return 0;
+				}
+				as.mem_op(0, false, { 0xC7 }, 0, R15, 0); // mov dword [r15], line
+				as.emit32(code[p_ip + 1]);
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_JUMP: {
+				if (space < 2 || !valid_target(code[p_ip + 1])) {
+					return 0;
+				}
+				jump_to(code[p_ip + 1], as.jmp());
+				r_falls_through = false;
+				// What follows is only reached through other jumps, such as the back edge of a `for` loop
+				// whose body has instructions left to the VM. Compile it so the VM can come back to it.
+				if (p_ip + 2 < function->_code_size) {
+					pending_ips.push_back(p_ip + 2);
+				}
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+				if (space < 3 || !decode_operands(p_ip, 1, ops) || !valid_target(code[p_ip + 2])) {
+					return 0;
+				}
+				emit_booleanize(ops[0]);
+				emit_branch(opcode == GDScriptFunction::OPCODE_JUMP_IF, code[p_ip + 2]);
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN: {
+				if (space < 3 || !decode_operands(p_ip, 2, ops) || ops[0].is_constant) {
+					return 0;
+				}
+				// Copy the raw value between types that don't need construction or destruction.
+				LocalVector<uint32_t> slow;
+				for (int i = 0; i < 2; i++) {
+					if (ops[i].is_constant) {
+						if (ops[i].constant_type > Variant::FLOAT) {
+							slow.push_back(as.jmp());
+						}
+						continue;
+					}
+					as.mem_op(0, false, { 0x81 }, 7, ops[i].base, type_offset(ops[i])); // cmp dword [m], FLOAT
+					as.emit32(Variant::FLOAT);
+					slow.push_back(as.jcc(CC_A));
+				}
+				as.mem_op(0, false, { 0x8B }, RAX, ops[1].base, type_offset(ops[1])); // mov eax, [src.type]
+				as.mem_op(0, false, { 0x89 }, RAX, ops[0].base, type_offset(ops[0])); // mov [dst.type], eax
+				as.mem_op(0, true, { 0x8B }, RAX, ops[1].base, value_offset(ops[1])); // mov rax, [src]
+				as.mem_op(0, true, { 0x89 }, RAX, ops[0].base, value_offset(ops[0])); // mov [dst], rax
+				uint32_t done = as.jmp();
+				for (uint32_t pos : slow) {
+					as.bind(pos, as.code.size());
+				}
+				lea(RDI, ops[0]);
+				lea(RSI, ops[1]);
+				as.call((const void *)&_assign);
+				as.bind(done, as.code.size());
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN_NULL:
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
+				if (space < 2 || !decode_operands(p_ip, 1, ops) || ops[0].is_constant) {
+					return 0;
+				}
+				lea(RDI, ops[0]);
+				if (opcode == GDScriptFunction::OPCODE_ASSIGN_NULL) {
+					as.call((const void *)&_assign_null);
+				} else {
+					as.mov_r32_imm32(RSI, opcode == GDScriptFunction::OPCODE_ASSIGN_TRUE);
+					as.call((const void *)&_assign_bool);
+				}
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL:
+			case GDScriptFunction::OPCODE_TYPE_ADJUST_INT:
+			case GDScriptFunction::OPCODE_TYPE_ADJUST_FLOAT: {
+				if (space < 2 || !decode_operands(p_ip, 1, ops) || ops[0].is_constant) {
+					return 0;
+				}
+				Variant::Type type = opcode == GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL ? Variant::BOOL : (opcode == GDScriptFunction::OPCODE_TYPE_ADJUST_INT ? Variant::INT : Variant::FLOAT);
+				as.mem_op(0, false, { 0x81 }, 7, ops[0].base, type_offset(ops[0])); // cmp dword [m], type
+				as.emit32(type);
+				uint32_t done = as.jcc(CC_E);
+				lea(RDI, ops[0]);
+				if (type == Variant::BOOL) {
+					as.call((const void *)&_type_adjust<bool>);
+				} else if (type == Variant::INT) {
+					as.call((const void *)&_type_adjust<int64_t>);
+				} else {
+					as.call((const void *)&_type_adjust<double>);
+				}
+				as.bind(done, as.code.size());
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT: {
+				if (space < 5 || !decode_operands(p_ip, 3, ops) || ops[0].is_constant || ops[2].is_constant || !valid_target(code[p_ip + 4])) {
+					return 0;
+				}
+				if (!guard_type(p_ip, ops[1], Variant::INT) || !guard_trivial(p_ip, ops[0]) || !guard_trivial(p_ip, ops[2])) {
+					return 0;
+				}
+				as.mem_op(0, false, { 0xC7 }, 0, ops[0].base, type_offset(ops[0])); // counter = 0
+				as.emit32(Variant::INT);
+				as.mem_op(0, true, { 0xC7 }, 0, ops[0].base, value_offset(ops[0]));
+				as.emit32(0);
+				as.mem_op(0, true, { 0x8B }, RAX, ops[1].base, value_offset(ops[1])); // mov rax, [container]
+				as.emit(0x48); // test rax, rax
+				as.emit(0x85);
+				as.emit(0xC0);
+				jump_to(code[p_ip + 4], as.jcc(CC_LE));
+				as.mem_op(0, false, { 0xC7 }, 0, ops[2].base, type_offset(ops[2])); // iterator = 0
+				as.emit32(Variant::INT);
+				as.mem_op(0, true, { 0xC7 }, 0, ops[2].base, value_offset(ops[2]));
+				as.emit32(0);
+				// Like the VM, skip the jump over the regular iteration that follows.
+				return 5;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_INT: {
+				if (space < 5 || !decode_operands(p_ip, 3, ops) || ops[0].is_constant || ops[2].is_constant || !valid_target(code[p_ip + 4])) {
+					return 0;
+				}
+				if (!guard_type(p_ip, ops[0], Variant::INT) || !guard_type(p_ip, ops[1], Variant::INT) || !guard_type(p_ip, ops[2], Variant::INT)) {
+					return 0;
+				}
+				as.mem_op(0, true, { 0x8B }, RAX, ops[0].base, value_offset(ops[0])); // mov rax, [counter]
+				as.emit(0x48); // add rax, 1
+				as.emit(0x83);
+				as.emit(0xC0);
+				as.emit(0x01);
+				as.mem_op(0, true, { 0x89 }, RAX, ops[0].base, value_offset(ops[0])); // mov [counter], rax
+				as.mem_op(0, true, { 0x3B }, RAX, ops[1].base, value_offset(ops[1])); // cmp rax, [container]
+				jump_to(code[p_ip + 4], as.jcc(CC_GE));
+				as.mem_op(0, true, { 0x89 }, RAX, ops[2].base, value_offset(ops[2])); // mov [iterator], rax
+				return 5;
+			}
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF:
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT: {
+				bool is_jump = opcode != GDScriptFunction::OPCODE_OPERATOR_VALIDATED;
+				int size = is_jump ? 6 : 5;
+				if (space < size || !decode_operands(p_ip, 3, ops) || ops[2].is_constant) {
+					return 0;
+				}
+				int operator_idx = code[p_ip + 4];
+				if (operator_idx < 0 || operator_idx >= function->_operator_funcs_count) {
+					return 0;
+				}
+				if (!is_jump) {
+					emit_operator_call(p_ip, ops[0], ops[1], ops[2]);
+					return size;
+				}
+				if (!valid_target(code[p_ip + 5])) {
+					return 0;
+				}
+				emit_operator_call(p_ip, ops[0], ops[1], ops[2]);
+				emit_booleanize(ops[2]);
+				emit_branch(opcode == GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF, code[p_ip + 5]);
+				return size;
+			}
+#define TYPED_JUMP(m_name, m_op, m_type)                          \
+	case GDScriptFunction::OPCODE_OPERATOR_##m_name##_JUMP_IF:     \
+	case GDScriptFunction::OPCODE_OPERATOR_##m_name##_JUMP_IF_NOT: \
+		return emit_typed_jump(p_ip, Variant::m_op, Variant::m_type, opcode == GDScriptFunction::OPCODE_OPERATOR_##m_name##_JUMP_IF);
+			TYPED_JUMP(EQUAL_INT, OP_EQUAL, INT)
+			TYPED_JUMP(NOT_EQUAL_INT, OP_NOT_EQUAL, INT)
+			TYPED_JUMP(LESS_INT, OP_LESS, INT)
+			TYPED_JUMP(LESS_EQUAL_INT, OP_LESS_EQUAL, INT)
+			TYPED_JUMP(GREATER_INT, OP_GREATER, INT)
+			TYPED_JUMP(GREATER_EQUAL_INT, OP_GREATER_EQUAL, INT)
+			TYPED_JUMP(EQUAL_FLOAT, OP_EQUAL, FLOAT)
+			TYPED_JUMP(NOT_EQUAL_FLOAT, OP_NOT_EQUAL, FLOAT)
+			TYPED_JUMP(LESS_FLOAT, OP_LESS, FLOAT)
+			TYPED_JUMP(LESS_EQUAL_FLOAT, OP_LESS_EQUAL, FLOAT)
+			TYPED_JUMP(GREATER_FLOAT, OP_GREATER, FLOAT)
+			TYPED_JUMP(GREATER_EQUAL_FLOAT, OP_GREATER_EQUAL, FLOAT)
+#undef TYPED_JUMP
+			default:
+				break;
+		}
+
+		// Typed operators.
+		Variant::Operator op = Variant::OP_MAX;
+		Variant::Type type = Variant::NIL;
+		switch (opcode) {
+#define TYPED_OPERATOR(m_name, m_op, m_type)          \
+	case GDScriptFunction::OPCODE_OPERATOR_##m_name: \
+		op = Variant::m_op;                          \
+		type = Variant::m_type;                      \
+		break;
+			TYPED_OPERATOR(ADD_INT, OP_ADD, INT)
+			TYPED_OPERATOR(SUBTRACT_INT, OP_SUBTRACT, INT)
+			TYPED_OPERATOR(MULTIPLY_INT, OP_MULTIPLY, INT)
+			TYPED_OPERATOR(EQUAL_INT, OP_EQUAL, INT)
+			TYPED_OPERATOR(NOT_EQUAL_INT, OP_NOT_EQUAL, INT)
+			TYPED_OPERATOR(LESS_INT, OP_LESS, INT)
+			TYPED_OPERATOR(LESS_EQUAL_INT, OP_LESS_EQUAL, INT)
+			TYPED_OPERATOR(GREATER_INT, OP_GREATER, INT)
+			TYPED_OPERATOR(GREATER_EQUAL_INT, OP_GREATER_EQUAL, INT)
+			TYPED_OPERATOR(ADD_FLOAT, OP_ADD, FLOAT)
+			TYPED_OPERATOR(SUBTRACT_FLOAT, OP_SUBTRACT, FLOAT)
+			TYPED_OPERATOR(MULTIPLY_FLOAT, OP_MULTIPLY, FLOAT)
+			TYPED_OPERATOR(DIVIDE_FLOAT, OP_DIVIDE, FLOAT)
+			TYPED_OPERATOR(EQUAL_FLOAT, OP_EQUAL, FLOAT)
+			TYPED_OPERATOR(NOT_EQUAL_FLOAT, OP_NOT_EQUAL, FLOAT)
+			TYPED_OPERATOR(LESS_FLOAT, OP_LESS, FLOAT)
+			TYPED_OPERATOR(LESS_EQUAL_FLOAT, OP_LESS_EQUAL, FLOAT)
+			TYPED_OPERATOR(GREATER_FLOAT, OP_GREATER, FLOAT)
+			TYPED_OPERATOR(GREATER_EQUAL_FLOAT, OP_GREATER_EQUAL, FLOAT)
+#undef TYPED_OPERATOR
+			case GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR2:
+			case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR2:
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR2:
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT:
+			case GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT:
+			case GDScriptFunction::OPCODE_OPERATOR_ADD_VECTOR3:
+			case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_VECTOR3:
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3:
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT:
+			case GDScriptFunction::OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT:
+				// Vectors go through the evaluator the typed opcode keeps.
+				break;
+			default:
+				return 0;
+		}
+
+		if (space < 5 || !decode_operands(p_ip, 3, ops) || ops[2].is_constant) {
+			return 0;
+		}
+		if (type == Variant::NIL) {
+			int operator_idx = code[p_ip + 4];
+			if (operator_idx < 0 || operator_idx >= function->_operator_funcs_count) {
+				return 0;
+			}
+			emit_operator_call(p_ip, ops[0], ops[1], ops[2]);
+			return 5;
+		}
+		return emit_typed_operator(p_ip, op, type, ops[0], ops[1], ops[2]) ? 5 : 0;
+	}
+
+	// Emits a typed compare-and-jump. Returns its size, or 0 if it must be left to the VM.
+	int emit_typed_jump(int p_ip, Variant::Operator p_operator, Variant::Type p_type, bool p_jump_if) {
+		Operand ops[3];
+		if (function->_code_size - p_ip < 6 || !decode_operands(p_ip, 3, ops) || !valid_target(function->_code_ptr[p_ip + 5])) {
+			return 0;
+		}
+		if (!emit_typed_operator(p_ip, p_operator, p_type, ops[0], ops[1], ops[2])) {
+			return 0;
+		}
+		emit_branch(p_jump_if, function->_code_ptr[p_ip + 5]);
+		return 6;
+	}
+
+	void emit_exit(int p_ip) {
+		as.mov_r32_imm32(RAX, p_ip);
+		epilogue_jumps.push_back(as.jmp());
+	}
+
+public:
+	bool compile(const GDScriptFunction *p_function, int p_data_offset) {
+		function = p_function;
+		data_offset = p_data_offset;
+
+		// Prologue. Five pushes keep the stack aligned for calls.
+		as.push(RBX);
+		as.push(R12);
+		as.push(R13);
+		as.push(R14);
+		as.push(R15);
+		as.mem_op(0, true, { 0x8B }, R12, RDI, sizeof(Variant *) * GDScriptFunction::ADDR_TYPE_STACK);
+		as.mem_op(0, true, { 0x8B }, R13, RDI, sizeof(Variant *) * GDScriptFunction::ADDR_TYPE_CONSTANT);
+		as.mem_op(0, true, { 0x8B }, R14, RDI, sizeof(Variant *) * GDScriptFunction::ADDR_TYPE_MEMBER);
+		as.emit(0x49); // mov r15, rsi
+		as.emit(0x89);
+		as.emit(0xF7);
+		as.emit(0x89); // mov ebx, edx
+		as.emit(0xD3);
+		// Static calls have no members, let the VM report the error if they're used.
+		as.emit(0x4D); // test r14, r14
+		as.emit(0x85);
+		as.emit(0xF6);
+		uint32_t no_members_exit = as.jcc(CC_E);
+		// The VM jumps back into the native code once it's past the instructions it was left.
+		uint32_t dispatch = as.code.size();
+		as.emit(0x48); // test rcx, rcx
+		as.emit(0x85);
+		as.emit(0xC9);
+		uint32_t function_entry = as.jcc(CC_E);
+		as.emit(0xFF); // jmp rcx
+		as.emit(0xE1);
+
+		int compiled_count = 0;
+		pending_ips.push_back(0);
+		while (!pending_ips.is_empty()) {
+			int ip = pending_ips[pending_ips.size() - 1];
+			pending_ips.remove_at(pending_ips.size() - 1);
+
+			while (!ip_offsets.has(ip)) {
+				ip_offsets[ip] = as.code.size();
+				bool falls_through = true;
+				int size = ip < function->_code_size ? emit_instruction(ip, falls_through) : 0;
+				if (size == 0) {
+					// Discard any partial code (such as guards) and leave the instruction to the VM.
+					as.code.resize(ip_offsets[ip]);
+					while (!exits.is_empty() && exits[exits.size() - 1].first >= as.code.size()) {
+						exits.remove_at(exits.size() - 1);
+					}
+					while (!jumps.is_empty() && jumps[jumps.size() - 1].first >= as.code.size()) {
+						jumps.remove_at(jumps.size() - 1);
+					}
+					emit_exit(ip);
+					break;
+				}
+				entries[ip] = ip_offsets[ip];
+				if (opcode_counts(ip)) {
+					compiled_count++;
+				}
+				if (!falls_through) {
+					break;
+				}
+				ip += size;
+				if (ip_offsets.has(ip)) {
+					jump_to(ip, as.jmp());
+				}
+			}
+		}
+
+		if (compiled_count == 0) {
+			return false;
+		}
+
+		// Exits to the VM.
+		HashMap<int, uint32_t> exit_stubs;
+		for (const Pair<uint32_t, int> &E : exits) {
+			if (!exit_stubs.has(E.second)) {
+				exit_stubs[E.second] = as.code.size();
+				emit_exit(E.second);
+			}
+			as.bind(E.first, exit_stubs[E.second]);
+		}
+		if (uses_members) {
+			as.bind(no_members_exit, as.code.size());
+			as.emit(0x89); // mov eax, ebx
+			as.emit(0xD8);
+			epilogue_jumps.push_back(as.jmp());
+		} else {
+			as.bind(no_members_exit, dispatch);
+		}
+		as.bind(function_entry, ip_offsets[0]);
+
+		for (const Pair<uint32_t, int> &E : jumps) {
+			as.bind(E.first, ip_offsets[E.second]);
+		}
+
+		uint32_t epilogue = as.code.size();
+		for (uint32_t pos : epilogue_jumps) {
+			as.bind(pos, epilogue);
+		}
+		as.pop(R15);
+		as.pop(R14);
+		as.pop(R13);
+		as.pop(R12);
+		as.pop(RBX);
+		as.ret();
+		return true;
+	}
+
+	bool opcode_counts(int p_ip) const {
+		return function->_code_ptr[p_ip] != GDScriptFunction::OPCODE_LINE;
+	}
+
+	const LocalVector<uint8_t> &get_code() const { return as.code; }
+	const HashMap<int, uint32_t> &get_entries() const { return entries; }
+};
+
+static int _get_variant_data_offset() {
+	Variant value = int64_t(0);
+	return int((const uint8_t *)VariantInternal::get_int(&value) - (const uint8_t *)&value);
+}
+
+bool GDScriptJIT::is_supported() {
+	// The generated code reads the type as the first member of Variant.
+	static const bool supported = []() {
+		Variant value = 1.5;
+		return *(const Variant::Type *)&value == Variant::FLOAT;
+	}();
+	return supported;
+}
+
+GDScriptFunction::JITFunction GDScriptJIT::compile(GDScriptFunction *p_function) {
+	if (mode == MODE_HOT_FUNCTIONS) {
+		// Only fully typed functions are expected to stay on the native path.
+		for (const GDScriptDataType &type : p_function->argument_types) {
+			if (!type.has_type) {
+				return nullptr;
+			}
+		}
+	}
+
+	Compiler compiler;
+	if (!compiler.compile(p_function, _get_variant_data_offset())) {
+		return nullptr;
+	}
+
+	const LocalVector<uint8_t> &code = compiler.get_code();
+	void *memory = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	ERR_FAIL_COND_V_MSG(memory == MAP_FAILED, nullptr, "Couldn't allocate memory for GDScript native code.");
+	memcpy(memory, code.ptr(), code.size());
+	if (mprotect(memory, code.size(), PROT_READ | PROT_EXEC) != 0) {
+		munmap(memory, code.size());
+		ERR_FAIL_V_MSG(nullptr, "Couldn't make GDScript native code executable.");
+	}
+
+	GDScriptFunction::JITFunction function = (GDScriptFunction::JITFunction)memory;
+	p_function->jit_code_size = code.size();
+	p_function->jit_entries = compiler.get_entries();
+	p_function->jit_function.store(function, std::memory_order_release);
+	return function;
+}
+
+void GDScriptJIT::free_function(GDScriptFunction *p_function) {
+	GDScriptFunction::JITFunction function = p_function->jit_function.exchange(nullptr);
+	if (function) {
+		munmap((void *)function, p_function->jit_code_size);
+	}
+}
+
+#else
+
+bool GDScriptJIT::is_supported() {
+	return false;
+}
+
+GDScriptFunction::JITFunction GDScriptJIT::compile(GDScriptFunction *p_function) {
+	return nullptr;
+}
+
+void GDScriptJIT::free_function(GDScriptFunction *p_function) {
+}
+
+#endif // GDSCRIPT_JIT_ENABLED
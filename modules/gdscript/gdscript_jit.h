@@ -0,0 +1,82 @@
+/**************************************************************************/
+/*  gdscript_jit.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_JIT_H
+#define GDSCRIPT_JIT_H
+
+#include "gdscript_function.h"
+
+// Baseline compiler translating the bytecode of hot functions into native code.
+//
+// Compilation starts at the function entry and follows every instruction reachable through
+// supported opcodes. Any other instruction, as well as a failed type guard, exits the native
+// code and lets the VM continue from that instruction, so a function never needs to be fully
+// supported to be compiled. The VM enters the native code again when it jumps to a compiled
+// instruction, so loops whose bodies have a few unsupported instructions keep running natively.
+class GDScriptJIT {
+public:
+	enum Mode {
+		MODE_DISABLED,
+		MODE_HOT_FUNCTIONS,
+		MODE_ALL_FUNCTIONS, // Compiles every function on its first call, used to test the compiler.
+	};
+
+private:
+	class Compiler;
+
+	static Mode mode;
+	static uint32_t hot_call_threshold;
+
+	static GDScriptFunction::JITFunction compile(GDScriptFunction *p_function);
+
+public:
+	static bool is_supported();
+
+	static void set_mode(Mode p_mode);
+	static Mode get_mode() { return mode; }
+	static void set_hot_call_threshold(uint32_t p_threshold);
+	static uint32_t get_hot_call_threshold() { return hot_call_threshold; }
+
+	// Returns the native code of the function, compiling it once it becomes hot.
+	_FORCE_INLINE_ static GDScriptFunction::JITFunction get_function(GDScriptFunction *p_function) {
+		if (mode == MODE_DISABLED) {
+			return nullptr;
+		}
+		GDScriptFunction::JITFunction function = p_function->jit_function.load(std::memory_order_acquire);
+		if (function == nullptr && p_function->jit_call_count.increment() == (mode == MODE_ALL_FUNCTIONS ? 1 : hot_call_threshold)) {
+			function = compile(p_function);
+		}
+		return function;
+	}
+
+	static void free_function(GDScriptFunction *p_function);
+};
+
+#endif // GDSCRIPT_JIT_H
@@ -0,0 +1,228 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#include "gdscript_function.h"
+
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+
+SafeFlag GDScriptSamplingProfiler::active;
+SafeNumeric<uint64_t> GDScriptSamplingProfiler::tick;
+uint32_t GDScriptSamplingProfiler::interval_usec = GDScriptSamplingProfiler::DEFAULT_INTERVAL_USEC;
+String GDScriptSamplingProfiler::output_path;
+Thread GDScriptSamplingProfiler::sampler_thread;
+SafeFlag GDScriptSamplingProfiler::sampler_exit;
+Mutex GDScriptSamplingProfiler::threads_mutex;
+LocalVector<GDScriptSamplingProfiler::ThreadData *> GDScriptSamplingProfiler::threads;
+HashMap<String, uint64_t> GDScriptSamplingProfiler::retired_stacks;
+HashMap<String, GDScriptSamplingProfiler::LineHits> GDScriptSamplingProfiler::retired_lines;
+thread_local GDScriptSamplingProfiler::ThreadData GDScriptSamplingProfiler::thread_data;
+
+GDScriptSamplingProfiler::ThreadData::ThreadData() {
+	MutexLock lock(threads_mutex);
+	threads.push_back(this);
+}
+
+GDScriptSamplingProfiler::ThreadData::~ThreadData() {
+	MutexLock lock(threads_mutex);
+	_merge(retired_stacks, retired_lines, *this);
+	threads.erase(this);
+}
+
+void GDScriptSamplingProfiler::_sampler_thread_func(void *p_userdata) {
+	while (!sampler_exit.is_set()) {
+		OS::get_singleton()->delay_usec(interval_usec);
+		tick.increment();
+	}
+}
+
+void GDScriptSamplingProfiler::_sample(ThreadData &p_data, uint64_t p_tick) {
+	uint64_t weight = p_tick - p_data.last_tick;
+	p_data.last_tick = p_tick;
+
+	MutexLock lock(p_data.mutex);
+
+	String folded;
+	for (uint32_t i = 0; i < p_data.stack.size(); i++) {
+		const Frame &frame = p_data.stack[i];
+		const String source = frame.function->get_source();
+		const String line = itos(*frame.line);
+		if (i > 0) {
+			folded += ";";
+		}
+		folded += source + ":" + String(frame.function->get_name()) + ":" + line;
+
+		LineHits &hits = p_data.lines[source + ":" + line];
+		if (i == p_data.stack.size() - 1) {
+			hits.self += weight;
+		}
+		// Count recursive calls once.
+		bool is_repeated = false;
+		for (uint32_t j = 0; j < i; j++) {
+			if (p_data.stack[j].function == frame.function && *p_data.stack[j].line == *frame.line) {
+				is_repeated = true;
+				break;
+			}
+		}
+		if (!is_repeated) {
+			hits.total += weight;
+		}
+	}
+	p_data.stacks[folded] += weight;
+}
+
+void GDScriptSamplingProfiler::_merge(HashMap<String, uint64_t> &r_stacks, HashMap<String, LineHits> &r_lines, const ThreadData &p_data) {
+	for (const KeyValue<String, uint64_t> &E : p_data.stacks) {
+		r_stacks[E.key] += E.value;
+	}
+	for (const KeyValue<String, LineHits> &E : p_data.lines) {
+		LineHits &hits = r_lines[E.key];
+		hits.self += E.value.self;
+		hits.total += E.value.total;
+	}
+}
+
+void GDScriptSamplingProfiler::_collect(HashMap<String, uint64_t> &r_stacks, HashMap<String, LineHits> &r_lines) {
+	MutexLock lock(threads_mutex);
+	r_stacks = retired_stacks;
+	r_lines = retired_lines;
+	for (ThreadData *data : threads) {
+		MutexLock data_lock(data->mutex);
+		_merge(r_stacks, r_lines, *data);
+	}
+}
+
+void GDScriptSamplingProfiler::start(uint32_t p_interval_usec, const String &p_output_path) {
+	ERR_FAIL_COND_MSG(is_active(), "The GDScript sampling profiler is already running.");
+	ERR_FAIL_COND(p_interval_usec == 0);
+
+	clear();
+	interval_usec = p_interval_usec;
+	output_path = p_output_path;
+
+	sampler_exit.clear();
+	sampler_thread.start(_sampler_thread_func, nullptr);
+	active.set();
+}
+
+void GDScriptSamplingProfiler::stop() {
+	if (!is_active()) {
+		return;
+	}
+	active.clear();
+	sampler_exit.set();
+	sampler_thread.wait_to_finish();
+
+	if (!output_path.is_empty()) {
+		save(output_path);
+		output_path = String();
+	}
+}
+
+void GDScriptSamplingProfiler::clear() {
+	MutexLock lock(threads_mutex);
+	retired_stacks.clear();
+	retired_lines.clear();
+	for (ThreadData *data : threads) {
+		MutexLock data_lock(data->mutex);
+		data->stacks.clear();
+		data->lines.clear();
+	}
+}
+
+String GDScriptSamplingProfiler::get_folded_stacks() {
+	HashMap<String, uint64_t> stacks;
+	HashMap<String, LineHits> lines;
+	_collect(stacks, lines);
+
+	// Sorted, so the output is stable.
+	LocalVector<String> keys;
+	for (const KeyValue<String, uint64_t> &E : stacks) {
+		keys.push_back(E.key);
+	}
+	keys.sort();
+
+	String result;
+	for (const String &key : keys) {
+		result += key + " " + itos(stacks[key]) + "\n";
+	}
+	return result;
+}
+
+String GDScriptSamplingProfiler::get_line_hits() {
+	HashMap<String, uint64_t> stacks;
+	HashMap<String, LineHits> lines;
+	_collect(stacks, lines);
+
+	struct Entry {
+		String location;
+		LineHits hits;
+	};
+	struct EntryComparator {
+		_FORCE_INLINE_ bool operator()(const Entry &p_a, const Entry &p_b) const {
+			if (p_a.hits.self != p_b.hits.self) {
+				return p_a.hits.self > p_b.hits.self;
+			}
+			if (p_a.hits.total != p_b.hits.total) {
+				return p_a.hits.total > p_b.hits.total;
+			}
+			return p_a.location < p_b.location;
+		}
+	};
+
+	LocalVector<Entry> entries;
+	for (const KeyValue<String, LineHits> &E : lines) {
+		entries.push_back({ E.key, E.value });
+	}
+	entries.sort_custom<EntryComparator>();
+
+	String result = "# location self total\n";
+	for (const Entry &entry : entries) {
+		result += entry.location + " " + itos(entry.hits.self) + " " + itos(entry.hits.total) + "\n";
+	}
+	return result;
+}
+
+Error GDScriptSamplingProfiler::save(const String &p_path) {
+	Error err;
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Couldn't write GDScript profile to: " + p_path);
+	file->store_string(get_folded_stacks());
+
+	// Per-line hits go next to the folded stacks.
+	Ref<FileAccess> lines_file = FileAccess::open(p_path + ".lines", FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Couldn't write GDScript line hits to: " + p_path + ".lines");
+	lines_file->store_string(get_line_hits());
+
+	print_line(vformat("GDScript profile saved to \"%s\".", p_path));
+	return OK;
+}
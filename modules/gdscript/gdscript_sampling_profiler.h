@@ -0,0 +1,136 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+class GDScriptFunction;
+
+// Statistical profiler for GDScript.
+//
+// A background thread advances a tick counter at a fixed interval. Threads running GDScript keep
+// a shadow stack of their functions and check the counter at function boundaries and at each new
+// line, charging the elapsed ticks to the stack and line that were running. Unlike the
+// instrumenting profiler, this costs nothing per call besides pushing a pointer.
+//
+// Results are folded stacks (`path:function:line;... count`, as expected by flame graph tools)
+// and the hit count of every line, both as self time and as time including callees.
+class GDScriptSamplingProfiler {
+	struct Frame {
+		GDScriptFunction *function = nullptr;
+		const int *line = nullptr;
+	};
+
+	struct LineHits {
+		uint64_t self = 0;
+		uint64_t total = 0;
+	};
+
+	struct ThreadData {
+		LocalVector<Frame> stack; // Only used by the owning thread.
+		uint64_t last_tick = 0;
+
+		Mutex mutex; // Protects the results from being read while sampling.
+		HashMap<String, uint64_t> stacks;
+		HashMap<String, LineHits> lines;
+
+		ThreadData();
+		~ThreadData();
+	};
+
+	static SafeFlag active;
+	static SafeNumeric<uint64_t> tick;
+	static uint32_t interval_usec;
+	static String output_path;
+
+	static Thread sampler_thread;
+	static SafeFlag sampler_exit;
+
+	static Mutex threads_mutex;
+	static LocalVector<ThreadData *> threads;
+	static HashMap<String, uint64_t> retired_stacks; // From threads that finished.
+	static HashMap<String, LineHits> retired_lines;
+
+	static thread_local ThreadData thread_data;
+
+	static void _sampler_thread_func(void *p_userdata);
+	static void _sample(ThreadData &p_data, uint64_t p_tick);
+	static void _merge(HashMap<String, uint64_t> &r_stacks, HashMap<String, LineHits> &r_lines, const ThreadData &p_data);
+	static void _collect(HashMap<String, uint64_t> &r_stacks, HashMap<String, LineHits> &r_lines);
+
+public:
+	static const uint32_t DEFAULT_INTERVAL_USEC = 1000;
+
+	_FORCE_INLINE_ static bool is_active() { return active.is_set(); }
+
+	// Called by the VM around every function call while active. `p_line` points to the current line of the call.
+	_FORCE_INLINE_ static void enter_function(GDScriptFunction *p_function, const int *p_line) {
+		ThreadData &data = thread_data;
+		if (data.stack.is_empty()) {
+			// Don't charge the time spent outside of scripts to the first line.
+			data.last_tick = tick.get();
+		} else {
+			poll();
+		}
+		data.stack.push_back({ p_function, p_line });
+	}
+
+	_FORCE_INLINE_ static void exit_function() {
+		ThreadData &data = thread_data;
+		poll();
+		data.stack.resize(data.stack.size() - 1);
+	}
+
+	// Called by the VM before moving to a new line.
+	_FORCE_INLINE_ static void poll() {
+		ThreadData &data = thread_data;
+		uint64_t current = tick.get();
+		if (unlikely(current != data.last_tick) && !data.stack.is_empty()) {
+			_sample(data, current);
+		}
+	}
+
+	// Starts sampling, discarding previous results. If `p_output_path` is set, results are saved there once stopped.
+	static void start(uint32_t p_interval_usec = DEFAULT_INTERVAL_USEC, const String &p_output_path = String());
+	static void stop();
+	static void clear();
+
+	static String get_folded_stacks();
+	static String get_line_hits();
+	static Error save(const String &p_path);
+};
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
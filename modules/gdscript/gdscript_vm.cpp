@@ -29,8 +29,12 @@
 /**************************************************************************/
 
 #include "gdscript.h"
+#include "gdscript_coroutine_frame_pool.h"
 #include "gdscript_function.h"
+#include "gdscript_inline_cache.h"
+#include "gdscript_jit.h"
 #include "gdscript_lambda_callable.h"
+#include "gdscript_sampling_profiler.h"
 
 #include "core/os/os.h"
 
@@ -215,6 +219,61 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {            \
 		&&OPCODE_OPERATOR,                               \
 		&&OPCODE_OPERATOR_VALIDATED,                     \
+		&&OPCODE_OPERATOR_VALIDATED_JUMP_IF,             \
+		&&OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT,         \
+		&&OPCODE_OPERATOR_ADD_INT,                       \
+		&&OPCODE_OPERATOR_SUBTRACT_INT,                  \
+		&&OPCODE_OPERATOR_MULTIPLY_INT,                  \
+		&&OPCODE_OPERATOR_EQUAL_INT,                     \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT,                 \
+		&&OPCODE_OPERATOR_LESS_INT,                      \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT,                \
+		&&OPCODE_OPERATOR_GREATER_INT,                   \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT,             \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                     \
+		&&OPCODE_OPERATOR_SUBTRACT_FLOAT,                \
+		&&OPCODE_OPERATOR_MULTIPLY_FLOAT,                \
+		&&OPCODE_OPERATOR_DIVIDE_FLOAT,                  \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT,                   \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT,               \
+		&&OPCODE_OPERATOR_LESS_FLOAT,                    \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT,              \
+		&&OPCODE_OPERATOR_GREATER_FLOAT,                 \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT,           \
+		&&OPCODE_OPERATOR_ADD_VECTOR2,                   \
+		&&OPCODE_OPERATOR_SUBTRACT_VECTOR2,              \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR2,              \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR2_FLOAT,        \
+		&&OPCODE_OPERATOR_DIVIDE_VECTOR2_FLOAT,          \
+		&&OPCODE_OPERATOR_ADD_VECTOR3,                   \
+		&&OPCODE_OPERATOR_SUBTRACT_VECTOR3,              \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR3,              \
+		&&OPCODE_OPERATOR_MULTIPLY_VECTOR3_FLOAT,        \
+		&&OPCODE_OPERATOR_DIVIDE_VECTOR3_FLOAT,          \
+		&&OPCODE_OPERATOR_EQUAL_INT_JUMP_IF,             \
+		&&OPCODE_OPERATOR_EQUAL_INT_JUMP_IF_NOT,         \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT_JUMP_IF,         \
+		&&OPCODE_OPERATOR_NOT_EQUAL_INT_JUMP_IF_NOT,     \
+		&&OPCODE_OPERATOR_LESS_INT_JUMP_IF,              \
+		&&OPCODE_OPERATOR_LESS_INT_JUMP_IF_NOT,          \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT_JUMP_IF,        \
+		&&OPCODE_OPERATOR_LESS_EQUAL_INT_JUMP_IF_NOT,    \
+		&&OPCODE_OPERATOR_GREATER_INT_JUMP_IF,           \
+		&&OPCODE_OPERATOR_GREATER_INT_JUMP_IF_NOT,       \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT_JUMP_IF,     \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_INT_JUMP_IF_NOT, \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT_JUMP_IF,           \
+		&&OPCODE_OPERATOR_EQUAL_FLOAT_JUMP_IF_NOT,       \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT_JUMP_IF,       \
+		&&OPCODE_OPERATOR_NOT_EQUAL_FLOAT_JUMP_IF_NOT,   \
+		&&OPCODE_OPERATOR_LESS_FLOAT_JUMP_IF,            \
+		&&OPCODE_OPERATOR_LESS_FLOAT_JUMP_IF_NOT,        \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT_JUMP_IF,      \
+		&&OPCODE_OPERATOR_LESS_EQUAL_FLOAT_JUMP_IF_NOT,  \
+		&&OPCODE_OPERATOR_GREATER_FLOAT_JUMP_IF,         \
+		&&OPCODE_OPERATOR_GREATER_FLOAT_JUMP_IF_NOT,     \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT_JUMP_IF,   \
+		&&OPCODE_OPERATOR_GREATER_EQUAL_FLOAT_JUMP_IF_NOT,\
 		&&OPCODE_TYPE_TEST_BUILTIN,                      \
 		&&OPCODE_TYPE_TEST_ARRAY,                        \
 		&&OPCODE_TYPE_TEST_NATIVE,                       \
@@ -222,9 +281,29 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_SET_KEYED,                              \
 		&&OPCODE_SET_KEYED_VALIDATED,                    \
 		&&OPCODE_SET_INDEXED_VALIDATED,                  \
+		&&OPCODE_SET_INDEXED_PACKED_BYTE_ARRAY,          \
+		&&OPCODE_SET_INDEXED_PACKED_INT32_ARRAY,         \
+		&&OPCODE_SET_INDEXED_PACKED_INT64_ARRAY,         \
+		&&OPCODE_SET_INDEXED_PACKED_FLOAT32_ARRAY,       \
+		&&OPCODE_SET_INDEXED_PACKED_FLOAT64_ARRAY,       \
+		&&OPCODE_SET_INDEXED_PACKED_STRING_ARRAY,        \
+		&&OPCODE_SET_INDEXED_PACKED_VECTOR2_ARRAY,       \
+		&&OPCODE_SET_INDEXED_PACKED_VECTOR3_ARRAY,       \
+		&&OPCODE_SET_INDEXED_PACKED_COLOR_ARRAY,         \
+		&&OPCODE_SET_INDEXED_PACKED_VECTOR4_ARRAY,       \
 		&&OPCODE_GET_KEYED,                              \
 		&&OPCODE_GET_KEYED_VALIDATED,                    \
 		&&OPCODE_GET_INDEXED_VALIDATED,                  \
+		&&OPCODE_GET_INDEXED_PACKED_BYTE_ARRAY,          \
+		&&OPCODE_GET_INDEXED_PACKED_INT32_ARRAY,         \
+		&&OPCODE_GET_INDEXED_PACKED_INT64_ARRAY,         \
+		&&OPCODE_GET_INDEXED_PACKED_FLOAT32_ARRAY,       \
+		&&OPCODE_GET_INDEXED_PACKED_FLOAT64_ARRAY,       \
+		&&OPCODE_GET_INDEXED_PACKED_STRING_ARRAY,        \
+		&&OPCODE_GET_INDEXED_PACKED_VECTOR2_ARRAY,       \
+		&&OPCODE_GET_INDEXED_PACKED_VECTOR3_ARRAY,       \
+		&&OPCODE_GET_INDEXED_PACKED_COLOR_ARRAY,         \
+		&&OPCODE_GET_INDEXED_PACKED_VECTOR4_ARRAY,       \
 		&&OPCODE_SET_NAMED,                              \
 		&&OPCODE_SET_NAMED_VALIDATED,                    \
 		&&OPCODE_GET_NAMED,                              \
@@ -493,17 +572,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 	uint32_t alloca_size = 0;
+	bool stack_moved = false;
 	GDScript *script;
 	int ip = 0;
 	int line = _initial_line;
 
 	if (p_state) {
 		//use existing (supplied) state (awaited)
-		stack = (Variant *)p_state->stack.ptr();
-		instruction_args = (Variant **)&p_state->stack.ptr()[sizeof(Variant) * p_state->stack_size]; //ptr() to avoid bounds check
+		stack = (Variant *)p_state->stack;
+		instruction_args = (Variant **)&p_state->stack[sizeof(Variant) * p_state->stack_size];
 		line = p_state->line;
 		ip = p_state->ip;
-		alloca_size = p_state->stack.size();
+		alloca_size = p_state->alloca_size;
 		script = p_state->script;
 		p_instance = p_state->instance;
 		defarg = p_state->defarg;
@@ -590,6 +670,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		GDScriptLanguage::get_singleton()->enter_function(p_instance, this, stack, &ip, &line);
 	}
 
+	const bool sampling = GDScriptSamplingProfiler::is_active();
+	if (unlikely(sampling)) {
+		GDScriptSamplingProfiler::enter_function(this, &line);
+	}
+
 #define GD_ERR_BREAK(m_cond)                                                                                           \
 	{                                                                                                                  \
 		if (unlikely(m_cond)) {                                                                                        \
@@ -667,6 +752,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	Variant *variant_addresses[ADDR_TYPE_MAX] = { stack, _constants_ptr, p_instance ? p_instance->members.ptrw() : nullptr };
 
+#ifdef GDSCRIPT_JIT_ENABLED
+	// Run as much as possible natively, the VM continues from wherever the native code stopped.
+	// Breakpoints, stepping and line sampling need the VM, so skip it while debugging or profiling.
+	JITFunction jit = nullptr;
+	if (!p_state && !EngineDebugger::is_active() && !GDScriptSamplingProfiler::is_active()) {
+		jit = GDScriptJIT::get_function(this);
+		if (jit) {
+			ip = jit(variant_addresses, &line, 0, nullptr);
+		}
+	}
+#endif
+
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
 		int last_opcode = _code_ptr[ip];
@@ -779,6 +876,111 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_OPERATOR_VALIDATED_JUMP_IF)
+			OPCODE(OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT) {
+				CHECK_SPACE(6);
+
+				int operator_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(operator_idx < 0 || operator_idx >= _operator_funcs_count);
+				Variant::ValidatedOperatorEvaluator operator_func = _operator_funcs_ptr[operator_idx];
+
+				GET_VARIANT_PTR(a, 0);
+				GET_VARIANT_PTR(b, 1);
+				GET_VARIANT_PTR(dst, 2);
+
+				operator_func(a, b, dst);
+
+				bool jump_on = _code_ptr[ip] == OPCODE_OPERATOR_VALIDATED_JUMP_IF;
+				if (dst->booleanize() == jump_on) {
+					int to = _code_ptr[ip + 5];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 6;
+				}
+			}
+			DISPATCH_OPCODE;
+
+			// Same layout as OPCODE_OPERATOR_VALIDATED, but operating directly on the payloads without calling the evaluator.
+#define OPCODE_OPERATOR_TYPED(m_name, m_left_type, m_right_type, m_result_type, m_op)                                          \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                                                         \
+		CHECK_SPACE(5);                                                                                                        \
+		GET_VARIANT_PTR(a, 0);                                                                                                 \
+		GET_VARIANT_PTR(b, 1);                                                                                                 \
+		GET_VARIANT_PTR(dst, 2);                                                                                               \
+		*VariantInternal::get_##m_result_type(dst) = *VariantInternal::get_##m_left_type(a) m_op *VariantInternal::get_##m_right_type(b); \
+		ip += 5;                                                                                                               \
+	}                                                                                                                          \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_TYPED(ADD_INT, int, int, int, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_INT, int, int, int, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_INT, int, int, int, *);
+			OPCODE_OPERATOR_TYPED(EQUAL_INT, int, int, bool, ==);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL_INT, int, int, bool, !=);
+			OPCODE_OPERATOR_TYPED(LESS_INT, int, int, bool, <);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_INT, int, int, bool, <=);
+			OPCODE_OPERATOR_TYPED(GREATER_INT, int, int, bool, >);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_INT, int, int, bool, >=);
+			OPCODE_OPERATOR_TYPED(ADD_FLOAT, float, float, float, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_FLOAT, float, float, float, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_FLOAT, float, float, float, *);
+			OPCODE_OPERATOR_TYPED(DIVIDE_FLOAT, float, float, float, /);
+			OPCODE_OPERATOR_TYPED(EQUAL_FLOAT, float, float, bool, ==);
+			OPCODE_OPERATOR_TYPED(NOT_EQUAL_FLOAT, float, float, bool, !=);
+			OPCODE_OPERATOR_TYPED(LESS_FLOAT, float, float, bool, <);
+			OPCODE_OPERATOR_TYPED(LESS_EQUAL_FLOAT, float, float, bool, <=);
+			OPCODE_OPERATOR_TYPED(GREATER_FLOAT, float, float, bool, >);
+			OPCODE_OPERATOR_TYPED(GREATER_EQUAL_FLOAT, float, float, bool, >=);
+			OPCODE_OPERATOR_TYPED(ADD_VECTOR2, vector2, vector2, vector2, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_VECTOR2, vector2, vector2, vector2, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_VECTOR2, vector2, vector2, vector2, *);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_VECTOR2_FLOAT, vector2, float, vector2, *);
+			OPCODE_OPERATOR_TYPED(DIVIDE_VECTOR2_FLOAT, vector2, float, vector2, /);
+			OPCODE_OPERATOR_TYPED(ADD_VECTOR3, vector3, vector3, vector3, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_VECTOR3, vector3, vector3, vector3, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_VECTOR3, vector3, vector3, vector3, *);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_VECTOR3_FLOAT, vector3, float, vector3, *);
+			OPCODE_OPERATOR_TYPED(DIVIDE_VECTOR3_FLOAT, vector3, float, vector3, /);
+#undef OPCODE_OPERATOR_TYPED
+
+			// Same layout as OPCODE_OPERATOR_VALIDATED_JUMP_IF(_NOT), comparing the payloads directly.
+#define OPCODE_OPERATOR_TYPED_JUMP(m_name, m_jump_name, m_type, m_op, m_jump_on) \
+	OPCODE(OPCODE_OPERATOR_##m_name##_##m_jump_name) {                           \
+		CHECK_SPACE(6);                                                          \
+		GET_VARIANT_PTR(a, 0);                                                   \
+		GET_VARIANT_PTR(b, 1);                                                   \
+		GET_VARIANT_PTR(dst, 2);                                                 \
+		bool result = *VariantInternal::get_##m_type(a) m_op *VariantInternal::get_##m_type(b); \
+		*VariantInternal::get_bool(dst) = result;                                \
+		if (result == m_jump_on) {                                               \
+			int to = _code_ptr[ip + 5];                                          \
+			GD_ERR_BREAK(to < 0 || to > _code_size);                             \
+			ip = to;                                                             \
+		} else {                                                                 \
+			ip += 6;                                                             \
+		}                                                                        \
+	}                                                                            \
+	DISPATCH_OPCODE
+#define OPCODE_OPERATOR_TYPED_JUMPS(m_name, m_type, m_op)             \
+	OPCODE_OPERATOR_TYPED_JUMP(m_name, JUMP_IF, m_type, m_op, true); \
+	OPCODE_OPERATOR_TYPED_JUMP(m_name, JUMP_IF_NOT, m_type, m_op, false)
+
+			OPCODE_OPERATOR_TYPED_JUMPS(EQUAL_INT, int, ==);
+			OPCODE_OPERATOR_TYPED_JUMPS(NOT_EQUAL_INT, int, !=);
+			OPCODE_OPERATOR_TYPED_JUMPS(LESS_INT, int, <);
+			OPCODE_OPERATOR_TYPED_JUMPS(LESS_EQUAL_INT, int, <=);
+			OPCODE_OPERATOR_TYPED_JUMPS(GREATER_INT, int, >);
+			OPCODE_OPERATOR_TYPED_JUMPS(GREATER_EQUAL_INT, int, >=);
+			OPCODE_OPERATOR_TYPED_JUMPS(EQUAL_FLOAT, float, ==);
+			OPCODE_OPERATOR_TYPED_JUMPS(NOT_EQUAL_FLOAT, float, !=);
+			OPCODE_OPERATOR_TYPED_JUMPS(LESS_FLOAT, float, <);
+			OPCODE_OPERATOR_TYPED_JUMPS(LESS_EQUAL_FLOAT, float, <=);
+			OPCODE_OPERATOR_TYPED_JUMPS(GREATER_FLOAT, float, >);
+			OPCODE_OPERATOR_TYPED_JUMPS(GREATER_EQUAL_FLOAT, float, >=);
+#undef OPCODE_OPERATOR_TYPED_JUMPS
+#undef OPCODE_OPERATOR_TYPED_JUMP
+
 			OPCODE(OPCODE_TYPE_TEST_BUILTIN) {
 				CHECK_SPACE(4);
 
@@ -988,6 +1190,46 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#ifdef DEBUG_ENABLED
+#define SET_INDEXED_PACKED_ARRAY_OOB_ERROR                                                                                      \
+	err_text = "Out of bounds set index '" + index->operator String() + "' (on base: '" + _get_var_type(dst) + "')"; \
+	OPCODE_BREAK;
+#else
+#define SET_INDEXED_PACKED_ARRAY_OOB_ERROR
+#endif
+
+#define OPCODE_SET_INDEXED_PACKED_ARRAY(m_var_type, m_elem_type, m_get_func, m_value_get_func) \
+	OPCODE(OPCODE_SET_INDEXED_PACKED_##m_var_type##_ARRAY) {                                   \
+		CHECK_SPACE(4);                                                                        \
+		GET_VARIANT_PTR(dst, 0);                                                               \
+		GET_VARIANT_PTR(index, 1);                                                             \
+		GET_VARIANT_PTR(value, 2);                                                             \
+		Vector<m_elem_type> *array = VariantInternal::m_get_func(dst);                         \
+		int64_t int_index = *VariantInternal::get_int(index);                                  \
+		if (int_index < 0) {                                                                   \
+			int_index += array->size();                                                        \
+		}                                                                                      \
+		if (likely(int_index >= 0 && int_index < array->size())) {                             \
+			array->ptrw()[int_index] = *VariantInternal::m_value_get_func(value);              \
+		} else {                                                                               \
+			SET_INDEXED_PACKED_ARRAY_OOB_ERROR                                                 \
+		}                                                                                      \
+		ip += 5;                                                                               \
+	}                                                                                          \
+	DISPATCH_OPCODE
+
+			// Packed arrays are accessed directly rather than through the validated setter.
+			OPCODE_SET_INDEXED_PACKED_ARRAY(BYTE, uint8_t, get_byte_array, get_int);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(INT32, int32_t, get_int32_array, get_int);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(INT64, int64_t, get_int64_array, get_int);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(FLOAT32, float, get_float32_array, get_float);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(FLOAT64, double, get_float64_array, get_float);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(STRING, String, get_string_array, get_string);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(VECTOR2, Vector2, get_vector2_array, get_vector2);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(VECTOR3, Vector3, get_vector3_array, get_vector3);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(COLOR, Color, get_color_array, get_color);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(VECTOR4, Vector4, get_vector4_array, get_vector4);
+
 			OPCODE(OPCODE_GET_KEYED) {
 				CHECK_SPACE(3);
 
@@ -1092,8 +1334,52 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#ifdef DEBUG_ENABLED
+#define GET_INDEXED_PACKED_ARRAY_OOB_ERROR                                                                                      \
+	err_text = "Out of bounds get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "')"; \
+	OPCODE_BREAK;
+#else
+#define GET_INDEXED_PACKED_ARRAY_OOB_ERROR
+#endif
+
+#define OPCODE_GET_INDEXED_PACKED_ARRAY(m_var_type, m_elem_type, m_get_func, m_ret_type, m_ret_get_func) \
+	OPCODE(OPCODE_GET_INDEXED_PACKED_##m_var_type##_ARRAY) {                                             \
+		CHECK_SPACE(4);                                                                                  \
+		GET_VARIANT_PTR(src, 0);                                                                         \
+		GET_VARIANT_PTR(index, 1);                                                                       \
+		GET_VARIANT_PTR(dst, 2);                                                                         \
+		const Vector<m_elem_type> *array = VariantInternal::m_get_func((const Variant *)src);            \
+		int64_t int_index = *VariantInternal::get_int(index);                                            \
+		if (int_index < 0) {                                                                             \
+			int_index += array->size();                                                                  \
+		}                                                                                                \
+		if (likely(int_index >= 0 && int_index < array->size())) {                                       \
+			const m_elem_type element = array->ptr()[int_index];                                         \
+			if (dst->get_type() != Variant::m_ret_type) {                                                \
+				VariantInternal::initialize(dst, Variant::m_ret_type);                                   \
+			}                                                                                            \
+			*VariantInternal::m_ret_get_func(dst) = element;                                             \
+		} else {                                                                                         \
+			GET_INDEXED_PACKED_ARRAY_OOB_ERROR                                                           \
+		}                                                                                                \
+		ip += 5;                                                                                         \
+	}                                                                                                    \
+	DISPATCH_OPCODE
+
+			// Packed arrays are read directly rather than through the validated getter, and never copied on write.
+			OPCODE_GET_INDEXED_PACKED_ARRAY(BYTE, uint8_t, get_byte_array, INT, get_int);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(INT32, int32_t, get_int32_array, INT, get_int);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(INT64, int64_t, get_int64_array, INT, get_int);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(FLOAT32, float, get_float32_array, FLOAT, get_float);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(FLOAT64, double, get_float64_array, FLOAT, get_float);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(STRING, String, get_string_array, STRING, get_string);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(VECTOR2, Vector2, get_vector2_array, VECTOR2, get_vector2);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(VECTOR3, Vector3, get_vector3_array, VECTOR3, get_vector3);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(COLOR, Color, get_color_array, COLOR, get_color);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(VECTOR4, Vector4, get_vector4_array, VECTOR4, get_vector4);
+
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(value, 1);
@@ -1103,8 +1389,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache_index = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_cache_count);
+
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				if (!_inline_caches_ptr[cache_index].set_named(dst, *index, *value, valid)) {
+					dst->set_named(*index, *value, valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -1125,7 +1416,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1145,7 +1436,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(dst, 1);
@@ -1155,22 +1446,35 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+				int cache_index = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_cache_count);
 
-#else
-				*dst = src->get_named(*index, valid);
-#endif
+				GDScriptInlineCache *inline_cache = &_inline_caches_ptr[cache_index];
+				bool valid = true;
 #ifdef DEBUG_ENABLED
+				//allow better error message in cases where src and dst are the same stack position
+				Variant ret;
+				if (!inline_cache->get_named(src, *index, ret)) {
+					ret = src->get_named(*index, valid);
+				}
 				if (!valid) {
 					err_text = "Invalid access to property or key '" + index->operator String() + "' on a base object of type '" + _get_var_type(src) + "'.";
 					OPCODE_BREAK;
 				}
 				*dst = ret;
+#else
+				if (unlikely(src == dst)) {
+					// The cache can start writing its result before it's done reading the base.
+					Variant ret;
+					if (!inline_cache->get_named(src, *index, ret)) {
+						ret = src->get_named(*index, valid);
+					}
+					*dst = ret;
+				} else if (!inline_cache->get_named(src, *index, *dst)) {
+					*dst = src->get_named(*index, valid);
+				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1706,7 +2010,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				bool call_async = (_code_ptr[ip]) == OPCODE_CALL_ASYNC;
 #endif
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 
 				ip += instr_arg_count;
 
@@ -1717,6 +2021,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int cache_index = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_cache_count);
+				GDScriptInlineCache *inline_cache = &_inline_caches_ptr[cache_index];
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1734,7 +2042,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					if (!inline_cache->call(base, *methodname, (const Variant **)argptrs, argc, *ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					}
 #ifdef DEBUG_ENABLED
 					if (ret->get_type() == Variant::NIL) {
 						if (base_type == Variant::OBJECT) {
@@ -1764,7 +2074,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 				} else {
 					Variant ret;
-					base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					if (!inline_cache->call(base, *methodname, (const Variant **)argptrs, argc, ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					}
 				}
 #ifdef DEBUG_ENABLED
 
@@ -1814,7 +2126,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -2378,13 +2690,6 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 					gdfs->function = this;
 
-					gdfs->state.stack.resize(alloca_size);
-
-					// First 3 stack addresses are special, so we just skip them here.
-					for (int i = 3; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
-					}
-					gdfs->state.stack_size = _stack_size;
 					gdfs->state.alloca_size = alloca_size;
 					gdfs->state.ip = ip + 2;
 					gdfs->state.line = line;
@@ -2408,12 +2713,26 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 					retvalue = gdfs;
 
-					Error err = sig.connect(Callable(gdfs.ptr(), "_signal_callback").bind(retvalue), Object::CONNECT_ONE_SHOT);
+					Error err = sig.connect(Callable(memnew(GDScriptFunctionStateCallable(gdfs))), Object::CONNECT_ONE_SHOT);
 					if (err != OK) {
 						err_text = "Error connecting to signal: " + sig.get_name() + " during await.";
 						OPCODE_BREAK;
 					}
 
+					// The stack is moved rather than copied, since this call returns right away. A resumed
+					// call already runs on a pooled frame, which is handed over as is.
+					if (p_state) {
+						gdfs->state.stack = p_state->stack;
+						p_state->stack = nullptr;
+						p_state->stack_size = 0;
+					} else {
+						gdfs->state.stack = GDScriptCoroutineFramePool::allocate(alloca_size);
+						// First 3 stack addresses are special, so we just skip them here.
+						memcpy((void *)&gdfs->state.stack[sizeof(Variant) * 3], (const void *)&stack[3], sizeof(Variant) * (_stack_size - 3));
+					}
+					gdfs->state.stack_size = _stack_size;
+					stack_moved = true;
+
 #ifdef DEBUG_ENABLED
 					exit_ok = true;
 					awaited = true;
@@ -2508,6 +2827,19 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				GD_ERR_BREAK(to < 0 || to > _code_size);
 				ip = to;
+#ifdef GDSCRIPT_JIT_ENABLED
+				// Loop back edges and the ends of branches, go back to the native code past what it left to the VM.
+				if (jit) {
+					const uint32_t *entry = jit_entries.getptr(to);
+					if (entry) {
+						ip = jit(variant_addresses, &line, to, (const uint8_t *)jit + *entry);
+						if (ip == to) {
+							// It can't get past this instruction (e.g. a type guard fails), stop trying for this call.
+							jit = nullptr;
+						}
+					}
+				}
+#endif
 			}
 			DISPATCH_OPCODE;
 
@@ -3037,14 +3369,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		CHECK_SPACE(8);                                                                                                    \
 		GET_VARIANT_PTR(counter, 0);                                                                                       \
 		GET_VARIANT_PTR(container, 1);                                                                                     \
-		Vector<m_elem_type> *array = VariantInternal::m_get_func(container);                                               \
+		const Vector<m_elem_type> *array = VariantInternal::m_get_func((const Variant *)container);                         \
 		VariantInternal::initialize(counter, Variant::INT);                                                                \
 		*VariantInternal::get_int(counter) = 0;                                                                            \
 		if (!array->is_empty()) {                                                                                          \
 			GET_VARIANT_PTR(iterator, 2);                                                                                  \
 			VariantInternal::initialize(iterator, Variant::m_var_ret_type);                                                \
 			m_ret_type *it = VariantInternal::m_ret_get_func(iterator);                                                    \
-			*it = array->get(0);                                                                                           \
+			*it = array->ptr()[0];                                                                                         \
 			ip += 5;                                                                                                       \
 		} else {                                                                                                           \
 			int jumpto = _code_ptr[ip + 4];                                                                                \
@@ -3384,7 +3716,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			ip = jumpto;                                                                            \
 		} else {                                                                                    \
 			GET_VARIANT_PTR(iterator, 2);                                                           \
-			*VariantInternal::m_ret_get_func(iterator) = array->get(*idx);                          \
+			*VariantInternal::m_ret_get_func(iterator) = array->ptr()[*idx];                        \
 			ip += 5;                                                                                \
 		}                                                                                           \
 	}                                                                                               \
@@ -3575,6 +3907,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_LINE) {
 				CHECK_SPACE(2);
 
+#ifdef DEBUG_ENABLED
+				// Charge the pending samples to the line that just finished.
+				if (unlikely(sampling)) {
+					GDScriptSamplingProfiler::poll();
+				}
+#endif
+
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
@@ -3671,6 +4010,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		}
 	}
 
+	if (unlikely(sampling)) {
+		GDScriptSamplingProfiler::exit_function();
+	}
+
 	// Check if this is not the last time it was interrupted by `await` or if it's the first time executing.
 	// If that is the case then we exit the function as normal. Otherwise we postpone it until the last `await` is completed.
 	// This ensures the call stack can be properly shown when using `await`, showing what resumed the function.
@@ -3680,9 +4023,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		}
 #endif
 
-		// Free stack, except reserved addresses.
-		for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
-			stack[i].~Variant();
+		// Free stack, except reserved addresses and unless it was moved by `await`.
+		if (!stack_moved) {
+			for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
+				stack[i].~Variant();
+			}
+			if (p_state) {
+				p_state->stack_size = 0;
+			}
 		}
 #ifdef DEBUG_ENABLED
 	}
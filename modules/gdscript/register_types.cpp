@@ -32,6 +32,7 @@
 
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_cache.h"
 #include "gdscript_tokenizer.h"
 #include "gdscript_tokenizer_buffer.h"
@@ -114,6 +115,33 @@ protected:
 		}
 
 		add_file(p_path.get_basename() + ".gdc", file, true);
+
+		// The tokens are still needed to compile the script when its bytecode can't be used,
+		// e.g. when it references something only available at runtime.
+		Ref<GDScript> script = ResourceLoader::load(p_path);
+		if (script.is_null() || !script->is_valid()) {
+			return;
+		}
+
+		// The editor's bytecode is compiled for its own target, a debug build emits line,
+		// breakpoint and assert opcodes. Debug editors compile the script again for release
+		// templates, release editors can't emit those opcodes for debug templates.
+		GDScriptBytecodeCache::CompressMode bytecode_compress_mode = compress_mode == GDScriptTokenizerBuffer::COMPRESS_ZSTD ? GDScriptBytecodeCache::COMPRESS_ZSTD : GDScriptBytecodeCache::COMPRESS_NONE;
+		Vector<uint8_t> bytecode;
+#ifdef DEBUG_ENABLED
+		if (p_features.has("debug")) {
+			bytecode = GDScriptBytecodeCache::serialize(script, bytecode_compress_mode);
+		} else {
+			bytecode = GDScriptBytecodeCache::serialize_for_release(script, bytecode_compress_mode);
+		}
+#else
+		if (!p_features.has("debug")) {
+			bytecode = GDScriptBytecodeCache::serialize(script, bytecode_compress_mode);
+		}
+#endif
+		if (!bytecode.is_empty()) {
+			add_file(GDScriptBytecodeCache::get_cache_path(p_path), bytecode, false);
+		}
 	}
 
 public:
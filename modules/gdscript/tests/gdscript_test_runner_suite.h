@@ -33,6 +33,11 @@
 
 #include "gdscript_test_runner.h"
 
+#include "../gdscript_bytecode_cache.h"
+#include "../gdscript_jit.h"
+
+#include "core/io/marshalls.h"
+
 #include "tests/test_macros.h"
 
 namespace GDScriptTests {
@@ -43,8 +48,16 @@ TEST_SUITE("[Modules][GDScript]") {
 	TEST_CASE("Script compilation and runtime") {
 		bool print_filenames = OS::get_singleton()->get_cmdline_args().find("--print-filenames") != nullptr;
 		bool use_binary_tokens = OS::get_singleton()->get_cmdline_args().find("--use-binary-tokens") != nullptr;
+		// Runs every function natively as far as the JIT can, to check it against the expected results.
+		bool force_jit = OS::get_singleton()->get_cmdline_args().find("--gdscript-force-jit") != nullptr;
 		GDScriptTestRunner runner("modules/gdscript/tests/scripts", true, print_filenames, use_binary_tokens);
+		GDScriptJIT::Mode jit_mode = GDScriptJIT::get_mode();
+		if (force_jit) {
+			REQUIRE_MESSAGE(GDScriptJIT::is_supported(), "The GDScript JIT isn't supported on this platform.");
+			GDScriptJIT::set_mode(GDScriptJIT::MODE_ALL_FUNCTIONS);
+		}
 		int fail_count = runner.run_tests();
+		GDScriptJIT::set_mode(jit_mode);
 		INFO("Make sure `*.out` files have expected results.");
 		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass.");
 	}
@@ -70,6 +83,107 @@ func _init():
 	ref_counted->set_script(gdscript);
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
+
+TEST_CASE("[Modules][GDScript] Load compiled bytecode and run it") {
+	const String path = "res://bytecode_cache_test.gd";
+	Vector<uint8_t> bytecode;
+	{
+		Ref<GDScript> gdscript = memnew(GDScript);
+		gdscript->set_path(path, true);
+		gdscript->set_source_code(R"(
+extends RefCounted
+
+const SQUARES: Array[int] = [1, 4, 9]
+
+class Accumulator:
+	var total := 0.0
+
+	func add(value: float) -> void:
+		total += value
+
+static var instances := 0
+
+func _init():
+	instances += 1
+	var accumulator := Accumulator.new()
+	for square in SQUARES:
+		accumulator.add(sqrt(square))
+	var double := func(value): return value * 2
+	set_meta("result", "%d %s %d" % [double.call(accumulator.total), str(Vector2(1, 2).length_squared()), instances])
+)");
+		ERR_PRINT_OFF;
+		const Error error = gdscript->reload();
+		ERR_PRINT_ON;
+		REQUIRE_MESSAGE(error == OK, "The script should compile successfully.");
+
+		bytecode = GDScriptBytecodeCache::serialize(gdscript, GDScriptBytecodeCache::COMPRESS_ZSTD);
+	}
+	REQUIRE_MESSAGE(!bytecode.is_empty(), "The compiled script should be serializable.");
+
+	Vector<uint8_t> contents;
+	REQUIRE(GDScriptBytecodeCache::decode(bytecode, contents) == OK);
+
+	SUBCASE("Loaded script runs without being compiled") {
+		Ref<GDScript> gdscript = memnew(GDScript);
+		gdscript->set_path(path, true);
+		REQUIRE(GDScriptBytecodeCache::make_scripts(gdscript.ptr(), contents) == OK);
+		REQUIRE(GDScriptBytecodeCache::load(gdscript.ptr(), contents) == OK);
+		CHECK(gdscript->is_valid());
+		CHECK(gdscript->get_source_code().is_empty());
+
+		Ref<RefCounted> ref_counted = memnew(RefCounted);
+		ref_counted->set_script(gdscript);
+		CHECK(String(ref_counted->get_meta("result")) == "12 5 1");
+	}
+
+	SUBCASE("Bytecode from another engine build is rejected") {
+		bytecode.write[8] ^= 0xFF;
+		CHECK(GDScriptBytecodeCache::decode(bytecode, contents) == ERR_FILE_UNRECOGNIZED);
+	}
+}
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Modules][GDScript] Compile bytecode for release builds") {
+	const String path = "res://bytecode_release_test.gd";
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_path(path, true);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+class Node:
+	var next: Node
+
+func _init():
+	assert(false)
+	var node := Node.new()
+	node.next = Node.new()
+	set_meta("result", node.next != null)
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should compile successfully.");
+
+	Vector<uint8_t> bytecode = GDScriptBytecodeCache::serialize_for_release(gdscript, GDScriptBytecodeCache::COMPRESS_NONE);
+	REQUIRE_MESSAGE(!bytecode.is_empty(), "The script should compile for release builds.");
+	CHECK(gdscript->is_valid());
+
+	Vector<uint8_t> contents;
+	CHECK_MESSAGE(GDScriptBytecodeCache::decode(bytecode, contents) == ERR_FILE_UNRECOGNIZED, "Release bytecode should be rejected by debug builds.");
+
+	// Load it anyway, the assert must be gone.
+	encode_uint32(GDScriptBytecodeCache::get_engine_hash(), &bytecode.write[8]);
+	REQUIRE(GDScriptBytecodeCache::decode(bytecode, contents) == OK);
+	Ref<GDScript> release_script = memnew(GDScript);
+	release_script->set_path(path, true);
+	REQUIRE(GDScriptBytecodeCache::make_scripts(release_script.ptr(), contents) == OK);
+	REQUIRE(GDScriptBytecodeCache::load(release_script.ptr(), contents) == OK);
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(release_script);
+	CHECK(bool(ref_counted->get_meta("result", false)));
+}
+#endif // DEBUG_ENABLED
 #endif // TOOLS_ENABLED
 
 TEST_CASE("[Modules][GDScript] Validate built-in API") {
@@ -0,0 +1,4 @@
+func test():
+	var vectors := PackedVector3Array([Vector3.ONE])
+	var index := 1
+	print(vectors[index])
@@ -0,0 +1,4 @@
+func test():
+	var floats := PackedFloat32Array([1.0])
+	var index := -2
+	floats[index] = 2.0
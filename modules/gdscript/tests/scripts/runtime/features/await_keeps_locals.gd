@@ -0,0 +1,55 @@
+signal tick(value)
+
+class Tracker extends RefCounted:
+	var name := ""
+	func _notification(what):
+		if what == NOTIFICATION_PREDELETE:
+			print("%s freed" % name)
+
+class Emitter extends Object:
+	signal tick
+
+var finished := 0
+
+func count_ticks(id: int, rounds: int):
+	var total := 0
+	var history := []
+	var label := "coroutine %d" % id
+	for i in rounds:
+		var value = await tick
+		total += value
+		history.append(value)
+	if id == 0:
+		print(label, " ", total, " ", history)
+	finished += 1
+
+func nested(depth: int) -> int:
+	if depth == 0:
+		return await tick
+	var inner = await nested(depth - 1)
+	return inner + depth
+
+func print_nested():
+	print("nested ", await nested(3))
+
+func wait_forever(emitter: Emitter):
+	var tracker := Tracker.new()
+	tracker.name = "tracker"
+	await emitter.tick
+	print("not reached")
+
+func test():
+	for id in 100:
+		count_ticks(id, 3)
+	tick.emit(1)
+	tick.emit(2)
+	tick.emit(3)
+	print("finished ", finished)
+
+	print_nested()
+	tick.emit(10)
+
+	var emitter := Emitter.new()
+	wait_forever(emitter)
+	emitter.free()
+	print("end")
@@ -0,0 +1,68 @@
+# Validated operators can write their result straight into typed locals and parameters,
+# and comparisons can be folded into the following conditional jump.
+
+var member_int: int = 1
+
+func add_to_parameter(value: int, amount: float) -> float:
+	amount += value
+	amount *= 2.0
+	return amount
+
+func test():
+	var a: int = 3
+	var b: int = 4
+	a += b
+	a = a * b - 1
+	print(a)
+
+	var f: float = 1.5
+	f = f * 2.0 + a
+	print(f)
+
+	print(add_to_parameter(2, 0.5))
+
+	member_int += a
+	print(member_int)
+
+	var v := Vector2(1, 2)
+	v = v * 2.0 + v
+	print(v)
+
+	var s: String = "a"
+	s = s + s
+	s += "b"
+	print(s)
+
+	# Container results must not be built in place over their own operands.
+	var arr: Array = [1]
+	arr = arr + arr
+	print(arr)
+
+	var total: int = 0
+	var i: int = 0
+	while i < 10:
+		if i % 2 == 0 and i != 4:
+			total += i
+		elif i > 7 or i == 5:
+			total -= 1
+		i += 1
+	print(total)
+
+	var label := "big" if total > 5 else "small"
+	print(label)
+
+	var negated: int = 0
+	negated = -a
+	print(negated)
+
+	for n in 3:
+		var shadow: int = n * 10
+		shadow += n
+		print(shadow)
+
+	if true:
+		var text: String = "stale"
+		print(text)
+	var late: int = a + b
+	late += 1
+	print(late)
@@ -0,0 +1,91 @@
+# Untyped named access and calls go through per-site inline caches,
+# which must give the same results as the generic lookup for every receiver.
+
+class A:
+	var value = 1
+	func describe():
+		return "A %s" % value
+
+class B extends A:
+	func describe():
+		return "B %s" % value
+
+class C:
+	var value = 3
+	func describe():
+		return "C %s" % value
+
+class D:
+	var value = 4
+	func describe():
+		return "D %s" % value
+
+class E:
+	var value = 5
+	func describe():
+		return "E %s" % value
+
+class WithAccessors:
+	var backing = 0
+	var value:
+		get:
+			return backing * 10
+		set(new_value):
+			backing = new_value + 1
+	func describe():
+		return "WithAccessors %s" % backing
+
+class Typed:
+	var value: float = 0.0
+	func describe():
+		return "Typed %s" % value
+
+
+func read_value(object):
+	return object.value
+
+
+func write_value(object, value):
+	object.value = value
+
+
+@warning_ignore("unsafe_method_access")
+func describe(object):
+	return object.describe()
+
+
+@warning_ignore("unsafe_method_access", "unsafe_call_argument")
+func test():
+	var receivers = [A.new(), B.new(), C.new(), D.new(), E.new(), WithAccessors.new(), Typed.new()]
+
+	# Run each site twice, so both the resolving and the cached executions are checked,
+	# and with more receiver types than the cache keeps.
+	for pass_index in 2:
+		for receiver in receivers:
+			write_value(receiver, 7)
+			print(read_value(receiver), " ", describe(receiver))
+
+	var typed = Typed.new()
+	write_value(typed, 2)
+	print(var_to_str(read_value(typed)))
+
+	# Native properties and methods.
+	var objects = [Object.new(), RefCounted.new(), Resource.new()]
+	for i in 2:
+		for object in objects:
+			print(object.get_class(), " ", object.is_class("RefCounted"))
+	var resource = objects[2]
+	for i in 2:
+		resource.resource_name = "Resource%d" % i
+		print(resource.resource_name)
+	objects[0].free()
+
+	# Builtin members.
+	var vectors = [Vector2(1, 2), Vector3(3, 4, 5), Color(0.5, 0.25, 1.0)]
+	for i in 2:
+		for vector in vectors:
+			print(vector.x if not vector is Color else vector.r)
+	var vector = Vector2(1, 2)
+	for i in 2:
+		vector.x = i + 5.0
+		print(vector)
@@ -0,0 +1,114 @@
+# Functions made of instructions the JIT compiles, checked against the interpreter
+# when the test suite runs with `--gdscript-force-jit`.
+
+var member_total: int = 0
+var member_scale := 0.5
+
+
+func sum_loop(n: int) -> int:
+	var total := 0
+	for i in n:
+		total += i * 3 - 1
+	return total
+
+
+func count_down(n: int) -> int:
+	var steps := 0
+	while n > 0:
+		n -= 7
+		steps += 1
+	return steps
+
+
+func float_math(a: float, b: float) -> float:
+	var r := a * b
+	r = r / 4.0 - a
+	if r >= b:
+		r += 1.0
+	else:
+		r -= 1.0
+	return r
+
+
+func nan_compares(x: float) -> Array:
+	var nan := NAN
+	return [x < nan, x <= nan, x > nan, x >= nan, x == nan, x != nan, nan == nan, nan != nan]
+
+
+func int_compares(a: int, b: int) -> Array:
+	return [a < b, a <= b, a > b, a >= b, a == b, a != b]
+
+
+func vector_math(v: Vector2, w: Vector3) -> String:
+	var a := v + v * 2.0 - v / 2.0
+	var b := w * w + w / 4.0
+	return "%s %s" % [a, b]
+
+
+func mixed_assign(n: int) -> String:
+	var value: Variant = n
+	var text: Variant = "text"
+	value = text
+	var flag := n > 3
+	flag = not flag
+	return "%s %s" % [value, flag]
+
+
+func members(n: int) -> int:
+	for i in n:
+		member_total += i
+		member_scale *= 2.0
+	return member_total
+
+
+static func static_loop(n: int) -> int:
+	var total := 0
+	for i in range(n):
+		total -= i
+	return total
+
+
+# The VM runs the calls, then jumps back into the native code for the rest of the loop.
+func loop_with_calls(n: int) -> int:
+	var total := 0
+	for i in n:
+		total += i * 3
+		total = maxi(total - 5, 0)
+		if i % 3 == 0:
+			total += absi(-i)
+	return total
+
+
+# The native code is left for good once the types it was compiled for change.
+func loop_changing_types(n: int) -> Variant:
+	var total = 0
+	for i in n:
+		if i == n >> 1:
+			total += 0.5
+		total += i
+	return total
+
+
+func test():
+	print(sum_loop(0))
+	print(sum_loop(100))
+	print(count_down(100))
+	print(count_down(-5))
+	print(float_math(3.0, 5.0))
+	print(float_math(-2.0, 0.5))
+	print(nan_compares(1.0))
+	print(int_compares(1, 2))
+	print(int_compares(-4, -4))
+	print(vector_math(Vector2(1, 2), Vector3(1, 2, 3)))
+	print(mixed_assign(5))
+	print(members(10))
+	print(member_scale)
+	print(static_loop(10))
+	print(loop_with_calls(0))
+	print(loop_with_calls(100))
+	print(loop_changing_types(10))
+	# Call enough times to go through the native code more than once.
+	var total := 0
+	for i in 50:
+		total += sum_loop(i)
+	print(total)
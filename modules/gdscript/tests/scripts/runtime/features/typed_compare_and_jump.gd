@@ -0,0 +1,51 @@
+# Conditions on typed int and float comparisons jump straight from the comparison.
+
+func compare_ints(a: int, b: int) -> String:
+	var result := ""
+	if a == b: result += "=="
+	if a != b: result += "!="
+	if a < b: result += "<"
+	if a <= b: result += "<="
+	if a > b: result += ">"
+	if a >= b: result += ">="
+	result += " |"
+	if a == b or false: result += " =="
+	if a != b or false: result += " !="
+	if a < b or false: result += " <"
+	if a <= b or false: result += " <="
+	if a > b or false: result += " >"
+	if a >= b or false: result += " >="
+	return result
+
+func compare_floats(a: float, b: float) -> String:
+	var result := ""
+	if a == b: result += "=="
+	if a != b: result += "!="
+	if a < b: result += "<"
+	if a <= b: result += "<="
+	if a > b: result += ">"
+	if a >= b: result += ">="
+	result += " |"
+	if a == b or false: result += " =="
+	if a != b or false: result += " !="
+	if a < b or false: result += " <"
+	if a <= b or false: result += " <="
+	if a > b or false: result += " >"
+	if a >= b or false: result += " >="
+	return result
+
+func test():
+	print(compare_ints(1, 2))
+	print(compare_ints(2, 2))
+	print(compare_ints(3, 2))
+	print(compare_floats(1.5, 2.5))
+	print(compare_floats(2.5, 2.5))
+	print(compare_floats(3.5, 2.5))
+	print(compare_floats(NAN, 2.5))
+
+	var count := 0
+	var i := 0
+	while i < 10:
+		i += 1
+		count += 1
+	print(count)
@@ -0,0 +1,28 @@
+# Operators on typed int, float, Vector2 and Vector3 use specialized opcodes.
+
+func test():
+	var a: int = 7
+	var b: int = -3
+	print(a + b, " ", a - b, " ", a * b)
+	print(a == b, " ", a != b, " ", a < b, " ", a <= b, " ", a > b, " ", a >= b)
+
+	var x: float = 2.5
+	var y: float = 0.5
+	print(x + y, " ", x - y, " ", x * y, " ", x / y)
+	print(x == y, " ", x != y, " ", x < y, " ", x <= y, " ", x > y, " ", x >= y)
+	print(y / 0.0)
+
+	var u := Vector2(1, 2)
+	var v := Vector2(3, -4)
+	print(u + v, " ", u - v, " ", u * v, " ", u * x, " ", v / y)
+
+	var p := Vector3(1, 2, 3)
+	var q := Vector3(-1, 0.5, 2)
+	print(p + q, " ", p - q, " ", p * q, " ", p * x, " ", q / y)
+
+	# Results can be written over one of the operands.
+	a = a * a
+	x = x / x
+	u = u * u
+	p = p - p
+	print(a, " ", x, " ", u, " ", p)
@@ -0,0 +1,49 @@
+var member_floats := PackedFloat32Array([0.5, 1.5, 2.5])
+
+func test():
+	var bytes := PackedByteArray([1, 2, 3])
+	bytes[0] = 255
+	bytes[-1] = 256 + 7
+	print(bytes[0], " ", bytes[1], " ", bytes[-1])
+
+	var ints32 := PackedInt32Array([10, 20])
+	ints32[1] = -5
+	var ints64 := PackedInt64Array([1 << 40, 2])
+	ints64[1] = ints64[0] + 1
+	print(ints32[0] + ints32[1], " ", ints64[1])
+
+	var floats64 := PackedFloat64Array([0.25])
+	floats64[0] *= 4.0
+	member_floats[1] = member_floats[0] + member_floats[2]
+	print(floats64[0], " ", member_floats[1], " ", member_floats)
+
+	var strings := PackedStringArray(["a", "b"])
+	strings[0] += strings[1]
+	print(strings[0], " ", strings[-1])
+
+	var vectors2 := PackedVector2Array([Vector2(1, 2)])
+	var vectors3 := PackedVector3Array([Vector3(1, 2, 3), Vector3()])
+	vectors3[1] = vectors3[0] * 2.0
+	vectors2[0] += Vector2(vectors3[1].x, vectors3[1].y)
+	print(vectors2[0], " ", vectors3[1])
+
+	var colors := PackedColorArray([Color.RED])
+	colors[0] = colors[0].lerp(Color.BLUE, 0.5)
+	var vectors4 := PackedVector4Array([Vector4(1, 2, 3, 4)])
+	vectors4[0].w = 0.0
+	print(colors[0], " ", vectors4[0])
+
+	# Packed arrays are shared by reference, writes are visible through all of them.
+	var shared := member_floats
+	shared[0] = 9.0
+	print(member_floats[0])
+
+	# Untyped targets take the element type.
+	var untyped_target = "string"
+	untyped_target = ints32[0]
+	print(typeof(untyped_target) == TYPE_INT, " ", untyped_target)
+
+	var total := 0.0
+	for i in member_floats.size():
+		total += member_floats[i]
+	print(total)
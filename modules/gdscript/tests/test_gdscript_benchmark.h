@@ -0,0 +1,302 @@
+/**************************************************************************/
+/*  test_gdscript_benchmark.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_BENCHMARK_H
+#define TEST_GDSCRIPT_BENCHMARK_H
+
+#include "../gdscript.h"
+#include "../gdscript_jit.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+// Compiles a benchmark script, and returns an object running it.
+static Ref<RefCounted> create_benchmark_instance(const String &p_source) {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(p_source);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The benchmark script should compile successfully.");
+
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(gdscript);
+	return instance;
+}
+
+// Calls a method of the benchmark script with an argument, and reports how long each of its iterations took.
+static Variant run_script_benchmark(const Ref<RefCounted> &p_instance, const StringName &p_method, const Variant &p_argument, int p_iterations, const String &p_iteration_name) {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	Variant ret = p_instance->call(p_method, p_argument);
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	MESSAGE(String(p_method), ": ", double(elapsed) / 1000.0, " ms, ", double(elapsed) * 1000.0 / p_iterations, " ns per ", p_iteration_name, ".");
+	return ret;
+}
+
+// Same, for methods taking their iteration count.
+static Variant run_script_benchmark(const Ref<RefCounted> &p_instance, const StringName &p_method, int p_iterations) {
+	return run_script_benchmark(p_instance, p_method, p_iterations, p_iterations, "iteration");
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][GDScript] Typed arithmetic and branches") {
+	const int LOOP_COUNT = 1 << 20;
+
+	const GDScriptJIT::Mode jit_mode = GDScriptJIT::get_mode();
+	SUBCASE("Interpreter") {
+		GDScriptJIT::set_mode(GDScriptJIT::MODE_DISABLED);
+	}
+	SUBCASE("JIT") {
+		if (!GDScriptJIT::is_supported()) {
+			return;
+		}
+		GDScriptJIT::set_mode(GDScriptJIT::MODE_ALL_FUNCTIONS);
+	}
+
+	Ref<RefCounted> instance = create_benchmark_instance(R"(
+extends RefCounted
+
+var member_total := 0
+
+func int_arithmetic(count: int) -> int:
+	var total := 0
+	var i := 0
+	while i < count:
+		total += i * 3 - (i & 7)
+		i += 1
+	return total
+
+func float_arithmetic(count: int) -> float:
+	var total := 0.0
+	var x := 0.0
+	for i in count:
+		x = x * 0.5 + 1.0
+		total += x - 1.0
+	return total
+
+func vector_arithmetic(count: int) -> Vector2:
+	var position := Vector2()
+	var velocity := Vector2(1.0, 0.5)
+	for i in count:
+		velocity = velocity * 0.5 + Vector2(1.0, 0.5)
+		position += velocity
+	return position
+
+func vector3_arithmetic(count: int) -> Vector3:
+	var position := Vector3()
+	var velocity := Vector3(1.0, 0.5, 0.25)
+	var step := 0.5
+	for i in count:
+		velocity = velocity * step + Vector3(1.0, 0.5, 0.25)
+		position += velocity
+	return position
+
+func compare_and_jump(count: int) -> int:
+	var hits := 0
+	for i in count:
+		if (i & 3) == 0 or i > count - 10:
+			hits += 1
+	return hits
+
+func member_arithmetic(count: int) -> int:
+	member_total = 0
+	for i in count:
+		member_total += i & 15
+	return member_total
+
+func loop_with_call(count: int) -> int:
+	var total := 0
+	for i in count:
+		total += i * 3 - (i & 7)
+		total = mini(total, 1000000)
+		total -= i & 1
+	return total
+)");
+
+	int64_t int_expected = 0;
+	int64_t hits_expected = 0;
+	int64_t member_expected = 0;
+	int64_t call_expected = 0;
+	for (int64_t i = 0; i < LOOP_COUNT; i++) {
+		int_expected += i * 3 - (i & 7);
+		hits_expected += (i & 3) == 0 || i > LOOP_COUNT - 10;
+		member_expected += i & 15;
+		call_expected = MIN(call_expected + i * 3 - (i & 7), 1000000) - (i & 1);
+	}
+
+	CHECK(int64_t(run_script_benchmark(instance, "int_arithmetic", LOOP_COUNT)) == int_expected);
+	CHECK(double(run_script_benchmark(instance, "float_arithmetic", LOOP_COUNT)) == doctest::Approx(LOOP_COUNT));
+	const Vector2 position = run_script_benchmark(instance, "vector_arithmetic", LOOP_COUNT);
+	CHECK(position.x == doctest::Approx(2.0 * LOOP_COUNT));
+	CHECK(position.y == doctest::Approx(LOOP_COUNT));
+	const Vector3 position_3d = run_script_benchmark(instance, "vector3_arithmetic", LOOP_COUNT);
+	CHECK(position_3d.x == doctest::Approx(2.0 * LOOP_COUNT));
+	CHECK(position_3d.z == doctest::Approx(0.5 * LOOP_COUNT));
+	CHECK(int64_t(run_script_benchmark(instance, "compare_and_jump", LOOP_COUNT)) == hits_expected);
+	CHECK(int64_t(run_script_benchmark(instance, "member_arithmetic", LOOP_COUNT)) == member_expected);
+	CHECK(int64_t(run_script_benchmark(instance, "loop_with_call", LOOP_COUNT)) == call_expected);
+
+	GDScriptJIT::set_mode(jit_mode);
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][GDScript] Untyped member access and calls") {
+	const int LOOP_COUNT = 1 << 18;
+
+	Ref<RefCounted> instance = create_benchmark_instance(R"(
+extends RefCounted
+
+class Body:
+	var position = 0
+	func step(amount):
+		return position + amount
+
+class OtherBody:
+	var position = 0
+	func step(amount):
+		return position - amount
+
+func monomorphic(count):
+	var body = Body.new()
+	for i in count:
+		body.position = body.step(i & 7)
+	return body.position
+
+func polymorphic(count):
+	var bodies = [Body.new(), OtherBody.new()]
+	var total = 0
+	for i in count:
+		var body = bodies[i & 1]
+		body.position = body.step(1)
+		total += body.position
+	return total
+
+func builtin_members(count):
+	var vector = Vector2()
+	for i in count:
+		vector.x = vector.y + 1.0
+		vector.y = vector.x
+	return vector.y
+)");
+
+	int64_t monomorphic_expected = 0;
+	for (int64_t i = 0; i < LOOP_COUNT; i++) {
+		monomorphic_expected += i & 7;
+	}
+
+	CHECK(int64_t(run_script_benchmark(instance, "monomorphic", LOOP_COUNT)) == monomorphic_expected);
+	CHECK(int64_t(run_script_benchmark(instance, "polymorphic", LOOP_COUNT)) == 0);
+	CHECK(double(run_script_benchmark(instance, "builtin_members", LOOP_COUNT)) == doctest::Approx(LOOP_COUNT));
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][GDScript] Packed array iteration and indexing") {
+	const int ELEMENT_COUNT = 1 << 20;
+
+	Ref<RefCounted> instance = create_benchmark_instance(R"(
+extends RefCounted
+
+func iterate_floats(values: PackedFloat32Array) -> float:
+	var total := 0.0
+	for value in values:
+		total += value
+	return total
+
+func index_floats(values: PackedFloat32Array) -> float:
+	var total := 0.0
+	for i in values.size():
+		total += values[i]
+	return total
+
+func scale_vectors(values: PackedVector3Array) -> Vector3:
+	for i in values.size():
+		values[i] = values[i] * 0.5
+	return values[values.size() - 1]
+)");
+
+	PackedFloat32Array floats;
+	floats.resize(ELEMENT_COUNT);
+	floats.fill(0.5);
+	PackedVector3Array vectors;
+	vectors.resize(ELEMENT_COUNT);
+	vectors.fill(Vector3(2.0, 4.0, 8.0));
+
+	CHECK(double(run_script_benchmark(instance, "iterate_floats", floats, ELEMENT_COUNT, "element")) == doctest::Approx(0.5 * ELEMENT_COUNT));
+	CHECK(double(run_script_benchmark(instance, "index_floats", floats, ELEMENT_COUNT, "element")) == doctest::Approx(0.5 * ELEMENT_COUNT));
+	// Packed arrays are passed by reference through Variant, so the vectors are scaled in place.
+	Variant vectors_variant = vectors;
+	CHECK(Vector3(run_script_benchmark(instance, "scale_vectors", vectors_variant, ELEMENT_COUNT, "element")) == Vector3(1.0, 2.0, 4.0));
+	CHECK(PackedVector3Array(vectors_variant)[0] == Vector3(1.0, 2.0, 4.0));
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][GDScript] Await and resume with 10k coroutines") {
+	const int COROUTINE_COUNT = 10000;
+	const int ROUND_COUNT = 20;
+
+	Ref<RefCounted> instance = create_benchmark_instance(R"(
+extends RefCounted
+
+signal tick
+
+var completed := 0
+
+func worker(rounds):
+	var total = 0
+	var position = Vector2()
+	var name = "worker"
+	for i in rounds:
+		await tick
+		total += i
+		position += Vector2(1.0, 0.0)
+	completed += 1
+
+func start(count, rounds):
+	for i in count:
+		worker(rounds)
+)");
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	instance->call("start", COROUTINE_COUNT, ROUND_COUNT);
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	MESSAGE("Starting ", COROUTINE_COUNT, " coroutines: ", double(elapsed) / 1000.0, " ms, ", double(elapsed) * 1000.0 / COROUTINE_COUNT, " ns per coroutine.");
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ROUND_COUNT; i++) {
+		instance->emit_signal(SNAME("tick"));
+	}
+	elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	MESSAGE("Resuming ", COROUTINE_COUNT, " coroutines ", ROUND_COUNT, " times: ", double(elapsed) / 1000.0, " ms, ", double(elapsed) * 1000.0 / (COROUTINE_COUNT * ROUND_COUNT), " ns per await.");
+
+	CHECK(int(instance->get("completed")) == COROUTINE_COUNT);
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_BENCHMARK_H
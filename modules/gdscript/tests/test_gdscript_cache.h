@@ -0,0 +1,105 @@
+/**************************************************************************/
+/*  test_gdscript_cache.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_CACHE_H
+#define TEST_GDSCRIPT_CACHE_H
+
+#include "../gdscript_cache.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace GDScriptTests {
+
+static void write_compile_test_script(const String &p_path, const String &p_source) {
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	REQUIRE(file.is_valid());
+	file->store_string(p_source);
+}
+
+TEST_CASE("[Modules][GDScript] Compiling scripts in parallel") {
+	const String dir = TestUtils::get_temp_path("gdscript_compile_scripts");
+	DirAccess::make_dir_recursive_absolute(dir);
+
+	const String base_path = dir.path_join("base.gd");
+	const String derived_path = dir.path_join("derived.gd");
+	const String user_path = dir.path_join("user.gd");
+	const String broken_path = dir.path_join("broken.gd");
+
+	write_compile_test_script(base_path, "extends RefCounted\n\nvar base_value = 1\n\nfunc get_value():\n\treturn base_value\n");
+	write_compile_test_script(derived_path, "extends \"base.gd\"\n\nfunc get_value():\n\treturn super() + 1\n");
+	write_compile_test_script(user_path, "extends RefCounted\n\nconst Derived = preload(\"derived.gd\")\n\nfunc get_value():\n\treturn Derived.new().get_value() * 10\n");
+	write_compile_test_script(broken_path, "extends RefCounted\n\nfunc broken(:\n");
+
+	Vector<String> paths;
+	paths.push_back(user_path);
+	paths.push_back(derived_path);
+	paths.push_back(broken_path);
+	paths.push_back(base_path);
+
+	ERR_PRINT_OFF;
+	const Vector<GDScriptCache::CompileTime> times = GDScriptCache::compile_scripts(paths);
+	ERR_PRINT_ON;
+
+	REQUIRE(times.size() == 4);
+	int base_index = -1;
+	int derived_index = -1;
+	for (int i = 0; i < times.size(); i++) {
+		if (times[i].path == base_path) {
+			base_index = i;
+		} else if (times[i].path == derived_path) {
+			derived_index = i;
+		}
+		CHECK_MESSAGE((times[i].error == OK) == (times[i].path != broken_path), "Unexpected result for ", times[i].path);
+	}
+	CHECK_MESSAGE(base_index < derived_index, "Base classes should be compiled before the scripts extending them.");
+
+	Ref<GDScript> user = GDScriptCache::get_cached_script(user_path);
+	REQUIRE(user.is_valid());
+	REQUIRE(user->is_valid());
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(user);
+	CHECK(int(instance->call("get_value")) == 20);
+	instance.unref();
+
+	user.unref();
+	for (const String &path : paths) {
+		GDScriptCache::remove_script(path);
+		DirAccess::remove_absolute(path);
+	}
+	DirAccess::remove_absolute(dir);
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_CACHE_H
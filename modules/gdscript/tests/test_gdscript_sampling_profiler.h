@@ -0,0 +1,100 @@
+/**************************************************************************/
+/*  test_gdscript_sampling_profiler.h                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_SAMPLING_PROFILER_H
+#define TEST_GDSCRIPT_SAMPLING_PROFILER_H
+
+#ifdef DEBUG_ENABLED
+
+#include "../gdscript.h"
+#include "../gdscript_sampling_profiler.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+TEST_CASE("[Modules][GDScript] Sampling profiler") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(extends RefCounted
+
+func busy(usec: int) -> int:
+	var end := Time.get_ticks_usec() + usec
+	var count := 0
+	while Time.get_ticks_usec() < end:
+		count += 1
+	return count
+
+func run() -> int:
+	return busy(50000)
+)");
+	gdscript->set_path("res://sampling_profiler_test.gd", true);
+	const Error error = gdscript->reload();
+	REQUIRE_MESSAGE(error == OK, "The script should compile successfully.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+
+	GDScriptSamplingProfiler::start(100);
+	CHECK(GDScriptSamplingProfiler::is_active());
+	CHECK(int64_t(ref_counted->call("run")) > 0);
+	GDScriptSamplingProfiler::stop();
+	CHECK_FALSE(GDScriptSamplingProfiler::is_active());
+
+	const String folded = GDScriptSamplingProfiler::get_folded_stacks();
+	const Vector<String> stacks = folded.strip_edges().split("\n");
+	REQUIRE_MESSAGE(stacks.size() > 0, "Some samples should have been taken.");
+
+	int64_t samples = 0;
+	for (const String &stack : stacks) {
+		// Every sample is inside `busy()`, called from line 11 of `run()`.
+		const Vector<String> frames = stack.get_slice(" ", 0).split(";");
+		REQUIRE_MESSAGE(frames.size() == 2, "Unexpected stack: ", stack);
+		CHECK_MESSAGE(frames[0] == "res://sampling_profiler_test.gd:run:11", "Unexpected stack: ", stack);
+		CHECK_MESSAGE(frames[1].begins_with("res://sampling_profiler_test.gd:busy:"), "Unexpected stack: ", stack);
+		const int line = frames[1].get_slice(":", frames[1].get_slice_count(":") - 1).to_int();
+		CHECK_MESSAGE((line >= 4 && line <= 8), "Unexpected line: ", stack);
+		samples += stack.get_slice(" ", 1).to_int();
+	}
+	CHECK(samples > 0);
+
+	// The caller line includes the time of every line of `busy()`.
+	const String line_hits = GDScriptSamplingProfiler::get_line_hits();
+	CHECK(line_hits.begins_with("# location self total\n"));
+	CHECK(line_hits.contains("\nres://sampling_profiler_test.gd:11 0 " + itos(samples) + "\n"));
+
+	GDScriptSamplingProfiler::clear();
+	CHECK(GDScriptSamplingProfiler::get_folded_stacks().is_empty());
+}
+
+} // namespace GDScriptTests
+
+#endif // DEBUG_ENABLED
+
+#endif // TEST_GDSCRIPT_SAMPLING_PROFILER_H
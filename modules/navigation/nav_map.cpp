@@ -37,6 +37,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/os/frame_arena.h"
 
 #include <Obstacle2d.h>
 
@@ -219,8 +220,11 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
+	// Scratch buffers for the search live in the thread's arena, and are dropped when returning.
+	FrameArena::Scope arena_scope;
+
 	// List of all reachable navigation polys.
-	LocalVector<gd::NavigationPoly> navigation_polys;
+	FrameArenaVector<gd::NavigationPoly> navigation_polys;
 	navigation_polys.reserve(polygons.size() * 0.75);
 
 	// Add the start polygon to the reachable navigation polygons.
@@ -232,7 +236,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	navigation_polys.push_back(begin_navigation_poly);
 
 	// List of polygon IDs to visit.
-	List<uint32_t> to_visit;
+	List<uint32_t, FrameArenaAllocator> to_visit;
 	to_visit.push_back(0);
 
 	// This is an implementation of the A* algorithm.
@@ -383,7 +387,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		// Find the polygon with the minimum cost from the list of polygons to visit.
 		least_cost_id = -1;
 		real_t least_cost = FLT_MAX;
-		for (List<uint32_t>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
+		for (List<uint32_t, FrameArenaAllocator>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
 			gd::NavigationPoly *np = &navigation_polys[element->get()];
 			real_t cost = np->traveled_distance;
 			cost += (np->entry.distance_to(end_point) * np->poly->owner->get_travel_cost());
@@ -1368,7 +1372,7 @@ void NavMap::dispatch_callbacks() {
 	}
 }
 
-void NavMap::clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
+void NavMap::clip_path(const FrameArenaVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
 	Vector3 from = path[path.size() - 1];
 
 	if (from.is_equal_approx(p_to_point)) {
@@ -33,6 +33,7 @@
 
 #include "core/math/math_funcs.h"
 #include "core/math/rect2.h"
+#include "core/templates/local_vector.h"
 
 class GodotCollisionObject2D;
 
@@ -44,6 +45,10 @@ public:
 
 	typedef uint32_t ID;
 
+	enum {
+		CULL_SEGMENTS_MAX = 32
+	};
+
 	typedef void *(*PairCallback)(GodotCollisionObject2D *A, int p_subindex_A, GodotCollisionObject2D *B, int p_subindex_B, void *p_userdata);
 	typedef void (*UnpairCallback)(GodotCollisionObject2D *A, int p_subindex_A, GodotCollisionObject2D *B, int p_subindex_B, void *p_data, void *p_userdata);
 
@@ -58,6 +63,9 @@ public:
 	virtual int get_subindex(ID p_id) const = 0;
 
 	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
+	// Culls up to CULL_SEGMENTS_MAX segments together, which is faster when they are close to each other.
+	// The results of segment i are written to r_results[i] and r_result_indices[i].
+	virtual void cull_segments(const Vector2 *p_from, const Vector2 *p_to, int p_count, LocalVector<GodotCollisionObject2D *> *r_results, LocalVector<int> *r_result_indices, int p_max_results) = 0;
 	virtual int cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) = 0;
@@ -87,6 +87,7 @@ public:
 	virtual int get_subindex(ID p_id) const override;
 
 	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+	virtual void cull_segments(const Vector2 *p_from, const Vector2 *p_to, int p_count, LocalVector<GodotCollisionObject2D *> *r_results, LocalVector<int> *r_result_indices, int p_max_results) override;
 	virtual int cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
 
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) override;
@@ -33,12 +33,16 @@
 #include "godot_collision_solver_2d.h"
 #include "godot_physics_server_2d.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/templates/pair.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
 
+#define INTERSECT_RAYS_PACKET_SIZE 16
+#define CAST_MOTION_BATCH_GRAIN 16
+
 _FORCE_INLINE_ static bool _can_collide_with(GodotCollisionObject2D *p_object, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (!(p_object->get_collision_layer() & p_collision_mask)) {
 		return false;
@@ -114,17 +118,14 @@ int GodotPhysicsDirectSpaceState2D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+// Finds the closest hit of the ray among the shapes culled for it.
+static bool _intersect_culled_ray(const PhysicsDirectSpaceState2D::RayParameters &p_parameters, const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D *const *p_objects, const int *p_shape_indices, int p_amount, PhysicsDirectSpaceState2D::RayResult &r_result) {
 	Vector2 begin, end;
 	Vector2 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -133,18 +134,18 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	const GodotCollisionObject2D *res_obj = nullptr;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject2D *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_shape_indices[i];
 		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -204,6 +205,43 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	return _intersect_culled_ray(p_parameters, p_parameters.from, p_parameters.to, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result);
+}
+
+void GodotPhysicsDirectSpaceState2D::intersect_rays_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_collided) {
+	ERR_FAIL_COND(space->locked);
+
+	// Rays next to each other in the batch are culled together, walking the broadphase once for each packet.
+	// They get their own cull results, as the ones of the space can't be shared between threads.
+	auto intersect_packets = [&](uint32_t p_packet_from, uint32_t p_packet_to) {
+		LocalVector<GodotCollisionObject2D *> objects[INTERSECT_RAYS_PACKET_SIZE];
+		LocalVector<int> shape_indices[INTERSECT_RAYS_PACKET_SIZE];
+
+		for (uint32_t packet = p_packet_from; packet < p_packet_to; packet++) {
+			const int first = packet * INTERSECT_RAYS_PACKET_SIZE;
+			const int count = MIN(p_count - first, INTERSECT_RAYS_PACKET_SIZE);
+
+			space->broadphase->cull_segments(p_from + first, p_to + first, count, objects, shape_indices, GodotSpace2D::INTERSECTION_QUERY_MAX);
+
+			for (int i = 0; i < count; i++) {
+				r_collided[first + i] = _intersect_culled_ray(p_parameters, p_from[first + i], p_to[first + i], objects[i].ptr(), shape_indices[i].ptr(), objects[i].size(), r_results[first + i]);
+			}
+		}
+	};
+
+	const uint32_t packet_count = (p_count + INTERSECT_RAYS_PACKET_SIZE - 1) / INTERSECT_RAYS_PACKET_SIZE;
+	if (packet_count > 1) {
+		WorkerThreadPool::get_singleton()->parallel_for(0, packet_count, 1, intersect_packets, true, SNAME("Physics2DIntersectRays"));
+	} else {
+		intersect_packets(0, packet_count);
+	}
+}
+
 int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
 	if (p_result_max <= 0) {
 		return 0;
@@ -253,43 +291,40 @@ int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
-	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, false);
-
-	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
+bool GodotPhysicsDirectSpaceState2D::_cast_motion(GodotShape2D *p_shape, const ShapeParameters &p_parameters, const Transform2D &p_transform, const Vector2 &p_motion, GodotCollisionObject2D **r_cull_objects, int *r_cull_shape_indices, real_t &p_closest_safe, real_t &p_closest_unsafe) {
+	Rect2 aabb = p_transform.xform(p_shape->get_aabb());
+	aabb = aabb.merge(Rect2(aabb.position + p_motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_aabb(aabb, r_cull_objects, GodotSpace2D::INTERSECTION_QUERY_MAX, r_cull_shape_indices);
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_objects[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject2D *col_obj = r_cull_objects[i];
+		int shape_idx = r_cull_shape_indices[i];
 
 		Transform2D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (!GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (!GodotCollisionSolver2D::solve(p_shape, p_transform, p_motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
-		if (GodotCollisionSolver2D::solve(shape, p_parameters.transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (GodotCollisionSolver2D::solve(p_shape, p_transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
-		Vector2 mnormal = p_parameters.motion.normalized();
+		Vector2 mnormal = p_motion.normalized();
 
 		//just do kinematic solving
 		real_t low = 0.0;
@@ -299,7 +334,7 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
 			Vector2 sep = mnormal; //important optimization for this to work fast enough
-			bool collided = GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
+			bool collided = GodotCollisionSolver2D::solve(p_shape, p_transform, p_motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
 
 			if (collided) {
 				hi = fraction;
@@ -336,6 +371,40 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	return _cast_motion(shape, p_parameters, p_parameters.transform, p_parameters.motion, space->intersection_query_results, space->intersection_query_subindex_results, p_closest_safe, p_closest_unsafe);
+}
+
+bool GodotPhysicsDirectSpaceState2D::cast_motion_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	// Each thread culls to its own results, as the ones of the space can't be shared between threads.
+	auto cast_motions = [&](uint32_t p_from, uint32_t p_to) {
+		LocalVector<GodotCollisionObject2D *> objects;
+		objects.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+		LocalVector<int> shape_indices;
+		shape_indices.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+
+		for (uint32_t i = p_from; i < p_to; i++) {
+			Transform2D transform = p_parameters.transform;
+			transform.set_origin(p_origins[i]);
+			_cast_motion(shape, p_parameters, transform, p_motions[i], objects.ptr(), shape_indices.ptr(), r_closest_safe[i], r_closest_unsafe[i]);
+		}
+	};
+
+	if (p_count > CAST_MOTION_BATCH_GRAIN) {
+		WorkerThreadPool::get_singleton()->parallel_for(0, p_count, CAST_MOTION_BATCH_GRAIN, cast_motions, true, SNAME("Physics2DCastMotions"));
+	} else {
+		cast_motions(0, p_count);
+	}
+
+	return true;
+}
+
 bool GodotPhysicsDirectSpaceState2D::collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) {
 	if (p_result_max <= 0) {
 		return false;
@@ -45,13 +45,17 @@
 class GodotPhysicsDirectSpaceState2D : public PhysicsDirectSpaceState2D {
 	GDCLASS(GodotPhysicsDirectSpaceState2D, PhysicsDirectSpaceState2D);
 
+	bool _cast_motion(GodotShape2D *p_shape, const ShapeParameters &p_parameters, const Transform2D &p_transform, const Vector2 &p_motion, GodotCollisionObject2D **r_cull_objects, int *r_cull_shape_indices, real_t &p_closest_safe, real_t &p_closest_unsafe);
+
 public:
 	GodotSpace2D *space = nullptr;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
+	virtual void intersect_rays_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_collided) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) override;
+	virtual bool cast_motion_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 
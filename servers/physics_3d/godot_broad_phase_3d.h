@@ -33,6 +33,7 @@
 
 #include "core/math/aabb.h"
 #include "core/math/math_funcs.h"
+#include "core/templates/local_vector.h"
 
 class GodotCollisionObject3D;
 
@@ -44,6 +45,10 @@ public:
 
 	typedef uint32_t ID;
 
+	enum {
+		CULL_SEGMENTS_MAX = 32
+	};
+
 	typedef void *(*PairCallback)(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_userdata);
 	typedef void (*UnpairCallback)(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_data, void *p_userdata);
 
@@ -59,6 +64,9 @@ public:
 
 	virtual int cull_point(const Vector3 &p_point, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
+	// Culls up to CULL_SEGMENTS_MAX segments together, which is faster when they are close to each other.
+	// The results of segment i are written to r_results[i] and r_result_indices[i].
+	virtual void cull_segments(const Vector3 *p_from, const Vector3 *p_to, int p_count, LocalVector<GodotCollisionObject3D *> *r_results, LocalVector<int> *r_result_indices, int p_max_results) = 0;
 	virtual int cull_aabb(const AABB &p_aabb, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) = 0;
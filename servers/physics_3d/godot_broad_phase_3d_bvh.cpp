@@ -82,6 +82,10 @@ int GodotBroadPhase3DBVH::cull_segment(const Vector3 &p_from, const Vector3 &p_t
 	return bvh.cull_segment(p_from, p_to, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
 }
 
+void GodotBroadPhase3DBVH::cull_segments(const Vector3 *p_from, const Vector3 *p_to, int p_count, LocalVector<GodotCollisionObject3D *> *r_results, LocalVector<int> *r_result_indices, int p_max_results) {
+	bvh.cull_segments(p_from, p_to, p_count, r_results, r_result_indices, p_max_results, nullptr);
+}
+
 int GodotBroadPhase3DBVH::cull_aabb(const AABB &p_aabb, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices) {
 	return bvh.cull_aabb(p_aabb, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
 }
@@ -125,4 +129,5 @@ GodotBroadPhase3D *GodotBroadPhase3DBVH::_create() {
 GodotBroadPhase3DBVH::GodotBroadPhase3DBVH() {
 	bvh.set_pair_callback(_pair_callback, this);
 	bvh.set_unpair_callback(_unpair_callback, this);
+	bvh.params_set_parallel_pairing(true);
 }
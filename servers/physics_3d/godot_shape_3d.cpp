@@ -35,6 +35,16 @@
 #include "core/math/geometry_3d.h"
 #include "core/templates/sort_array.h"
 
+#ifndef REAL_T_IS_DOUBLE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONCAVE_BVH_LANES_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CONCAVE_BVH_LANES_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 // GodotHeightMapShape3D is based on Bullet btHeightfieldTerrainShape.
 
 /*
@@ -1345,53 +1355,157 @@ Vector3 GodotConcavePolygonShape3D::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+// One lane for each child of a concave polygon BVH node. Comparisons give masks with all bits set
+// in the lanes where they hold.
+struct ConcaveBVHLanes {
+#if defined(CONCAVE_BVH_LANES_SSE2)
+	__m128 v;
+
+	static _FORCE_INLINE_ ConcaveBVHLanes splat(real_t p_value) { return { _mm_set1_ps(p_value) }; }
+	_FORCE_INLINE_ void store(real_t *r_values) const { _mm_storeu_ps(r_values, v); }
+
+	// Same as _concave_bvh_dequantize() in each lane.
+	static _FORCE_INLINE_ ConcaveBVHLanes dequantize(float p_origin, float p_scale, const uint8_t *p_quantized) {
+		int32_t packed;
+		memcpy(&packed, p_quantized, sizeof(packed));
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i quantized = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+		return { _mm_add_ps(_mm_set1_ps(p_origin), _mm_mul_ps(_mm_cvtepi32_ps(quantized), _mm_set1_ps(p_scale))) };
+	}
+
+	_FORCE_INLINE_ ConcaveBVHLanes operator-(const ConcaveBVHLanes &p_b) const { return { _mm_sub_ps(v, p_b.v) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator*(const ConcaveBVHLanes &p_b) const { return { _mm_mul_ps(v, p_b.v) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator<(const ConcaveBVHLanes &p_b) const { return { _mm_cmplt_ps(v, p_b.v) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator<=(const ConcaveBVHLanes &p_b) const { return { _mm_cmple_ps(v, p_b.v) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator>(const ConcaveBVHLanes &p_b) const { return { _mm_cmpgt_ps(v, p_b.v) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator&(const ConcaveBVHLanes &p_b) const { return { _mm_and_ps(v, p_b.v) }; }
+	static _FORCE_INLINE_ ConcaveBVHLanes min(const ConcaveBVHLanes &p_a, const ConcaveBVHLanes &p_b) { return { _mm_min_ps(p_a.v, p_b.v) }; }
+	static _FORCE_INLINE_ ConcaveBVHLanes max(const ConcaveBVHLanes &p_a, const ConcaveBVHLanes &p_b) { return { _mm_max_ps(p_a.v, p_b.v) }; }
+
+	// Bit i set when the mask is set in lane i.
+	_FORCE_INLINE_ uint32_t bits() const { return _mm_movemask_ps(v); }
+#elif defined(CONCAVE_BVH_LANES_NEON)
+	float32x4_t v;
+
+	static _FORCE_INLINE_ ConcaveBVHLanes splat(real_t p_value) { return { vdupq_n_f32(p_value) }; }
+	_FORCE_INLINE_ void store(real_t *r_values) const { vst1q_f32(r_values, v); }
+
+	// Same as _concave_bvh_dequantize() in each lane.
+	static _FORCE_INLINE_ ConcaveBVHLanes dequantize(float p_origin, float p_scale, const uint8_t *p_quantized) {
+		uint32_t packed;
+		memcpy(&packed, p_quantized, sizeof(packed));
+		const uint16x8_t quantized = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(packed)));
+		const float32x4_t values = vcvtq_f32_u32(vmovl_u16(vget_low_u16(quantized)));
+		return { vaddq_f32(vdupq_n_f32(p_origin), vmulq_f32(values, vdupq_n_f32(p_scale))) };
+	}
+
+	_FORCE_INLINE_ ConcaveBVHLanes operator-(const ConcaveBVHLanes &p_b) const { return { vsubq_f32(v, p_b.v) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator*(const ConcaveBVHLanes &p_b) const { return { vmulq_f32(v, p_b.v) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator<(const ConcaveBVHLanes &p_b) const { return { vreinterpretq_f32_u32(vcltq_f32(v, p_b.v)) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator<=(const ConcaveBVHLanes &p_b) const { return { vreinterpretq_f32_u32(vcleq_f32(v, p_b.v)) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator>(const ConcaveBVHLanes &p_b) const { return { vreinterpretq_f32_u32(vcgtq_f32(v, p_b.v)) }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator&(const ConcaveBVHLanes &p_b) const { return { vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), vreinterpretq_u32_f32(p_b.v))) }; }
+	static _FORCE_INLINE_ ConcaveBVHLanes min(const ConcaveBVHLanes &p_a, const ConcaveBVHLanes &p_b) { return { vminq_f32(p_a.v, p_b.v) }; }
+	static _FORCE_INLINE_ ConcaveBVHLanes max(const ConcaveBVHLanes &p_a, const ConcaveBVHLanes &p_b) { return { vmaxq_f32(p_a.v, p_b.v) }; }
+
+	// Bit i set when the mask is set in lane i.
+	_FORCE_INLINE_ uint32_t bits() const {
+		static const uint32_t lane_bits[4] = { 1, 2, 4, 8 };
+		return vaddvq_u32(vandq_u32(vreinterpretq_u32_f32(v), vld1q_u32(lane_bits)));
+	}
+#else
+	real_t v[GodotConcavePolygonShape3D::BVH_NODE_WIDTH];
 
-	if (!params_bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
+	static _FORCE_INLINE_ ConcaveBVHLanes splat(real_t p_value) { return { { p_value, p_value, p_value, p_value } }; }
+	_FORCE_INLINE_ void store(real_t *r_values) const { memcpy(r_values, v, sizeof(v)); }
+
+	static _FORCE_INLINE_ ConcaveBVHLanes dequantize(float p_origin, float p_scale, const uint8_t *p_quantized);
+
+	_FORCE_INLINE_ ConcaveBVHLanes operator-(const ConcaveBVHLanes &p_b) const { return { { v[0] - p_b.v[0], v[1] - p_b.v[1], v[2] - p_b.v[2], v[3] - p_b.v[3] } }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator*(const ConcaveBVHLanes &p_b) const { return { { v[0] * p_b.v[0], v[1] * p_b.v[1], v[2] * p_b.v[2], v[3] * p_b.v[3] } }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator<(const ConcaveBVHLanes &p_b) const { return { { real_t(v[0] < p_b.v[0]), real_t(v[1] < p_b.v[1]), real_t(v[2] < p_b.v[2]), real_t(v[3] < p_b.v[3]) } }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator<=(const ConcaveBVHLanes &p_b) const { return { { real_t(v[0] <= p_b.v[0]), real_t(v[1] <= p_b.v[1]), real_t(v[2] <= p_b.v[2]), real_t(v[3] <= p_b.v[3]) } }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator>(const ConcaveBVHLanes &p_b) const { return { { real_t(v[0] > p_b.v[0]), real_t(v[1] > p_b.v[1]), real_t(v[2] > p_b.v[2]), real_t(v[3] > p_b.v[3]) } }; }
+	_FORCE_INLINE_ ConcaveBVHLanes operator&(const ConcaveBVHLanes &p_b) const { return { { v[0] * p_b.v[0], v[1] * p_b.v[1], v[2] * p_b.v[2], v[3] * p_b.v[3] } }; }
+	static _FORCE_INLINE_ ConcaveBVHLanes min(const ConcaveBVHLanes &p_a, const ConcaveBVHLanes &p_b) { return { { MIN(p_a.v[0], p_b.v[0]), MIN(p_a.v[1], p_b.v[1]), MIN(p_a.v[2], p_b.v[2]), MIN(p_a.v[3], p_b.v[3]) } }; }
+	static _FORCE_INLINE_ ConcaveBVHLanes max(const ConcaveBVHLanes &p_a, const ConcaveBVHLanes &p_b) { return { { MAX(p_a.v[0], p_b.v[0]), MAX(p_a.v[1], p_b.v[1]), MAX(p_a.v[2], p_b.v[2]), MAX(p_a.v[3], p_b.v[3]) } }; }
+
+	// Bit i set when the mask is set in lane i.
+	_FORCE_INLINE_ uint32_t bits() const { return (v[0] != 0 ? 1 : 0) | (v[1] != 0 ? 2 : 0) | (v[2] != 0 ? 4 : 0) | (v[3] != 0 ? 8 : 0); }
+#endif
+};
+
+// The bounds the build checks against, so they must round exactly like the lanes do.
+static _FORCE_INLINE_ real_t _concave_bvh_dequantize(float p_origin, float p_scale, int p_quantized) {
+	return real_t(p_origin) + real_t(p_quantized) * real_t(p_scale);
+}
+
+#if !defined(CONCAVE_BVH_LANES_SSE2) && !defined(CONCAVE_BVH_LANES_NEON)
+ConcaveBVHLanes ConcaveBVHLanes::dequantize(float p_origin, float p_scale, const uint8_t *p_quantized) {
+	return { { _concave_bvh_dequantize(p_origin, p_scale, p_quantized[0]), _concave_bvh_dequantize(p_origin, p_scale, p_quantized[1]), _concave_bvh_dequantize(p_origin, p_scale, p_quantized[2]), _concave_bvh_dequantize(p_origin, p_scale, p_quantized[3]) } };
+}
+#endif
+
+static _FORCE_INLINE_ ConcaveBVHLanes _concave_bvh_overlap_axis(const GodotConcavePolygonShape3D::BVHNode &p_node, int p_axis, const ConcaveBVHLanes &p_begin, const ConcaveBVHLanes &p_end) {
+	const ConcaveBVHLanes child_begin = ConcaveBVHLanes::dequantize(p_node.origin[p_axis], p_node.scale[p_axis], p_node.child_min[p_axis]);
+	const ConcaveBVHLanes child_end = ConcaveBVHLanes::dequantize(p_node.origin[p_axis], p_node.scale[p_axis], p_node.child_max[p_axis]);
+	return (child_begin < p_end) & (child_end > p_begin);
+}
+
+// Children of the node whose bounds overlap the box, as bits.
+static _FORCE_INLINE_ uint32_t _concave_bvh_cull_aabb(const GodotConcavePolygonShape3D::BVHNode &p_node, const ConcaveBVHLanes *p_begin, const ConcaveBVHLanes *p_end) {
+	const ConcaveBVHLanes overlap = _concave_bvh_overlap_axis(p_node, 0, p_begin[0], p_end[0]) & _concave_bvh_overlap_axis(p_node, 1, p_begin[1], p_end[1]) & _concave_bvh_overlap_axis(p_node, 2, p_begin[2], p_end[2]);
+	return overlap.bits();
+}
+
+// Children of the node whose bounds the segment crosses before p_max_t, as bits, along with where it enters them.
+static _FORCE_INLINE_ uint32_t _concave_bvh_cull_segment(const GodotConcavePolygonShape3D::BVHNode &p_node, const ConcaveBVHLanes *p_from, const ConcaveBVHLanes *p_inv_delta, real_t p_max_t, real_t *r_enter_t) {
+	ConcaveBVHLanes enter = ConcaveBVHLanes::splat(0);
+	ConcaveBVHLanes exit = ConcaveBVHLanes::splat(p_max_t);
+	for (int i = 0; i < 3; i++) {
+		const ConcaveBVHLanes t0 = (ConcaveBVHLanes::dequantize(p_node.origin[i], p_node.scale[i], p_node.child_min[i]) - p_from[i]) * p_inv_delta[i];
+		const ConcaveBVHLanes t1 = (ConcaveBVHLanes::dequantize(p_node.origin[i], p_node.scale[i], p_node.child_max[i]) - p_from[i]) * p_inv_delta[i];
+		enter = ConcaveBVHLanes::max(enter, ConcaveBVHLanes::min(t0, t1));
+		exit = ConcaveBVHLanes::min(exit, ConcaveBVHLanes::max(t0, t1));
 	}
+	enter.store(r_enter_t);
+	return (enter <= exit).bits();
+}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-
-		Vector3 res;
-		Vector3 normal;
-		int face_index = params_bvh->face_index;
-		if (face->intersect_segment(p_params->from, p_params->to, res, normal, face_index, true)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			if ((d > 0) && (d < p_params->min_d)) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = normal;
-				p_params->face_index = face_index;
-				p_params->collisions++;
-			}
-		}
-	} else {
-		if (params_bvh->left >= 0) {
-			_cull_segment(params_bvh->left, p_params);
-		}
-		if (params_bvh->right >= 0) {
-			_cull_segment(params_bvh->right, p_params);
+void GodotConcavePolygonShape3D::_cull_segment(int p_face_index, _SegmentCullParams *p_params) const {
+	const Face *f = &p_params->faces[p_face_index];
+	GodotFaceShape3D *face = p_params->face;
+	face->normal = f->normal;
+	face->vertex[0] = p_params->vertices[f->indices[0]];
+	face->vertex[1] = p_params->vertices[f->indices[1]];
+	face->vertex[2] = p_params->vertices[f->indices[2]];
+
+	Vector3 res;
+	Vector3 normal;
+	int face_index = p_face_index;
+	if (face->intersect_segment(p_params->from, p_params->to, res, normal, face_index, true)) {
+		real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
+		if ((d > 0) && (d < p_params->min_d)) {
+			p_params->min_d = d;
+			p_params->result = res;
+			p_params->normal = normal;
+			p_params->face_index = face_index;
+			p_params->collisions++;
+			// Nothing past this hit can be closer, leave some room for rounding.
+			p_params->max_t = MIN(p_params->max_t, (d + CMP_EPSILON) * p_params->inv_length);
 		}
 	}
 }
 
 bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const {
-	if (faces.size() == 0) {
+	if (faces.size() == 0 || p_begin == p_end) {
 		return false;
 	}
 
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
+	const BVHNode *br = bvh.ptr();
 
 	GodotFaceShape3D face;
 	face.backface_collision = backface_collision && p_hit_back_faces;
@@ -1400,6 +1514,7 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 	params.from = p_begin;
 	params.to = p_end;
 	params.dir = (p_end - p_begin).normalized();
+	params.inv_length = 1.0 / (p_end - p_begin).length();
 
 	params.faces = fr;
 	params.vertices = vr;
@@ -1407,8 +1522,53 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 
 	params.face = &face;
 
-	// cull
-	_cull_segment(0, &params);
+	ConcaveBVHLanes from[3];
+	ConcaveBVHLanes inv_delta[3];
+	for (int i = 0; i < 3; i++) {
+		const real_t delta = p_end[i] - p_begin[i];
+		from[i] = ConcaveBVHLanes::splat(p_begin[i]);
+		// Keeps the slabs finite when the segment runs along them.
+		inv_delta[i] = ConcaveBVHLanes::splat(Math::abs(delta) < 1e-20 ? 1e20 : 1.0 / delta);
+	}
+
+	// cull, closest children first so that farther ones can be skipped
+	struct Entry {
+		int32_t child;
+		real_t enter_t;
+	};
+	Entry stack[BVH_STACK_SIZE];
+	int stack_size = 1;
+	stack[0].child = 0;
+	stack[0].enter_t = 0;
+
+	while (stack_size > 0) {
+		const Entry entry = stack[--stack_size];
+		if (entry.enter_t > params.max_t) {
+			continue;
+		}
+		if (entry.child < 0) {
+			_cull_segment(~entry.child, &params);
+			continue;
+		}
+
+		const BVHNode &node = br[entry.child];
+		real_t enter_t[BVH_NODE_WIDTH];
+		const uint32_t hits = _concave_bvh_cull_segment(node, from, inv_delta, params.max_t, enter_t);
+
+		const int first = stack_size;
+		for (int i = 0; i < BVH_NODE_WIDTH; i++) {
+			if (!(hits & (1 << i)) || node.children[i] == BVH_EMPTY_CHILD) {
+				continue;
+			}
+			// Keep the nearest child on top.
+			int j = stack_size++;
+			for (; j > first && stack[j - 1].enter_t < enter_t[i]; j--) {
+				stack[j] = stack[j - 1];
+			}
+			stack[j].child = node.children[i];
+			stack[j].enter_t = enter_t[i];
+		}
+	}
 
 	if (params.collisions > 0) {
 		r_result = params.result;
@@ -1428,38 +1588,26 @@ Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point)
 	return Vector3();
 }
 
-bool GodotConcavePolygonShape3D::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+bool GodotConcavePolygonShape3D::_cull(int p_face_index, _CullParams *p_params) const {
+	const Face *f = &p_params->faces[p_face_index];
+	const Vector3 &v0 = p_params->vertices[f->indices[0]];
+	const Vector3 &v1 = p_params->vertices[f->indices[1]];
+	const Vector3 &v2 = p_params->vertices[f->indices[2]];
 
-	if (!p_params->aabb.intersects(params_bvh->aabb)) {
+	// The quantized bounds are a little larger, so check the exact ones too.
+	AABB face_aabb(v0, Vector3());
+	face_aabb.expand_to(v1);
+	face_aabb.expand_to(v2);
+	if (!p_params->aabb.intersects(face_aabb)) {
 		return false;
 	}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		if (p_params->callback(p_params->userdata, face)) {
-			return true;
-		}
-	} else {
-		if (params_bvh->left >= 0) {
-			if (_cull(params_bvh->left, p_params)) {
-				return true;
-			}
-		}
-
-		if (params_bvh->right >= 0) {
-			if (_cull(params_bvh->right, p_params)) {
-				return true;
-			}
-		}
-	}
-
-	return false;
+	GodotFaceShape3D *face = p_params->face;
+	face->normal = f->normal;
+	face->vertex[0] = v0;
+	face->vertex[1] = v1;
+	face->vertex[2] = v2;
+	return p_params->callback(p_params->userdata, face);
 }
 
 void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
@@ -1473,7 +1621,7 @@ void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
+	const BVHNode *br = bvh.ptr();
 
 	GodotFaceShape3D face; // use this to send in the callback
 	face.backface_collision = backface_collision;
@@ -1488,8 +1636,34 @@ void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_
 	params.callback = p_callback;
 	params.userdata = p_userdata;
 
+	ConcaveBVHLanes begin[3];
+	ConcaveBVHLanes end[3];
+	for (int i = 0; i < 3; i++) {
+		begin[i] = ConcaveBVHLanes::splat(local_aabb.position[i]);
+		end[i] = ConcaveBVHLanes::splat(local_aabb.position[i] + local_aabb.size[i]);
+	}
+
 	// cull
-	_cull(0, &params);
+	int32_t stack[BVH_STACK_SIZE];
+	int stack_size = 1;
+	stack[0] = 0;
+
+	while (stack_size > 0) {
+		const BVHNode &node = br[stack[--stack_size]];
+		const uint32_t hits = _concave_bvh_cull_aabb(node, begin, end);
+
+		for (int i = BVH_NODE_WIDTH - 1; i >= 0; i--) {
+			const int32_t child = node.children[i];
+			if (!(hits & (1 << i)) || child == BVH_EMPTY_CHILD) {
+				continue;
+			}
+			if (child >= 0) {
+				stack[stack_size++] = child;
+			} else if (_cull(~child, &params)) {
+				return;
+			}
+		}
+	}
 }
 
 Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
@@ -1528,85 +1702,275 @@ struct _Volume_BVH_CompareZ {
 
 struct _Volume_BVH {
 	AABB aabb;
-	_Volume_BVH *left = nullptr;
-	_Volume_BVH *right = nullptr;
+	int left = -1;
+	int right = -1;
 
-	int face_index = 0;
+	int face_index = -1;
+	int face_count = 1;
 };
 
-_Volume_BVH *_volume_build_bvh(_Volume_BVH_Element *p_elements, int p_size, int &count) {
-	_Volume_BVH *bvh = memnew(_Volume_BVH);
-
-	if (p_size == 1) {
-		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = nullptr;
-		bvh->right = nullptr;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
-		bvh->face_index = -1;
+static _FORCE_INLINE_ real_t _volume_bvh_surface_area(const AABB &p_aabb) {
+	return p_aabb.size.x * p_aabb.size.y + p_aabb.size.y * p_aabb.size.z + p_aabb.size.z * p_aabb.size.x;
+}
+
+// Splits the elements where the surface area heuristic estimates the cheapest queries, binning them by center.
+// Returns the size of the first half, or 0 if all centers fall in the same bin.
+static int _volume_bvh_sah_split(_Volume_BVH_Element *p_elements, int p_size, const AABB &p_centers) {
+	const int BIN_COUNT = 16;
+
+	int best_axis = -1;
+	int best_bin = 0;
+	real_t best_cost = 0;
+
+	for (int axis = 0; axis < 3; axis++) {
+		if (p_centers.size[axis] <= 0) {
+			continue;
+		}
+		const real_t bin_scale = BIN_COUNT / p_centers.size[axis];
+
+		AABB bin_aabb[BIN_COUNT];
+		int bin_size[BIN_COUNT] = {};
+		for (int i = 0; i < p_size; i++) {
+			const int bin = CLAMP(int((p_elements[i].center[axis] - p_centers.position[axis]) * bin_scale), 0, BIN_COUNT - 1);
+			if (bin_size[bin] == 0) {
+				bin_aabb[bin] = p_elements[i].aabb;
+			} else {
+				bin_aabb[bin].merge_with(p_elements[i].aabb);
+			}
+			bin_size[bin]++;
+		}
+
+		// Cost of everything after each bin.
+		real_t right_cost[BIN_COUNT] = {};
+		AABB right_aabb;
+		int right_size = 0;
+		for (int bin = BIN_COUNT - 1; bin > 0; bin--) {
+			if (bin_size[bin] > 0) {
+				if (right_size == 0) {
+					right_aabb = bin_aabb[bin];
+				} else {
+					right_aabb.merge_with(bin_aabb[bin]);
+				}
+				right_size += bin_size[bin];
+			}
+			right_cost[bin] = _volume_bvh_surface_area(right_aabb) * right_size;
+		}
+
+		AABB left_aabb;
+		int left_size = 0;
+		for (int bin = 0; bin < BIN_COUNT - 1; bin++) {
+			if (bin_size[bin] > 0) {
+				if (left_size == 0) {
+					left_aabb = bin_aabb[bin];
+				} else {
+					left_aabb.merge_with(bin_aabb[bin]);
+				}
+				left_size += bin_size[bin];
+			}
+			if (left_size == 0 || left_size == p_size) {
+				continue;
+			}
+			const real_t cost = _volume_bvh_surface_area(left_aabb) * left_size + right_cost[bin + 1];
+			if (best_axis < 0 || cost < best_cost) {
+				best_axis = axis;
+				best_bin = bin;
+				best_cost = cost;
+			}
+		}
 	}
 
-	AABB aabb;
+	if (best_axis < 0) {
+		return 0;
+	}
+
+	const real_t bin_scale = BIN_COUNT / p_centers.size[best_axis];
+	int split = 0;
 	for (int i = 0; i < p_size; i++) {
-		if (i == 0) {
-			aabb = p_elements[i].aabb;
-		} else {
-			aabb.merge_with(p_elements[i].aabb);
+		const int bin = CLAMP(int((p_elements[i].center[best_axis] - p_centers.position[best_axis]) * bin_scale), 0, BIN_COUNT - 1);
+		if (bin <= best_bin) {
+			SWAP(p_elements[i], p_elements[split]);
+			split++;
 		}
 	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
-		case 0: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
+	return split;
+}
 
-		} break;
-		case 1: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
-		} break;
-		case 2: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
-		} break;
-	}
+// Builds a binary tree with a face in each leaf, root first.
+static void _volume_build_bvh(_Volume_BVH_Element *p_elements, int p_size, LocalVector<_Volume_BVH> &r_bvh) {
+	struct Range {
+		int node = 0;
+		int begin = 0;
+		int end = 0;
+		int depth = 0;
+	};
+	LocalVector<Range> stack;
 
-	int split = p_size / 2;
-	bvh->left = _volume_build_bvh(p_elements, split, count);
-	bvh->right = _volume_build_bvh(&p_elements[split], p_size - split, count);
+	r_bvh.push_back(_Volume_BVH());
+	stack.push_back({ 0, 0, p_size, 0 });
 
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
-}
+	while (stack.size()) {
+		const Range range = stack[stack.size() - 1];
+		stack.resize(stack.size() - 1);
 
-void GodotConcavePolygonShape3D::_fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
-	int idx = p_idx;
+		_Volume_BVH_Element *elements = &p_elements[range.begin];
+		const int size = range.end - range.begin;
 
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
+		AABB aabb = elements[0].aabb;
+		AABB centers(elements[0].center, Vector3());
+		for (int i = 1; i < size; i++) {
+			aabb.merge_with(elements[i].aabb);
+			centers.expand_to(elements[i].center);
+		}
+		r_bvh[range.node].aabb = aabb;
+		r_bvh[range.node].face_count = size;
 
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
+		if (size == 1) {
+			//leaf
+			r_bvh[range.node].face_index = elements[0].face_index;
+			continue;
+		}
 
-	} else {
-		p_bvh_array[p_idx].left = -1;
+		int split = 0;
+		if (range.depth < GodotConcavePolygonShape3D::BVH_SAH_MAX_DEPTH) {
+			split = _volume_bvh_sah_split(elements, size, centers);
+		}
+		if (split == 0) {
+			split = size / 2;
+			switch (centers.get_longest_axis_index()) {
+				case 0: {
+					SortArray<_Volume_BVH_Element, _Volume_BVH_CompareX> sort_x;
+					sort_x.nth_element(0, size, split, elements);
+				} break;
+				case 1: {
+					SortArray<_Volume_BVH_Element, _Volume_BVH_CompareY> sort_y;
+					sort_y.nth_element(0, size, split, elements);
+				} break;
+				case 2: {
+					SortArray<_Volume_BVH_Element, _Volume_BVH_CompareZ> sort_z;
+					sort_z.nth_element(0, size, split, elements);
+				} break;
+			}
+		}
+
+		const int left = r_bvh.size();
+		const int right = left + 1;
+		r_bvh.push_back(_Volume_BVH());
+		r_bvh.push_back(_Volume_BVH());
+		r_bvh[range.node].left = left;
+		r_bvh[range.node].right = right;
+
+		stack.push_back({ right, range.begin + split, range.end, range.depth + 1 });
+		stack.push_back({ left, range.begin, range.begin + split, range.depth + 1 });
 	}
+}
 
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
+// Quantizes p_child to the node, rounding outwards by enough to cover the rounding of the queries.
+static void _volume_bvh_quantize(GodotConcavePolygonShape3D::BVHNode &r_node, int p_child, const AABB &p_child_aabb, const real_t *p_slack) {
+	for (int i = 0; i < 3; i++) {
+		const float origin = r_node.origin[i];
+		const float scale = r_node.scale[i];
+		const real_t begin = p_child_aabb.position[i] - p_slack[i];
+		const real_t end = p_child_aabb.position[i] + p_child_aabb.size[i] + p_slack[i];
+
+		int quantized_min = 0;
+		int quantized_max = 0;
+		if (scale > 0) {
+			quantized_min = int(CLAMP(Math::floor((begin - origin) / scale), real_t(0), real_t(255)));
+			quantized_max = int(CLAMP(Math::ceil((end - origin) / scale), real_t(0), real_t(255)));
+		}
+		while (quantized_min > 0 && _concave_bvh_dequantize(origin, scale, quantized_min) > begin) {
+			quantized_min--;
+		}
+		while (quantized_max < 255 && _concave_bvh_dequantize(origin, scale, quantized_max) < end) {
+			quantized_max++;
+		}
 
-	} else {
-		p_bvh_array[p_idx].right = -1;
+		r_node.child_min[i][p_child] = quantized_min;
+		r_node.child_max[i][p_child] = quantized_max;
 	}
+}
 
-	memdelete(p_bvh_tree);
+void GodotConcavePolygonShape3D::_fill_bvh(const LocalVector<_Volume_BVH> &p_bvh_tree) {
+	struct Pending {
+		int tree_node = 0;
+		int node = 0;
+	};
+	LocalVector<Pending> stack;
+
+	bvh.clear();
+	bvh.push_back(BVHNode());
+	stack.push_back({ 0, 0 });
+
+	while (stack.size()) {
+		const Pending pending = stack[stack.size() - 1];
+		stack.resize(stack.size() - 1);
+
+		// Open up children of the binary tree until the node is full. Small subtrees that fit in the
+		// remaining slots come first so they don't need nodes of their own, then the largest ones.
+		const _Volume_BVH &tree_node = p_bvh_tree[pending.tree_node];
+		int children[BVH_NODE_WIDTH];
+		int child_count = 0;
+		if (tree_node.face_index >= 0) {
+			children[child_count++] = pending.tree_node;
+		} else {
+			children[child_count++] = tree_node.left;
+			children[child_count++] = tree_node.right;
+		}
+		while (child_count < BVH_NODE_WIDTH) {
+			int fitting = -1;
+			int largest = -1;
+			real_t largest_area = 0;
+			for (int i = 0; i < child_count; i++) {
+				const _Volume_BVH &child = p_bvh_tree[children[i]];
+				if (child.face_index >= 0) {
+					continue;
+				}
+				if (child.face_count <= BVH_NODE_WIDTH - child_count + 1 && (fitting < 0 || child.face_count < p_bvh_tree[children[fitting]].face_count)) {
+					fitting = i;
+				}
+				if (largest < 0 || _volume_bvh_surface_area(child.aabb) > largest_area) {
+					largest = i;
+					largest_area = _volume_bvh_surface_area(child.aabb);
+				}
+			}
+			const int open = fitting >= 0 ? fitting : largest;
+			if (open < 0) {
+				break;
+			}
+			const _Volume_BVH &child = p_bvh_tree[children[open]];
+			children[open] = child.left;
+			children[child_count++] = child.right;
+		}
+
+		BVHNode node;
+		real_t slack[3];
+		for (int i = 0; i < 3; i++) {
+			const real_t begin = tree_node.aabb.position[i];
+			const real_t end = begin + tree_node.aabb.size[i];
+			// A few float steps at this magnitude, for when a multiply and add get fused.
+			slack[i] = (Math::abs(begin) + Math::abs(end)) * 1e-6;
+			node.origin[i] = begin - slack[i] * 2;
+			node.scale[i] = (end + slack[i] * 2 - node.origin[i]) / 255;
+		}
+
+		for (int i = 0; i < BVH_NODE_WIDTH; i++) {
+			if (i >= child_count) {
+				node.children[i] = BVH_EMPTY_CHILD;
+				continue;
+			}
+			const _Volume_BVH &child = p_bvh_tree[children[i]];
+			_volume_bvh_quantize(node, i, child.aabb, slack);
+			if (child.face_index >= 0) {
+				node.children[i] = ~child.face_index;
+			} else {
+				node.children[i] = bvh.size();
+				stack.push_back({ children[i], int(bvh.size()) });
+				bvh.push_back(BVHNode());
+			}
+		}
+
+		bvh[pending.node] = node;
+	}
 }
 
 void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_backface_collision) {
@@ -1620,10 +1984,10 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 
 	const Vector3 *facesr = p_faces.ptr();
 
-	Vector<_Volume_BVH_Element> bvh_array;
+	LocalVector<_Volume_BVH_Element> bvh_array;
 	bvh_array.resize(src_face_count);
 
-	_Volume_BVH_Element *bvh_arrayw = bvh_array.ptrw();
+	_Volume_BVH_Element *bvh_arrayw = bvh_array.ptr();
 
 	faces.resize(src_face_count);
 	Face *facesw = faces.ptrw();
@@ -1654,15 +2018,9 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 		}
 	}
 
-	int count = 0;
-	_Volume_BVH *bvh_tree = _volume_build_bvh(bvh_arrayw, src_face_count, count);
-
-	bvh.resize(count + 1);
-
-	BVH *bvh_arrayw2 = bvh.ptrw();
-
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+	LocalVector<_Volume_BVH> bvh_tree;
+	_volume_build_bvh(bvh_arrayw, src_face_count, bvh_tree);
+	_fill_bvh(bvh_tree);
 
 	backface_collision = p_backface_collision;
 
@@ -316,15 +316,26 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 	Vector<Face> faces;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		int left = 0;
-		int right = 0;
+	enum {
+		BVH_NODE_WIDTH = 4,
+		BVH_EMPTY_CHILD = INT32_MIN,
+		// Past this depth the build splits at the median, so trees stay shallow enough for BVH_STACK_SIZE.
+		BVH_SAH_MAX_DEPTH = 48,
+		BVH_STACK_SIZE = 256,
+	};
 
-		int face_index = 0;
+	// Four children per node, so a node fills a single cache line. The bounds of the children
+	// are quantized to 8 bits within the bounds of the node, rounded outwards.
+	struct BVHNode {
+		float origin[3] = {};
+		float scale[3] = {};
+		uint8_t child_min[3][BVH_NODE_WIDTH] = {};
+		uint8_t child_max[3][BVH_NODE_WIDTH] = {};
+		// Index of a node, ~face_index for a face, or BVH_EMPTY_CHILD.
+		int32_t children[BVH_NODE_WIDTH] = {};
 	};
 
-	Vector<BVH> bvh;
+	LocalVector<BVHNode> bvh;
 
 	struct _CullParams {
 		AABB aabb;
@@ -332,7 +343,7 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 		void *userdata = nullptr;
 		const Face *faces = nullptr;
 		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
+		const BVHNode *bvh = nullptr;
 		GodotFaceShape3D *face = nullptr;
 	};
 
@@ -340,9 +351,11 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 		Vector3 from;
 		Vector3 to;
 		Vector3 dir;
+		real_t inv_length = 0;
+		real_t max_t = 1;
 		const Face *faces = nullptr;
 		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
+		const BVHNode *bvh = nullptr;
 		GodotFaceShape3D *face = nullptr;
 
 		Vector3 result;
@@ -354,10 +367,10 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 
 	bool backface_collision = false;
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	bool _cull(int p_idx, _CullParams *p_params) const;
+	void _cull_segment(int p_face_index, _SegmentCullParams *p_params) const;
+	bool _cull(int p_face_index, _CullParams *p_params) const;
 
-	void _fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
+	void _fill_bvh(const LocalVector<_Volume_BVH> &p_bvh_tree);
 
 	void _setup(const Vector<Vector3> &p_faces, bool p_backface_collision);
 
@@ -915,7 +915,7 @@ void GodotSoftBody3D::add_velocity(const Vector3 &p_velocity) {
 	}
 }
 
-void GodotSoftBody3D::apply_forces(const LocalVector<GodotArea3D *> &p_wind_areas) {
+void GodotSoftBody3D::apply_forces(const LocalVectorInline<GodotArea3D *, 4> &p_wind_areas) {
 	if (nodes.is_empty()) {
 		return;
 	}
@@ -977,7 +977,7 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	bool gravity_done = false;
 	Vector3 gravity;
 
-	LocalVector<GodotArea3D *> wind_areas;
+	LocalVectorInline<GodotArea3D *, 4> wind_areas;
 
 	int ac = areas.size();
 	if (ac) {
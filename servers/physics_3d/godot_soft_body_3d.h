@@ -39,6 +39,7 @@
 #include "core/math/vector3.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/local_vector_inline.h"
 #include "core/templates/vset.h"
 
 class GodotConstraint3D;
@@ -229,7 +230,7 @@ private:
 
 	void add_velocity(const Vector3 &p_velocity);
 
-	void apply_forces(const LocalVector<GodotArea3D *> &p_wind_areas);
+	void apply_forces(const LocalVectorInline<GodotArea3D *, 4> &p_wind_areas);
 
 	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
 	void generate_bending_constraints(int p_distance);
@@ -34,10 +34,14 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
 
+#define INTERSECT_RAYS_PACKET_SIZE 16
+#define CAST_MOTION_BATCH_GRAIN 16
+
 _FORCE_INLINE_ static bool _can_collide_with(GodotCollisionObject3D *p_object, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (!(p_object->get_collision_layer() & p_collision_mask)) {
 		return false;
@@ -105,17 +109,14 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+// Finds the closest hit of the ray among the shapes culled for it.
+static bool _intersect_culled_ray(const PhysicsDirectSpaceState3D::RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D *const *p_objects, const int *p_shape_indices, int p_amount, PhysicsDirectSpaceState3D::RayResult &r_result) {
 	Vector3 begin, end;
 	Vector3 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -125,22 +126,22 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	const GodotCollisionObject3D *res_obj = nullptr;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(p_objects[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject3D *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_shape_indices[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -205,6 +206,43 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	return _intersect_culled_ray(p_parameters, p_parameters.from, p_parameters.to, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result);
+}
+
+void GodotPhysicsDirectSpaceState3D::intersect_rays_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided) {
+	ERR_FAIL_COND(space->locked);
+
+	// Rays next to each other in the batch are culled together, walking the broadphase once for each packet.
+	// They get their own cull results, as the ones of the space can't be shared between threads.
+	auto intersect_packets = [&](uint32_t p_packet_from, uint32_t p_packet_to) {
+		LocalVector<GodotCollisionObject3D *> objects[INTERSECT_RAYS_PACKET_SIZE];
+		LocalVector<int> shape_indices[INTERSECT_RAYS_PACKET_SIZE];
+
+		for (uint32_t packet = p_packet_from; packet < p_packet_to; packet++) {
+			const int first = packet * INTERSECT_RAYS_PACKET_SIZE;
+			const int count = MIN(p_count - first, INTERSECT_RAYS_PACKET_SIZE);
+
+			space->broadphase->cull_segments(p_from + first, p_to + first, count, objects, shape_indices, GodotSpace3D::INTERSECTION_QUERY_MAX);
+
+			for (int i = 0; i < count; i++) {
+				r_collided[first + i] = _intersect_culled_ray(p_parameters, p_from[first + i], p_to[first + i], objects[i].ptr(), shape_indices[i].ptr(), objects[i].size(), r_results[first + i]);
+			}
+		}
+	};
+
+	const uint32_t packet_count = (p_count + INTERSECT_RAYS_PACKET_SIZE - 1) / INTERSECT_RAYS_PACKET_SIZE;
+	if (packet_count > 1) {
+		WorkerThreadPool::get_singleton()->parallel_for(0, packet_count, 1, intersect_packets, true, SNAME("Physics3DIntersectRays"));
+	} else {
+		intersect_packets(0, packet_count);
+	}
+}
+
 int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
 	if (p_result_max <= 0) {
 		return 0;
@@ -260,55 +298,52 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
-	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, false);
-
-	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(AABB(aabb.position + p_parameters.motion, aabb.size)); //motion
+bool GodotPhysicsDirectSpaceState3D::_cast_motion(GodotShape3D *p_shape, const ShapeParameters &p_parameters, const Transform3D &p_transform, const Vector3 &p_motion, GodotCollisionObject3D **r_cull_objects, int *r_cull_shape_indices, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
+	AABB aabb = p_transform.xform(p_shape->get_aabb());
+	aabb = aabb.merge(AABB(aabb.position + p_motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_aabb(aabb, r_cull_objects, GodotSpace3D::INTERSECTION_QUERY_MAX, r_cull_shape_indices);
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
-	Transform3D xform_inv = p_parameters.transform.affine_inverse();
+	Transform3D xform_inv = p_transform.affine_inverse();
 	GodotMotionShape3D mshape;
-	mshape.shape = shape;
-	mshape.motion = xform_inv.basis.xform(p_parameters.motion);
+	mshape.shape = p_shape;
+	mshape.motion = xform_inv.basis.xform(p_motion);
 
 	bool best_first = true;
 
-	Vector3 motion_normal = p_parameters.motion.normalized();
+	Vector3 motion_normal = p_motion.normalized();
 
 	Vector3 closest_A, closest_B;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_objects[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject3D *col_obj = r_cull_objects[i];
+		int shape_idx = r_cull_shape_indices[i];
 
 		Vector3 point_A, point_B;
 		Vector3 sep_axis = motion_normal;
 
 		Transform3D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (GodotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (GodotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
 		sep_axis = motion_normal;
 
-		if (!GodotCollisionSolver3D::solve_distance(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (!GodotCollisionSolver3D::solve_distance(p_shape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
 			continue;
 		}
 
@@ -319,11 +354,11 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 		for (int j = 0; j < 8; j++) { //steps should be customizable..
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
-			mshape.motion = xform_inv.basis.xform(p_parameters.motion * fraction);
+			mshape.motion = xform_inv.basis.xform(p_motion * fraction);
 
 			Vector3 lA, lB;
 			Vector3 sep = motion_normal; //important optimization for this to work fast enough
-			bool collided = !GodotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
+			bool collided = !GodotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
 
 			if (collided) {
 				hi = fraction;
@@ -379,6 +414,39 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	return _cast_motion(shape, p_parameters, p_parameters.transform, p_parameters.motion, space->intersection_query_results, space->intersection_query_subindex_results, p_closest_safe, p_closest_unsafe, r_info);
+}
+
+bool GodotPhysicsDirectSpaceState3D::cast_motion_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	// Each thread culls to its own results, as the ones of the space can't be shared between threads.
+	auto cast_motions = [&](uint32_t p_from, uint32_t p_to) {
+		LocalVector<GodotCollisionObject3D *> objects;
+		objects.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+		LocalVector<int> shape_indices;
+		shape_indices.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+
+		for (uint32_t i = p_from; i < p_to; i++) {
+			const Transform3D transform(p_parameters.transform.basis, p_origins[i]);
+			_cast_motion(shape, p_parameters, transform, p_motions[i], objects.ptr(), shape_indices.ptr(), r_closest_safe[i], r_closest_unsafe[i], nullptr);
+		}
+	};
+
+	if (p_count > CAST_MOTION_BATCH_GRAIN) {
+		WorkerThreadPool::get_singleton()->parallel_for(0, p_count, CAST_MOTION_BATCH_GRAIN, cast_motions, true, SNAME("Physics3DCastMotions"));
+	} else {
+		cast_motions(0, p_count);
+	}
+
+	return true;
+}
+
 bool GodotPhysicsDirectSpaceState3D::collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) {
 	if (p_result_max <= 0) {
 		return false;
@@ -1061,7 +1129,7 @@ void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A
 			GodotBodySoftBodyPair3D *soft_pair = memnew(GodotBodySoftBodyPair3D(static_cast<GodotBody3D *>(A), p_subindex_A, static_cast<GodotSoftBody3D *>(B)));
 			return soft_pair;
 		} else {
-			GodotBodyPair3D *b = memnew(GodotBodyPair3D(static_cast<GodotBody3D *>(A), p_subindex_A, static_cast<GodotBody3D *>(B), p_subindex_B));
+			GodotBodyPair3D *b = self->body_pair_allocator.alloc(static_cast<GodotBody3D *>(A), p_subindex_A, static_cast<GodotBody3D *>(B), p_subindex_B);
 			return b;
 		}
 	} else {
@@ -1078,6 +1146,10 @@ void GodotSpace3D::_broadphase_unpair(GodotCollisionObject3D *A, int p_subindex_
 
 	GodotSpace3D *self = static_cast<GodotSpace3D *>(p_self);
 	self->collision_pairs--;
+	if (A->get_type() == GodotCollisionObject3D::TYPE_BODY && B->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+		self->body_pair_allocator.free(static_cast<GodotBodyPair3D *>(p_data));
+		return;
+	}
 	GodotConstraint3D *c = static_cast<GodotConstraint3D *>(p_data);
 	memdelete(c);
 }
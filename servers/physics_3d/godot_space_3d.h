@@ -41,18 +41,23 @@
 
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/paged_allocator.h"
 #include "core/typedefs.h"
 
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	bool _cast_motion(GodotShape3D *p_shape, const ShapeParameters &p_parameters, const Transform3D &p_transform, const Vector3 &p_motion, GodotCollisionObject3D **r_cull_objects, int *r_cull_shape_indices, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info);
+
 public:
 	GodotSpace3D *space = nullptr;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
+	virtual void intersect_rays_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) override;
+	virtual bool cast_motion_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
@@ -89,6 +94,9 @@ private:
 	static void *_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_data, void *p_self);
 
+	// Body pairs are created and destroyed whenever bodies start or stop overlapping.
+	PagedAllocator<GodotBodyPair3D> body_pair_allocator;
+
 	HashSet<GodotCollisionObject3D *> objects;
 
 	GodotArea3D *area = nullptr;
@@ -41,6 +41,13 @@
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
 
+// Islands with fewer constraints are solved in a single batch.
+#define ISLAND_BATCHING_MIN_CONSTRAINTS 256
+// Batches with fewer constraints aren't worth splitting between threads.
+#define ISLAND_BATCH_PARALLEL_MIN_CONSTRAINTS 32
+// Constraints that don't fit in the parallel batches go in a last one, solved serially.
+#define ISLAND_PARALLEL_BATCH_MAX 64
+
 void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
 
@@ -112,7 +119,7 @@ void GodotStep3D::_populate_island_soft_body(GodotSoftBody3D *p_soft_body, Local
 	}
 }
 
-void GodotStep3D::_setup_constraint(uint32_t p_constraint_index, void *p_userdata) {
+void GodotStep3D::_setup_constraint(uint32_t p_constraint_index) {
 	GodotConstraint3D *constraint = all_constraints[p_constraint_index];
 	constraint->setup(delta);
 }
@@ -130,29 +137,124 @@ void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constrai
 	p_constraint_island.resize(valid_constraint_count);
 }
 
-void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
+void GodotStep3D::_batch_island(LocalVector<GodotConstraint3D *> &p_constraint_island, LocalVector<uint32_t> &r_batch_ends) {
+	uint32_t constraint_count = p_constraint_island.size();
+
+	r_batch_ends.clear();
+	if (constraint_count < ISLAND_BATCHING_MIN_CONSTRAINTS) {
+		r_batch_ends.push_back(constraint_count);
+		return;
+	}
+
+	// Greedy coloring in island order, so the batches only depend on the island.
+	uint32_t batch_sizes[ISLAND_PARALLEL_BATCH_MAX + 1] = {};
+	uint32_t batch_count = 0;
+	body_batch_masks.clear();
+	constraint_batches.resize(constraint_count);
+
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		GodotConstraint3D *constraint = p_constraint_island[constraint_index];
+		GodotBody3D **bodies = constraint->get_body_ptr();
+		uint32_t batch = ISLAND_PARALLEL_BATCH_MAX;
+
+		// Soft bodies aren't tracked, and static or kinematic bodies aren't modified by solving.
+		if (constraint->get_soft_body_count() == 0) {
+			uint64_t used_batches = 0;
+			for (int i = 0; i < constraint->get_body_count(); i++) {
+				if (bodies[i]->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+					const uint64_t *mask = body_batch_masks.getptr(bodies[i]);
+					if (mask) {
+						used_batches |= *mask;
+					}
+				}
+			}
+
+			if (used_batches != UINT64_MAX) {
+				batch = 0;
+				while (used_batches & (uint64_t(1) << batch)) {
+					batch++;
+				}
+				batch_count = MAX(batch_count, batch + 1);
+
+				for (int i = 0; i < constraint->get_body_count(); i++) {
+					if (bodies[i]->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+						uint64_t *mask = body_batch_masks.getptr(bodies[i]);
+						if (mask) {
+							*mask |= uint64_t(1) << batch;
+						} else {
+							body_batch_masks.insert(bodies[i], uint64_t(1) << batch);
+						}
+					}
+				}
+			}
+		}
+
+		constraint_batches[constraint_index] = batch;
+		batch_sizes[batch]++;
+	}
+
+	// The last batch holds the constraints that didn't fit in any other.
+	batch_sizes[batch_count] = batch_sizes[ISLAND_PARALLEL_BATCH_MAX];
+
+	uint32_t batch_offsets[ISLAND_PARALLEL_BATCH_MAX + 1];
+	uint32_t offset = 0;
+	for (uint32_t batch = 0; batch <= batch_count; batch++) {
+		batch_offsets[batch] = offset;
+		offset += batch_sizes[batch];
+		r_batch_ends.push_back(offset);
+	}
+
+	// Keep the island order within each batch.
+	batched_constraints.resize(constraint_count);
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		uint32_t batch = MIN((uint32_t)constraint_batches[constraint_index], batch_count);
+		batched_constraints[batch_offsets[batch]++] = p_constraint_island[constraint_index];
+	}
+	memcpy(p_constraint_island.ptr(), batched_constraints.ptr(), constraint_count * sizeof(GodotConstraint3D *));
+}
+
+void GodotStep3D::_solve_island(uint32_t p_island_index) {
 	LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[p_island_index];
+	LocalVector<uint32_t> &batch_ends = constraint_island_batches[p_island_index];
+
+	auto solve_batch = [this, &constraint_island](uint32_t p_from, uint32_t p_to) {
+		for (uint32_t constraint_index = p_from; constraint_index < p_to; ++constraint_index) {
+			constraint_island[constraint_index]->solve(delta);
+		}
+	};
 
 	int current_priority = 1;
 
 	uint32_t constraint_count = constraint_island.size();
 	while (constraint_count > 0) {
 		for (int i = 0; i < iterations; i++) {
-			// Go through all iterations.
-			for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
-				constraint_island[constraint_index]->solve(delta);
+			// Go through all iterations, one batch after the other.
+			uint32_t batch_start = 0;
+			for (uint32_t batch = 0; batch < batch_ends.size(); batch++) {
+				uint32_t batch_end = batch_ends[batch];
+				if (batch + 1 < batch_ends.size() && batch_end - batch_start >= ISLAND_BATCH_PARALLEL_MIN_CONSTRAINTS) {
+					WorkerThreadPool::get_singleton()->parallel_for(batch_start, batch_end, 0, solve_batch, true, SNAME("Physics3DConstraintSolveBatch"));
+				} else {
+					solve_batch(batch_start, batch_end);
+				}
+				batch_start = batch_end;
 			}
 		}
 
 		// Check priority to keep only higher priority constraints.
 		uint32_t priority_constraint_count = 0;
 		++current_priority;
-		for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
-			GodotConstraint3D *constraint = constraint_island[constraint_index];
-			if (constraint->get_priority() >= current_priority) {
-				// Keep this constraint for the next iteration.
-				constraint_island[priority_constraint_count++] = constraint;
+		uint32_t batch_start = 0;
+		for (uint32_t &batch_end : batch_ends) {
+			for (uint32_t constraint_index = batch_start; constraint_index < batch_end; ++constraint_index) {
+				GodotConstraint3D *constraint = constraint_island[constraint_index];
+				if (constraint->get_priority() >= current_priority) {
+					// Keep this constraint for the next iteration.
+					constraint_island[priority_constraint_count++] = constraint;
+				}
 			}
+			batch_start = batch_end;
+			batch_end = priority_constraint_count;
 		}
 		constraint_count = priority_constraint_count;
 	}
@@ -344,8 +446,12 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
 	uint32_t total_constraint_count = all_constraints.size();
-	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics3DConstraintSetup"));
-	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	auto setup_constraints = [this](uint32_t p_from, uint32_t p_to) {
+		for (uint32_t i = p_from; i < p_to; i++) {
+			_setup_constraint(i);
+		}
+	};
+	WorkerThreadPool::get_singleton()->parallel_for(0, total_constraint_count, 0, setup_constraints, true, SNAME("Physics3DConstraintSetup"));
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -356,16 +462,26 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	/* PRE-SOLVE CONSTRAINT ISLANDS */
 
 	// Warning: This doesn't run on threads, because it involves thread-unsafe processing.
+	if (constraint_island_batches.size() < island_count) {
+		constraint_island_batches.resize(island_count);
+	}
 	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
 		_pre_solve_island(constraint_islands[island_index]);
+		// Large islands are split into batches that can be solved on several threads.
+		_batch_island(constraint_islands[island_index], constraint_island_batches[island_index]);
 	}
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	// Warning: _solve_island modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
-	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics3DConstraintSolveIslands"));
-	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	// Island sizes vary wildly, so they're handed out one at a time.
+	auto solve_islands = [this](uint32_t p_from, uint32_t p_to) {
+		for (uint32_t i = p_from; i < p_to; i++) {
+			_solve_island(i);
+		}
+	};
+	WorkerThreadPool::get_singleton()->parallel_for(0, island_count, 1, solve_islands, true, SNAME("Physics3DConstraintSolveIslands"));
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -33,6 +33,7 @@
 
 #include "godot_space_3d.h"
 
+#include "core/templates/hash_map.h"
 #include "core/templates/local_vector.h"
 
 class GodotStep3D {
@@ -45,11 +46,19 @@ class GodotStep3D {
 	LocalVector<LocalVector<GodotConstraint3D *>> constraint_islands;
 	LocalVector<GodotConstraint3D *> all_constraints;
 
+	// Where each batch of a constraint island ends. Constraints in the same batch don't share
+	// any rigid body so they can be solved concurrently, except for the last batch.
+	LocalVector<LocalVector<uint32_t>> constraint_island_batches;
+	HashMap<const GodotBody3D *, uint64_t> body_batch_masks;
+	LocalVector<uint8_t> constraint_batches;
+	LocalVector<GodotConstraint3D *> batched_constraints;
+
 	void _populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _populate_island_soft_body(GodotSoftBody3D *p_soft_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
-	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
+	void _setup_constraint(uint32_t p_constraint_index);
 	void _pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const;
-	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _batch_island(LocalVector<GodotConstraint3D *> &p_constraint_island, LocalVector<uint32_t> &r_batch_ends);
+	void _solve_island(uint32_t p_island_index);
 	void _check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const;
 
 public:
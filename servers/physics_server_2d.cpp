@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/typed_array.h"
 
 PhysicsServer2D *PhysicsServer2D::singleton = nullptr;
@@ -410,6 +411,102 @@ Vector<real_t> PhysicsDirectSpaceState2D::_cast_motion(const Ref<PhysicsShapeQue
 	return ret;
 }
 
+Dictionary PhysicsDirectSpaceState2D::_intersect_rays_batch(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const Vector<Vector2> &p_from, const Vector<Vector2> &p_to) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Dictionary(), "The arrays of ray starts and ends must have the same size.");
+
+	const int count = p_from.size();
+	LocalVector<RayResult> results;
+	results.resize(count);
+	LocalVector<bool> collided;
+	collided.resize(count);
+
+	intersect_rays_batch(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), count, results.ptr(), collided.ptr());
+
+	PackedByteArray collided_array;
+	collided_array.resize(count);
+	PackedVector2Array positions;
+	positions.resize(count);
+	PackedVector2Array normals;
+	normals.resize(count);
+	PackedInt64Array collider_ids;
+	collider_ids.resize(count);
+	PackedInt32Array shapes;
+	shapes.resize(count);
+
+	for (int i = 0; i < count; i++) {
+		collided_array.write[i] = collided[i];
+		if (collided[i]) {
+			positions.write[i] = results[i].position;
+			normals.write[i] = results[i].normal;
+			collider_ids.write[i] = (int64_t)results[i].collider_id;
+			shapes.write[i] = results[i].shape;
+		} else {
+			positions.write[i] = Vector2();
+			normals.write[i] = Vector2();
+			collider_ids.write[i] = 0;
+			shapes.write[i] = 0;
+		}
+	}
+
+	Dictionary d;
+	d["collided"] = collided_array;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+
+	return d;
+}
+
+Vector<real_t> PhysicsDirectSpaceState2D::_cast_motion_batch(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const Vector<Vector2> &p_origins, const Vector<Vector2> &p_motions) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Vector<real_t>());
+	ERR_FAIL_COND_V_MSG(p_origins.size() != p_motions.size(), Vector<real_t>(), "The arrays of origins and motions must have the same size.");
+
+	const int count = p_origins.size();
+	LocalVector<real_t> closest_safe;
+	closest_safe.resize(count);
+	LocalVector<real_t> closest_unsafe;
+	closest_unsafe.resize(count);
+
+	bool res = cast_motion_batch(p_shape_query->get_parameters(), p_origins.ptr(), p_motions.ptr(), count, closest_safe.ptr(), closest_unsafe.ptr());
+	if (!res) {
+		return Vector<real_t>();
+	}
+
+	Vector<real_t> ret;
+	ret.resize(count * 2);
+	for (int i = 0; i < count; i++) {
+		ret.write[i * 2 + 0] = closest_safe[i];
+		ret.write[i * 2 + 1] = closest_unsafe[i];
+	}
+	return ret;
+}
+
+void PhysicsDirectSpaceState2D::intersect_rays_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_collided) {
+	// Not every server can be queried from several threads, so by default the rays are cast one by one.
+	RayParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		r_collided[i] = intersect_ray(parameters, r_results[i]);
+	}
+}
+
+bool PhysicsDirectSpaceState2D::cast_motion_batch(const ShapeParameters &p_parameters, const Vector2 *p_origins, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform.set_origin(p_origins[i]);
+		parameters.motion = p_motions[i];
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+		if (!cast_motion(parameters, r_closest_safe[i], r_closest_unsafe[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
 TypedArray<Vector2> PhysicsDirectSpaceState2D::_collide_shape(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), TypedArray<Vector2>());
 
@@ -457,6 +554,8 @@ void PhysicsDirectSpaceState2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_ray", "parameters"), &PhysicsDirectSpaceState2D::_intersect_ray);
 	ClassDB::bind_method(D_METHOD("intersect_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState2D::_cast_motion);
+	ClassDB::bind_method(D_METHOD("intersect_rays_batch", "parameters", "from", "to"), &PhysicsDirectSpaceState2D::_intersect_rays_batch);
+	ClassDB::bind_method(D_METHOD("cast_motion_batch", "parameters", "origins", "motions"), &PhysicsDirectSpaceState2D::_cast_motion_batch);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState2D::_get_rest_info);
 }
@@ -51,7 +51,7 @@
 class PhysicsServer2DWrapMT : public PhysicsServer2D {
 	mutable PhysicsServer2D *physics_server_2d = nullptr;
 
-	mutable CommandQueueMT command_queue;
+	mutable CommandQueueMT command_queue = CommandQueueMT(true);
 
 	Thread::ID server_thread = Thread::UNASSIGNED_ID;
 	WorkerThreadPool::TaskID server_task_id = WorkerThreadPool::INVALID_TASK_ID;
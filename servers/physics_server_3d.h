@@ -127,6 +127,8 @@ private:
 	TypedArray<Dictionary> _intersect_point(const Ref<PhysicsPointQueryParameters3D> &p_point_query, int p_max_results = 32);
 	TypedArray<Dictionary> _intersect_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results = 32);
 	Vector<real_t> _cast_motion(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query);
+	Dictionary _intersect_rays_batch(const Ref<PhysicsRayQueryParameters3D> &p_ray_query, const Vector<Vector3> &p_from, const Vector<Vector3> &p_to);
+	Vector<real_t> _cast_motion_batch(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_motions);
 	TypedArray<Vector3> _collide_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query);
 
@@ -161,6 +163,10 @@ public:
 
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) = 0;
 
+	// Casts p_count rays that share p_parameters, except for their ends. r_collided[i] tells whether
+	// the ray from p_from[i] to p_to[i] hit something, in which case r_results[i] is set.
+	virtual void intersect_rays_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided);
+
 	struct ShapeResult {
 		RID rid;
 		ObjectID collider_id;
@@ -202,6 +208,9 @@ public:
 
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) = 0;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) = 0;
+	// Casts the shape of p_parameters p_count times, from p_origins[i] along p_motions[i] instead of
+	// from the origin of its transform along its motion.
+	virtual bool cast_motion_batch(const ShapeParameters &p_parameters, const Vector3 *p_origins, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe);
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) = 0;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) = 0;
 
@@ -50,7 +50,7 @@
 class PhysicsServer3DWrapMT : public PhysicsServer3D {
 	mutable PhysicsServer3D *physics_server_3d = nullptr;
 
-	mutable CommandQueueMT command_queue;
+	mutable CommandQueueMT command_queue = CommandQueueMT(true);
 
 	Thread::ID server_thread = Thread::UNASSIGNED_ID;
 	WorkerThreadPool::TaskID server_task_id = WorkerThreadPool::INVALID_TASK_ID;
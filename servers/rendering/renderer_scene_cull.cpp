@@ -2647,14 +2647,6 @@ void RendererSceneCull::render_camera(const Ref<RenderSceneBuffers> &p_render_bu
 #endif
 }
 
-void RendererSceneCull::_visibility_cull_threaded(uint32_t p_thread, VisibilityCullData *cull_data) {
-	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
-	uint32_t bin_from = p_thread * cull_data->cull_count / total_threads;
-	uint32_t bin_to = (p_thread + 1 == total_threads) ? cull_data->cull_count : ((p_thread + 1) * cull_data->cull_count / total_threads);
-
-	_visibility_cull(*cull_data, cull_data->cull_offset + bin_from, cull_data->cull_offset + bin_to);
-}
-
 void RendererSceneCull::_visibility_cull(const VisibilityCullData &cull_data, uint64_t p_from, uint64_t p_to) {
 	Scenario *scenario = cull_data.scenario;
 	for (unsigned int i = p_from; i < p_to; i++) {
@@ -2743,13 +2735,13 @@ bool RendererSceneCull::_visibility_parent_check(const CullData &p_cull_data, co
 	return ((parent_flags & InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK) == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE) || (parent_flags & InstanceData::FLAG_VISIBILITY_DEPENDENCY_FADE_CHILDREN);
 }
 
-void RendererSceneCull::_scene_cull_threaded(uint32_t p_thread, CullData *cull_data) {
-	uint32_t cull_total = cull_data->scenario->instance_data.size();
-	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
-	uint32_t cull_from = p_thread * cull_total / total_threads;
-	uint32_t cull_to = (p_thread + 1 == total_threads) ? cull_total : ((p_thread + 1) * cull_total / total_threads);
+void RendererSceneCull::_scene_cull_range(CullData &cull_data, uint32_t p_from, uint32_t p_to) {
+	// Ranges are processed one after the other on each thread, so results can be gathered per thread.
+	// The last result is for the thread that started the cull, if it's not a pool thread.
+	int thread_index = WorkerThreadPool::get_thread_index();
+	InstanceCullResult &cull_result = scene_cull_result_threads[thread_index >= 0 ? thread_index : scene_cull_result_threads.size() - 1];
 
-	_scene_cull(*cull_data, scene_cull_result_threads[p_thread], cull_from, cull_to);
+	_scene_cull(cull_data, cull_result, p_from, p_to);
 }
 
 void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cull_result, uint64_t p_from, uint64_t p_to) {
@@ -3064,8 +3056,10 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 			}
 
 			if (visibility_cull_data.cull_count > thread_cull_threshold) {
-				WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_visibility_cull_threaded, &visibility_cull_data, WorkerThreadPool::get_singleton()->get_thread_count(), -1, true, SNAME("VisibilityCullInstances"));
-				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+				auto visibility_cull = [this, &visibility_cull_data](uint32_t p_from, uint32_t p_to) {
+					_visibility_cull(visibility_cull_data, p_from, p_to);
+				};
+				WorkerThreadPool::get_singleton()->parallel_for(visibility_cull_data.cull_offset, visibility_cull_data.cull_offset + visibility_cull_data.cull_count, 0, visibility_cull, true, SNAME("VisibilityCullInstances"));
 			} else {
 				_visibility_cull(visibility_cull_data, visibility_cull_data.cull_offset, visibility_cull_data.cull_offset + visibility_cull_data.cull_count);
 			}
@@ -3171,8 +3165,10 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 				thread.clear();
 			}
 
-			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_scene_cull_threaded, &cull_data, scene_cull_result_threads.size(), -1, true, SNAME("RenderCullInstances"));
-			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+			auto scene_cull = [this, &cull_data](uint32_t p_from, uint32_t p_to) {
+				_scene_cull_range(cull_data, p_from, p_to);
+			};
+			WorkerThreadPool::get_singleton()->parallel_for(cull_from, cull_to, 0, scene_cull, true, SNAME("RenderCullInstances"));
 
 			for (InstanceCullResult &thread : scene_cull_result_threads) {
 				scene_cull_result.append_from(thread);
@@ -4255,7 +4251,7 @@ RendererSceneCull::RendererSceneCull() {
 	}
 
 	scene_cull_result.init(&rid_cull_page_pool, &geometry_instance_cull_page_pool, &instance_cull_page_pool);
-	scene_cull_result_threads.resize(WorkerThreadPool::get_singleton()->get_thread_count());
+	scene_cull_result_threads.resize(WorkerThreadPool::get_singleton()->get_thread_count() + 1); // Pool threads, plus the calling one.
 	for (InstanceCullResult &thread : scene_cull_result_threads) {
 		thread.init(&rid_cull_page_pool, &geometry_instance_cull_page_pool, &instance_cull_page_pool);
 	}
@@ -0,0 +1,148 @@
+/**************************************************************************/
+/*  test_bvh.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BVH_H
+#define TEST_BVH_H
+
+#include "core/math/bvh.h"
+#include "core/math/random_pcg.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBVH {
+
+struct PairingItem {
+	int id = 0;
+};
+
+template <typename T>
+class PairingTestFunction {
+public:
+	static bool user_pair_check(const T *p_a, const T *p_b) {
+		// Odd items only pair with each other, to check the filtering still applies.
+		return (p_a->id & 1) == 0 || (p_b->id & 1) == 1;
+	}
+};
+
+template <typename T>
+class PairingCullFunction {
+public:
+	static bool user_cull_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+typedef BVH_Manager<PairingItem, 2, true, 32, PairingTestFunction<PairingItem>, PairingCullFunction<PairingItem>> PairingBVH;
+
+struct PairingLog {
+	LocalVector<Vector3i> events;
+	int pairs = 0;
+
+	static void *pair(void *p_self, uint32_t, PairingItem *p_a, int, uint32_t, PairingItem *p_b, int) {
+		PairingLog *self = static_cast<PairingLog *>(p_self);
+		self->events.push_back(Vector3i(1, p_a->id, p_b->id));
+		self->pairs++;
+		return p_self;
+	}
+
+	static void unpair(void *p_self, uint32_t, PairingItem *p_a, int, uint32_t, PairingItem *p_b, int, void *p_data) {
+		PairingLog *self = static_cast<PairingLog *>(p_self);
+		CHECK(p_data == p_self);
+		self->events.push_back(Vector3i(0, p_a->id, p_b->id));
+		self->pairs--;
+	}
+};
+
+TEST_CASE("[BVH] Parallel pairing sends the same callbacks as serial pairing") {
+	const int item_count = 1000;
+
+	LocalVector<PairingItem> items;
+	items.resize(item_count);
+	for (int i = 0; i < item_count; i++) {
+		items[i].id = i;
+	}
+
+	PairingBVH bvhs[2];
+	PairingLog logs[2];
+	LocalVector<BVHHandle> handles[2];
+
+	for (int b = 0; b < 2; b++) {
+		bvhs[b].params_set_parallel_pairing(b == 1);
+		bvhs[b].set_pair_callback(PairingLog::pair, &logs[b]);
+		bvhs[b].set_unpair_callback(PairingLog::unpair, &logs[b]);
+	}
+
+	RandomPCG rng(1234);
+	for (int i = 0; i < item_count; i++) {
+		// Every fourth item is static, in the first tree which only pairs with the second.
+		bool is_static = (i & 3) == 0;
+		AABB aabb(Vector3(rng.randf(), rng.randf(), rng.randf()) * 25.0, Vector3(2, 2, 2));
+		for (int b = 0; b < 2; b++) {
+			handles[b].push_back(bvhs[b].create(&items[i], true, is_static ? 0 : 1, is_static ? 2 : 3, aabb));
+		}
+	}
+
+	for (int step = 0; step < 4; step++) {
+		for (int i = 0; i < item_count; i++) {
+			if ((i & 3) == 0) {
+				continue;
+			}
+			AABB aabb;
+			bvhs[0].item_get_AABB(handles[0][i], aabb);
+			aabb.position += Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5) * 6.0;
+			for (int b = 0; b < 2; b++) {
+				bvhs[b].move(handles[b][i], aabb);
+			}
+		}
+		for (int b = 0; b < 2; b++) {
+			bvhs[b].update();
+		}
+	}
+
+	CHECK_MESSAGE(logs[0].pairs > item_count, "The items should overlap enough to pair.");
+	CHECK(logs[0].pairs == logs[1].pairs);
+	REQUIRE(logs[0].events.size() == logs[1].events.size());
+	bool same_events = true;
+	for (uint32_t i = 0; i < logs[0].events.size(); i++) {
+		same_events = same_events && logs[0].events[i] == logs[1].events[i];
+	}
+	CHECK_MESSAGE(same_events, "Pairs should be made and broken in the same order.");
+
+	for (int b = 0; b < 2; b++) {
+		for (const BVHHandle &h : handles[b]) {
+			bvhs[b].erase(h);
+		}
+		CHECK(logs[b].pairs == 0);
+	}
+}
+
+} // namespace TestBVH
+
+#endif // TEST_BVH_H
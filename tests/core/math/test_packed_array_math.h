@@ -0,0 +1,238 @@
+/**************************************************************************/
+/*  test_packed_array_math.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PACKED_ARRAY_MATH_H
+#define TEST_PACKED_ARRAY_MATH_H
+
+#include "core/math/packed_array_math.h"
+#include "core/variant/variant.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPackedArrayMath {
+
+// Sizes that are not a multiple of the SIMD block size, so the remaining scalars are covered too.
+static const int64_t test_sizes[] = { 0, 1, 5, 17, 64, 101 };
+
+static PackedFloat32Array make_floats(int64_t p_size, float p_offset) {
+	PackedFloat32Array array;
+	array.resize(p_size);
+	for (int64_t i = 0; i < p_size; i++) {
+		array.write[i] = p_offset + float((i * 7) % 13) - 6.0f;
+	}
+	return array;
+}
+
+static PackedVector3Array make_vectors(int64_t p_size, real_t p_offset) {
+	PackedVector3Array array;
+	array.resize(p_size);
+	for (int64_t i = 0; i < p_size; i++) {
+		array.write[i] = Vector3(p_offset + (i % 5), p_offset - (i % 3), real_t(i % 7) * 0.5);
+	}
+	return array;
+}
+
+TEST_CASE("[PackedArrayMath] Operations with a value") {
+	for (int64_t size : test_sizes) {
+		const PackedFloat32Array source = make_floats(size, 0.5f);
+
+		PackedFloat32Array array = source;
+		const float value = 2.5f;
+		PackedArrayMath::add_value(array.ptrw(), size, &value, 1);
+		for (int64_t i = 0; i < size; i++) {
+			CHECK(array[i] == source[i] + value);
+		}
+
+		array = source;
+		const float multiplier = -1.5f;
+		PackedArrayMath::multiply_add_value(array.ptrw(), size, &multiplier, &value, 1);
+		for (int64_t i = 0; i < size; i++) {
+			CHECK(array[i] == source[i] * multiplier + value);
+		}
+
+		array = source;
+		const float low = -2.0f;
+		const float high = 3.0f;
+		PackedArrayMath::clamp(array.ptrw(), size, &low, &high, 1);
+		for (int64_t i = 0; i < size; i++) {
+			CHECK(array[i] == CLAMP(source[i], low, high));
+		}
+	}
+}
+
+TEST_CASE("[PackedArrayMath] Operations with a value repeated per component") {
+	for (int64_t size : test_sizes) {
+		const PackedVector3Array source = make_vectors(size, 1.0);
+		const Vector3 value(1.0, -2.0, 4.0);
+
+		PackedVector3Array array = source;
+		PackedArrayMath::multiply_value((real_t *)array.ptrw(), size * 3, value.coord, 3);
+		for (int64_t i = 0; i < size; i++) {
+			CHECK(array[i] == source[i] * value);
+		}
+
+		array = source;
+		const Vector3 low(0.0, -1.0, 1.0);
+		PackedArrayMath::clamp((real_t *)array.ptrw(), size * 3, low.coord, value.coord, 3);
+		for (int64_t i = 0; i < size; i++) {
+			CHECK(array[i] == source[i].clamp(low, value));
+		}
+	}
+}
+
+TEST_CASE("[PackedArrayMath] Operations with another buffer") {
+	for (int64_t size : test_sizes) {
+		const PackedFloat32Array source = make_floats(size, 0.5f);
+		const PackedFloat32Array other = make_floats(size, -1.0f);
+
+		PackedFloat32Array array = source;
+		PackedArrayMath::add(array.ptrw(), other.ptr(), size);
+		for (int64_t i = 0; i < size; i++) {
+			CHECK(array[i] == source[i] + other[i]);
+		}
+
+		array = source;
+		PackedArrayMath::multiply_add(array.ptrw(), other.ptr(), source.ptr(), size);
+		for (int64_t i = 0; i < size; i++) {
+			CHECK(array[i] == source[i] * other[i] + source[i]);
+		}
+
+		array = source;
+		PackedArrayMath::lerp(array.ptrw(), other.ptr(), 0.25f, size);
+		for (int64_t i = 0; i < size; i++) {
+			CHECK(array[i] == doctest::Approx(Math::lerp(source[i], other[i], 0.25f)));
+		}
+
+		float dot = 0.0f;
+		for (int64_t i = 0; i < size; i++) {
+			dot += source[i] * other[i];
+		}
+		// The values are small integers and halves, so the sum is exact in any order.
+		CHECK(PackedArrayMath::dot(source.ptr(), other.ptr(), size) == dot);
+	}
+}
+
+TEST_CASE("[PackedArrayMath] Reductions") {
+	for (int64_t size : test_sizes) {
+		const PackedVector3Array source = make_vectors(size, 2.0);
+		Vector3 sum;
+		Vector3 min = size ? source[0] : Vector3();
+		Vector3 max = min;
+		for (int64_t i = 0; i < size; i++) {
+			sum += source[i];
+			min = min.min(source[i]);
+			max = max.max(source[i]);
+		}
+
+		Vector3 result(-1.0, -1.0, -1.0);
+		PackedArrayMath::sum((const real_t *)source.ptr(), size * 3, result.coord, 3);
+		CHECK(result == sum);
+		result = Vector3();
+		PackedArrayMath::min((const real_t *)source.ptr(), size * 3, result.coord, 3);
+		CHECK(result == min);
+		result = Vector3();
+		PackedArrayMath::max((const real_t *)source.ptr(), size * 3, result.coord, 3);
+		CHECK(result == max);
+	}
+}
+
+TEST_CASE("[PackedArrayMath] Per-vector operations") {
+	const PackedVector3Array source = make_vectors(21, -1.0);
+	const Transform3D transform(Basis(Vector3(0.0, 1.0, 0.0), 0.5).scaled(Vector3(1.0, 2.0, 3.0)), Vector3(4.0, -5.0, 6.0));
+
+	PackedVector3Array array = source;
+	PackedArrayMath::transform(array.ptrw(), array.size(), transform);
+	for (int64_t i = 0; i < array.size(); i++) {
+		CHECK(array[i].is_equal_approx(transform.xform(source[i])));
+	}
+
+	array = source;
+	array.write[3] = Vector3();
+	PackedArrayMath::normalize(array.ptrw(), array.size());
+	Vector<real_t> lengths;
+	lengths.resize(array.size());
+	PackedArrayMath::lengths(source.ptr(), source.size(), lengths.ptrw());
+	for (int64_t i = 0; i < array.size(); i++) {
+		CHECK(array[i].is_equal_approx(i == 3 ? Vector3() : source[i].normalized()));
+		CHECK(lengths[i] == doctest::Approx(source[i].length()));
+	}
+
+	PackedVector2Array vectors_2d;
+	for (int64_t i = 0; i < 11; i++) {
+		vectors_2d.push_back(Vector2(real_t(i % 4) - 1.0, real_t(i % 3) * 0.5));
+	}
+	const Transform2D transform_2d(0.75, Size2(2.0, -1.0), 0.1, Vector2(3.0, 4.0));
+	PackedVector2Array array_2d = vectors_2d;
+	PackedArrayMath::transform(array_2d.ptrw(), array_2d.size(), transform_2d);
+	for (int64_t i = 0; i < array_2d.size(); i++) {
+		CHECK(array_2d[i].is_equal_approx(transform_2d.xform(vectors_2d[i])));
+	}
+
+	array_2d = vectors_2d;
+	PackedArrayMath::normalize(array_2d.ptrw(), array_2d.size());
+	for (int64_t i = 0; i < array_2d.size(); i++) {
+		CHECK(array_2d[i].is_equal_approx(vectors_2d[i].normalized()));
+	}
+}
+
+TEST_CASE("[PackedArrayMath] Bulk math methods on packed arrays") {
+	Variant floats = make_floats(10, 0.0f);
+	Callable::CallError ce;
+	Variant ret;
+	const Variant two = 2.0;
+	const Variant *args[] = { &two };
+	floats.callp("multiply_scalar", args, 1, ret, ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	// Packed arrays are modified in place.
+	CHECK(float(PackedFloat32Array(floats)[0]) == -12.0f);
+	CHECK(double(floats.call("max")) == 10.0);
+
+	Variant vectors = make_vectors(10, 0.0);
+	const Variant offset = Vector3(1.0, 2.0, 3.0);
+	args[0] = &offset;
+	vectors.callp("add_scalar", args, 1, ret, ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(PackedVector3Array(vectors)[1] == Vector3(2.0, 1.0, 3.5));
+	CHECK(PackedFloat32Array(vectors.call("lengths")).size() == 10);
+
+	Variant colors = PackedColorArray({ Color(0.5, 1.5, 0.25, 1.0), Color(1.0, -0.5, 0.5, 0.5) });
+	colors.call("clamp", Color(0, 0, 0, 0), Color(1, 1, 1, 1));
+	CHECK(Color(colors.call("sum")) == Color(1.5, 1.0, 0.75, 1.5));
+
+	ERR_PRINT_OFF;
+	Variant mismatched = make_floats(3, 0.0f);
+	floats.call("add_array", mismatched);
+	ERR_PRINT_ON;
+	CHECK(float(PackedFloat32Array(floats)[0]) == -12.0f);
+}
+
+} // namespace TestPackedArrayMath
+
+#endif // TEST_PACKED_ARRAY_MATH_H
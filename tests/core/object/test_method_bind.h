@@ -31,7 +31,9 @@
 #ifndef TEST_METHOD_BIND_H
 #define TEST_METHOD_BIND_H
 
+#include "core/object/callable_method_pointer.h"
 #include "core/object/class_db.h"
+#include "core/os/os.h"
 
 #include "tests/test_macros.h"
 
@@ -170,6 +172,138 @@ TEST_CASE("[MethodBind] check all method binds") {
 
 	memdelete(mbt);
 }
+
+static int64_t static_method_sum(int64_t p_a, int64_t p_b) {
+	return p_a + p_b;
+}
+
+TEST_CASE("[MethodBind] Callable ptrcall") {
+	MethodBindTester *mbt = memnew(MethodBindTester);
+
+	// Integers are passed as int64_t in the ptrcall encoding.
+	int64_t arg = 42;
+	const void *args[1] = { &arg };
+	int64_t ret = 0;
+	Callable::CallError ce;
+
+	SUBCASE("Standard callable to a native method") {
+		Callable(mbt, "test_methodr_args").ptrcall(args, 1, &ret, ce);
+		CHECK(ce.error == Callable::CallError::CALL_OK);
+		CHECK(ret == 42);
+
+		Callable(mbt, "test_methodr_args").ptrcall(args, 0, &ret, ce);
+		CHECK(ce.error == Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS);
+		CHECK(ce.expected == 1);
+
+		Callable(mbt, "does_not_exist").ptrcall(args, 1, &ret, ce);
+		CHECK(ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD);
+	}
+
+	SUBCASE("Method pointer callable") {
+		arg = 1234;
+		callable_mp(mbt, &MethodBindTester::test_methodr_args).ptrcall(args, 1, &ret, ce);
+		CHECK(ce.error == Callable::CallError::CALL_OK);
+		CHECK(ret == 1234);
+
+		mbt->test_num = 5678;
+		callable_mp(mbt, &MethodBindTester::test_methodrc).ptrcall(nullptr, 0, &ret, ce);
+		CHECK(ce.error == Callable::CallError::CALL_OK);
+		CHECK(ret == 5678);
+
+		callable_mp(mbt, &MethodBindTester::test_method_args).ptrcall(args, 2, nullptr, ce);
+		CHECK(ce.error == Callable::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS);
+
+		// The error of the previous call must not leak into the next one.
+		callable_mp(mbt, &MethodBindTester::test_methodr_args).ptrcall(args, 1, &ret, ce);
+		CHECK(ce.error == Callable::CallError::CALL_OK);
+	}
+
+	SUBCASE("Static method pointer callable") {
+		int64_t b = 8;
+		const void *sum_args[2] = { &arg, &b };
+		callable_mp_static(&static_method_sum).ptrcall(sum_args, 2, &ret, ce);
+		CHECK(ce.error == Callable::CallError::CALL_OK);
+		CHECK(ret == 50);
+	}
+
+	SUBCASE("Custom callable without ptrcall support") {
+		Callable bound = Callable(mbt, "test_methodr_args").bind(1);
+		bound.ptrcall(nullptr, 0, &ret, ce);
+		CHECK(ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD);
+	}
+
+	SUBCASE("Freed instance") {
+		Callable callable = Callable(mbt, "test_methodr_args");
+		memdelete(mbt);
+		mbt = nullptr;
+		callable.ptrcall(args, 1, &ret, ce);
+		CHECK(ce.error == Callable::CallError::CALL_ERROR_INSTANCE_IS_NULL);
+	}
+
+	if (mbt) {
+		memdelete(mbt);
+	}
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][MethodBind] Variant calls compared to ptrcalls") {
+	const int CALL_COUNT = 1 << 20;
+
+	MethodBindTester *mbt = memnew(MethodBindTester);
+	const Callable standard = Callable(mbt, "test_methodr_args");
+	const Callable method_pointer = callable_mp(mbt, &MethodBindTester::test_methodr_args);
+	const StringName method_name = "test_methodr_args";
+
+	auto report = [](const String &p_name, uint64_t p_begin, int64_t p_checksum) {
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - p_begin;
+		CHECK(p_checksum == int64_t(CALL_COUNT - 1) * CALL_COUNT / 2);
+		MESSAGE(p_name, ": ", double(CALL_COUNT) / elapsed, " million calls/s, ", double(elapsed) * 1000.0 / CALL_COUNT, " ns per call.");
+	};
+
+	{
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		int64_t checksum = 0;
+		for (int i = 0; i < CALL_COUNT; i++) {
+			Variant arg = i;
+			const Variant *args[1] = { &arg };
+			Callable::CallError ce;
+			checksum += int64_t(mbt->callp(method_name, args, 1, ce));
+		}
+		report("Object::callp()", begin, checksum);
+	}
+
+	const Callable *callables[2] = { &standard, &method_pointer };
+	const char *names[2] = { "standard", "method pointer" };
+	for (int c = 0; c < 2; c++) {
+		{
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			int64_t checksum = 0;
+			for (int i = 0; i < CALL_COUNT; i++) {
+				Variant arg = i;
+				const Variant *args[1] = { &arg };
+				Variant ret;
+				Callable::CallError ce;
+				callables[c]->callp(args, 1, ret, ce);
+				checksum += int64_t(ret);
+			}
+			report(String("Callable::callp(), ") + names[c], begin, checksum);
+		}
+		{
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			int64_t checksum = 0;
+			for (int i = 0; i < CALL_COUNT; i++) {
+				int64_t arg = i;
+				const void *args[1] = { &arg };
+				int64_t ret = 0;
+				Callable::CallError ce;
+				callables[c]->ptrcall(args, 1, &ret, ce);
+				checksum += ret;
+			}
+			report(String("Callable::ptrcall(), ") + names[c], begin, checksum);
+		}
+	}
+
+	memdelete(mbt);
+}
 } // namespace TestMethodBind
 
 #endif // TEST_METHOD_BIND_H
@@ -0,0 +1,205 @@
+/**************************************************************************/
+/*  test_frame_arena.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_FRAME_ARENA_H
+#define TEST_FRAME_ARENA_H
+
+#include "core/os/frame_arena.h"
+#include "core/templates/frame_arena_vector.h"
+#include "core/templates/list.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameArena {
+
+TEST_CASE("[FrameArena] Allocation and alignment") {
+	FrameArena arena(1024);
+
+	uint8_t *a = (uint8_t *)arena.alloc(3);
+	uint8_t *b = (uint8_t *)arena.alloc(5);
+	uint8_t *c = (uint8_t *)arena.alloc(8, 64);
+	REQUIRE(a != nullptr);
+	CHECK(((uintptr_t)a % FrameArena::DEFAULT_ALIGN) == 0);
+	CHECK(((uintptr_t)b % FrameArena::DEFAULT_ALIGN) == 0);
+	CHECK(((uintptr_t)c % 64) == 0);
+	CHECK(b >= a + 3);
+	CHECK(c >= b + 5);
+	CHECK(arena.get_chunk_count() == 1);
+
+	// Larger than a chunk.
+	uint8_t *large = (uint8_t *)arena.alloc(4000);
+	REQUIRE(large != nullptr);
+	memset(large, 0xAB, 4000);
+	CHECK(arena.get_chunk_count() == 2);
+	CHECK(arena.get_capacity() >= 1024 + 4000);
+}
+
+TEST_CASE("[FrameArena] Reset merges chunks") {
+	FrameArena arena(256);
+
+	for (int frame = 0; frame < 3; frame++) {
+		for (int i = 0; i < 64; i++) {
+			CHECK(arena.alloc(64) != nullptr);
+		}
+		arena.reset();
+		// A single chunk big enough for the whole frame is kept.
+		CHECK(arena.get_chunk_count() == 1);
+		CHECK(arena.get_capacity() >= 64 * 64);
+	}
+
+	size_t capacity = arena.get_capacity();
+	void *first = arena.alloc(64);
+	arena.reset();
+	CHECK(arena.alloc(64) == first);
+	CHECK(arena.get_capacity() == capacity);
+}
+
+TEST_CASE("[FrameArena] Scopes rewind the arena") {
+	FrameArena arena(1024);
+
+	void *outer = arena.alloc(16);
+	void *inner = nullptr;
+	{
+		FrameArena::Scope scope(&arena);
+		inner = arena.alloc(16);
+		CHECK(inner != outer);
+
+		// Resetting is deferred while a scope is open.
+		arena.reset();
+		CHECK(arena.alloc(16) != inner);
+	}
+	CHECK(arena.alloc(16) == inner);
+
+	void *top = arena.alloc(32);
+	arena.release(top, 32);
+	CHECK(arena.alloc(32) == top);
+}
+
+TEST_CASE("[FrameArena] Nested scopes keep chunks") {
+	FrameArena arena(256);
+
+	{
+		// Both scopes start at the beginning of the first chunk.
+		FrameArena::Scope outer(&arena);
+		{
+			FrameArena::Scope inner(&arena);
+			for (int i = 0; i < 64; i++) {
+				CHECK(arena.alloc(64) != nullptr);
+			}
+		}
+		// Closing the inner scope must not free the chunks the outer one points into.
+		uint32_t chunk_count = arena.get_chunk_count();
+		CHECK(chunk_count > 1);
+
+		uint8_t *block = (uint8_t *)arena.alloc(64);
+		memset(block, 0xAB, 64);
+		{
+			FrameArena::Scope inner(&arena);
+			for (int i = 0; i < 64; i++) {
+				CHECK(arena.alloc(64) != block);
+			}
+		}
+		CHECK(block[63] == 0xAB);
+		CHECK(arena.get_chunk_count() == chunk_count);
+	}
+
+	// Only a reset with no scope open merges them.
+	arena.reset();
+	CHECK(arena.get_chunk_count() == 1);
+	CHECK(arena.get_capacity() >= 64 * 64);
+}
+
+TEST_CASE("[FrameArena] Vector") {
+	FrameArena arena(256);
+	FrameArena::Scope scope(&arena);
+
+	FrameArenaVector<int> vector(&arena);
+	for (int i = 0; i < 1000; i++) {
+		vector.push_back(999 - i);
+	}
+	CHECK(vector.size() == 1000);
+	CHECK(vector[0] == 999);
+	CHECK(vector[999] == 0);
+
+	vector.sort();
+	bool sorted = true;
+	for (int i = 0; i < 1000; i++) {
+		sorted = sorted && vector[i] == i;
+	}
+	CHECK(sorted);
+
+	CHECK(vector.find(500) == 500);
+	vector.remove_at(0);
+	CHECK(vector[0] == 1);
+	CHECK(vector.erase(1));
+	CHECK(vector.size() == 998);
+
+	Vector<int> copy = vector;
+	CHECK(copy.size() == 998);
+	CHECK(copy[0] == 2);
+
+	FrameArenaVector<String> strings(&arena);
+	strings.push_back("a");
+	strings.resize(3);
+	strings[2] = "c";
+	CHECK(strings[0] == "a");
+	CHECK(strings[1].is_empty());
+	CHECK(strings[2] == "c");
+}
+
+TEST_CASE("[FrameArena] Vector grows in place") {
+	FrameArena arena(4096);
+	FrameArena::Scope scope(&arena);
+
+	FrameArenaVector<uint32_t> vector(&arena);
+	vector.reserve(4);
+	const uint32_t *data = vector.ptr();
+	for (uint32_t i = 0; i < 512; i++) {
+		vector.push_back(i);
+	}
+	CHECK(vector.ptr() == data);
+}
+
+TEST_CASE("[FrameArena] Allocator for node-based containers") {
+	FrameArena::Scope scope;
+
+	List<int, FrameArenaAllocator> list;
+	for (int i = 0; i < 100; i++) {
+		list.push_back(i);
+	}
+	list.erase(50);
+	CHECK(list.size() == 99);
+	CHECK(list.front()->get() == 0);
+	CHECK(list.back()->get() == 99);
+}
+
+} // namespace TestFrameArena
+
+#endif // TEST_FRAME_ARENA_H
@@ -0,0 +1,215 @@
+/**************************************************************************/
+/*  test_slab_allocator.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SLAB_ALLOCATOR_H
+#define TEST_SLAB_ALLOCATOR_H
+
+#include "core/os/os.h"
+#include "core/os/slab_allocator.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSlabAllocator {
+
+TEST_CASE("[SlabAllocator] Size classes") {
+	for (size_t size = 1; size <= SlabAllocator::MAX_BLOCK_SIZE; size++) {
+		uint32_t size_class = SlabAllocator::get_size_class(size);
+		REQUIRE(size_class < SlabAllocator::SIZE_CLASS_COUNT);
+		CHECK(SlabAllocator::get_size_class_block_size(size_class) >= size);
+		if (size_class > 0) {
+			// The smallest class that fits.
+			CHECK(SlabAllocator::get_size_class_block_size(size_class - 1) < size);
+		}
+	}
+	CHECK(SlabAllocator::get_size_class_block_size(SlabAllocator::SIZE_CLASS_COUNT - 1) == SlabAllocator::MAX_BLOCK_SIZE);
+}
+
+TEST_CASE("[SlabAllocator] Allocation and ownership") {
+	CHECK(SlabAllocator::alloc(SlabAllocator::MAX_BLOCK_SIZE + 1) == nullptr);
+
+	void *system = malloc(64);
+	CHECK_FALSE(SlabAllocator::owns(system));
+	free(system);
+
+	LocalVector<uint8_t *> blocks;
+	for (uint32_t i = 0; i < 4096; i++) {
+		size_t size = 1 + (i * 37) % SlabAllocator::MAX_BLOCK_SIZE;
+		uint8_t *block = (uint8_t *)SlabAllocator::alloc(size);
+		REQUIRE(block != nullptr);
+		CHECK(SlabAllocator::owns(block));
+		CHECK(SlabAllocator::get_block_size(block) >= size);
+		CHECK(((uintptr_t)block & 15) == 0);
+		memset(block, i & 0xFF, size);
+		blocks.push_back(block);
+	}
+
+	bool intact = true;
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		size_t size = 1 + (i * 37) % SlabAllocator::MAX_BLOCK_SIZE;
+		for (size_t j = 0; j < size; j++) {
+			intact = intact && blocks[i][j] == (i & 0xFF);
+		}
+		SlabAllocator::free(blocks[i]);
+	}
+	CHECK_MESSAGE(intact, "Live blocks should not overlap.");
+}
+
+TEST_CASE("[SlabAllocator] Reallocation") {
+	uint8_t *block = (uint8_t *)SlabAllocator::alloc(20);
+	REQUIRE(block != nullptr);
+	for (uint8_t i = 0; i < 20; i++) {
+		block[i] = i;
+	}
+
+	// Fits in the same size class.
+	CHECK(SlabAllocator::realloc(block, 32) == block);
+
+	block = (uint8_t *)SlabAllocator::realloc(block, 300);
+	REQUIRE(block != nullptr);
+	CHECK(SlabAllocator::get_block_size(block) >= 300);
+	bool preserved = true;
+	for (uint8_t i = 0; i < 20; i++) {
+		preserved = preserved && block[i] == i;
+	}
+	CHECK(preserved);
+
+	// Too large for a span, moves to the system allocator.
+	uint8_t *large = (uint8_t *)SlabAllocator::realloc(block, SlabAllocator::MAX_BLOCK_SIZE * 4);
+	REQUIRE(large != nullptr);
+	CHECK_FALSE(SlabAllocator::owns(large));
+	CHECK(large[19] == 19);
+	free(large);
+
+	block = (uint8_t *)SlabAllocator::alloc(64);
+	CHECK(SlabAllocator::realloc(block, 0) == nullptr);
+}
+
+struct RemoteFreeData {
+	LocalVector<void *> blocks;
+};
+
+void static_remote_free(void *p_userdata) {
+	RemoteFreeData *data = (RemoteFreeData *)p_userdata;
+	for (void *block : data->blocks) {
+		SlabAllocator::free(block);
+	}
+}
+
+TEST_CASE("[SlabAllocator] Blocks freed from other threads are reused") {
+	const uint32_t block_count = 1024;
+
+	SlabAllocator::Stats before = SlabAllocator::get_stats();
+
+	RemoteFreeData data;
+	for (uint32_t i = 0; i < block_count; i++) {
+		void *block = SlabAllocator::alloc(48);
+		REQUIRE(block != nullptr);
+		data.blocks.push_back(block);
+	}
+
+	Thread thread;
+	thread.start(static_remote_free, &data);
+	thread.wait_to_finish();
+
+	SlabAllocator::Stats after = SlabAllocator::get_stats();
+	CHECK(after.remote_frees - before.remote_frees == block_count);
+	CHECK(after.cache_hits > before.cache_hits);
+
+	// Keep allocating until the remotely freed blocks come back.
+	uint32_t reused = 0;
+	LocalVector<void *> blocks;
+	for (uint32_t i = 0; i < block_count * 4 && reused < block_count; i++) {
+		void *block = SlabAllocator::alloc(48);
+		REQUIRE(block != nullptr);
+		reused += data.blocks.has(block) ? 1 : 0;
+		blocks.push_back(block);
+	}
+	CHECK(reused == block_count);
+
+	for (void *block : blocks) {
+		SlabAllocator::free(block);
+	}
+}
+
+struct ChurnData {
+	bool use_slab = false;
+	uint32_t iterations = 0;
+	Thread thread;
+};
+
+void static_churn(void *p_userdata) {
+	ChurnData *data = (ChurnData *)p_userdata;
+	void *live[64] = {};
+	uint32_t seed = 12345;
+	for (uint32_t i = 0; i < data->iterations; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		uint32_t slot = seed >> 26;
+		size_t size = 16 + ((seed >> 8) & 0xFF);
+		if (live[slot]) {
+			data->use_slab ? SlabAllocator::free(live[slot]) : free(live[slot]);
+		}
+		live[slot] = data->use_slab ? SlabAllocator::alloc(size) : malloc(size);
+	}
+	for (void *block : live) {
+		if (block) {
+			data->use_slab ? SlabAllocator::free(block) : free(block);
+		}
+	}
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][SlabAllocator] Small allocation churn compared to malloc") {
+	const uint32_t iterations = 4000000;
+
+	for (uint32_t thread_count : { 1, 4, 16 }) {
+		for (bool use_slab : { false, true }) {
+			LocalVector<ChurnData> threads;
+			threads.resize(thread_count);
+
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (ChurnData &data : threads) {
+				data.use_slab = use_slab;
+				data.iterations = iterations;
+				data.thread.start(static_churn, &data);
+			}
+			for (ChurnData &data : threads) {
+				data.thread.wait_to_finish();
+			}
+			uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1u);
+
+			MESSAGE(thread_count, " thread(s), ", String(use_slab ? "slab allocator" : "malloc"), ": ", elapsed / 1000, " ms (", uint64_t(thread_count) * iterations * 1000 / elapsed, " allocations/ms).");
+		}
+	}
+}
+
+} // namespace TestSlabAllocator
+
+#endif // TEST_SLAB_ALLOCATOR_H
@@ -0,0 +1,160 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+#include "core/templates/safe_refcount.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const String name = "test_string_name_interning";
+	CHECK(StringName::search(name) == StringName());
+
+	StringName a = name;
+	StringName b = StringName(name.utf8().get_data());
+	StringName c = StringName(StaticCString::create("test_string_name_interning"));
+
+	CHECK(a == b);
+	CHECK(a == c);
+	CHECK(a.data_unique_pointer() == c.data_unique_pointer());
+	CHECK(a == name);
+	CHECK(StringName::search(name) == a);
+	CHECK(StringName::search(U"test_string_name_interning") == a);
+	CHECK(StringName(name) != StringName("test_string_name_other"));
+}
+
+TEST_CASE("[StringName] Release and recreate") {
+	const String name = "test_string_name_release";
+	{
+		StringName a = name;
+		StringName b = a;
+		CHECK(StringName::search(name) == a);
+	}
+	// The last reference is gone, so the name is no longer interned.
+	CHECK(StringName::search(name) == StringName());
+
+	StringName c = name;
+	CHECK(c == name);
+	CHECK(StringName::search(name) == c);
+}
+
+struct StringNameStressData {
+	static const int NAME_COUNT = 512;
+
+	Vector<String> names;
+	int iterations = 0;
+	SafeNumeric<uint32_t> mismatches;
+
+	static void thread_func(void *p_userdata) {
+		StringNameStressData *data = static_cast<StringNameStressData *>(p_userdata);
+		uint32_t seed = uint32_t(Thread::get_caller_id());
+		for (int i = 0; i < data->iterations; i++) {
+			seed = seed * 1664525u + 1013904223u;
+			const String &name = data->names[(seed >> 8) % NAME_COUNT];
+
+			// Mix short-lived names, which are created and released constantly,
+			// with names held across several lookups.
+			StringName held = name;
+			StringName copy = StringName(name);
+			if (held != copy || held != name || StringName::search(name) != held) {
+				data->mismatches.increment();
+			}
+		}
+	}
+};
+
+TEST_CASE("[StringName] Concurrent creation and release") {
+	const int THREAD_COUNT = 8;
+
+	StringNameStressData data;
+	data.iterations = 20000;
+	for (int i = 0; i < StringNameStressData::NAME_COUNT; i++) {
+		data.names.push_back("stress_name_" + itos(i));
+	}
+
+	Thread threads[THREAD_COUNT];
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].start(&StringNameStressData::thread_func, &data);
+	}
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	CHECK(data.mismatches.get() == 0);
+	for (int i = 0; i < StringNameStressData::NAME_COUNT; i++) {
+		CHECK(StringName::search(data.names[i]) == StringName());
+	}
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][StringName] Concurrent creation from several threads") {
+	const int TOTAL_ITERATIONS = 1 << 21;
+	const int thread_counts[] = { 1, 4, 16 };
+
+	StringNameStressData data;
+	for (int i = 0; i < StringNameStressData::NAME_COUNT; i++) {
+		data.names.push_back("benchmark_name_" + itos(i));
+	}
+
+	// Keep half of the names alive, so both the lookup and the create/release paths are exercised.
+	Vector<StringName> kept;
+	for (int i = 0; i < StringNameStressData::NAME_COUNT; i += 2) {
+		kept.push_back(data.names[i]);
+	}
+
+	for (int thread_count : thread_counts) {
+		data.iterations = TOTAL_ITERATIONS / thread_count;
+		Thread *threads = memnew_arr(Thread, thread_count);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].start(&StringNameStressData::thread_func, &data);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].wait_to_finish();
+		}
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		memdelete_arr(threads);
+
+		CHECK(data.mismatches.get() == 0);
+		MESSAGE(thread_count, " thread(s): ", elapsed / 1000.0, " ms, ", double(elapsed) * 1000.0 / (data.iterations * thread_count), " ns per iteration.");
+	}
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
@@ -446,6 +446,391 @@ TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
+
+class MultiProducerState {
+public:
+	CommandQueueMT command_queue;
+
+	// Only touched by the consumer.
+	LocalVector<uint32_t> log;
+	uint32_t command_count = 0;
+
+	Thread consumer_thread;
+	WorkerThreadPool::TaskID pump_task_id = WorkerThreadPool::INVALID_TASK_ID;
+	SafeFlag exit_consumer;
+
+	struct Big {
+		uint8_t data[20000] = {}; // Larger than a staging block.
+	};
+
+	void record(uint32_t p_value) {
+		log.push_back(p_value);
+		command_count++;
+	}
+	uint32_t record_ret(uint32_t p_value) {
+		record(p_value);
+		return p_value * 2;
+	}
+	void record_big(uint32_t p_value, Big p_big) {
+		record(p_value + p_big.data[0]);
+	}
+	void count() {
+		command_count++;
+	}
+
+	void consumer_loop() {
+		while (!exit_consumer.is_set()) {
+			command_queue.flush_all();
+		}
+		command_queue.flush_all();
+	}
+	static void static_consumer_loop(void *p_state) {
+		static_cast<MultiProducerState *>(p_state)->consumer_loop();
+	}
+
+	// Like the servers, only flushes when notified of new commands.
+	void pump_loop() {
+		while (!exit_consumer.is_set()) {
+			WorkerThreadPool::get_singleton()->yield();
+			command_queue.flush_all();
+		}
+	}
+	static void static_pump_loop(void *p_state) {
+		static_cast<MultiProducerState *>(p_state)->pump_loop();
+	}
+
+	void start_pump() {
+		pump_task_id = WorkerThreadPool::get_singleton()->add_native_task(&MultiProducerState::static_pump_loop, this, true);
+		command_queue.set_pump_task_id(pump_task_id);
+	}
+	void finish_pump() {
+		exit_consumer.set();
+		command_queue.sync();
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(pump_task_id);
+	}
+
+	MultiProducerState(bool p_lock_free) :
+			command_queue(p_lock_free) {}
+};
+
+TEST_CASE("[CommandQueue] Lock-free mode keeps push order") {
+	const uint32_t PRODUCER_COUNT = 4;
+	const uint32_t COMMANDS_PER_PRODUCER = 2000;
+
+	struct ProducerData {
+		MultiProducerState *state = nullptr;
+		uint32_t index = 0;
+		uint32_t wrong_returns = 0;
+		Thread thread;
+	};
+
+	MultiProducerState state(true);
+	state.consumer_thread.start(&MultiProducerState::static_consumer_loop, &state);
+
+	auto produce = [](void *p_data) {
+		ProducerData *data = static_cast<ProducerData *>(p_data);
+		MultiProducerState::Big big;
+		for (uint32_t i = 0; i < COMMANDS_PER_PRODUCER; i++) {
+			uint32_t value = data->index * COMMANDS_PER_PRODUCER + i;
+			if (i % 100 == 0) {
+				uint32_t ret = 0;
+				data->state->command_queue.push_and_ret(data->state, &MultiProducerState::record_ret, value, &ret);
+				if (ret != value * 2) {
+					data->wrong_returns++;
+				}
+			} else if (i % 250 == 1) {
+				data->state->command_queue.push(data->state, &MultiProducerState::record_big, value, big);
+			} else {
+				data->state->command_queue.push(data->state, &MultiProducerState::record, value);
+			}
+		}
+	};
+
+	ProducerData producers[PRODUCER_COUNT];
+	for (uint32_t i = 0; i < PRODUCER_COUNT; i++) {
+		producers[i].state = &state;
+		producers[i].index = i;
+		producers[i].thread.start(produce, &producers[i]);
+	}
+	for (uint32_t i = 0; i < PRODUCER_COUNT; i++) {
+		producers[i].thread.wait_to_finish();
+		CHECK_MESSAGE(producers[i].wrong_returns == 0, "push_and_ret() should get the result of its own command.");
+	}
+
+	state.command_queue.sync();
+	state.exit_consumer.set();
+	state.consumer_thread.wait_to_finish();
+
+	REQUIRE(state.log.size() == PRODUCER_COUNT * COMMANDS_PER_PRODUCER);
+	uint32_t next_expected[PRODUCER_COUNT] = {};
+	uint32_t out_of_order = 0;
+	for (uint32_t value : state.log) {
+		uint32_t producer = value / COMMANDS_PER_PRODUCER;
+		if (value % COMMANDS_PER_PRODUCER != next_expected[producer]) {
+			out_of_order++;
+		}
+		next_expected[producer] = value % COMMANDS_PER_PRODUCER + 1;
+	}
+	CHECK_MESSAGE(out_of_order == 0, "Commands of each producer should run in push order.");
+}
+
+TEST_CASE("[CommandQueue] Lock-free mode orders commands across producers") {
+	const uint32_t ROUNDS = 500;
+
+	struct Handoff {
+		MultiProducerState *state = nullptr;
+		Semaphore first_pushed;
+		Semaphore second_pushed;
+	};
+
+	MultiProducerState state(true);
+	Handoff handoff;
+	handoff.state = &state;
+
+	// The second thread only pushes once the first one is done pushing, so
+	// its command has to run later even though it comes from another producer.
+	auto first = [](void *p_data) {
+		Handoff *handoff = static_cast<Handoff *>(p_data);
+		for (uint32_t i = 0; i < ROUNDS; i++) {
+			handoff->state->command_queue.push(handoff->state, &MultiProducerState::record, i * 2);
+			handoff->first_pushed.post();
+			handoff->second_pushed.wait();
+		}
+	};
+	auto second = [](void *p_data) {
+		Handoff *handoff = static_cast<Handoff *>(p_data);
+		for (uint32_t i = 0; i < ROUNDS; i++) {
+			handoff->first_pushed.wait();
+			handoff->state->command_queue.push(handoff->state, &MultiProducerState::record, i * 2 + 1);
+			handoff->second_pushed.post();
+		}
+	};
+
+	Thread first_thread;
+	Thread second_thread;
+	first_thread.start(first, &handoff);
+	second_thread.start(second, &handoff);
+	first_thread.wait_to_finish();
+	second_thread.wait_to_finish();
+
+	state.command_queue.flush_all();
+
+	REQUIRE(state.log.size() == ROUNDS * 2);
+	uint32_t out_of_order = 0;
+	for (uint32_t i = 0; i < state.log.size(); i++) {
+		if (state.log[i] != i) {
+			out_of_order++;
+		}
+	}
+	CHECK_MESSAGE(out_of_order == 0, "Commands should run in the order they were pushed.");
+}
+
+TEST_CASE("[CommandQueue] Lock-free flush_all() runs everything pushed before it") {
+	const uint32_t PRODUCER_COUNT = 4;
+	const uint32_t ROUNDS = 2000;
+
+	struct FlushState {
+		CommandQueueMT command_queue = CommandQueueMT(true);
+		std::atomic<uint32_t> marks[PRODUCER_COUNT] = {};
+		std::atomic<uint32_t> missed = 0;
+		SafeFlag exit_consumer;
+
+		void mark(uint32_t p_producer, uint32_t p_round) {
+			marks[p_producer].store(p_round, std::memory_order_relaxed);
+		}
+	};
+
+	struct ProducerData {
+		FlushState *state = nullptr;
+		uint32_t index = 0;
+		Thread thread;
+	};
+
+	FlushState state;
+
+	// Flushes concurrently with the producers, which also flush after each push.
+	auto consume = [](void *p_data) {
+		FlushState *state = static_cast<FlushState *>(p_data);
+		while (!state->exit_consumer.is_set()) {
+			state->command_queue.flush_all();
+		}
+	};
+	auto produce = [](void *p_data) {
+		ProducerData *data = static_cast<ProducerData *>(p_data);
+		for (uint32_t i = 1; i <= ROUNDS; i++) {
+			data->state->command_queue.push(data->state, &FlushState::mark, data->index, i);
+			data->state->command_queue.flush_all();
+			if (data->state->marks[data->index].load(std::memory_order_relaxed) != i) {
+				data->state->missed.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	Thread consumer_thread;
+	consumer_thread.start(consume, &state);
+	ProducerData producers[PRODUCER_COUNT];
+	for (uint32_t i = 0; i < PRODUCER_COUNT; i++) {
+		producers[i].state = &state;
+		producers[i].index = i;
+		producers[i].thread.start(produce, &producers[i]);
+	}
+	for (uint32_t i = 0; i < PRODUCER_COUNT; i++) {
+		producers[i].thread.wait_to_finish();
+	}
+	state.exit_consumer.set();
+	consumer_thread.wait_to_finish();
+
+	CHECK_MESSAGE(state.missed.load() == 0, "flush_all() should only return once the commands pushed before it have run.");
+}
+
+TEST_CASE("[CommandQueue] Lock-free batches") {
+	const uint32_t PRODUCER_COUNT = 4;
+	const uint32_t COMMANDS_PER_PRODUCER = 2000;
+
+	SUBCASE("Commands are only published when the batch ends") {
+		MultiProducerState state(true);
+		state.command_queue.begin_batch();
+		state.command_queue.push(&state, &MultiProducerState::record, 1u);
+		state.command_queue.begin_batch();
+		state.command_queue.push(&state, &MultiProducerState::record, 2u);
+		state.command_queue.end_batch();
+		state.command_queue.flush_all();
+		CHECK(state.command_count == 0);
+		state.command_queue.end_batch();
+		state.command_queue.flush_all();
+		REQUIRE(state.log.size() == 2);
+		CHECK(state.log[0] == 1);
+		CHECK(state.log[1] == 2);
+	}
+
+	SUBCASE("Batches keep push order") {
+		struct ProducerData {
+			MultiProducerState *state = nullptr;
+			uint32_t index = 0;
+			uint32_t wrong_returns = 0;
+			Thread thread;
+		};
+
+		MultiProducerState state(true);
+		state.start_pump();
+
+		// Batches span block boundaries and include commands waiting for their result.
+		auto produce = [](void *p_data) {
+			ProducerData *data = static_cast<ProducerData *>(p_data);
+			MultiProducerState::Big big;
+			for (uint32_t i = 0; i < COMMANDS_PER_PRODUCER; i++) {
+				uint32_t value = data->index * COMMANDS_PER_PRODUCER + i;
+				if (i % 50 == 0) {
+					data->state->command_queue.begin_batch();
+				}
+				if (i % 100 == 30) {
+					uint32_t ret = 0;
+					data->state->command_queue.push_and_ret(data->state, &MultiProducerState::record_ret, value, &ret);
+					if (ret != value * 2) {
+						data->wrong_returns++;
+					}
+				} else if (i % 250 == 1) {
+					data->state->command_queue.push(data->state, &MultiProducerState::record_big, value, big);
+				} else {
+					data->state->command_queue.push(data->state, &MultiProducerState::record, value);
+				}
+				if (i % 50 == 49) {
+					data->state->command_queue.end_batch();
+				}
+			}
+		};
+
+		ProducerData producers[PRODUCER_COUNT];
+		for (uint32_t i = 0; i < PRODUCER_COUNT; i++) {
+			producers[i].state = &state;
+			producers[i].index = i;
+			producers[i].thread.start(produce, &producers[i]);
+		}
+		for (uint32_t i = 0; i < PRODUCER_COUNT; i++) {
+			producers[i].thread.wait_to_finish();
+			CHECK_MESSAGE(producers[i].wrong_returns == 0, "push_and_ret() should get the result of its own command.");
+		}
+		state.finish_pump();
+
+		REQUIRE(state.log.size() == PRODUCER_COUNT * COMMANDS_PER_PRODUCER);
+		uint32_t next_expected[PRODUCER_COUNT] = {};
+		uint32_t out_of_order = 0;
+		for (uint32_t value : state.log) {
+			uint32_t producer = value / COMMANDS_PER_PRODUCER;
+			if (value % COMMANDS_PER_PRODUCER != next_expected[producer]) {
+				out_of_order++;
+			}
+			next_expected[producer] = value % COMMANDS_PER_PRODUCER + 1;
+		}
+		CHECK_MESSAGE(out_of_order == 0, "Commands of each producer should run in push order.");
+	}
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][CommandQueue] Multiple producers") {
+	const uint32_t COMMAND_COUNT = 1 << 20;
+	const uint32_t BATCH_SIZE = 64;
+	const uint32_t producer_counts[] = { 1, 4, 16 };
+	const char *mode_names[] = { "Mutex", "Lock-free", "Lock-free batched", "Lock-free with pump", "Lock-free batched with pump" };
+
+	struct ProducerData {
+		MultiProducerState *state = nullptr;
+		uint32_t count = 0;
+		bool batched = false;
+		Thread thread;
+	};
+
+	auto produce = [](void *p_data) {
+		ProducerData *data = static_cast<ProducerData *>(p_data);
+		for (uint32_t i = 0; i < data->count; i++) {
+			if (data->batched && i % BATCH_SIZE == 0) {
+				data->state->command_queue.begin_batch();
+			}
+			data->state->command_queue.push(data->state, &MultiProducerState::count);
+			if (data->batched && (i % BATCH_SIZE == BATCH_SIZE - 1 || i == data->count - 1)) {
+				data->state->command_queue.end_batch();
+			}
+		}
+	};
+
+	for (uint32_t producer_count : producer_counts) {
+		for (int mode = 0; mode < 5; mode++) {
+			MultiProducerState *state = memnew(MultiProducerState(mode > 0));
+			// The pump only flushes when notified, like the servers do.
+			const bool pump = mode >= 3;
+
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			if (pump) {
+				state->start_pump();
+			} else {
+				state->consumer_thread.start(&MultiProducerState::static_consumer_loop, state);
+			}
+
+			ProducerData *producers = memnew_arr(ProducerData, producer_count);
+			for (uint32_t i = 0; i < producer_count; i++) {
+				producers[i].state = state;
+				producers[i].count = COMMAND_COUNT / producer_count;
+				producers[i].batched = mode == 2 || mode == 4;
+				producers[i].thread.start(produce, &producers[i]);
+			}
+			for (uint32_t i = 0; i < producer_count; i++) {
+				producers[i].thread.wait_to_finish();
+			}
+			if (pump) {
+				state->finish_pump();
+			} else {
+				state->exit_consumer.set();
+				state->consumer_thread.wait_to_finish();
+			}
+			uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+			CHECK(state->command_count == COMMAND_COUNT / producer_count * producer_count);
+			MESSAGE(String(mode_names[mode]), " mode, ", producer_count, " producer(s): ", elapsed / 1000.0, " ms, ", double(elapsed) * 1000.0 / COMMAND_COUNT, " ns per command.");
+
+			memdelete_arr(producers);
+			memdelete(state);
+		}
+	}
+}
 } // namespace TestCommandQueue
 
 #endif // TEST_COMMAND_QUEUE_H
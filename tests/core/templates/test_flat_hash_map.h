@@ -0,0 +1,267 @@
+/**************************************************************************/
+/*  test_flat_hash_map.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_FLAT_HASH_MAP_H
+#define TEST_FLAT_HASH_MAP_H
+
+#include "core/os/os.h"
+#include "core/string/string_name.h"
+#include "core/templates/flat_hash_map.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/oa_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFlatHashMap {
+
+TEST_CASE("[FlatHashMap] Insert element") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+}
+
+TEST_CASE("[FlatHashMap] Overwrite element") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[FlatHashMap] Erase via element") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+	map.remove(e);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[FlatHashMap] Erase via key") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	CHECK(map.erase(42));
+	CHECK(!map.erase(42));
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+}
+
+TEST_CASE("[FlatHashMap] Size") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 84);
+	map.insert(123, 84);
+	map.insert(0, 84);
+	map.insert(123485, 84);
+
+	CHECK(map.size() == 4);
+}
+
+TEST_CASE("[FlatHashMap] Iteration") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 12385);
+	map.insert(0, 12934);
+	map.insert(123485, 1238888);
+	map.insert(123, 111111);
+
+	// Iteration order is unspecified, so only check that every element is visited once.
+	HashMap<int, int> expected;
+	expected.insert(42, 84);
+	expected.insert(123, 111111);
+	expected.insert(0, 12934);
+	expected.insert(123485, 1238888);
+
+	int count = 0;
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(expected.has(E.key));
+		CHECK(expected[E.key] == E.value);
+		expected.erase(E.key);
+		count++;
+	}
+	CHECK(count == 4);
+	CHECK(expected.is_empty());
+
+	const FlatHashMap<int, int> const_map = map;
+	count = 0;
+	for (const KeyValue<int, int> &E : const_map) {
+		CHECK(map[E.key] == E.value);
+		count++;
+	}
+	CHECK(count == 4);
+}
+
+TEST_CASE("[FlatHashMap] Growth with interleaved inserts and erases") {
+	FlatHashMap<int, int> map;
+	HashMap<int, int> reference;
+
+	// Churn through many keys so that the table both grows and reuses deleted slots.
+	uint32_t seed = 12345;
+	for (int i = 0; i < 20000; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		int key = (seed >> 8) % 4096;
+		if ((seed & 3) == 0) {
+			CHECK(map.erase(key) == reference.erase(key));
+		} else {
+			map[key] = i;
+			reference[key] = i;
+		}
+	}
+
+	CHECK(map.size() == reference.size());
+	CHECK(map.get_capacity() >= map.size());
+	for (const KeyValue<int, int> &E : reference) {
+		const int *value = map.getptr(E.key);
+		REQUIRE(value != nullptr);
+		CHECK(*value == E.value);
+	}
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(reference.has(E.key));
+	}
+
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(map.begin() == map.end());
+	CHECK(!map.has(0));
+}
+
+TEST_CASE("[FlatHashMap] Reserve") {
+	FlatHashMap<int, int> map;
+	map.reserve(1000);
+	uint32_t capacity = map.get_capacity();
+	CHECK(capacity >= 1000);
+
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i * 2);
+	}
+	CHECK(map.get_capacity() == capacity);
+	CHECK(map.size() == 1000);
+	CHECK(map[999] == 1998);
+}
+
+TEST_CASE("[FlatHashMap] Non-trivial keys and values") {
+	FlatHashMap<String, String> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(itos(i), "value" + itos(i));
+	}
+	for (int i = 0; i < 100; i += 2) {
+		map.erase(itos(i));
+	}
+
+	FlatHashMap<String, String> copy;
+	copy = map;
+	map.clear();
+
+	CHECK(copy.size() == 50);
+	CHECK(!copy.has("0"));
+	CHECK(copy.has("1"));
+	CHECK(copy["99"] == "value99");
+	CHECK(copy.get("51") == "value51");
+}
+
+template <typename TMap, typename TKey>
+static const int *benchmark_lookup(const TMap &p_map, const TKey &p_key) {
+	return p_map.getptr(p_key);
+}
+
+template <typename TKey>
+static const int *benchmark_lookup(const OAHashMap<TKey, int> &p_map, const TKey &p_key) {
+	return p_map.lookup_ptr(p_key);
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][FlatHashMap] Insertion and lookup compared to HashMap and OAHashMap") {
+	const int ELEMENT_COUNT = 1 << 16;
+	const int LOOKUP_ROUNDS = 16;
+
+	// The second half is never inserted and is used for missed lookups.
+	Vector<StringName> names;
+	names.resize(ELEMENT_COUNT * 2);
+	for (int i = 0; i < ELEMENT_COUNT * 2; i++) {
+		names.write[i] = StringName("name_" + itos(i));
+	}
+
+	auto run = [&](const char *p_name, auto &p_map, auto p_key) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < ELEMENT_COUNT; i++) {
+			p_map.insert(p_key(i), i);
+		}
+		uint64_t inserted = OS::get_singleton()->get_ticks_usec();
+
+		int64_t sum = 0;
+		for (int r = 0; r < LOOKUP_ROUNDS; r++) {
+			for (int i = 0; i < ELEMENT_COUNT; i++) {
+				// Half of the lookups miss.
+				const int *value = benchmark_lookup(p_map, p_key(i + (i & 1) * ELEMENT_COUNT));
+				if (value) {
+					sum += *value;
+				}
+			}
+		}
+		uint64_t looked_up = OS::get_singleton()->get_ticks_usec();
+
+		CHECK(sum > 0);
+		MESSAGE(String(p_name), ": insert ", double(inserted - begin) * 1000.0 / ELEMENT_COUNT, " ns, lookup ", double(looked_up - inserted) * 1000.0 / (ELEMENT_COUNT * LOOKUP_ROUNDS), " ns per element.");
+	};
+
+	auto int_key = [](int i) { return uint32_t(i) * 2654435761u; };
+	auto name_key = [&](int i) -> const StringName & { return names[i]; };
+
+	{
+		FlatHashMap<uint32_t, int> map;
+		run("FlatHashMap<uint32_t>", map, int_key);
+	}
+	{
+		HashMap<uint32_t, int> map;
+		run("HashMap<uint32_t>", map, int_key);
+	}
+	{
+		OAHashMap<uint32_t, int> map;
+		run("OAHashMap<uint32_t>", map, int_key);
+	}
+	{
+		FlatHashMap<StringName, int> map;
+		run("FlatHashMap<StringName>", map, name_key);
+	}
+	{
+		HashMap<StringName, int> map;
+		run("HashMap<StringName>", map, name_key);
+	}
+}
+
+} // namespace TestFlatHashMap
+
+#endif // TEST_FLAT_HASH_MAP_H
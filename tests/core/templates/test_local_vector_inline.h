@@ -0,0 +1,143 @@
+/**************************************************************************/
+/*  test_local_vector_inline.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_LOCAL_VECTOR_INLINE_H
+#define TEST_LOCAL_VECTOR_INLINE_H
+
+#include "core/templates/local_vector_inline.h"
+
+#include "tests/test_macros.h"
+
+namespace TestLocalVectorInline {
+
+TEST_CASE("[LocalVectorInline] Push back within and past the inline storage.") {
+	LocalVectorInline<int, 4> vector;
+	CHECK(vector.get_capacity() == 4);
+
+	for (int i = 0; i < 4; i++) {
+		vector.push_back(i);
+	}
+	CHECK(vector.is_using_inline_storage());
+	CHECK(vector.size() == 4);
+
+	for (int i = 4; i < 10; i++) {
+		vector.push_back(i);
+	}
+	CHECK_FALSE(vector.is_using_inline_storage());
+	CHECK(vector.size() == 10);
+	for (int i = 0; i < 10; i++) {
+		CHECK(vector[i] == i);
+	}
+
+	vector.reset();
+	CHECK(vector.is_using_inline_storage());
+	CHECK(vector.is_empty());
+	CHECK(vector.get_capacity() == 4);
+}
+
+TEST_CASE("[LocalVectorInline] Remove, insert and find.") {
+	LocalVectorInline<int, 4> vector{ 3, 1, 4, 0, 2 };
+	CHECK(vector.size() == 5);
+
+	CHECK(vector.find(0) == 3);
+	CHECK(vector.has(4));
+	CHECK_FALSE(vector.has(5));
+
+	vector.remove_at(0);
+	CHECK(vector.size() == 4);
+	CHECK(vector[0] == 1);
+	CHECK(vector[3] == 2);
+
+	vector.remove_at_unordered(0);
+	CHECK(vector[0] == 2);
+
+	vector.insert(1, 7);
+	CHECK(vector[1] == 7);
+	CHECK(vector.erase(7));
+	CHECK_FALSE(vector.erase(7));
+
+	vector.sort();
+	CHECK(vector[0] == 0);
+	CHECK(vector[1] == 2);
+	CHECK(vector[2] == 4);
+
+	int sum = 0;
+	for (int value : vector) {
+		sum += value;
+	}
+	CHECK(sum == 6);
+}
+
+TEST_CASE("[LocalVectorInline] Copy and non-trivial types.") {
+	LocalVectorInline<String, 2> vector;
+	vector.push_back("a");
+	vector.push_back("b");
+
+	LocalVectorInline<String, 2> inline_copy = vector;
+	CHECK(inline_copy.is_using_inline_storage());
+	CHECK(inline_copy[1] == "b");
+
+	vector.push_back("c");
+	LocalVectorInline<String, 2> heap_copy = vector;
+	CHECK_FALSE(heap_copy.is_using_inline_storage());
+	CHECK(heap_copy.size() == 3);
+	CHECK(heap_copy[2] == "c");
+
+	heap_copy = inline_copy;
+	CHECK(heap_copy.size() == 2);
+	CHECK(heap_copy[0] == "a");
+
+	Vector<String> converted = vector;
+	CHECK(converted.size() == 3);
+	CHECK(converted[2] == "c");
+
+	vector.resize(1);
+	CHECK(vector.size() == 1);
+	CHECK(vector[0] == "a");
+}
+
+TEST_CASE("[LocalVectorInline] Nested in a LocalVector.") {
+	// LocalVector moves elements with memrealloc, which has to keep working.
+	LocalVector<LocalVectorInline<int, 2>> vectors;
+	for (int i = 0; i < 64; i++) {
+		vectors.push_back(LocalVectorInline<int, 2>());
+		for (int j = 0; j <= i % 4; j++) {
+			vectors[i].push_back(i + j);
+		}
+	}
+	for (int i = 0; i < 64; i++) {
+		CHECK(vectors[i].size() == uint32_t(i % 4 + 1));
+		CHECK(vectors[i][i % 4] == i + i % 4);
+	}
+}
+
+} // namespace TestLocalVectorInline
+
+#endif // TEST_LOCAL_VECTOR_INLINE_H
@@ -0,0 +1,142 @@
+/**************************************************************************/
+/*  test_work_stealing_deque.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_WORK_STEALING_DEQUE_H
+#define TEST_WORK_STEALING_DEQUE_H
+
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/work_stealing_deque.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkStealingDeque {
+
+TEST_CASE("[WorkStealingDeque] Owner pops LIFO, thieves steal FIFO") {
+	WorkStealingDeque<int, 8> deque;
+	CHECK(deque.is_empty());
+
+	for (int i = 0; i < 4; i++) {
+		CHECK(deque.push(i));
+	}
+	CHECK(deque.size() == 4);
+
+	int item = -1;
+	CHECK(deque.pop(item));
+	CHECK(item == 3);
+	CHECK(deque.steal(item));
+	CHECK(item == 0);
+	CHECK(deque.pop(item));
+	CHECK(item == 2);
+	CHECK(deque.steal(item));
+	CHECK(item == 1);
+
+	CHECK(deque.is_empty());
+	CHECK_FALSE(deque.pop(item));
+	CHECK_FALSE(deque.steal(item));
+}
+
+TEST_CASE("[WorkStealingDeque] Push fails when full") {
+	WorkStealingDeque<int, 4> deque;
+	for (int i = 0; i < 4; i++) {
+		CHECK(deque.push(i));
+	}
+	CHECK_FALSE(deque.push(4));
+	CHECK(deque.size() == deque.get_capacity());
+
+	int item = -1;
+	CHECK(deque.steal(item));
+	CHECK(deque.push(4)); // Wraps around the ring buffer.
+	for (int i = 4; i >= 1; i--) {
+		CHECK(deque.pop(item));
+		CHECK(item == i);
+	}
+}
+
+struct StealTestData {
+	WorkStealingDeque<uint32_t, 64> deque;
+	LocalVector<SafeNumeric<uint32_t>> seen;
+	SafeFlag done;
+};
+
+static void steal_thread(void *p_userdata) {
+	StealTestData *data = (StealTestData *)p_userdata;
+	uint32_t item = 0;
+	while (!data->done.is_set()) {
+		if (data->deque.steal(item)) {
+			data->seen[item].increment();
+		}
+	}
+	while (data->deque.steal(item)) {
+		data->seen[item].increment();
+	}
+}
+
+TEST_CASE("[WorkStealingDeque] Every item is taken exactly once under concurrent stealing") {
+	const uint32_t item_count = 100000;
+	StealTestData data;
+	data.seen.resize(item_count);
+
+	Thread thieves[3];
+	for (Thread &thief : thieves) {
+		thief.start(steal_thread, &data);
+	}
+
+	uint32_t next = 0;
+	uint32_t item = 0;
+	while (next < item_count) {
+		for (int i = 0; i < 7 && next < item_count && data.deque.push(next); i++) {
+			next++;
+		}
+		for (int i = 0; i < 3 && data.deque.pop(item); i++) {
+			data.seen[item].increment();
+		}
+	}
+	while (data.deque.pop(item)) {
+		data.seen[item].increment();
+	}
+
+	data.done.set();
+	for (Thread &thief : thieves) {
+		thief.wait_to_finish();
+	}
+
+	bool all_taken_once = true;
+	for (uint32_t i = 0; i < item_count; i++) {
+		// Reduce number of check messages.
+		all_taken_once &= data.seen[i].get() == 1;
+	}
+	CHECK(all_taken_once);
+}
+
+} // namespace TestWorkStealingDeque
+
+#endif // TEST_WORK_STEALING_DEQUE_H
@@ -0,0 +1,173 @@
+/**************************************************************************/
+/*  test_task_graph.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_TASK_GRAPH_H
+#define TEST_TASK_GRAPH_H
+
+#include "core/object/task_graph.h"
+
+#include "tests/test_macros.h"
+
+namespace TestTaskGraph {
+
+struct NodeData {
+	SafeNumeric<uint32_t> runs;
+	LocalVector<NodeData *> predecessors;
+	SafeFlag ran_too_early;
+	SafeNumeric<uint32_t> *sequence = nullptr;
+	uint32_t order = 0;
+};
+
+static void static_node(void *p_arg) {
+	NodeData *data = (NodeData *)p_arg;
+	uint32_t run = data->runs.get() + 1;
+	for (NodeData *predecessor : data->predecessors) {
+		// Predecessors must be done with the same run before this one starts it.
+		if (predecessor->runs.get() < run) {
+			data->ran_too_early.set();
+		}
+	}
+	if (data->sequence) {
+		data->order = data->sequence->increment();
+	}
+	data->runs.increment();
+}
+
+TEST_CASE("[TaskGraph] Tasks run after their predecessors") {
+	// Diamond: a -> (b, c) -> d.
+	NodeData data[4];
+	SafeNumeric<uint32_t> sequence;
+	for (NodeData &E : data) {
+		E.sequence = &sequence;
+	}
+
+	TaskGraph graph;
+	TaskGraph::NodeID a = graph.add_native_task(static_node, &data[0]);
+	TaskGraph::NodeID b = graph.add_native_continuation(a, static_node, &data[1]);
+	TaskGraph::NodeID c = graph.add_native_continuation(a, static_node, &data[2]);
+	TaskGraph::NodeID d = graph.add_native_task(static_node, &data[3]);
+	graph.add_dependency(d, b);
+	graph.add_dependency(d, c);
+	data[1].predecessors.push_back(&data[0]);
+	data[2].predecessors.push_back(&data[0]);
+	data[3].predecessors.push_back(&data[1]);
+	data[3].predecessors.push_back(&data[2]);
+	CHECK(graph.get_task_count() == 4);
+
+	TaskGraph::RunID run = graph.submit();
+	REQUIRE(run != TaskGraph::INVALID_RUN_ID);
+	graph.wait(run);
+
+	for (NodeData &E : data) {
+		CHECK(E.runs.get() == 1);
+		CHECK_FALSE(E.ran_too_early.is_set());
+	}
+	CHECK(data[0].order == 1);
+	CHECK(data[3].order == 4);
+}
+
+TEST_CASE("[TaskGraph] Resubmit, waiting for each run") {
+	const uint32_t node_count = 32;
+	NodeData data[node_count];
+
+	// Each node depends on the two previous ones.
+	TaskGraph graph;
+	for (uint32_t i = 0; i < node_count; i++) {
+		graph.add_native_task(static_node, &data[i]);
+		for (uint32_t j = i > 2 ? i - 2 : 0; j < i; j++) {
+			graph.add_dependency(i, j);
+			data[i].predecessors.push_back(&data[j]);
+		}
+	}
+
+	for (uint32_t i = 0; i < 100; i++) {
+		TaskGraph::RunID run = graph.submit();
+		graph.wait(run);
+		CHECK(graph.is_run_completed(run));
+	}
+
+	bool all_ok = true;
+	for (NodeData &E : data) {
+		//Reduce number of check messages
+		all_ok &= E.runs.get() == 100 && !E.ran_too_early.is_set();
+	}
+	CHECK(all_ok);
+}
+
+TEST_CASE("[TaskGraph] Overlapping runs keep each task in order") {
+	const uint32_t node_count = 8;
+	const uint32_t run_count = 50;
+	NodeData data[node_count];
+
+	// A chain, like the stages of a frame.
+	TaskGraph graph;
+	graph.add_native_task(static_node, &data[0]);
+	for (uint32_t i = 1; i < node_count; i++) {
+		graph.add_native_continuation(i - 1, static_node, &data[i]);
+		data[i].predecessors.push_back(&data[i - 1]);
+	}
+
+	for (uint32_t i = 0; i < run_count; i++) {
+		graph.submit(); // Without waiting for the previous run.
+	}
+	graph.wait_all();
+
+	bool all_ok = true;
+	for (NodeData &E : data) {
+		//Reduce number of check messages
+		all_ok &= E.runs.get() == run_count && !E.ran_too_early.is_set();
+	}
+	CHECK(all_ok);
+}
+
+TEST_CASE("[TaskGraph] Cycles are rejected") {
+	NodeData data[3];
+	TaskGraph graph;
+	TaskGraph::NodeID a = graph.add_native_task(static_node, &data[0]);
+	TaskGraph::NodeID b = graph.add_native_continuation(a, static_node, &data[1]);
+	TaskGraph::NodeID c = graph.add_native_continuation(b, static_node, &data[2]);
+	graph.add_dependency(a, c);
+
+	ERR_PRINT_OFF;
+	CHECK(graph.submit() == TaskGraph::INVALID_RUN_ID);
+	ERR_PRINT_ON;
+	for (NodeData &E : data) {
+		CHECK(E.runs.get() == 0);
+	}
+
+	graph.clear();
+	CHECK(graph.get_task_count() == 0);
+	TaskGraph::RunID run = graph.submit(); // Empty graphs complete right away.
+	graph.wait(run);
+}
+
+} // namespace TestTaskGraph
+
+#endif // TEST_TASK_GRAPH_H
@@ -107,6 +107,36 @@ TEST_CASE("[WorkerThreadPool] Process elements using group tasks") {
 	}
 }
 
+TEST_CASE("[WorkerThreadPool] Parallel for covers every element once, in ranges no larger than the grain") {
+	for (int iterations = 0; iterations < 200; iterations++) {
+		const uint32_t begin = Math::rand() % 100;
+		const uint32_t count = Math::pow(2.0f, Math::random(0.0f, 14.0f)) - 1;
+		const uint32_t grain = Math::rand() % 64; // Zero lets the pool choose.
+
+		counter.clear();
+		counter.resize(begin + count);
+		SafeFlag oversized_range;
+
+		auto body = [&](uint32_t p_from, uint32_t p_to) {
+			if (p_from >= p_to || (grain && p_to - p_from > grain)) {
+				oversized_range.set();
+			}
+			for (uint32_t i = p_from; i < p_to; i++) {
+				counter[i].increment();
+			}
+		};
+		WorkerThreadPool::get_singleton()->parallel_for(begin, begin + count, grain, body);
+
+		bool all_run_once = true;
+		for (uint32_t i = 0; i < begin + count; i++) {
+			//Reduce number of check messages
+			all_run_once &= counter[i].get() == (i >= begin ? 1 : 0);
+		}
+		CHECK(all_run_once);
+		CHECK_FALSE(oversized_range.is_set());
+	}
+}
+
 static void static_test_daemon(void *p_arg) {
 	while (!exit.is_set()) {
 		counter[0].add(1);
@@ -173,6 +203,111 @@ TEST_CASE("[WorkerThreadPool] Run a yielding daemon as the only hope for other t
 	CHECK_MESSAGE(all_needed_yield, "All legit tasks should have needed the daemon yielding to run.");
 }
 
+static void static_nested_leaf(void *p_arg) {
+	counter[(uintptr_t)p_arg].increment();
+}
+
+static void static_nested_fork(void *p_arg) {
+	// Posted from a pool thread, so these go to its own work queue and get stolen by the others.
+	WorkerThreadPool::TaskID leaves[8];
+	for (int i = 0; i < 8; i++) {
+		leaves[i] = WorkerThreadPool::get_singleton()->add_native_task(static_nested_leaf, p_arg, true);
+	}
+	for (int i = 0; i < 8; i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(leaves[i]);
+	}
+}
+
+TEST_CASE("[WorkerThreadPool] Tasks posted from pool threads are processed exactly once") {
+	for (int iterations = 0; iterations < 100; iterations++) {
+		const int count = 16;
+		counter.clear();
+		counter.resize(count);
+
+		LocalVector<WorkerThreadPool::TaskID> forks;
+		for (int i = 0; i < count; i++) {
+			forks.push_back(WorkerThreadPool::get_singleton()->add_native_task(static_nested_fork, (void *)(uintptr_t)i, true));
+		}
+		for (WorkerThreadPool::TaskID fork : forks) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(fork);
+		}
+
+		bool all_run = true;
+		for (int i = 0; i < count; i++) {
+			//Reduce number of check messages
+			all_run &= counter[i].get() == 8;
+		}
+		CHECK(all_run);
+	}
+}
+
+struct ForkJoinProducer {
+	uint32_t rounds = 0;
+	uint32_t tasks_per_round = 0;
+};
+
+static void static_fork_join_element(void *p_arg) {
+	counter[0].increment();
+}
+
+static void static_fork_join_producer(void *p_arg) {
+	const ForkJoinProducer *producer = (const ForkJoinProducer *)p_arg;
+	LocalVector<WorkerThreadPool::TaskID> tasks;
+	tasks.resize(producer->tasks_per_round);
+	for (uint32_t round = 0; round < producer->rounds; round++) {
+		for (WorkerThreadPool::TaskID &task : tasks) {
+			task = WorkerThreadPool::get_singleton()->add_native_task(static_fork_join_element, nullptr, true);
+		}
+		for (WorkerThreadPool::TaskID task : tasks) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+		}
+	}
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][WorkerThreadPool] Tasks forked and joined from pool threads") {
+	// Producers run as pool tasks, so what they post goes through the per-thread queues.
+	ForkJoinProducer producer;
+	producer.rounds = 500;
+	producer.tasks_per_round = 64;
+
+	for (uint32_t producer_count : { 1, 4, 16 }) {
+		counter.clear();
+		counter.resize(1);
+
+		LocalVector<WorkerThreadPool::TaskID> producer_tasks;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t i = 0; i < producer_count; i++) {
+			producer_tasks.push_back(WorkerThreadPool::get_singleton()->add_native_task(static_fork_join_producer, &producer, true));
+		}
+		for (WorkerThreadPool::TaskID task : producer_tasks) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+		}
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1u);
+
+		uint32_t total_tasks = producer_count * producer.rounds * producer.tasks_per_round;
+		CHECK(counter[0].get() == (int)total_tasks);
+		MESSAGE(producer_count, " producer task(s): ", total_tasks, " tasks in ", elapsed / 1000, " ms (", uint64_t(total_tasks) * 1000000 / elapsed, " tasks/s).");
+	}
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][WorkerThreadPool] Tasks forked and joined from the main thread") {
+	// Tasks posted from outside the pool go through the injection queues.
+	ForkJoinProducer producer;
+	producer.rounds = 2000;
+	producer.tasks_per_round = 64;
+
+	counter.clear();
+	counter.resize(1);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	static_fork_join_producer(&producer);
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1u);
+
+	uint32_t total_tasks = producer.rounds * producer.tasks_per_round;
+	CHECK(counter[0].get() == (int)total_tasks);
+	MESSAGE("Main thread: ", total_tasks, " tasks in ", elapsed / 1000, " ms (", uint64_t(total_tasks) * 1000000 / elapsed, " tasks/s).");
+}
+
 } // namespace TestWorkerThreadPool
 
 #endif // TEST_WORKER_THREAD_POOL_H
@@ -0,0 +1,394 @@
+/**************************************************************************/
+/*  test_physics_server_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_H
+#define TEST_PHYSICS_SERVER_3D_H
+
+#include "servers/physics_3d/godot_physics_server_3d.h"
+#include "servers/physics_3d/godot_shape_3d.h"
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3D {
+
+// A pile of boxes resting against each other on a floor, which all end up in the same island.
+struct BoxPile {
+	GodotPhysicsServer3D *server = nullptr;
+	RID space;
+	RID floor_shape;
+	RID floor;
+	RID box_shape;
+	LocalVector<RID> boxes;
+
+	BoxPile(int p_width, int p_height) {
+		server = memnew(GodotPhysicsServer3D(false));
+		server->init();
+		server->set_active(true);
+
+		space = server->space_create();
+		server->space_set_active(space, true);
+
+		floor_shape = server->world_boundary_shape_create();
+		server->shape_set_data(floor_shape, Plane(Vector3(0, 1, 0), 0));
+		floor = server->body_create();
+		server->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+		server->body_add_shape(floor, floor_shape);
+		server->body_set_space(floor, space);
+
+		box_shape = server->box_shape_create();
+		server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+		for (int y = 0; y < p_height; y++) {
+			for (int z = 0; z < p_width; z++) {
+				for (int x = 0; x < p_width; x++) {
+					RID box = server->body_create();
+					server->body_set_mode(box, PhysicsServer3D::BODY_MODE_RIGID);
+					server->body_add_shape(box, box_shape);
+					server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(x, y + 0.5, z)));
+					server->body_set_space(box, space);
+					boxes.push_back(box);
+				}
+			}
+		}
+	}
+
+	void step(int p_steps) {
+		for (int i = 0; i < p_steps; i++) {
+			server->step(1.0 / 60.0);
+		}
+	}
+
+	Transform3D get_box_transform(int p_index) const {
+		return server->body_get_state(boxes[p_index], PhysicsServer3D::BODY_STATE_TRANSFORM);
+	}
+
+	~BoxPile() {
+		for (const RID &box : boxes) {
+			server->free(box);
+		}
+		server->free(floor);
+		server->free(box_shape);
+		server->free(floor_shape);
+		server->free(space);
+		server->finish();
+		memdelete(server);
+	}
+};
+
+// A bumpy grid of p_size by p_size quads, two triangles each.
+static Vector<Vector3> make_terrain_faces(int p_size) {
+	Vector<Vector3> faces;
+	faces.resize(p_size * p_size * 6);
+	Vector3 *w = faces.ptrw();
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector3 corners[4];
+			for (int i = 0; i < 4; i++) {
+				const real_t corner_x = x + (i & 1);
+				const real_t corner_z = z + (i >> 1);
+				corners[i] = Vector3(corner_x, Math::sin(corner_x * 0.3) * Math::cos(corner_z * 0.2) * 3.0, corner_z);
+			}
+			w[0] = corners[0];
+			w[1] = corners[1];
+			w[2] = corners[2];
+			w[3] = corners[1];
+			w[4] = corners[3];
+			w[5] = corners[2];
+			w += 6;
+		}
+	}
+	return faces;
+}
+
+static void make_concave_polygon_shape(GodotConcavePolygonShape3D &r_shape, const Vector<Vector3> &p_faces) {
+	Dictionary data;
+	data["faces"] = p_faces;
+	data["backface_collision"] = false;
+	r_shape.set_data(data);
+}
+
+static bool collect_face_center(void *p_userdata, GodotShape3D *p_convex) {
+	const GodotFaceShape3D *face = static_cast<GodotFaceShape3D *>(p_convex);
+	static_cast<LocalVector<Vector3> *>(p_userdata)->push_back((face->vertex[0] + face->vertex[1] + face->vertex[2]) / 3.0);
+	return false;
+}
+
+TEST_CASE("[Physics3D][GodotPhysics] Large islands are solved deterministically") {
+	// Enough contacts for the island to be split into batches solved on several threads.
+	LocalVector<Transform3D> transforms[2];
+	for (int run = 0; run < 2; run++) {
+		BoxPile pile(8, 6);
+		pile.step(60);
+		CHECK(pile.server->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT) == 1);
+		for (uint32_t i = 0; i < pile.boxes.size(); i++) {
+			transforms[run].push_back(pile.get_box_transform(i));
+		}
+	}
+
+	bool stable = true;
+	bool same = true;
+	for (uint32_t i = 0; i < transforms[0].size(); i++) {
+		const Vector3 start = Vector3(i % 8, i / 64 + 0.5, (i / 8) % 8);
+		stable = stable && transforms[0][i].origin.distance_to(start) < 0.1;
+		same = same && transforms[0][i] == transforms[1][i];
+	}
+	CHECK_MESSAGE(stable, "The pile should stay at rest.");
+	CHECK_MESSAGE(same, "Stepping the same pile should give exactly the same results.");
+}
+
+TEST_CASE("[Physics3D][GodotPhysics] Batched queries match single queries") {
+	BoxPile pile(8, 2);
+	pile.step(1);
+	PhysicsDirectSpaceState3D *space_state = pile.server->space_get_direct_state(pile.space);
+
+	// Rays going down over the pile and the floor around it, enough for several packets.
+	LocalVector<Vector3> from;
+	LocalVector<Vector3> to;
+	for (int z = 0; z < 24; z++) {
+		for (int x = 0; x < 24; x++) {
+			const Vector3 position = Vector3(x * 0.5 - 2.0, 5.0, z * 0.5 - 2.0);
+			from.push_back(position);
+			to.push_back(position + Vector3(0.3, -10.0, 0.1));
+		}
+	}
+
+	SUBCASE("Rays") {
+		PhysicsDirectSpaceState3D::RayParameters parameters;
+		LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+		results.resize(from.size());
+		LocalVector<bool> collided;
+		collided.resize(from.size());
+		space_state->intersect_rays_batch(parameters, from.ptr(), to.ptr(), from.size(), results.ptr(), collided.ptr());
+
+		bool all_hit = true;
+		bool same = true;
+		for (uint32_t i = 0; i < from.size(); i++) {
+			parameters.from = from[i];
+			parameters.to = to[i];
+			PhysicsDirectSpaceState3D::RayResult result;
+			const bool single_collided = space_state->intersect_ray(parameters, result);
+			all_hit = all_hit && single_collided;
+			same = same && collided[i] == single_collided && results[i].position == result.position && results[i].normal == result.normal && results[i].rid == result.rid && results[i].shape == result.shape;
+		}
+		CHECK_MESSAGE(all_hit, "Every ray should hit the pile or the floor.");
+		CHECK_MESSAGE(same, "Each ray of the batch should give the same result as when cast alone.");
+	}
+
+	SUBCASE("Motions") {
+		const RID sphere_shape = pile.server->sphere_shape_create();
+		pile.server->shape_set_data(sphere_shape, 0.25);
+
+		PhysicsDirectSpaceState3D::ShapeParameters parameters;
+		parameters.shape_rid = sphere_shape;
+		LocalVector<Vector3> motions;
+		for (uint32_t i = 0; i < from.size(); i++) {
+			motions.push_back(to[i] - from[i]);
+		}
+		LocalVector<real_t> closest_safe;
+		closest_safe.resize(from.size());
+		LocalVector<real_t> closest_unsafe;
+		closest_unsafe.resize(from.size());
+		CHECK(space_state->cast_motion_batch(parameters, from.ptr(), motions.ptr(), from.size(), closest_safe.ptr(), closest_unsafe.ptr()));
+
+		bool all_hit = true;
+		bool same = true;
+		for (uint32_t i = 0; i < from.size(); i++) {
+			parameters.transform.origin = from[i];
+			parameters.motion = motions[i];
+			real_t single_closest_safe = 1.0;
+			real_t single_closest_unsafe = 1.0;
+			space_state->cast_motion(parameters, single_closest_safe, single_closest_unsafe);
+			all_hit = all_hit && single_closest_safe < 1.0;
+			same = same && closest_safe[i] == single_closest_safe && closest_unsafe[i] == single_closest_unsafe;
+		}
+		CHECK_MESSAGE(all_hit, "Every motion should be stopped by the pile or the floor.");
+		CHECK_MESSAGE(same, "Each motion of the batch should give the same result as when cast alone.");
+
+		pile.server->free(sphere_shape);
+	}
+}
+
+TEST_CASE("[Physics3D][GodotPhysics] Concave polygon queries match testing every face") {
+	const Vector<Vector3> faces = make_terrain_faces(48);
+	GodotConcavePolygonShape3D shape;
+	make_concave_polygon_shape(shape, faces);
+	RandomPCG random(1234);
+
+	SUBCASE("Segments") {
+		bool same = true;
+		int hit_count = 0;
+		for (int i = 0; i < 500; i++) {
+			const Vector3 from = Vector3(random.random(-5.0f, 53.0f), random.random(-2.0f, 8.0f), random.random(-5.0f, 53.0f));
+			const Vector3 to = from + Vector3(random.random(-20.0f, 20.0f), random.random(-12.0f, 4.0f), random.random(-20.0f, 20.0f));
+
+			Vector3 result;
+			Vector3 normal;
+			int face_index = -1;
+			const bool hit = shape.intersect_segment(from, to, result, normal, face_index, true);
+
+			// The closest hit of any face.
+			GodotFaceShape3D face;
+			const Vector3 dir = (to - from).normalized();
+			real_t closest_d = 1e20;
+			Vector3 closest_result;
+			for (int j = 0; j < faces.size() / 3; j++) {
+				const Face3 face3(faces[j * 3 + 0], faces[j * 3 + 1], faces[j * 3 + 2]);
+				face.vertex[0] = face3.vertex[0];
+				face.vertex[1] = face3.vertex[1];
+				face.vertex[2] = face3.vertex[2];
+				face.normal = face3.get_plane().normal;
+				Vector3 face_result;
+				Vector3 face_normal;
+				int index = j;
+				if (face.intersect_segment(from, to, face_result, face_normal, index, true)) {
+					const real_t d = dir.dot(face_result) - dir.dot(from);
+					if (d > 0 && d < closest_d) {
+						closest_d = d;
+						closest_result = face_result;
+					}
+				}
+			}
+
+			const bool brute_force_hit = closest_d < 1e20;
+			hit_count += hit ? 1 : 0;
+			same = same && hit == brute_force_hit && (!hit || result.is_equal_approx(closest_result));
+		}
+		CHECK_MESSAGE(hit_count > 150, "Enough segments should hit the terrain to be meaningful.");
+		CHECK_MESSAGE(same, "The BVH should find the same closest hit as testing every face.");
+	}
+
+	SUBCASE("Boxes") {
+		bool same = true;
+		for (int i = 0; i < 200; i++) {
+			const AABB aabb(Vector3(random.random(-5.0f, 53.0f), random.random(-5.0f, 5.0f), random.random(-5.0f, 53.0f)), Vector3(random.random(0.0f, 6.0f), random.random(0.0f, 3.0f), random.random(0.0f, 6.0f)));
+
+			LocalVector<Vector3> culled;
+			shape.cull(aabb, collect_face_center, &culled, false);
+			culled.sort();
+
+			LocalVector<Vector3> expected;
+			for (int j = 0; j < faces.size() / 3; j++) {
+				const Face3 face(faces[j * 3 + 0], faces[j * 3 + 1], faces[j * 3 + 2]);
+				if (aabb.intersects(face.get_aabb())) {
+					expected.push_back((face.vertex[0] + face.vertex[1] + face.vertex[2]) / 3.0);
+				}
+			}
+			expected.sort();
+
+			same = same && culled.size() == expected.size();
+			for (uint32_t j = 0; same && j < culled.size(); j++) {
+				same = culled[j].is_equal_approx(expected[j]);
+			}
+		}
+		CHECK_MESSAGE(same, "The BVH should report exactly the faces whose bounds overlap the box.");
+	}
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][Physics3D][GodotPhysics] Casting rays") {
+	const int RAY_ROWS = 256;
+
+	BoxPile pile(24, 1);
+	pile.step(1);
+	PhysicsDirectSpaceState3D *space_state = pile.server->space_get_direct_state(pile.space);
+
+	LocalVector<Vector3> from;
+	LocalVector<Vector3> to;
+	for (int z = 0; z < RAY_ROWS; z++) {
+		for (int x = 0; x < RAY_ROWS; x++) {
+			const Vector3 position = Vector3(x * 0.1, 5.0, z * 0.1);
+			from.push_back(position);
+			to.push_back(position + Vector3(0.0, -10.0, 0.0));
+		}
+	}
+
+	PhysicsDirectSpaceState3D::RayParameters parameters;
+	LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+	results.resize(from.size());
+	LocalVector<bool> collided;
+	collided.resize(from.size());
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	SUBCASE("One by one") {
+		for (uint32_t i = 0; i < from.size(); i++) {
+			parameters.from = from[i];
+			parameters.to = to[i];
+			collided[i] = space_state->intersect_ray(parameters, results[i]);
+		}
+	}
+	SUBCASE("Batched") {
+		space_state->intersect_rays_batch(parameters, from.ptr(), to.ptr(), from.size(), results.ptr(), collided.ptr());
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	MESSAGE(from.size(), " rays: ", double(elapsed) / 1000.0, " ms.");
+}
+
+TEST_CASE_BENCHMARK("[Benchmark][Physics3D][GodotPhysics] Concave polygon queries") {
+	const int TERRAIN_SIZE = 1024;
+	const int QUERY_COUNT = 200000;
+
+	const Vector<Vector3> faces = make_terrain_faces(TERRAIN_SIZE);
+	GodotConcavePolygonShape3D shape;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	make_concave_polygon_shape(shape, faces);
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	MESSAGE(int(faces.size() / 3), " faces: built in ", double(elapsed) / 1000.0, " ms, ", double(shape.bvh.size() * sizeof(GodotConcavePolygonShape3D::BVHNode)) / (1024 * 1024), " MiB of BVH nodes.");
+
+	RandomPCG random(1234);
+	SUBCASE("Segments") {
+		int hit_count = 0;
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < QUERY_COUNT; i++) {
+			const Vector3 from = Vector3(random.random(0.0f, float(TERRAIN_SIZE)), 5.0, random.random(0.0f, float(TERRAIN_SIZE)));
+			const Vector3 to = from + Vector3(random.random(-4.0f, 4.0f), -10.0, random.random(-4.0f, 4.0f));
+			Vector3 result;
+			Vector3 normal;
+			int face_index = -1;
+			hit_count += shape.intersect_segment(from, to, result, normal, face_index, true) ? 1 : 0;
+		}
+		elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+		MESSAGE(QUERY_COUNT, " segments, ", hit_count, " hits: ", double(elapsed) / 1000.0, " ms.");
+	}
+	SUBCASE("Boxes") {
+		LocalVector<Vector3> culled;
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < QUERY_COUNT; i++) {
+			const AABB aabb(Vector3(random.random(0.0f, float(TERRAIN_SIZE)), random.random(-3.0f, 3.0f), random.random(0.0f, float(TERRAIN_SIZE))), Vector3(1.0, 1.0, 1.0));
+			shape.cull(aabb, collect_face_center, &culled, false);
+		}
+		elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+		MESSAGE(QUERY_COUNT, " boxes, ", culled.size(), " faces: ", double(elapsed) / 1000.0, " ms.");
+	}
+}
+
+} // namespace TestPhysicsServer3D
+
+#endif // TEST_PHYSICS_SERVER_3D_H
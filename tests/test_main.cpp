@@ -53,11 +53,13 @@
 #include "tests/core/math/test_aabb.h"
 #include "tests/core/math/test_astar.h"
 #include "tests/core/math/test_basis.h"
+#include "tests/core/math/test_bvh.h"
 #include "tests/core/math/test_color.h"
 #include "tests/core/math/test_expression.h"
 #include "tests/core/math/test_geometry_2d.h"
 #include "tests/core/math/test_geometry_3d.h"
 #include "tests/core/math/test_math_funcs.h"
+#include "tests/core/math/test_packed_array_math.h"
 #include "tests/core/math/test_plane.h"
 #include "tests/core/math/test_quaternion.h"
 #include "tests/core/math/test_random_number_generator.h"
@@ -75,24 +77,31 @@
 #include "tests/core/object/test_method_bind.h"
 #include "tests/core/object/test_object.h"
 #include "tests/core/object/test_undo_redo.h"
+#include "tests/core/os/test_frame_arena.h"
 #include "tests/core/os/test_os.h"
+#include "tests/core/os/test_slab_allocator.h"
 #include "tests/core/string/test_node_path.h"
 #include "tests/core/string/test_string.h"
+#include "tests/core/string/test_string_name.h"
 #include "tests/core/string/test_translation.h"
 #include "tests/core/string/test_translation_server.h"
 #include "tests/core/templates/test_command_queue.h"
+#include "tests/core/templates/test_flat_hash_map.h"
 #include "tests/core/templates/test_hash_map.h"
 #include "tests/core/templates/test_hash_set.h"
 #include "tests/core/templates/test_list.h"
 #include "tests/core/templates/test_local_vector.h"
+#include "tests/core/templates/test_local_vector_inline.h"
 #include "tests/core/templates/test_lru.h"
 #include "tests/core/templates/test_oa_hash_map.h"
 #include "tests/core/templates/test_paged_array.h"
 #include "tests/core/templates/test_rid.h"
 #include "tests/core/templates/test_vector.h"
+#include "tests/core/templates/test_work_stealing_deque.h"
 #include "tests/core/test_crypto.h"
 #include "tests/core/test_hashing_context.h"
 #include "tests/core/test_time.h"
+#include "tests/core/threads/test_task_graph.h"
 #include "tests/core/threads/test_worker_thread_pool.h"
 #include "tests/core/variant/test_array.h"
 #include "tests/core/variant/test_callable.h"
@@ -141,6 +150,7 @@
 #include "tests/scene/test_primitives.h"
 #include "tests/servers/test_navigation_server_2d.h"
 #include "tests/servers/test_navigation_server_3d.h"
+#include "tests/servers/test_physics_server_3d.h"
 #endif // _3D_DISABLED
 
 #include "modules/modules_tests.gen.h"